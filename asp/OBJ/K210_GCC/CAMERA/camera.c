@@ -8,40 +8,40 @@
  *  Copyright (C) 2004-2012 by Embedded and Real-Time Systems Laboratory
  *              Graduate School of Information Science, Nagoya Univ., JAPAN
  * 
- *  嵭Ԥϡʲ(1)(4)ξ˸¤ꡤܥեȥ
- *  ܥեȥѤΤޤࡥʲƱˤѡʣ
- *  ѡۡʰʲѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
- *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
- *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
- *      ˴ޤޤƤ뤳ȡ
- *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
- *      ѤǤǺۤˤϡۤȼɥȡ
- *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
- *      ̵ݾڵǺܤ뤳ȡ
- *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
- *      ѤǤʤǺۤˤϡΤ줫ξ
- *      ȡ
- *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
- *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
- *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
- *        𤹤뤳ȡ
- *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
- *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
- *      ޤܥեȥΥ桼ޤϥɥ桼Τʤ
- *      ͳ˴Ťᤫ⡤嵭ԤTOPPERSץȤ
- *      դ뤳ȡ
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
  * 
- *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
- *  TOPPERSץȤϡܥեȥ˴ؤơλŪ
- *  ФŬޤơʤݾڤԤʤޤܥեȥ
- *  ѤˤľŪޤϴŪʤ»˴ؤƤ⡤
- *  Ǥʤ
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
  * 
  *  $Id: camera.c 2416 2020-12-10 08:06:20Z fukuen $
  */
 
 /* 
- *  CAMERA ǥץ
+ *  CAMERA デモプログラム
  */
 
 #include <kernel.h>
@@ -54,11 +54,21 @@
 #include "device.h"
 #include "sipeed_st7789.h"
 #include "sipeed_ov7740.h"
+#include "sipeed_motion.h"
+#include "image_kernel.h"
+#include "sipeed_aeawb.h"
+#include "sipeed_camstat.h"
+#include "sipeed_strip.h"
+#include "sipeed_framepool.h"
+#include "image_blob.h"
+#include "image_overlay.h"
+#include "lcd_push.h"
+#include "lcd_te.h"
 #include "kernel_cfg.h"
 #include "camera.h"
 
 /*
- *  ӥΥ顼Υ
+ *  サービスコールのエラーのログ出力
  */
 Inline void
 svc_perror(const char *file, int_t line, const char *expr, ER ercd)
@@ -70,12 +80,85 @@ svc_perror(const char *file, int_t line, const char *expr, ER ercd)
 
 #define	SVC_PERROR(expr)	svc_perror(__FILE__, __LINE__, #expr, (expr))
 
-#define SWAP_16(x) ((x >> 8 & 0xff) | (x << 8))
-
 #ifndef SPI1DMATX_SEM
 #define SPI1DMATX_SEM   0
 #endif
 
+/*
+ *  CAMERA_MOTIONを1にすると動き検出を行い、検出結果をLOG_DEBUGで出力する
+ */
+#ifndef CAMERA_MOTION
+#define CAMERA_MOTION       0
+#endif
+
+/*
+ *  CAMERA_MOTION_GATEを1にすると動きのあったフレームのみLCDに表示する
+ *  (CAMERA_MOTIONが1の場合のみ有効)
+ */
+#ifndef CAMERA_MOTION_GATE
+#define CAMERA_MOTION_GATE  0
+#endif
+
+/*
+ *  CAMERA_SOFT_AEAWBを1にするとソフトウェアAE/AWBを使用する
+ */
+#ifndef CAMERA_SOFT_AEAWB
+#define CAMERA_SOFT_AEAWB   0
+#endif
+
+/*
+ *  パイプライン計測のサマリ出力間隔(ms)、0で出力しない
+ */
+#ifndef CAMERA_STAT_REPORT
+#define CAMERA_STAT_REPORT  0
+#endif
+
+/*
+ *  CAMERA_STRIP_VGAを1にするとVGAをバンド分割で取り込み、QVGAに縮小して表示する
+ */
+#ifndef CAMERA_STRIP_VGA
+#define CAMERA_STRIP_VGA    0
+#endif
+
+/*
+ *  CAMERA_BINOCULARを1にするとパワーダウン線で2センサーを交互に取り込み、
+ *  センサー0を表示する
+ */
+#ifndef CAMERA_BINOCULAR
+#define CAMERA_BINOCULAR    0
+#endif
+
+/*
+ *  CAMERA_BLOBを1にすると赤色ブロブを検出し、最大のブロブを枠で表示する
+ */
+#ifndef CAMERA_BLOB
+#define CAMERA_BLOB         0
+#endif
+
+/*
+ *  CAMERA_LCD_ASYNCを1にするとLCD転送を非同期で行い、転送中に次のフレームを
+ *  取り込む(フレームプール使用時)
+ */
+#ifndef CAMERA_LCD_ASYNC
+#define CAMERA_LCD_ASYNC    0
+#endif
+
+/*
+ *  非同期LCD転送の分割フレーム数(32ビット単位)
+ *  LCDは低優先のSPI利用者とし、分割の切れ目で高優先の転送にバスを譲る
+ */
+#ifndef CAMERA_LCD_CHUNK
+#define CAMERA_LCD_CHUNK    4096
+#endif
+
+/*
+ *  CAMERA_OVERLAYを1にするとフレームレートと経過時間のOSDを
+ *  RGB565変換時に合成する
+ */
+#ifndef CAMERA_OVERLAY
+#define CAMERA_OVERLAY      0
+#endif
+
 static uint32_t heap_area[256*1024];
 
 intptr_t heap_param[2] = {
@@ -84,15 +167,125 @@ intptr_t heap_param[2] = {
 };
 
 /*
- *  Ѥѿ
+ *  使用する変数の定義
  */
 LCD_Handler_t  LcdHandle;
 LCD_DrawProp_t DrawProp;
 DVP_Handle_t   DvpHandle;
 OV7740_t       CameraHandle;
+#if CAMERA_MOTION
+MOTION_Handle_t MotionHandle;
+#endif
+AEAWB_Handle_t AeawbHandle;
+IMAGE_Stats_t  FrameStats;
+CAMSTAT_Handle_t CamStat;
+FRAMEPOOL_Handle_t FramePool;
+#if CAMERA_BLOB
+BLOB_Handle_t  BlobHandle;
+BLOB_t         Blobs[4];
+
+/*
+ *  ブロブ外接矩形の描画
+ */
+static void
+draw_blob_box(uint16_t *buf, uint16_t width, const BLOB_t *blob, uint16_t color)
+{
+	uint16_t i;
+
+	for(i = 0 ; i < blob->w ; i++){
+		buf[blob->y * width + blob->x + i] = color;
+		buf[(blob->y + blob->h - 1) * width + blob->x + i] = color;
+	}
+	for(i = 0 ; i < blob->h ; i++){
+		buf[(blob->y + i) * width + blob->x] = color;
+		buf[(blob->y + i) * width + blob->x + blob->w - 1] = color;
+	}
+}
+#endif
+#if CAMERA_OVERLAY
+#define OSD_WIDTH           80
+#define OSD_HEIGHT          18
+
+static uint16_t OsdBuffer[OSD_WIDTH * OSD_HEIGHT];
+OVERLAY_Layer_t OsdLayer;
+OVERLAY_Layer_t *const OsdLayers[1] = { &OsdLayer };
+
+/*
+ *  OSDの更新
+ *  1秒ごとに表示フレームレートと経過時間を描き直し、それ以外のフレームでは
+ *  レイヤーに触れない
+ */
+static void
+update_osd(uint32_t frames)
+{
+	static SYSUTM   last;
+	static uint32_t last_frames;
+	SYSUTM  now;
+	int16_t x;
+
+	get_utm(&now);
+	if(last != 0 && (now - last) < 1000000)
+		return;
+	overlay_clear(&OsdLayer);
+	if(last != 0){
+		x = overlay_text(&OsdLayer, 0, 0, "FPS ", ST7789_WHITE, 1);
+		overlay_number(&OsdLayer, x, 0, (uint32_t)(((uint64_t)(frames - last_frames) * 100000000) / (now - last)), 2, ST7789_WHITE, 1);
+	}
+	x = overlay_text(&OsdLayer, 0, OVERLAY_FONT_HEIGHT + 3, "T ", ST7789_WHITE, 1);
+	overlay_number(&OsdLayer, x, OVERLAY_FONT_HEIGHT + 3, (uint32_t)(now / 100000), 1, ST7789_WHITE, 1);
+	last = now;
+	last_frames = frames;
+}
+#endif
+#if CAMERA_LCD_ASYNC
+LCDPUSH_Handle_t LcdPush;
+SPI_Client_t   LcdClient;
+
+/*
+ *  LCD転送終了でLCDが持つフレームの参照を返却する
+ */
+static void
+lcd_push_callback(LCDPUSH_Handle_t *hpush, uint16_t *buf)
+{
+	FRAMEPOOL_Handle_t *hfp = (FRAMEPOOL_Handle_t *)hpush->Init.exinf;
+	uint8_t i;
+
+	for(i = 0 ; i < hfp->Init.NumFrames ; i++){
+		if(hfp->frame[i].buf == (uint32_t *)buf){
+			framepool_release(hfp, &hfp->frame[i]);
+			break;
+		}
+	}
+}
+#endif
+#if CAMERA_LCD_TE
+LCDTE_Handle_t LcdTe;
+static bool_t  LcdTeSync = true;
+#endif
+#if CAMERA_BINOCULAR
+DVP_Binocular_t Binocular;
+SENSOR_Pair_t  FramePair;
+#endif
+#if CAMERA_STRIP_VGA
+STRIP_Handle_t StripHandle;
 
 /*
- *  ᥤ󥿥
+ *  VGAバンドをQVGAに縮小してLCDバッファに書き込む
+ */
+static ER
+strip_band_callback(STRIP_Handle_t *hsp, const uint32_t *band, uint16_t y, uint16_t lines)
+{
+	uint16_t *lcd_buffer = (uint16_t *)hsp->Init.exinf;
+	uint16_t *pix = (uint16_t *)band;
+
+	image_sensor_to_rgb565(pix, band, hsp->Init.Width * lines);
+	return image_resize_bilinear(lcd_buffer + (y / 2) * (hsp->Init.Width / 2),
+				hsp->Init.Width / 2, lines / 2, pix, hsp->Init.Width, lines);
+}
+#endif
+
+/*
+ *  メインタスク
  */
 void main_task(intptr_t exinf)
 {
@@ -100,21 +293,28 @@ void main_task(intptr_t exinf)
 	SPI_Handle_t    *hspi;
 	LCD_Handler_t   *hlcd;
 	OV7740_t        *hcmr;
+#if CAMERA_MOTION
+	MOTION_Handle_t *hmd;
+	MOTION_Event_t  event;
+#endif
+#if CAMERA_BLOB
+	ER_UINT         nblobs;
+#endif
 	DVP_Handle_t    *hdvp;
+	FRAME_t         *frame;
 	uint16_t        *lcd_buffer;
 	ER_UINT	ercd;
 	uint32_t count;
-	unsigned long atmp;
 
 	SVC_PERROR(syslog_msk_log(LOG_UPTO(LOG_INFO), LOG_UPTO(LOG_EMERG)));
 	syslog(LOG_NOTICE, "Camera program starts (exinf = %d).", (int_t) exinf);
 
 	/*
-	 *  ꥢݡȤν
+	 *  シリアルポートの初期化
 	 *
-	 *  ƥƱꥢݡȤȤʤɡꥢ
-	 *  ݡȤץѤߤξˤϤE_OBJ顼ˤʤ뤬پ
-	 *  ʤ
+	 *  システムログタスクと同じシリアルポートを使う場合など，シリアル
+	 *  ポートがオープン済みの場合にはここでE_OBJエラーになるが，支障は
+	 *  ない．
 	 */
 	ercd = serial_opn_por(TASK_PORTID);
 	if (ercd < 0 && MERCD(ercd) != E_OBJ) {
@@ -162,8 +362,12 @@ void main_task(intptr_t exinf)
 	syslog_1(LOG_NOTICE, "## DvpHandle[%08x] ##", &DvpHandle);
 
 	syslog_3(LOG_NOTICE, "## hcmr->_width(%d) hcmr->_height(%d) size[%08x] ##", hcmr->_width, hcmr->_height, (hcmr->_width * hcmr->_height * 2));
-	hcmr->_dataBuffer = (uint32_t*)malloc(hcmr->_width * hcmr->_height * 2); //RGB565
-    if(hcmr->_dataBuffer == NULL){
+	FramePool.Init.Width     = hcmr->_width;
+	FramePool.Init.Height    = hcmr->_height;
+	FramePool.Init.NumFrames = NUM_CAMERA_FRAMES;
+	FramePool.Init.semid     = FRAMEPOOL_SEM;
+	hcmr->_dataBuffer = (uint32_t*)malloc(FRAMEPOOL_SIZE(hcmr->_width, hcmr->_height, NUM_CAMERA_FRAMES)); //RGB565
+    if(hcmr->_dataBuffer == NULL || framepool_init(&FramePool, hcmr->_dataBuffer, FRAMEPOOL_SIZE(hcmr->_width, hcmr->_height, NUM_CAMERA_FRAMES)) != E_OK){
 		hcmr->_width = 0;
 		hcmr->_height = 0;
 		syslog_0(LOG_ERROR, "Can't allocate _dataBuffer !");
@@ -179,14 +383,10 @@ void main_task(intptr_t exinf)
 		slp_tsk();
 	}
 	syslog_2(LOG_NOTICE, "## hcmr->_dataBuffer[%08x] hcmr->_aiBuffer[%08x] ##", hcmr->_dataBuffer, hcmr->_aiBuffer);
-	atmp = (unsigned long)hcmr->_aiBuffer;
-	hdvp->Init.RedAddr    = (uint32_t)atmp;
-	atmp = (unsigned long)(hcmr->_aiBuffer + hcmr->_width * hcmr->_height);
-	hdvp->Init.GreenAddr  = (uint32_t)atmp;
-	atmp = (unsigned long)(hcmr->_aiBuffer + hcmr->_width * hcmr->_height * 2);
-	hdvp->Init.BlueAddr   = (uint32_t)atmp;
-	atmp = (unsigned long)hcmr->_dataBuffer;
-	hdvp->Init.RGBAddr    = (uint32_t)atmp;
+	hdvp->Init.RedAddr    = DVP_BUS_ADDR(hcmr->_aiBuffer);
+	hdvp->Init.GreenAddr  = DVP_BUS_ADDR(hcmr->_aiBuffer + hcmr->_width * hcmr->_height);
+	hdvp->Init.BlueAddr   = DVP_BUS_ADDR(hcmr->_aiBuffer + hcmr->_width * hcmr->_height * 2);
+	hdvp->Init.RGBAddr    = DVP_BUS_ADDR(hcmr->_dataBuffer);
     dvp_init(hdvp);
 
 	if(ov7740_sensor_gc_detect(hcmr) == E_OK){
@@ -244,33 +444,235 @@ void main_task(intptr_t exinf)
     lcd_init(hlcd);
 	syslog_2(LOG_NOTICE, "width(%d) height(%d)", hlcd->_width, hlcd->_height);
 	count = hcmr->_width * hcmr->_height;
+#if CAMERA_STRIP_VGA
 	lcd_buffer = (uint16_t *)malloc(count * 2);
 	if(lcd_buffer == NULL){
 		syslog_0(LOG_ERROR, "no lcd buffer !");
 		slp_tsk();
 	}
+#endif
 	DrawProp.BackColor = ST7789_BLACK;
 	DrawProp.TextColor = ST7789_WHITE;
 	lcd_fillScreen(&DrawProp);
+#if CAMERA_LCD_TE
+	LcdTe.Init.hlcd     = hlcd;
+	LcdTe.Init.Pin      = LCD_TE_PIN;
+	LcdTe.Init.GpioNum  = LCD_TE_GPIONUM;
+	LcdTe.Init.Interval = 1;
+	LcdTe.Init.Policy   = LCDTE_POLICY_SKIP;
+	LcdTe.Init.Window   = 1000;
+	if(lcdte_init(&LcdTe) != E_OK){
+		syslog_0(LOG_ERROR, "lcd te init error !");
+		slp_tsk();
+	}
+#endif
+#if CAMERA_LCD_ASYNC
+	LcdPush.Init.hlcd      = hlcd;
+	LcdPush.Init.Buffer[0] = NULL;
+	LcdPush.Init.Buffer[1] = NULL;
+	LcdPush.Init.semid     = 0;
+	LcdPush.Init.callback  = lcd_push_callback;
+	LcdPush.Init.exinf     = (intptr_t)&FramePool;
+	if(lcdpush_init(&LcdPush) != E_OK){
+		syslog_0(LOG_ERROR, "lcd push init error !");
+		slp_tsk();
+	}
+	spi_client_attach(hspi, &LcdClient, SPI_PRIORITY_LOW, CAMERA_LCD_CHUNK, LCDCLIENT_SEM);
+#endif
+
+#if CAMERA_MOTION
+	hmd = &MotionHandle;
+	hmd->Init.GridWidth  = 40;
+	hmd->Init.GridHeight = 30;
+	hmd->Init.Threshold  = 12;
+	hmd->Init.LearnShift = 3;
+	hmd->Init.SampleStep = 2;
+	hmd->Init.MinCells   = 4;
+	if(motion_init(hmd) != E_OK){
+		syslog_0(LOG_ERROR, "motion init error !");
+		slp_tsk();
+	}
+#endif
+
+#if CAMERA_SOFT_AEAWB
+	AeawbHandle.Init.TargetY   = 110;
+	AeawbHandle.Init.Tolerance = 8;
+	AeawbHandle.Init.ExpMin    = 4;
+	AeawbHandle.Init.ExpMax    = 500;
+	AeawbHandle.Init.GainMax   = SENSOR_GAIN_UNIT * 3;
+	AeawbHandle.Init.AutoWB    = true;
+	if(aeawb_init(&AeawbHandle, hcmr) != E_OK){
+		syslog_0(LOG_ERROR, "aeawb init error !");
+		slp_tsk();
+	}
+#endif
 
+#if CAMERA_STRIP_VGA
+	StripHandle.Init.Width      = 640;
+	StripHandle.Init.Height     = 480;
+	StripHandle.Init.BandLines  = STRIP_DEF_LINES;
+	StripHandle.Init.SkipFrames = STRIP_DEF_SKIP;
+	StripHandle.Init.Buffer     = (uint32_t *)malloc(640 * STRIP_DEF_LINES * 2);
+	StripHandle.Init.callback   = strip_band_callback;
+	StripHandle.Init.exinf      = (intptr_t)lcd_buffer;
+	if(StripHandle.Init.Buffer == NULL || strip_init(&StripHandle, hcmr) != E_OK){
+		syslog_0(LOG_ERROR, "strip init error !");
+		slp_tsk();
+	}
+#endif
+
+#if CAMERA_BLOB
+	BlobHandle.Init.Space      = BLOB_SPACE_LAB;
+	BlobHandle.Init.Min[0]     = 20;
+	BlobHandle.Init.Max[0]     = 80;
+	BlobHandle.Init.Min[1]     = 30;
+	BlobHandle.Init.Max[1]     = 127;
+	BlobHandle.Init.Min[2]     = 0;
+	BlobHandle.Init.Max[2]     = 127;
+	BlobHandle.Init.SampleStep = 2;
+	BlobHandle.Init.MinPixels  = 200;
+	if(blob_init(&BlobHandle) != E_OK){
+		syslog_0(LOG_ERROR, "blob init error !");
+		slp_tsk();
+	}
+#endif
+#if CAMERA_OVERLAY
+	OsdLayer.x      = 4;
+	OsdLayer.y      = 4;
+	OsdLayer.width  = OSD_WIDTH;
+	OsdLayer.height = OSD_HEIGHT;
+	OsdLayer.buf    = OsdBuffer;
+	OsdLayer.key    = ST7789_BLACK;
+	OsdLayer.enable = 1;
+	overlay_clear(&OsdLayer);
+#endif
+#if CAMERA_BINOCULAR
+	/* プールの2フレームをセンサー0/1の出力先として占有する */
+	frame = framepool_get(&FramePool, TMO_POL);
+	if(frame == NULL){
+		syslog_0(LOG_ERROR, "binocular frame0 get error !");
+		slp_tsk();
+	}
+	Binocular.RGBAddr[0] = DVP_BUS_ADDR(frame->buf);
+	frame = framepool_get(&FramePool, TMO_POL);
+	if(frame == NULL){
+		syslog_0(LOG_ERROR, "binocular frame1 get error !");
+		slp_tsk();
+	}
+	Binocular.RGBAddr[1] = DVP_BUS_ADDR(frame->buf);
+	Binocular.Select     = (hcmr->_pwdnPoliraty == ACTIVE_HIGH) ? false : true;
+	Binocular.Settle     = 1;
+	if(ov7740_binocular_reset(hcmr, &Binocular) != E_OK){
+		syslog_0(LOG_ERROR, "binocular reset error !");
+		slp_tsk();
+	}
+#endif
+
+	camstat_init(&CamStat, CAMERA_STAT_REPORT);
 	if((ercd = ov7740_activate(hcmr, true)) != E_OK){
 		syslog_2(LOG_NOTICE, "ov7740 activate error result(%d) id(%d) ##", ercd, ov7740_id(hcmr));
 		slp_tsk();
 	}
 
 	for(;;){
-		ercd = ov7740_snapshot(hcmr);
+#if CAMERA_STRIP_VGA
+		ercd = strip_capture(&StripHandle);
+		camstat_frame(&CamStat, hdvp, ercd);
+		if(ercd == E_OK){
+			camstat_mark(&CamStat, CAMSTAT_CONVERT);
+			lcd_drawPicture(hlcd, 0, 0, hcmr->_width, hcmr->_height, lcd_buffer);
+			camstat_mark(&CamStat, CAMSTAT_DISPLAY);
+		}
+		camstat_done(&CamStat);
+		continue;
+#endif
+#if CAMERA_BINOCULAR
+		ercd = ov7740_snapshot_pair(hcmr, &Binocular, &FramePair);
+		camstat_frame(&CamStat, hdvp, ercd);
 		if(ercd == E_OK){
-			uint16_t *p = (uint16_t *)hcmr->_dataBuffer;
-			uint32_t no;
-			for (no = 0; no < count ; no += 2){
-				lcd_buffer[no]   = SWAP_16(*(p + 1));
-				lcd_buffer[no+1] = SWAP_16(*(p));
-				p += 2;
-			}
+			syslog_2(LOG_DEBUG, "pair(%d) skew(%d)us", FramePair.seq, FramePair.skew);
+			lcd_buffer = (uint16_t *)FramePair.buf[0];
+			image_sensor_to_rgb565(lcd_buffer, FramePair.buf[0], count);
+			camstat_mark(&CamStat, CAMSTAT_CONVERT);
 			lcd_drawPicture(hlcd, 0, 0, hcmr->_width, hcmr->_height, lcd_buffer);
+			camstat_mark(&CamStat, CAMSTAT_DISPLAY);
+		}
+		camstat_done(&CamStat);
+		continue;
+#endif
+		ercd = framepool_capture(&FramePool, hcmr, &frame, TMO_FEVR);
+		camstat_frame(&CamStat, hdvp, ercd);
+		if(ercd != E_OK){
+			camstat_done(&CamStat);
+			continue;
+		}
+#if CAMERA_MOTION
+		if(motion_detect(hmd, frame->buf, frame->width, frame->height, frame->format, &event) > 0){
+			syslog_5(LOG_DEBUG, "motion cells(%d) x(%d) y(%d) w(%d) h(%d)", event.cells, event.x, event.y, event.w, event.h);
+		}
+		else if(CAMERA_MOTION_GATE){
+			framepool_release(&FramePool, frame);
+			camstat_done(&CamStat);
+			continue;
+		}
+#endif
+		/* 参照者が自タスクのみのため、フレーム上でRGB565に変換する */
+		lcd_buffer = (uint16_t *)frame->buf;
+#if CAMERA_SOFT_AEAWB
+		image_stats_clear(&FrameStats);
+		image_sensor_to_rgb565_stats(lcd_buffer, frame->buf, count, &FrameStats);
+		aeawb_update(&AeawbHandle, &FrameStats);
+#if CAMERA_OVERLAY
+		update_osd(frame->seq);
+		overlay_compose(lcd_buffer, frame->width, frame->height, OsdLayers, 1);
+#endif
+#elif CAMERA_OVERLAY
+		update_osd(frame->seq);
+		overlay_sensor_to_rgb565(lcd_buffer, frame->buf, frame->width, frame->height, OsdLayers, 1);
+#else
+		image_sensor_to_rgb565(lcd_buffer, frame->buf, count);
+#endif
+#if CAMERA_BLOB
+		nblobs = blob_find(&BlobHandle, lcd_buffer, frame->width, frame->height, Blobs, 4);
+		if(nblobs > 0){
+			syslog_4(LOG_INFO, "blob cx(%d) cy(%d) pixels(%d) %dus", Blobs[0].cx, Blobs[0].cy, Blobs[0].pixels, BlobHandle.time);
+			draw_blob_box(lcd_buffer, frame->width, &Blobs[0], ST7789_WHITE);
+		}
+		else if(nblobs == E_NOMEM && (frame->seq % 100) == 0)
+			syslog_1(LOG_WARNING, "blob overflow(%d) !", BlobHandle.overflow);
+#endif
+		camstat_mark(&CamStat, CAMSTAT_CONVERT);
+#if CAMERA_LCD_TE
+		/* TEが来ない場合は以後同期せずに表示する */
+		if(LcdTeSync && lcdte_sync(&LcdTe) == E_TMOUT){
+			syslog_0(LOG_WARNING, "lcd te timeout, sync disabled !");
+			LcdTeSync = false;
+		}
+		if(LcdTeSync && (frame->seq % 100) == 0){
+			syslog_4(LOG_NOTICE, "lcd te period(%u)us late(%u) skipped(%u) maxwait(%u)us", LcdTe.period, LcdTe.late, LcdTe.skipped, LcdTe.maxwait);
+			lcdte_clear_stat(&LcdTe);
 		}
+#endif
+#if CAMERA_LCD_ASYNC
+		/* LCD転送中の参照を追加し、転送終了コールバックで返却する */
+		framepool_acquire(&FramePool, frame);
+		if(lcdpush_draw_async(&LcdPush, 0, 0, frame->width, frame->height, lcd_buffer) != E_OK)
+			framepool_release(&FramePool, frame);
+		if((frame->seq % 100) == 0){
+			uint32_t fps = lcdpush_get_fps(&LcdPush);
+			SPI_WaitStat_t ws;
+			syslog_3(LOG_NOTICE, "lcd fps(%u.%02u) push(%u)us", fps / 100, fps % 100, LcdPush.time);
+			spi_get_wait_stat(hspi, &hspi->async, &ws, true);
+			syslog_3(LOG_NOTICE, "lcd spi yields(%u) resume max(%u)us total(%u)us", ws.yields, ws.max, (uint32_t)ws.total);
+		}
+#else
+		lcd_drawPicture(hlcd, 0, 0, frame->width, frame->height, lcd_buffer);
+#endif
+		camstat_mark(&CamStat, CAMSTAT_DISPLAY);
+		framepool_release(&FramePool, frame);
+		camstat_done(&CamStat);
 	}
+
 	ov7740_activate(hcmr, false);
 
 	syslog_0(LOG_NOTICE, "## STOP ##");
@@ -8,68 +8,76 @@
  *  Copyright (C) 2004-2010 by Embedded and Real-Time Systems Laboratory
  *              Graduate School of Information Science, Nagoya Univ., JAPAN
  *
- *  嵭Ԥϡʲ(1)(4)ξ˸¤ꡤܥեȥ
- *  ܥեȥѤΤޤࡥʲƱˤѡʣ
- *  ѡۡʰʲѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
- *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
- *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
- *      ˴ޤޤƤ뤳ȡ
- *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
- *      ѤǤǺۤˤϡۤȼɥȡ
- *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
- *      ̵ݾڵǺܤ뤳ȡ
- *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
- *      ѤǤʤǺۤˤϡΤ줫ξ
- *      ȡ
- *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
- *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
- *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
- *        𤹤뤳ȡ
- *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
- *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
- *      ޤܥեȥΥ桼ޤϥɥ桼Τʤ
- *      ͳ˴Ťᤫ⡤嵭ԤTOPPERSץȤ
- *      դ뤳ȡ
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
  * 
- *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
- *  TOPPERSץȤϡܥեȥ˴ؤơλŪ
- *  ФŬޤơʤݾڤԤʤޤܥեȥ
- *  ѤˤľŪޤϴŪʤ»˴ؤƤ⡤
- *  Ǥʤ
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
  *
  *  $Id: camera.h 2416 2020-12-10 08:06:20Z fukuen $
  */
 
 /*
- *  CAMERA ץΥإåե
+ *  CAMERA プログラムのヘッダファイル
  */
 
 /*
- *  åȰ¸
+ *  ターゲット依存の定義
  */
 #include "target_test.h"
 #include "glcd_disp.h"
 #include "i2c.h"
 
 /*
- *  ƥͥ٤
+ *  各タスクの優先度の定義
  */
 
-#define MAIN_PRIORITY	5		/* ᥤ󥿥ͥ */
-								/* HIGH_PRIORITY⤯뤳 */
+#define MAIN_PRIORITY	5		/* メインタスクの優先度 */
+								/* HIGH_PRIORITYより高くすること */
 
 /*
- *  åȤ˰¸ǽΤ
+ *  ターゲットに依存する可能性のある定数の定義
  */
 
 #ifndef TASK_PORTID
-#define	TASK_PORTID		1			/* ʸϤ륷ꥢݡID */
+#define	TASK_PORTID		1			/* 文字入力するシリアルポートID */
 #endif /* TASK_PORTID */
 
 #ifndef STACK_SIZE
-#define	STACK_SIZE		8192		/* Υå */
+#define	STACK_SIZE		8192		/* タスクのスタックサイズ */
 #endif /* STACK_SIZE */
 
+#ifndef DVP_SIM_PERIOD
+#define DVP_SIM_PERIOD		33			/* シミュレーションのフレーム周期(ms) */
+#endif /* DVP_SIM_PERIOD */
+
+#ifndef NUM_CAMERA_FRAMES
+#define NUM_CAMERA_FRAMES	2			/* フレームプールのフレーム数 */
+#endif /* NUM_CAMERA_FRAMES */
+
 #define SIPEED_ST7789_RST_PIN    37
 #define SIPEED_ST7789_DCX_PIN    38
 #define SIPEED_ST7789_SS_PIN     36
@@ -89,16 +97,34 @@
 #define LED_PIN       14 //blue
 
 #define SPI_PORTID    SPI1_PORTID
-#define INHNO_SPI     IRQ_VECTOR_SPI0	/* ߥϥɥֹ */
-#define INTNO_SPI     IRQ_VECTOR_SPI0	/* ֹ */
-#define INTPRI_SPI    -5		/* ͥ */
-#define INTATR_SPI    0			/* ° */
+#define INHNO_SPI     IRQ_VECTOR_SPI0	/* 割込みハンドラ番号 */
+#define INTNO_SPI     IRQ_VECTOR_SPI0	/* 割込み番号 */
+#define INTPRI_SPI    -5		/* 割込み優先度 */
+#define INTATR_SPI    0			/* 割込み属性 */
 
 #define SIPEED_DMA_CH DMA_CHANNEL3
-#define INHNO_DMATX   IRQ_VECTOR_DMA3	/* ߥϥɥֹ */
-#define INTNO_DMATX   IRQ_VECTOR_DMA3	/* ֹ */
-#define INTPRI_DMATX  -4		/* ͥ */
-#define INTATR_DMATX  0			/* ° */
+#define INHNO_DMATX   IRQ_VECTOR_DMA3	/* 割込みハンドラ番号 */
+#define INTNO_DMATX   IRQ_VECTOR_DMA3	/* 割込み番号 */
+#define INTPRI_DMATX  -4		/* 割込み優先度 */
+#define INTATR_DMATX  0			/* 割込み属性 */
+
+/*
+ *  CAMERA_LCD_TEを1にするとパネルのTE出力でLCD転送の開始を同期する
+ *  LCD_TE_PIN/LCD_TE_GPIONUMは仮の値で、標準のボードにはTEの配線がない．
+ *  TE信号の配線に合わせてピン番号を変更すること
+ */
+#ifndef CAMERA_LCD_TE
+#define CAMERA_LCD_TE 0
+#endif
+
+#if CAMERA_LCD_TE
+#define LCD_TE_PIN    35		/* 仮の値 */
+#define LCD_TE_GPIONUM 8		/* 仮の値 */
+#define INHNO_LCDTE   (IRQ_VECTOR_GPIOHS0+LCD_TE_GPIONUM)	/* 割込みハンドラ番号 */
+#define INTNO_LCDTE   (IRQ_VECTOR_GPIOHS0+LCD_TE_GPIONUM)	/* 割込み番号 */
+#define INTPRI_LCDTE  -3		/* 割込み優先度 */
+#define INTATR_LCDTE  0			/* 割込み属性 */
+#endif
 
 #ifndef PORTID
 #define PORTID        1				/* arduino D15/D14 */
@@ -106,30 +132,36 @@
 
 #if PORTID == 1
 #define I2C_PORTID    I2C1_PORTID
-#define INHNO_I2CEV   IRQ_VECTOR_I2C0	/* ߥϥɥֹ */
-#define INTNO_I2CEV   IRQ_VECTOR_I2C0	/* ֹ */
-#define INTPRI_I2CEV  -5			/* ͥ */
-#define INTATR_I2CEV  0				/* ° */
+#define INHNO_I2CEV   IRQ_VECTOR_I2C0	/* 割込みハンドラ番号 */
+#define INTNO_I2CEV   IRQ_VECTOR_I2C0	/* 割込み番号 */
+#define INTPRI_I2CEV  -5			/* 割込み優先度 */
+#define INTATR_I2CEV  0				/* 割込み属性 */
 #else
 #define I2C_PORTID    I2C2_PORTID
-#define INHNO_I2CEV   IRQ_VECTOR_I2C1	/* ߥϥɥֹ */
-#define INTNO_I2CEV   IRQ_VECTOR_I2C1	/* ֹ */
-#define INTPRI_I2CEV  -5			/* ͥ */
-#define INTATR_I2CEV  0				/* ° */
+#define INHNO_I2CEV   IRQ_VECTOR_I2C1	/* 割込みハンドラ番号 */
+#define INTNO_I2CEV   IRQ_VECTOR_I2C1	/* 割込み番号 */
+#define INTPRI_I2CEV  -5			/* 割込み優先度 */
+#define INTATR_I2CEV  0				/* 割込み属性 */
 #endif
 
 #ifndef TOPPERS_MACRO_ONLY
 
 /*
- *  ҡΰ
+ *  ヒープ領域の設定
  */
 extern intptr_t heap_param[2];
 
 /*
- *  ؿΥץȥ
+ *  関数のプロトタイプ宣言
  */
 
 extern void	main_task(intptr_t exinf);
 extern void heap_init(intptr_t exinf);
+#ifdef DVP_SIMULATION
+extern void dvp_sim_cyclic(intptr_t exinf);
+#endif
+#if CAMERA_LCD_TE
+extern void lcdte_isr(intptr_t exinf);
+#endif
 
 #endif /* TOPPERS_MACRO_ONLY */
@@ -9,40 +9,40 @@
  *              Graduate School of Information Science, Nagoya Univ., JAPAN
  *  Copyright (C) 2020-2021 by fukuen
  * 
- *  嵭Ԥϡʲ(1)(4)ξ˸¤ꡤܥեȥ
- *  ܥեȥѤΤޤࡥʲƱˤѡʣ
- *  ѡۡʰʲѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
- *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
- *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
- *      ˴ޤޤƤ뤳ȡ
- *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
- *      ѤǤǺۤˤϡۤȼɥȡ
- *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
- *      ̵ݾڵǺܤ뤳ȡ
- *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
- *      ѤǤʤǺۤˤϡΤ줫ξ
- *      ȡ
- *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
- *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
- *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
- *        𤹤뤳ȡ
- *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
- *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
- *      ޤܥեȥΥ桼ޤϥɥ桼Τʤ
- *      ͳ˴Ťᤫ⡤嵭ԤTOPPERSץȤ
- *      դ뤳ȡ
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
  * 
- *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
- *  TOPPERSץȤϡܥեȥ˴ؤơλŪ
- *  ФŬޤơʤݾڤԤʤޤܥեȥ
- *  ѤˤľŪޤϴŪʤ»˴ؤƤ⡤
- *  Ǥʤ
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
  * 
  *  $Id: main.c 2416 2020-12-03 08:06:20Z fukuen $
  */
 
 /* 
- *  FFTץץ
+ *  FFTサンプルプログラムの本体
  */
 
 #include <kernel.h>
@@ -57,6 +57,8 @@
 #include <math.h>
 #include "device.h"
 #include "sipeed_st7789.h"
+#include "lcd_push.h"
+#include "lcd_fb.h"
 #include "i2s.h"
 #include "fft.h"
 #include "spi.h"
@@ -71,7 +73,7 @@
 #define MIC_DAT_PIN   20
 
 /*
- *  ӥΥ顼Υ
+ *  サービスコールのエラーのログ出力
  */
 Inline void
 svc_perror(const char *file, int_t line, const char *expr, ER ercd)
@@ -87,6 +89,28 @@ svc_perror(const char *file, int_t line, const char *expr, ER ercd)
 #define SPI1DMATX_SEM   0
 #endif
 
+/*
+ *  FFT_LCD_ASYNCを1にするとダブルバッファでLCD転送中に次の描画を行う
+ */
+#ifndef FFT_LCD_ASYNC
+#define FFT_LCD_ASYNC   0
+#endif
+
+/*
+ *  FFT_LCD_DIRTYを1にすると高さの変化したバーの領域のみLCDに送信する
+ */
+#ifndef FFT_LCD_DIRTY
+#define FFT_LCD_DIRTY   0
+#endif
+
+/*
+ *  FFT_LCD_FILLを1にするとフレームバッファを使わず、高さの変化したバーの
+ *  差分をフィルDMAで直接描画する
+ */
+#ifndef FFT_LCD_FILL
+#define FFT_LCD_FILL    0
+#endif
+
 static uint32_t heap_area[2*512*1024];
 
 intptr_t heap_param[2] = {
@@ -94,7 +118,7 @@ intptr_t heap_param[2] = {
 	(4*2*512*1024)
 };
 /*
- *  Ѥѿ
+ *  使用する変数の定義
  */
 LCD_Handler_t  LcdHandle;
 LCD_DrawProp_t DrawProp;
@@ -117,7 +141,20 @@ float hard_power[FFT_N];
 
 #define WIDTH 320
 #define HEIGHT 240
+#if FFT_LCD_FILL
+LCDPUSH_Handle_t LcdPush;
+LCDPUSH_Bars_t FftBars;
+#elif FFT_LCD_DIRTY
+uint16_t g_lcd_gram[WIDTH * HEIGHT] __attribute__((aligned(64)));
+uint16_t g_lcd_staging[WIDTH * 60] __attribute__((aligned(64)));
+LCDPUSH_Handle_t LcdPush;
+LCDFB_Handle_t LcdFb;
+#elif FFT_LCD_ASYNC
+uint16_t g_lcd_gram[2][WIDTH * HEIGHT] __attribute__((aligned(64)));
+LCDPUSH_Handle_t LcdPush;
+#else
 uint16_t g_lcd_gram[WIDTH * HEIGHT] __attribute__((aligned(64)));
+#endif
 
 #define SAMPLE_RATE 16000
 
@@ -130,7 +167,7 @@ uint16_t g_lcd_gram[WIDTH * HEIGHT] __attribute__((aligned(64)));
 #define INPUT_PULLDOWN  0X1
 
 /*
- *  쥯ȥǥԥ
+ *  ダイレクトデジタルピン設定
 */
 void
 pinMode(uint8_t Pin, uint8_t dwMode){ 
@@ -166,7 +203,7 @@ pinMode(uint8_t Pin, uint8_t dwMode){
 }
 
 /*
- *  쥯ȥǥԥ
+ *  ダイレクトデジタルピン出力
  */
 void
 digitalWrite(uint8_t Pin, int dwVal){
@@ -179,31 +216,43 @@ digitalWrite(uint8_t Pin, int dwVal){
 
 #define SWAP_16(x) ((x >> 8 & 0xff) | (x << 8))
 
+#define NUM_BARS 80
+int g_bar_height[NUM_BARS];
+
+/*
+ *  パワースペクトルからバーの高さ(0-120)を求める
+ */
+static void
+calc_fft_bars(float* hard_power, float pw_max)
+{
+    int i, h;
+
+    for (i = 0; i < NUM_BARS; i++)  // 53* 38640/512 => ~4000Hz
+    {
+        h = 120*(hard_power[i+2])/pw_max;
+
+        if (h>120)
+            h = 120;
+        if (h<0)
+            h = 0;
+        g_bar_height[i] = h;
+    }
+}
+
 void update_image_fft(float* hard_power, float pw_max, uint32_t* pImage, uint32_t color, uint32_t bkg_color)
 {
     uint32_t bcolor= SWAP_16((bkg_color << 16)) | SWAP_16(bkg_color);
     uint32_t fcolor= SWAP_16((color << 16)) | SWAP_16(color);
 
-    int  h[80];
-
     int i, x = 0;
 
-    for (i = 0; i < 80; i++)
-    {
-        h[i]=120*(hard_power[i])/pw_max;
-
-        if (h[i]>120)
-            h[i] = 120;
-        if (h[i]<0)
-            h[i] = 0;
-    }
-
-    for (i = 0; i < 80; i++)  // 53* 38640/512 => ~4000Hz
+    calc_fft_bars(hard_power, pw_max);
+    for (i = 0; i < NUM_BARS; i++)
     {
         x=i*2;
         for( int y=0; y<120; y++)
         {
-            if( y<(120 - h[i+2]) )
+            if( y<(120 - g_bar_height[i]) )
             {
                 pImage[x+y*2*160]=bcolor;
                 pImage[x+1+y*2*160]=bcolor;
@@ -221,6 +270,45 @@ void update_image_fft(float* hard_power, float pw_max, uint32_t* pImage, uint32_
     }
 }
 
+#if FFT_LCD_FILL
+/*
+ *  前回から高さの変化したバーの差分をフィルDMAで描画する
+ */
+static ER
+draw_fft_bars(LCDPUSH_Handle_t *hpush)
+{
+    static uint16_t prev[NUM_BARS];
+    uint16_t height[NUM_BARS];
+    int i;
+
+    for (i = 0; i < NUM_BARS; i++)
+        height[i] = g_bar_height[i] * 2;
+    return lcdpush_bars(hpush, &FftBars, height, prev);
+}
+#endif
+
+#if FFT_LCD_DIRTY
+/*
+ *  前回から高さの変化したバーの領域を更新登録する
+ */
+static void
+damage_fft_bars(LCDFB_Handle_t *hfb)
+{
+    static int prev[NUM_BARS];
+    int i, lo, hi;
+
+    for (i = 0; i < NUM_BARS; i++)
+    {
+        if (g_bar_height[i] == prev[i])
+            continue;
+        lo = g_bar_height[i] < prev[i] ? g_bar_height[i] : prev[i];
+        hi = g_bar_height[i] > prev[i] ? g_bar_height[i] : prev[i];
+        lcdfb_damage(hfb, i * 4, (120 - hi) * 2, 4, (hi - lo) * 2);
+        prev[i] = g_bar_height[i];
+    }
+}
+#endif
+
 void FFT(FFT_Handle_t *hfft, int offset)
 {
     for (int i = 0; i < FFT_N / 2; i++)
@@ -254,12 +342,15 @@ void FFT(FFT_Handle_t *hfft, int offset)
 
 
 /*
- *  ᥤ󥿥
+ *  メインタスク
  */
 void main_task(intptr_t exinf)
 {
 	SPI_Handle_t  *hspi;
 	LCD_Handler_t *hlcd;
+#if !FFT_LCD_FILL
+	uint16_t      *gram;
+#endif
 	I2S_Handle_t  *hi2s_i;
 	I2S_Handle_t  *hi2s_o;
 	FFT_Handle_t  *hfft;
@@ -270,11 +361,11 @@ void main_task(intptr_t exinf)
 	syslog(LOG_NOTICE, "Sample program starts (exinf = %d).", (int_t) exinf);
 
 	/*
-	 *  ꥢݡȤν
+	 *  シリアルポートの初期化
 	 *
-	 *  ƥƱꥢݡȤȤʤɡꥢ
-	 *  ݡȤץѤߤξˤϤE_OBJ顼ˤʤ뤬پ
-	 *  ʤ
+	 *  システムログタスクと同じシリアルポートを使う場合など，シリアル
+	 *  ポートがオープン済みの場合にはここでE_OBJエラーになるが，支障は
+	 *  ない．
 	 */
 	ercd = serial_opn_por(TASK_PORTID);
 	if (ercd < 0 && MERCD(ercd) != E_OBJ) {
@@ -404,12 +495,83 @@ void main_task(intptr_t exinf)
 	DrawProp.BackColor = ST7789_BLACK;
 	DrawProp.TextColor = ST7789_RED;
 	lcd_fillScreen(&DrawProp);
+#if FFT_LCD_FILL
+	LcdPush.Init.hlcd      = hlcd;
+	LcdPush.Init.Buffer[0] = NULL;
+	LcdPush.Init.Buffer[1] = NULL;
+	LcdPush.Init.semid     = 0;
+	LcdPush.Init.callback  = NULL;
+	LcdPush.Init.exinf     = 0;
+	if(lcdpush_init(&LcdPush) != E_OK){
+		syslog_0(LOG_ERROR, "## LCD PUSH INIT ERROR ##");
+		slp_tsk();
+	}
+	FftBars.x         = 0;
+	FftBars.y         = HEIGHT;
+	FftBars.width     = 4;
+	FftBars.pitch     = 4;
+	FftBars.maxheight = HEIGHT;
+	FftBars.num       = NUM_BARS;
+	FftBars.color     = (uint16_t)SWAP_16(ST7789_BLUE);
+	FftBars.back      = (uint16_t)SWAP_16(ST7789_BLACK);
+#elif FFT_LCD_DIRTY
+	LcdPush.Init.hlcd      = hlcd;
+	LcdPush.Init.Buffer[0] = NULL;
+	LcdPush.Init.Buffer[1] = NULL;
+	LcdPush.Init.semid     = 0;
+	LcdPush.Init.callback  = NULL;
+	LcdPush.Init.exinf     = 0;
+	LcdFb.Init.hpush       = &LcdPush;
+	LcdFb.Init.Buffer      = g_lcd_gram;
+	LcdFb.Init.Width       = WIDTH;
+	LcdFb.Init.Height      = HEIGHT;
+	LcdFb.Init.Staging     = g_lcd_staging;
+	LcdFb.Init.StagingSize = sizeof(g_lcd_staging);
+	if(lcdpush_init(&LcdPush) != E_OK || lcdfb_init(&LcdFb) != E_OK){
+		syslog_0(LOG_ERROR, "## LCD FB INIT ERROR ##");
+		slp_tsk();
+	}
+	lcdfb_damage_all(&LcdFb);
+	gram = g_lcd_gram;
+#elif FFT_LCD_ASYNC
+	LcdPush.Init.hlcd      = hlcd;
+	LcdPush.Init.Buffer[0] = g_lcd_gram[0];
+	LcdPush.Init.Buffer[1] = g_lcd_gram[1];
+	LcdPush.Init.semid     = 0;
+	LcdPush.Init.callback  = NULL;
+	LcdPush.Init.exinf     = 0;
+	if(lcdpush_init(&LcdPush) != E_OK){
+		syslog_0(LOG_ERROR, "## LCD PUSH INIT ERROR ##");
+		slp_tsk();
+	}
+	gram = lcdpush_back_buffer(&LcdPush);
+#else
+	gram = g_lcd_gram;
+#endif
 
 	while (1){
 		i2s_receive_data(hi2s_i, i2s_rx_buf, FRAME_LENGTH * 2);
 		FFT(hfft, 0);
-		update_image_fft(hard_power, 140 /*MAX range dBFS*/, (uint32_t *)g_lcd_gram, ST7789_BLUE, ST7789_BLACK);
-		lcd_drawPicture(hlcd, 0, 0, WIDTH, HEIGHT, (uint16_t *)g_lcd_gram);
+#if !FFT_LCD_FILL
+		update_image_fft(hard_power, 140 /*MAX range dBFS*/, (uint32_t *)gram, ST7789_BLUE, ST7789_BLACK);
+#endif
+#if FFT_LCD_FILL
+		calc_fft_bars(hard_power, 140 /*MAX range dBFS*/);
+		if(draw_fft_bars(&LcdPush) != E_OK)
+			syslog_0(LOG_ERROR, "## LCD FILL ERROR ##");
+#elif FFT_LCD_DIRTY
+		damage_fft_bars(&LcdFb);
+		lcdfb_flush(&LcdFb);
+		if((LcdFb.frames % 100) == 0)
+			syslog_3(LOG_NOTICE, "lcd bytes avg(%d) max(%d) rects(%d)", (int)(LcdFb.total_bytes / LcdFb.frames), LcdFb.max_bytes, LcdFb.rects);
+#elif FFT_LCD_ASYNC
+		if((gram = lcdpush_swap(&LcdPush, 0, 0, WIDTH, HEIGHT)) == NULL){
+			syslog_0(LOG_ERROR, "## LCD PUSH ERROR ##");
+			gram = lcdpush_back_buffer(&LcdPush);
+		}
+#else
+		lcd_drawPicture(hlcd, 0, 0, WIDTH, HEIGHT, gram);
+#endif
 		dly_tsk(1);
 	}
 
@@ -9,40 +9,40 @@
  *              Graduate School of Information Science, Nagoya Univ., JAPAN
  *  Copyright (C) 2020-2021 by fukuen
  * 
- *  嵭Ԥϡʲ(1)(4)ξ˸¤ꡤܥեȥ
- *  ܥեȥѤΤޤࡥʲƱˤѡʣ
- *  ѡۡʰʲѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
- *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
- *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
- *      ˴ޤޤƤ뤳ȡ
- *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
- *      ѤǤǺۤˤϡۤȼɥȡ
- *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
- *      ̵ݾڵǺܤ뤳ȡ
- *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
- *      ѤǤʤǺۤˤϡΤ줫ξ
- *      ȡ
- *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
- *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
- *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
- *        𤹤뤳ȡ
- *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
- *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
- *      ޤܥեȥΥ桼ޤϥɥ桼Τʤ
- *      ͳ˴Ťᤫ⡤嵭ԤTOPPERSץȤ
- *      դ뤳ȡ
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
  * 
- *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
- *  TOPPERSץȤϡܥեȥ˴ؤơλŪ
- *  ФŬޤơʤݾڤԤʤޤܥեȥ
- *  ѤˤľŪޤϴŪʤ»˴ؤƤ⡤
- *  Ǥʤ
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
  * 
  *  $Id: tone.c 2416 2020-12-03 08:06:20Z fukuen $
  */
 
 /* 
- *  I2Sץץ
+ *  I2Sサンプルプログラムの本体
  */
 
 #include <kernel.h>
@@ -67,7 +67,7 @@
 #define MIC_DAT_PIN   20
 
 /*
- *  ӥΥ顼Υ
+ *  サービスコールのエラーのログ出力
  */
 Inline void
 svc_perror(const char *file, int_t line, const char *expr, ER ercd)
@@ -103,7 +103,7 @@ uint32_t i2s_tx_buf[FRAME_LENGTH * 2];
 #define INPUT_PULLDOWN  0X1
 
 /*
- *  쥯ȥǥԥ
+ *  ダイレクトデジタルピン設定
 */
 void pinMode(uint8_t Pin, uint8_t dwMode){ 
 	int gpionum = gpio_get_gpiohno(Pin, false);
@@ -138,7 +138,7 @@ void pinMode(uint8_t Pin, uint8_t dwMode){
 }
 
 /*
- *  쥯ȥǥԥ
+ *  ダイレクトデジタルピン出力
  */
 void digitalWrite(uint8_t Pin, int dwVal)
 {
@@ -150,7 +150,7 @@ void digitalWrite(uint8_t Pin, int dwVal)
 }
 
 /*
- *  
+ *  正弦波生成
  */
 int generateSign(uint16_t frequency)
 {
@@ -166,7 +166,7 @@ int generateSign(uint16_t frequency)
 }
 
 /*
- *  ᥤ󥿥
+ *  メインタスク
  */
 void main_task(intptr_t exinf)
 {
@@ -179,11 +179,11 @@ void main_task(intptr_t exinf)
 	syslog(LOG_NOTICE, "Sample program starts (exinf = %d).", (int_t) exinf);
 
 	/*
-	 *  ꥢݡȤν
+	 *  シリアルポートの初期化
 	 *
-	 *  ƥƱꥢݡȤȤʤɡꥢ
-	 *  ݡȤץѤߤξˤϤE_OBJ顼ˤʤ뤬پ
-	 *  ʤ
+	 *  システムログタスクと同じシリアルポートを使う場合など，シリアル
+	 *  ポートがオープン済みの場合にはここでE_OBJエラーになるが，支障は
+	 *  ない．
 	 */
 	ercd = serial_opn_por(TASK_PORTID);
 	if (ercd < 0 && MERCD(ercd) != E_OBJ) {
@@ -0,0 +1,334 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  色ブロブ検出
+ *
+ *  しきい値判定は初期化時にRGB565の全65536値についてLAB/HSV変換を行い
+ *  ビットマスクとして保持するため、検出時は1画素1回の表引きとなる．
+ *  連結成分はライン毎のラン長と前ラインのランとの重なり(8近傍)から
+ *  union-findでラベル付けし、外接矩形と重心を求める．
+ */
+#include <kernel.h>
+#include <t_syslog.h>
+#include <string.h>
+#include <math.h>
+#include "image_blob.h"
+
+#define BLOB_NONE               0xFFFF
+#define BLOB_MASK(hb, p)        (((hb)->mask[(p) >> 5] >> ((p) & 31)) & 1)
+
+/*
+ *  sRGBの線形化
+ */
+static float
+blob_linear(float c)
+{
+	return (c <= 0.04045f) ? (c / 12.92f) : powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+/*
+ *  LAB変換の非線形関数
+ */
+static float
+blob_lab_f(float t)
+{
+	return (t > 0.008856f) ? cbrtf(t) : (7.787f * t + 16.0f / 116.0f);
+}
+
+/*
+ *  RGB565からLABへの変換(D65)
+ */
+static void
+blob_to_lab(const float *lr, const float *lg, const float *lb, uint16_t pix, int *c)
+{
+	float r = lr[pix >> 11], g = lg[(pix >> 5) & 0x3f], b = lb[pix & 0x1f];
+	float fx, fy, fz;
+
+	fx = blob_lab_f((0.4124f * r + 0.3576f * g + 0.1805f * b) / 0.95047f);
+	fy = blob_lab_f(0.2126f * r + 0.7152f * g + 0.0722f * b);
+	fz = blob_lab_f((0.0193f * r + 0.1192f * g + 0.9505f * b) / 1.08883f);
+	c[0] = (int)(116.0f * fy - 16.0f + 0.5f);
+	c[1] = (int)lroundf(500.0f * (fx - fy));
+	c[2] = (int)lroundf(200.0f * (fy - fz));
+}
+
+/*
+ *  RGB565からHSVへの変換
+ */
+static void
+blob_to_hsv(uint16_t pix, int *c)
+{
+	int r = RGB565_R8(pix), g = RGB565_G8(pix), b = RGB565_B8(pix);
+	int max = r, min = r, d, h;
+
+	if(g > max) max = g;
+	if(b > max) max = b;
+	if(g < min) min = g;
+	if(b < min) min = b;
+	d = max - min;
+	if(d == 0)
+		h = 0;
+	else if(max == r)
+		h = (60 * (g - b) / d + 360) % 360;
+	else if(max == g)
+		h = 60 * (b - r) / d + 120;
+	else
+		h = 60 * (r - g) / d + 240;
+	c[0] = h;
+	c[1] = (max == 0) ? 0 : (255 * d / max);
+	c[2] = max;
+}
+
+/*
+ *  ブロブ検出初期化
+ *  parameter1  hb: ブロブ検出ハンドラへのポインタ
+ *  return      ERコード
+ *  しきい値のビットマスクを作成する(数十ms)．
+ */
+ER
+blob_init(BLOB_Handle_t *hb)
+{
+	float    lr[32], lg[64], lb[32];
+	uint32_t pix;
+	int      c[3], i;
+	bool_t   in;
+
+	if(hb == NULL || hb->Init.Space > BLOB_SPACE_HSV)
+		return E_PAR;
+	if(hb->Init.SampleStep == 0)
+		hb->Init.SampleStep = 1;
+	if(hb->Init.SampleStep != 1 && hb->Init.SampleStep != 2 && hb->Init.SampleStep != 4)
+		return E_PAR;
+	for(i = 0 ; i < 64 ; i++){
+		if(i < 32){
+			lr[i] = blob_linear(i / 31.0f);
+			lb[i] = lr[i];
+		}
+		lg[i] = blob_linear(i / 63.0f);
+	}
+
+	memset(hb->mask, 0, sizeof(hb->mask));
+	for(pix = 0 ; pix < 65536 ; pix++){
+		if(hb->Init.Space == BLOB_SPACE_LAB)
+			blob_to_lab(lr, lg, lb, pix, c);
+		else
+			blob_to_hsv(pix, c);
+		in = true;
+		for(i = 0 ; i < 3 && in ; i++){
+			if(i == 0 && hb->Init.Space == BLOB_SPACE_HSV && hb->Init.Min[0] > hb->Init.Max[0])
+				in = (c[0] >= hb->Init.Min[0] || c[0] <= hb->Init.Max[0]);
+			else
+				in = (c[i] >= hb->Init.Min[i] && c[i] <= hb->Init.Max[i]);
+		}
+		if(in)
+			hb->mask[pix >> 5] |= 1u << (pix & 31);
+	}
+	hb->labels   = 0;
+	hb->overflow = 0;
+	hb->time     = 0;
+	return E_OK;
+}
+
+/*
+ *  ルートラベルの検索(経路半減)
+ */
+static uint16_t
+blob_root(BLOB_Handle_t *hb, uint16_t l)
+{
+	while(hb->label[l].parent != l){
+		hb->label[l].parent = hb->label[hb->label[l].parent].parent;
+		l = hb->label[l].parent;
+	}
+	return l;
+}
+
+/*
+ *  ラベル統計の統合
+ */
+static void
+blob_merge(BLOB_Label_t *d, const BLOB_Label_t *s)
+{
+	if(s->x0 < d->x0) d->x0 = s->x0;
+	if(s->y0 < d->y0) d->y0 = s->y0;
+	if(s->x1 > d->x1) d->x1 = s->x1;
+	if(s->y1 > d->y1) d->y1 = s->y1;
+	d->count  += s->count;
+	d->sum_x2 += s->sum_x2;
+	d->sum_y  += s->sum_y;
+}
+
+/*
+ *  ブロブ検出
+ *  parameter1  hb: ブロブ検出ハンドラへのポインタ
+ *  parameter2  src: RGB565画像
+ *  parameter3  width: 画像幅
+ *  parameter4  height: 画像高さ
+ *  parameter5  blobs: 検出結果の格納先
+ *  parameter6  max: 格納先の要素数
+ *  return      格納したブロブ数(画素数の降順)、負値はERコード
+ *  ラン/ラベルが不足して捨てたランがあればE_NOMEMを返す．
+ */
+ER_UINT
+blob_find(BLOB_Handle_t *hb, const uint16_t *src, uint16_t width, uint16_t height, BLOB_t *blobs, uint16_t max)
+{
+	BLOB_Run_t   *prev, *cur, *r;
+	BLOB_Label_t *lb;
+	const uint16_t *row;
+	uint32_t nprev = 0, ncur, p, q, n, step, pixels;
+	uint16_t x, x0, x1, y, l, m;
+	uint16_t nblobs = 0;
+	SYSUTM   stime, etime;
+
+	if(hb == NULL || src == NULL || blobs == NULL || width == 0 || height == 0)
+		return E_PAR;
+	get_utm(&stime);
+	step = hb->Init.SampleStep;
+	hb->labels   = 0;
+	hb->overflow = 0;
+	prev = hb->run[1];
+
+	for(y = 0 ; y < height ; y += step){
+		cur  = hb->run[(y / step) & 1];
+		ncur = 0;
+		p    = 0;
+		row  = src + (uint32_t)y * width;
+		for(x = 0 ; x < width ; ){
+			while(x < width && !BLOB_MASK(hb, row[x]))
+				x += step;
+			if(x >= width)
+				break;
+			x0 = x;
+			while(x < width && BLOB_MASK(hb, row[x]))
+				x += step;
+			x1 = x - step;
+			if(ncur >= BLOB_MAX_RUNS){
+				hb->overflow++;
+				continue;
+			}
+			r = &cur[ncur++];
+			r->x0 = x0;
+			r->x1 = x1;
+			r->label = BLOB_NONE;
+
+			/* 前ラインの重なるラン(8近傍)と連結 */
+			while(p < nprev && prev[p].x1 + step < x0)
+				p++;
+			for(q = p ; q < nprev && prev[q].x0 <= x1 + step ; q++){
+				if(prev[q].label == BLOB_NONE)
+					continue;
+				l = blob_root(hb, prev[q].label);
+				if(r->label == BLOB_NONE)
+					r->label = l;
+				else if(l != r->label){
+					m = (l < r->label) ? l : r->label;
+					hb->label[(l < r->label) ? r->label : l].parent = m;
+					r->label = m;
+				}
+			}
+			if(r->label == BLOB_NONE){
+				if(hb->labels >= BLOB_MAX_LABELS){
+					hb->overflow++;
+					continue;
+				}
+				l  = hb->labels++;
+				lb = &hb->label[l];
+				lb->parent = l;
+				lb->x0 = x0;
+				lb->x1 = x1;
+				lb->y0 = lb->y1 = y;
+				lb->count = lb->sum_x2 = lb->sum_y = 0;
+				r->label = l;
+			}
+
+			/* ランの統計を加算 */
+			lb = &hb->label[r->label];
+			n  = (x1 - x0) / step + 1;
+			if(x0 < lb->x0) lb->x0 = x0;
+			if(x1 > lb->x1) lb->x1 = x1;
+			if(y < lb->y0) lb->y0 = y;
+			if(y > lb->y1) lb->y1 = y;
+			lb->count  += n;
+			lb->sum_x2 += n * (x0 + x1);
+			lb->sum_y  += n * y;
+		}
+		prev  = cur;
+		nprev = ncur;
+	}
+
+	/*
+	 *  子ラベルを親に統合(親は常に小さい番号)
+	 */
+	for(l = hb->labels ; l-- > 0 ; ){
+		if(hb->label[l].parent != l)
+			blob_merge(&hb->label[blob_root(hb, l)], &hb->label[l]);
+	}
+
+	/*
+	 *  画素数の降順に格納
+	 */
+	for(l = 0 ; l < hb->labels ; l++){
+		lb = &hb->label[l];
+		if(lb->parent != l)
+			continue;
+		pixels = lb->count * step * step;
+		if(pixels < hb->Init.MinPixels)
+			continue;
+		for(m = nblobs ; m > 0 && blobs[m-1].pixels < pixels ; m--){
+			if(m < max)
+				blobs[m] = blobs[m-1];
+		}
+		if(m >= max)
+			continue;
+		blobs[m].x  = lb->x0;
+		blobs[m].y  = lb->y0;
+		blobs[m].w  = ((lb->x1 + step > width) ? width : (lb->x1 + step)) - lb->x0;
+		blobs[m].h  = ((lb->y1 + step > height) ? height : (lb->y1 + step)) - lb->y0;
+		blobs[m].cx = lb->sum_x2 / (2 * lb->count);
+		blobs[m].cy = lb->sum_y / lb->count;
+		blobs[m].pixels = pixels;
+		if(nblobs < max)
+			nblobs++;
+	}
+	get_utm(&etime);
+	hb->time = etime - stime;
+	return (hb->overflow != 0) ? E_NOMEM : nblobs;
+}
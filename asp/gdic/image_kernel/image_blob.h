@@ -0,0 +1,138 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  色ブロブ検出のヘッダファイル
+ */
+
+#ifndef _IMAGE_BLOB_H_
+#define _IMAGE_BLOB_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "image_kernel.h"
+
+/*
+ *  しきい値の色空間
+ */
+#define BLOB_SPACE_LAB          0		/* L:0-100, A,B:-128-127 */
+#define BLOB_SPACE_HSV          1		/* H:0-359(Min>Maxで0度をまたぐ), S,V:0-255 */
+
+/*
+ *  検出バッファのサイズ
+ */
+#define BLOB_MAX_RUNS           160		/* 1ラインの最大ラン数 */
+#define BLOB_MAX_LABELS         256		/* 最大ラベル数 */
+
+/*
+ *  ブロブ検出初期設定
+ */
+typedef struct {
+	uint8_t         Space;			/* しきい値の色空間 */
+	int16_t         Min[3];			/* 成分毎の下限 */
+	int16_t         Max[3];			/* 成分毎の上限 */
+	uint8_t         SampleStep;		/* 間引き間隔(1,2,4) */
+	uint32_t        MinPixels;		/* ブロブとする最小画素数(元画像換算) */
+} BLOB_Init_t;
+
+/*
+ *  検出結果
+ */
+typedef struct {
+	uint16_t        x;				/* 外接矩形 */
+	uint16_t        y;
+	uint16_t        w;
+	uint16_t        h;
+	uint16_t        cx;				/* 重心 */
+	uint16_t        cy;
+	uint32_t        pixels;			/* 画素数(元画像換算) */
+} BLOB_t;
+
+/*
+ *  ラン
+ */
+typedef struct {
+	uint16_t        x0;
+	uint16_t        x1;
+	uint16_t        label;
+} BLOB_Run_t;
+
+/*
+ *  ラベル統計
+ */
+typedef struct {
+	uint16_t        parent;			/* union-findの親ラベル */
+	uint16_t        x0, y0, x1, y1;	/* 外接矩形 */
+	uint32_t        count;			/* サンプル画素数 */
+	uint32_t        sum_x2;			/* X座標合計の2倍 */
+	uint32_t        sum_y;			/* Y座標合計 */
+} BLOB_Label_t;
+
+/*
+ *  ブロブ検出ハンドラ
+ */
+typedef struct {
+	BLOB_Init_t     Init;
+	uint32_t        mask[65536/32];	/* RGB565値毎のしきい値判定 */
+	BLOB_Run_t      run[2][BLOB_MAX_RUNS];
+	BLOB_Label_t    label[BLOB_MAX_LABELS];
+	uint16_t        labels;			/* 使用ラベル数 */
+	uint16_t        overflow;		/* ラン/ラベル不足で捨てたラン数 */
+	uint32_t        time;			/* 直近の処理時間(μs) */
+} BLOB_Handle_t;
+
+/*
+ *  blob_findの戻り値
+ *  0以上は格納したブロブ数で、0はしきい値内のブロブが無いことを示す．
+ *  1ラインのランがBLOB_MAX_RUNS、ラベルがBLOB_MAX_LABELSを超えた場合は
+ *  E_NOMEMを返す．この時blobsには捨てなかったランからの結果が入るが、
+ *  ブロブの分割や欠落があり得る．捨てたラン数はoverflowに残る．
+ */
+extern ER blob_init(BLOB_Handle_t *hb);
+extern ER_UINT blob_find(BLOB_Handle_t *hb, const uint16_t *src, uint16_t width, uint16_t height, BLOB_t *blobs, uint16_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _IMAGE_BLOB_H_ */
@@ -0,0 +1,533 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  画像処理カーネル
+ *
+ *  変換系は8バイト境界にあるデータを64ビット単位で読み書きし、
+ *  回転はIMAGE_TILE_SIZE四方のタイル単位で処理する．
+ */
+#include <kernel.h>
+#include <t_syslog.h>
+#include <string.h>
+#include "image_kernel.h"
+
+#define IS_ALIGNED8(p)          ((((uintptr_t)(p)) & 7) == 0)
+#define IS_ALIGNED4(p)          ((((uintptr_t)(p)) & 3) == 0)
+
+#define RGB565_EXPAND(p)        (((p) | ((uint32_t)(p) << 16)) & 0x07E0F81F)
+#define RGB565_PACK(v)          ((uint16_t)(((v) & 0xF81F) | (((v) >> 16) & 0x07E0)))
+
+static inline uint8_t
+clamp_u8(int32_t v)
+{
+	return (v < 0) ? 0 : ((v > 255) ? 255 : v);
+}
+
+/*
+ *  センサー画像からRGB565への変換
+ *  parameter1  dst: RGB565出力
+ *  parameter2  src: ov7740_snapshot後の_dataBuffer
+ *  parameter3  count: 画素数
+ *  snapshotで32ビット単位にバイト反転された並びを元に戻す．
+ */
+void
+image_sensor_to_rgb565(uint16_t *dst, const uint32_t *src, uint32_t count)
+{
+	uint32_t i = 0, v;
+
+	if(IS_ALIGNED8(dst) && IS_ALIGNED8(src)){
+		const uint64_t *s = (const uint64_t *)src;
+		uint64_t *d = (uint64_t *)dst;
+		uint64_t x;
+		for(; i + 4 <= count ; i += 4){
+			x = *s++;
+			x = ((x & 0x00FF00FF00FF00FFULL) << 8) | ((x >> 8) & 0x00FF00FF00FF00FFULL);
+			x = ((x & 0x0000FFFF0000FFFFULL) << 16) | ((x >> 16) & 0x0000FFFF0000FFFFULL);
+			*d++ = x;
+		}
+	}
+	for(; i < count ; i += 2){
+		v = src[i / 2];
+		v = (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+		dst[i] = v & 0xffff;
+		if(i + 1 < count)
+			dst[i + 1] = v >> 16;
+	}
+}
+
+/*
+ *  1画素の統計加算
+ */
+static inline void
+image_stats_add(IMAGE_Stats_t *st, uint16_t p)
+{
+	uint32_t r = RGB565_R8(p);
+	uint32_t g = RGB565_G8(p);
+	uint32_t b = RGB565_B8(p);
+	uint32_t y = RGB_TO_Y(r, g, b);
+
+	st->hist[y >> 2]++;
+	st->sum_r += r;
+	st->sum_g += g;
+	st->sum_b += b;
+	st->sum_y += y;
+	if(y >= IMAGE_OVER_LEVEL)
+		st->over++;
+	else if(y <= IMAGE_UNDER_LEVEL)
+		st->under++;
+	st->count++;
+}
+
+/*
+ *  統計の初期化
+ */
+void
+image_stats_clear(IMAGE_Stats_t *st)
+{
+	memset(st, 0, sizeof(IMAGE_Stats_t));
+}
+
+/*
+ *  センサー画像からRGB565への変換と統計の同時取得
+ *  parameter1  dst: RGB565出力
+ *  parameter2  src: ov7740_snapshot後の_dataBuffer
+ *  parameter3  count: 画素数
+ *  parameter4  st: 統計(呼び出し側でクリアしておく)
+ *  変換する64ビット(4画素)ごとに1画素を統計に加える．
+ */
+void
+image_sensor_to_rgb565_stats(uint16_t *dst, const uint32_t *src, uint32_t count, IMAGE_Stats_t *st)
+{
+	uint32_t i = 0, v;
+
+	if(IS_ALIGNED8(dst) && IS_ALIGNED8(src)){
+		const uint64_t *s = (const uint64_t *)src;
+		uint64_t *d = (uint64_t *)dst;
+		uint64_t x;
+		for(; i + 4 <= count ; i += 4){
+			x = *s++;
+			x = ((x & 0x00FF00FF00FF00FFULL) << 8) | ((x >> 8) & 0x00FF00FF00FF00FFULL);
+			x = ((x & 0x0000FFFF0000FFFFULL) << 16) | ((x >> 16) & 0x0000FFFF0000FFFFULL);
+			*d++ = x;
+			image_stats_add(st, x & 0xffff);
+		}
+	}
+	for(; i < count ; i += 2){
+		v = src[i / 2];
+		v = (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+		dst[i] = v & 0xffff;
+		if(i + 1 < count)
+			dst[i + 1] = v >> 16;
+		if((i & 3) == 0)
+			image_stats_add(st, v & 0xffff);
+	}
+}
+
+/*
+ *  RGB565画像の統計取得
+ *  parameter1  st: 統計(呼び出し側でクリアしておく)
+ *  parameter2  src: RGB565画像
+ *  parameter3  count: 画素数
+ *  parameter4  step: 間引き間隔(1以上)
+ */
+void
+image_rgb565_stats(IMAGE_Stats_t *st, const uint16_t *src, uint32_t count, uint8_t step)
+{
+	uint32_t i;
+
+	if(step == 0)
+		step = 1;
+	for(i = 0 ; i < count ; i += step)
+		image_stats_add(st, src[i]);
+}
+
+/*
+ *  RGB565からRGB888(R,G,Bの順に詰めたもの)への変換
+ */
+void
+image_rgb565_to_rgb888(uint8_t *dst, const uint16_t *src, uint32_t count)
+{
+	uint32_t i;
+	uint16_t p;
+
+	for(i = 0 ; i < count ; i++){
+		p = src[i];
+		*dst++ = RGB565_R8(p);
+		*dst++ = RGB565_G8(p);
+		*dst++ = RGB565_B8(p);
+	}
+}
+
+/*
+ *  RGB565からRGB888プレーン(KPU入力形式)への変換
+ */
+void
+image_rgb565_to_rgb888p(uint8_t *r, uint8_t *g, uint8_t *b, const uint16_t *src, uint32_t count)
+{
+	uint32_t i = 0, j;
+	uint16_t p;
+
+	if(IS_ALIGNED8(src) && IS_ALIGNED4(r) && IS_ALIGNED4(g) && IS_ALIGNED4(b)){
+		const uint64_t *s = (const uint64_t *)src;
+		uint64_t x;
+		uint32_t rr, gg, bb;
+		for(; i + 4 <= count ; i += 4){
+			x = *s++;
+			rr = gg = bb = 0;
+			for(j = 0 ; j < 4 ; j++, x >>= 16){
+				p = x & 0xffff;
+				rr |= RGB565_R8(p) << (j * 8);
+				gg |= RGB565_G8(p) << (j * 8);
+				bb |= RGB565_B8(p) << (j * 8);
+			}
+			*(uint32_t *)(r + i) = rr;
+			*(uint32_t *)(g + i) = gg;
+			*(uint32_t *)(b + i) = bb;
+		}
+	}
+	for(; i < count ; i++){
+		p = src[i];
+		r[i] = RGB565_R8(p);
+		g[i] = RGB565_G8(p);
+		b[i] = RGB565_B8(p);
+	}
+}
+
+/*
+ *  RGB888(R,G,Bの順に詰めたもの)からRGB565への変換
+ */
+void
+image_rgb888_to_rgb565(uint16_t *dst, const uint8_t *src, uint32_t count)
+{
+	uint32_t i;
+
+	for(i = 0 ; i < count ; i++, src += 3)
+		dst[i] = RGB888_TO_565(src[0], src[1], src[2]);
+}
+
+/*
+ *  RGB565から8ビットグレースケールへの変換
+ */
+void
+image_rgb565_to_gray(uint8_t *dst, const uint16_t *src, uint32_t count)
+{
+	uint32_t i = 0, j;
+	uint16_t p;
+
+	if(IS_ALIGNED8(src) && IS_ALIGNED4(dst)){
+		const uint64_t *s = (const uint64_t *)src;
+		uint64_t x;
+		uint32_t y;
+		for(; i + 4 <= count ; i += 4){
+			x = *s++;
+			y = 0;
+			for(j = 0 ; j < 4 ; j++, x >>= 16){
+				p = x & 0xffff;
+				y |= RGB_TO_Y(RGB565_R8(p), RGB565_G8(p), RGB565_B8(p)) << (j * 8);
+			}
+			*(uint32_t *)(dst + i) = y;
+		}
+	}
+	for(; i < count ; i++){
+		p = src[i];
+		dst[i] = RGB_TO_Y(RGB565_R8(p), RGB565_G8(p), RGB565_B8(p));
+	}
+}
+
+/*
+ *  8ビットグレースケールからRGB565への変換
+ */
+void
+image_gray_to_rgb565(uint16_t *dst, const uint8_t *src, uint32_t count)
+{
+	uint32_t i = 0, j;
+	uint8_t  y;
+
+	if(IS_ALIGNED4(src) && IS_ALIGNED8(dst)){
+		const uint32_t *s = (const uint32_t *)src;
+		uint64_t *d = (uint64_t *)dst;
+		uint64_t x;
+		uint32_t v;
+		for(; i + 4 <= count ; i += 4){
+			v = *s++;
+			x = 0;
+			for(j = 0 ; j < 4 ; j++, v >>= 8){
+				y = v & 0xff;
+				x |= (uint64_t)RGB888_TO_565(y, y, y) << (j * 16);
+			}
+			*d++ = x;
+		}
+	}
+	for(; i < count ; i++){
+		y = src[i];
+		dst[i] = RGB888_TO_565(y, y, y);
+	}
+}
+
+/*
+ *  RGB565からYUV422への変換
+ *  色差は水平2画素の平均とする
+ */
+void
+image_rgb565_to_yuv422(uint16_t *dst, const uint16_t *src, uint32_t count)
+{
+	uint32_t i;
+	int32_t r0, g0, b0, r1, g1, b1, u, v;
+
+	for(i = 0 ; i < count ; i += 2){
+		r0 = RGB565_R8(src[i]);
+		g0 = RGB565_G8(src[i]);
+		b0 = RGB565_B8(src[i]);
+		if(i + 1 < count){
+			r1 = RGB565_R8(src[i+1]);
+			g1 = RGB565_G8(src[i+1]);
+			b1 = RGB565_B8(src[i+1]);
+		}
+		else{
+			r1 = r0;
+			g1 = g0;
+			b1 = b0;
+		}
+		u = ((-43 * (r0 + r1) - 85 * (g0 + g1) + 128 * (b0 + b1) + 256) >> 9) + 128;
+		v = ((128 * (r0 + r1) - 107 * (g0 + g1) - 21 * (b0 + b1) + 256) >> 9) + 128;
+		dst[i] = RGB_TO_Y(r0, g0, b0) | (clamp_u8(u) << 8);
+		if(i + 1 < count)
+			dst[i+1] = RGB_TO_Y(r1, g1, b1) | (clamp_u8(v) << 8);
+	}
+}
+
+/*
+ *  YUV422からRGB565への変換
+ */
+void
+image_yuv422_to_rgb565(uint16_t *dst, const uint16_t *src, uint32_t count)
+{
+	uint32_t i, j;
+	int32_t y, u, v, ru, gu, bv;
+
+	for(i = 0 ; i < count ; i += 2){
+		u = (src[i] >> 8) - 128;
+		v = (i + 1 < count) ? (src[i+1] >> 8) - 128 : 0;
+		ru = (359 * v) >> 8;
+		gu = (88 * u + 183 * v) >> 8;
+		bv = (454 * u) >> 8;
+		for(j = i ; j < i + 2 && j < count ; j++){
+			y = src[j] & 0xff;
+			dst[j] = RGB888_TO_565(clamp_u8(y + ru), clamp_u8(y - gu), clamp_u8(y + bv));
+		}
+	}
+}
+
+/*
+ *  切り出し
+ *  parameter1  dst: 出力(w x h)
+ *  parameter2  src: 入力画像
+ *  parameter3  sw: 入力画像幅
+ *  parameter4  sh: 入力画像高さ
+ *  parameter5  x: 切り出し開始X
+ *  parameter6  y: 切り出し開始Y
+ *  parameter7  w: 切り出し幅
+ *  parameter8  h: 切り出し高さ
+ *  parameter9  bpp: 1画素のバイト数(1-4)
+ *  return      ERコード
+ */
+ER
+image_crop(void *dst, const void *src, uint16_t sw, uint16_t sh, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t bpp)
+{
+	const uint8_t *s;
+	uint8_t *d = (uint8_t *)dst;
+	uint32_t line;
+
+	if(dst == NULL || src == NULL || bpp == 0 || bpp > 4)
+		return E_PAR;
+	if(w == 0 || h == 0 || (x + w) > sw || (y + h) > sh)
+		return E_PAR;
+	line = (uint32_t)w * bpp;
+	s = (const uint8_t *)src + ((uint32_t)y * sw + x) * bpp;
+	for(; h > 0 ; h--){
+		memcpy(d, s, line);
+		d += line;
+		s += (uint32_t)sw * bpp;
+	}
+	return E_OK;
+}
+
+/*
+ *  最近傍法による拡大縮小(RGB565)
+ *  parameter1  dst: 出力画像
+ *  parameter2  dw: 出力幅
+ *  parameter3  dh: 出力高さ
+ *  parameter4  src: 入力画像
+ *  parameter5  sw: 入力幅
+ *  parameter6  sh: 入力高さ
+ *  return      ERコード
+ */
+ER
+image_resize_nearest(uint16_t *dst, uint16_t dw, uint16_t dh, const uint16_t *src, uint16_t sw, uint16_t sh)
+{
+	uint32_t xstep, ystep, fx, fy;
+	const uint16_t *s;
+	uint16_t x, y;
+
+	if(dst == NULL || src == NULL || dst == src || dw == 0 || dh == 0 || sw == 0 || sh == 0)
+		return E_PAR;
+	xstep = ((uint32_t)sw << 16) / dw;
+	ystep = ((uint32_t)sh << 16) / dh;
+	for(y = 0, fy = ystep / 2 ; y < dh ; y++, fy += ystep){
+		s = src + (fy >> 16) * sw;
+		for(x = 0, fx = xstep / 2 ; x < dw ; x++, fx += xstep)
+			*dst++ = s[fx >> 16];
+	}
+	return E_OK;
+}
+
+/*
+ *  双線形補間による拡大縮小(RGB565)
+ *  parameter1  dst: 出力画像
+ *  parameter2  dw: 出力幅
+ *  parameter3  dh: 出力高さ
+ *  parameter4  src: 入力画像
+ *  parameter5  sw: 入力幅
+ *  parameter6  sh: 入力高さ
+ *  return      ERコード
+ *  3成分を32ビットに展開し、5ビットの重みで一括補間する．
+ */
+ER
+image_resize_bilinear(uint16_t *dst, uint16_t dw, uint16_t dh, const uint16_t *src, uint16_t sw, uint16_t sh)
+{
+	uint32_t xstep, ystep, x0, x1, y0, y1, wx, wy;
+	uint32_t p00, p01, p10, p11, top, bot;
+	int32_t  fx, fy;
+	const uint16_t *s0, *s1;
+	uint16_t x, y;
+
+	if(dst == NULL || src == NULL || dst == src || dw == 0 || dh == 0 || sw == 0 || sh == 0)
+		return E_PAR;
+	xstep = ((uint32_t)sw << 16) / dw;
+	ystep = ((uint32_t)sh << 16) / dh;
+	for(y = 0 ; y < dh ; y++){
+		fy = (int32_t)(y * ystep + ystep / 2) - 0x8000;
+		if(fy < 0)
+			fy = 0;
+		y0 = fy >> 16;
+		y1 = (y0 + 1 < sh) ? y0 + 1 : y0;
+		wy = (fy >> 11) & 0x1f;
+		s0 = src + y0 * sw;
+		s1 = src + y1 * sw;
+		for(x = 0 ; x < dw ; x++){
+			fx = (int32_t)(x * xstep + xstep / 2) - 0x8000;
+			if(fx < 0)
+				fx = 0;
+			x0 = fx >> 16;
+			x1 = (x0 + 1 < sw) ? x0 + 1 : x0;
+			wx = (fx >> 11) & 0x1f;
+			p00 = RGB565_EXPAND(s0[x0]);
+			p01 = RGB565_EXPAND(s0[x1]);
+			p10 = RGB565_EXPAND(s1[x0]);
+			p11 = RGB565_EXPAND(s1[x1]);
+			top = ((p00 * (32 - wx) + p01 * wx) >> 5) & 0x07E0F81F;
+			bot = ((p10 * (32 - wx) + p11 * wx) >> 5) & 0x07E0F81F;
+			top = ((top * (32 - wy) + bot * wy) >> 5) & 0x07E0F81F;
+			*dst++ = RGB565_PACK(top);
+		}
+	}
+	return E_OK;
+}
+
+/*
+ *  回転・反転(RGB565)
+ *  parameter1  dst: 出力画像(IMAGE_DIR_SWAPXY指定時はh x w)
+ *  parameter2  src: 入力画像
+ *  parameter3  w: 入力幅
+ *  parameter4  h: 入力高さ
+ *  parameter5  dir: IMAGE_DIR_xxxの組み合わせ(LCD_Handler_tのdirと同じ値)
+ *  return      ERコード
+ *  反転を適用した後にXYを入れ替える．
+ */
+ER
+image_rotate(uint16_t *dst, const uint16_t *src, uint16_t w, uint16_t h, uint8_t dir)
+{
+	int32_t base = 0, stepx, stepy, idx;
+	uint16_t tx, ty, x, y, xe, ye;
+
+	if(dst == NULL || src == NULL || dst == src || w == 0 || h == 0)
+		return E_PAR;
+	dir &= IMAGE_DIR_MASK;
+	if((dir & IMAGE_DIR_SWAPXY) == 0){
+		stepx = 1;
+		stepy = w;
+		if(dir & IMAGE_DIR_MIRRORX){
+			base += w - 1;
+			stepx = -1;
+		}
+		if(dir & IMAGE_DIR_MIRRORY){
+			base += (int32_t)(h - 1) * w;
+			stepy = -(int32_t)w;
+		}
+	}
+	else{
+		stepx = h;
+		stepy = 1;
+		if(dir & IMAGE_DIR_MIRRORX){
+			base += (int32_t)(w - 1) * h;
+			stepx = -(int32_t)h;
+		}
+		if(dir & IMAGE_DIR_MIRRORY){
+			base += h - 1;
+			stepy = -1;
+		}
+	}
+
+	for(ty = 0 ; ty < h ; ty += IMAGE_TILE_SIZE){
+		ye = (ty + IMAGE_TILE_SIZE < h) ? ty + IMAGE_TILE_SIZE : h;
+		for(tx = 0 ; tx < w ; tx += IMAGE_TILE_SIZE){
+			xe = (tx + IMAGE_TILE_SIZE < w) ? tx + IMAGE_TILE_SIZE : w;
+			for(y = ty ; y < ye ; y++){
+				const uint16_t *s = src + (uint32_t)y * w;
+				idx = base + (int32_t)tx * stepx + (int32_t)y * stepy;
+				for(x = tx ; x < xe ; x++, idx += stepx)
+					dst[idx] = s[x];
+			}
+		}
+	}
+	return E_OK;
+}
@@ -0,0 +1,123 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  画像処理カーネルのヘッダファイル
+ *
+ *  特に記述のない限りRGB565画像はuint16_t配列(ネイティブ順)とする．
+ *  YUV422は1画素16ビットで下位8ビットがY、上位8ビットが偶数画素でU、
+ *  奇数画素でVとする．
+ */
+
+#ifndef _IMAGE_KERNEL_H_
+#define _IMAGE_KERNEL_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "kernel.h"
+
+/*
+ *  回転・反転指定(ST7789のMADCTLと同じビット配置)
+ */
+#define IMAGE_DIR_SWAPXY        0x20	/* MV: XY入れ替え */
+#define IMAGE_DIR_MIRRORX       0x40	/* MX: 左右反転 */
+#define IMAGE_DIR_MIRRORY       0x80	/* MY: 上下反転 */
+#define IMAGE_DIR_MASK          0xE0
+
+#define IMAGE_ROTATE_90         (IMAGE_DIR_SWAPXY | IMAGE_DIR_MIRRORY)	/* 時計回り */
+#define IMAGE_ROTATE_180        (IMAGE_DIR_MIRRORX | IMAGE_DIR_MIRRORY)
+#define IMAGE_ROTATE_270        (IMAGE_DIR_SWAPXY | IMAGE_DIR_MIRRORX)
+
+/*
+ *  回転処理のタイルサイズ
+ */
+#define IMAGE_TILE_SIZE         16
+
+/*
+ *  フレーム統計
+ */
+#define IMAGE_HIST_BINS         64		/* 輝度ヒストグラムの階級数(4階調単位) */
+#define IMAGE_OVER_LEVEL        248		/* 白飛びとみなす輝度 */
+#define IMAGE_UNDER_LEVEL       8		/* 黒つぶれとみなす輝度 */
+
+typedef struct {
+	uint32_t        count;			/* 集計画素数 */
+	uint32_t        hist[IMAGE_HIST_BINS];	/* 輝度ヒストグラム */
+	uint32_t        sum_r;			/* R合計(8ビット換算) */
+	uint32_t        sum_g;			/* G合計 */
+	uint32_t        sum_b;			/* B合計 */
+	uint32_t        sum_y;			/* 輝度合計 */
+	uint32_t        over;			/* 白飛び画素数 */
+	uint32_t        under;			/* 黒つぶれ画素数 */
+} IMAGE_Stats_t;
+
+/*
+ *  RGB565の成分取り出し(8ビットに拡張)
+ */
+#define RGB565_R8(p)            ((((p) >> 8) & 0xf8) | ((p) >> 13))
+#define RGB565_G8(p)            ((((p) >> 3) & 0xfc) | (((p) >> 9) & 0x03))
+#define RGB565_B8(p)            ((((p) << 3) & 0xf8) | (((p) >> 2) & 0x07))
+#define RGB888_TO_565(r, g, b)  ((((r) & 0xf8) << 8) | (((g) & 0xfc) << 3) | ((b) >> 3))
+#define RGB_TO_Y(r, g, b)       ((77 * (r) + 150 * (g) + 29 * (b) + 128) >> 8)
+
+extern void image_sensor_to_rgb565(uint16_t *dst, const uint32_t *src, uint32_t count);
+extern void image_sensor_to_rgb565_stats(uint16_t *dst, const uint32_t *src, uint32_t count, IMAGE_Stats_t *st);
+extern void image_stats_clear(IMAGE_Stats_t *st);
+extern void image_rgb565_stats(IMAGE_Stats_t *st, const uint16_t *src, uint32_t count, uint8_t step);
+extern void image_rgb565_to_rgb888(uint8_t *dst, const uint16_t *src, uint32_t count);
+extern void image_rgb565_to_rgb888p(uint8_t *r, uint8_t *g, uint8_t *b, const uint16_t *src, uint32_t count);
+extern void image_rgb888_to_rgb565(uint16_t *dst, const uint8_t *src, uint32_t count);
+extern void image_rgb565_to_gray(uint8_t *dst, const uint16_t *src, uint32_t count);
+extern void image_gray_to_rgb565(uint16_t *dst, const uint8_t *src, uint32_t count);
+extern void image_rgb565_to_yuv422(uint16_t *dst, const uint16_t *src, uint32_t count);
+extern void image_yuv422_to_rgb565(uint16_t *dst, const uint16_t *src, uint32_t count);
+extern ER image_crop(void *dst, const void *src, uint16_t sw, uint16_t sh, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t bpp);
+extern ER image_resize_nearest(uint16_t *dst, uint16_t dw, uint16_t dh, const uint16_t *src, uint16_t sw, uint16_t sh);
+extern ER image_resize_bilinear(uint16_t *dst, uint16_t dw, uint16_t dh, const uint16_t *src, uint16_t sw, uint16_t sh);
+extern ER image_rotate(uint16_t *dst, const uint16_t *src, uint16_t w, uint16_t h, uint8_t dir);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _IMAGE_KERNEL_H_ */
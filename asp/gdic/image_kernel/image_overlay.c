@@ -0,0 +1,328 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  オーバーレイ合成
+ *
+ *  センサー画像のRGB565変換を1ラインずつ行い、変換直後のラインに
+ *  そのラインにかかるレイヤーの画素を透過色を除いて書き込む．合成の
+ *  ためにフレーム全体を読み直す処理がなく、追加の処理量はレイヤーの
+ *  面積に比例する．レイヤーは配列の後ろのものほど手前に表示する．
+ */
+#include <kernel.h>
+#include <t_syslog.h>
+#include <string.h>
+#include "image_overlay.h"
+
+#define OVERLAY_FONT_FIRST      0x20
+#define OVERLAY_FONT_LAST       0x5A
+
+/*
+ *  5x7フォント(0x20-0x5A、列単位、LSBが上端)
+ */
+static const uint8_t overlay_font[][OVERLAY_FONT_WIDTH] = {
+	{0x00, 0x00, 0x00, 0x00, 0x00},	/* ' ' */
+	{0x00, 0x00, 0x5F, 0x00, 0x00},	/* '!' */
+	{0x00, 0x07, 0x00, 0x07, 0x00},	/* '"' */
+	{0x14, 0x7F, 0x14, 0x7F, 0x14},	/* '#' */
+	{0x24, 0x2A, 0x7F, 0x2A, 0x12},	/* '$' */
+	{0x23, 0x13, 0x08, 0x64, 0x62},	/* '%' */
+	{0x36, 0x49, 0x55, 0x22, 0x50},	/* '&' */
+	{0x00, 0x05, 0x03, 0x00, 0x00},	/* ''' */
+	{0x00, 0x1C, 0x22, 0x41, 0x00},	/* '(' */
+	{0x00, 0x41, 0x22, 0x1C, 0x00},	/* ')' */
+	{0x14, 0x08, 0x3E, 0x08, 0x14},	/* '*' */
+	{0x08, 0x08, 0x3E, 0x08, 0x08},	/* '+' */
+	{0x00, 0x50, 0x30, 0x00, 0x00},	/* ',' */
+	{0x08, 0x08, 0x08, 0x08, 0x08},	/* '-' */
+	{0x00, 0x60, 0x60, 0x00, 0x00},	/* '.' */
+	{0x20, 0x10, 0x08, 0x04, 0x02},	/* '/' */
+	{0x3E, 0x51, 0x49, 0x45, 0x3E},	/* '0' */
+	{0x00, 0x42, 0x7F, 0x40, 0x00},	/* '1' */
+	{0x42, 0x61, 0x51, 0x49, 0x46},	/* '2' */
+	{0x21, 0x41, 0x45, 0x4B, 0x31},	/* '3' */
+	{0x18, 0x14, 0x12, 0x7F, 0x10},	/* '4' */
+	{0x27, 0x45, 0x45, 0x45, 0x39},	/* '5' */
+	{0x3C, 0x4A, 0x49, 0x49, 0x30},	/* '6' */
+	{0x01, 0x71, 0x09, 0x05, 0x03},	/* '7' */
+	{0x36, 0x49, 0x49, 0x49, 0x36},	/* '8' */
+	{0x06, 0x49, 0x49, 0x29, 0x1E},	/* '9' */
+	{0x00, 0x36, 0x36, 0x00, 0x00},	/* ':' */
+	{0x00, 0x56, 0x36, 0x00, 0x00},	/* ';' */
+	{0x08, 0x14, 0x22, 0x41, 0x00},	/* '<' */
+	{0x14, 0x14, 0x14, 0x14, 0x14},	/* '=' */
+	{0x00, 0x41, 0x22, 0x14, 0x08},	/* '>' */
+	{0x02, 0x01, 0x51, 0x09, 0x06},	/* '?' */
+	{0x32, 0x49, 0x79, 0x41, 0x3E},	/* '@' */
+	{0x7E, 0x11, 0x11, 0x11, 0x7E},	/* 'A' */
+	{0x7F, 0x49, 0x49, 0x49, 0x36},	/* 'B' */
+	{0x3E, 0x41, 0x41, 0x41, 0x22},	/* 'C' */
+	{0x7F, 0x41, 0x41, 0x22, 0x1C},	/* 'D' */
+	{0x7F, 0x49, 0x49, 0x49, 0x41},	/* 'E' */
+	{0x7F, 0x09, 0x09, 0x09, 0x01},	/* 'F' */
+	{0x3E, 0x41, 0x49, 0x49, 0x7A},	/* 'G' */
+	{0x7F, 0x08, 0x08, 0x08, 0x7F},	/* 'H' */
+	{0x00, 0x41, 0x7F, 0x41, 0x00},	/* 'I' */
+	{0x20, 0x40, 0x41, 0x3F, 0x01},	/* 'J' */
+	{0x7F, 0x08, 0x14, 0x22, 0x41},	/* 'K' */
+	{0x7F, 0x40, 0x40, 0x40, 0x40},	/* 'L' */
+	{0x7F, 0x02, 0x0C, 0x02, 0x7F},	/* 'M' */
+	{0x7F, 0x04, 0x08, 0x10, 0x7F},	/* 'N' */
+	{0x3E, 0x41, 0x41, 0x41, 0x3E},	/* 'O' */
+	{0x7F, 0x09, 0x09, 0x09, 0x06},	/* 'P' */
+	{0x3E, 0x41, 0x51, 0x21, 0x5E},	/* 'Q' */
+	{0x7F, 0x09, 0x19, 0x29, 0x46},	/* 'R' */
+	{0x46, 0x49, 0x49, 0x49, 0x31},	/* 'S' */
+	{0x01, 0x01, 0x7F, 0x01, 0x01},	/* 'T' */
+	{0x3F, 0x40, 0x40, 0x40, 0x3F},	/* 'U' */
+	{0x1F, 0x20, 0x40, 0x20, 0x1F},	/* 'V' */
+	{0x3F, 0x40, 0x38, 0x40, 0x3F},	/* 'W' */
+	{0x63, 0x14, 0x08, 0x14, 0x63},	/* 'X' */
+	{0x07, 0x08, 0x70, 0x08, 0x07},	/* 'Y' */
+	{0x61, 0x51, 0x49, 0x45, 0x43},	/* 'Z' */
+};
+
+/*
+ *  レイヤー全体を透過色でクリア
+ *  parameter1  layer: レイヤーへのポインタ
+ */
+void
+overlay_clear(OVERLAY_Layer_t *layer)
+{
+	uint32_t i, count = (uint32_t)layer->width * layer->height;
+
+	for(i = 0 ; i < count ; i++)
+		layer->buf[i] = layer->key;
+}
+
+/*
+ *  レイヤーへの塗りつぶし矩形描画(レイヤー外はクリップする)
+ *  parameter1  layer: レイヤーへのポインタ
+ *  parameter2  x: レイヤー上のX座標
+ *  parameter3  y: レイヤー上のY座標
+ *  parameter4  width: 幅
+ *  parameter5  height: 高さ
+ *  parameter6  color: 描画色
+ */
+void
+overlay_fill(OVERLAY_Layer_t *layer, int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color)
+{
+	int32_t  x1 = x, y1 = y, x2 = x + width, y2 = y + height;
+	int32_t  i, j;
+	uint16_t *p;
+
+	if(x1 < 0)
+		x1 = 0;
+	if(y1 < 0)
+		y1 = 0;
+	if(x2 > layer->width)
+		x2 = layer->width;
+	if(y2 > layer->height)
+		y2 = layer->height;
+	for(j = y1 ; j < y2 ; j++){
+		p = &layer->buf[j * layer->width];
+		for(i = x1 ; i < x2 ; i++)
+			p[i] = color;
+	}
+}
+
+/*
+ *  レイヤーへの矩形枠描画
+ *  parameter1  layer: レイヤーへのポインタ
+ *  parameter2  x: レイヤー上のX座標
+ *  parameter3  y: レイヤー上のY座標
+ *  parameter4  width: 幅
+ *  parameter5  height: 高さ
+ *  parameter6  color: 描画色
+ */
+void
+overlay_box(OVERLAY_Layer_t *layer, int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color)
+{
+	if(width <= 0 || height <= 0)
+		return;
+	overlay_fill(layer, x, y, width, 1, color);
+	overlay_fill(layer, x, y + height - 1, width, 1, color);
+	overlay_fill(layer, x, y, 1, height, color);
+	overlay_fill(layer, x + width - 1, y, 1, height, color);
+}
+
+/*
+ *  レイヤーへの文字列描画
+ *  英小文字は大文字で描き、フォントにない文字は空白とする．
+ *  parameter1  layer: レイヤーへのポインタ
+ *  parameter2  x: 描画開始X座標
+ *  parameter3  y: 描画開始Y座標
+ *  parameter4  str: 文字列
+ *  parameter5  color: 描画色
+ *  parameter6  scale: 拡大率(1以上)
+ *  return      描画終了位置のX座標
+ */
+int16_t
+overlay_text(OVERLAY_Layer_t *layer, int16_t x, int16_t y, const char *str, uint16_t color, uint8_t scale)
+{
+	const uint8_t *glyph;
+	uint8_t c;
+	int     i, j;
+
+	if(scale == 0)
+		scale = 1;
+	for(; *str != 0 ; str++, x += OVERLAY_FONT_PITCH * scale){
+		c = (uint8_t)*str;
+		if(c >= 'a' && c <= 'z')
+			c -= 'a' - 'A';
+		if(c < OVERLAY_FONT_FIRST || c > OVERLAY_FONT_LAST)
+			c = ' ';
+		glyph = overlay_font[c - OVERLAY_FONT_FIRST];
+		for(i = 0 ; i < OVERLAY_FONT_WIDTH ; i++){
+			for(j = 0 ; j < OVERLAY_FONT_HEIGHT ; j++){
+				if(glyph[i] & (1 << j))
+					overlay_fill(layer, x + i * scale, y + j * scale, scale, scale, color);
+			}
+		}
+	}
+	return x;
+}
+
+/*
+ *  レイヤーへの数値描画
+ *  valueを10のfrac乗で割った値を小数点以下frac桁で描く
+ *  parameter1  layer: レイヤーへのポインタ
+ *  parameter2  x: 描画開始X座標
+ *  parameter3  y: 描画開始Y座標
+ *  parameter4  value: 数値
+ *  parameter5  frac: 小数点以下の桁数
+ *  parameter6  color: 描画色
+ *  parameter7  scale: 拡大率(1以上)
+ *  return      描画終了位置のX座標
+ */
+int16_t
+overlay_number(OVERLAY_Layer_t *layer, int16_t x, int16_t y, uint32_t value, uint8_t frac, uint16_t color, uint8_t scale)
+{
+	char buf[16];
+	int  i = sizeof(buf) - 1, n = 0;
+
+	if(frac > 8)
+		frac = 8;
+	buf[i] = 0;
+	do{
+		if(n == frac && frac != 0)
+			buf[--i] = '.';
+		buf[--i] = '0' + (value % 10);
+		value /= 10;
+		n++;
+	}while(value != 0 || n <= frac);
+	return overlay_text(layer, x, y, &buf[i], color, scale);
+}
+
+/*
+ *  1ラインへのレイヤー合成
+ */
+static void
+overlay_line(uint16_t *dst, uint16_t width, int32_t y, const OVERLAY_Layer_t *layer)
+{
+	const uint16_t *p;
+	int32_t  x1, x2, i;
+	uint16_t v, key = layer->key;
+
+	if(!layer->enable || y < layer->y || y >= layer->y + layer->height)
+		return;
+	x1 = layer->x < 0 ? 0 : layer->x;
+	x2 = layer->x + layer->width;
+	if(x2 > width)
+		x2 = width;
+	p = &layer->buf[(y - layer->y) * layer->width];
+	for(i = x1 ; i < x2 ; i++){
+		v = p[i - layer->x];
+		if(v != key)
+			dst[i] = v;
+	}
+}
+
+/*
+ *  オーバーレイ合成付きセンサー画像からRGB565への変換
+ *  1ラインずつimage_sensor_to_rgb565で変換し、キャッシュにある間に
+ *  そのラインにかかるレイヤーを合成する．
+ *  parameter1  dst: RGB565出力
+ *  parameter2  src: ov7740_snapshot後の_dataBuffer
+ *  parameter3  width: フレーム幅(偶数)
+ *  parameter4  height: フレーム高さ
+ *  parameter5  layers: レイヤーへのポインタの配列(後ろほど手前)
+ *  parameter6  num: レイヤー数
+ */
+void
+overlay_sensor_to_rgb565(uint16_t *dst, const uint32_t *src, uint16_t width, uint16_t height, OVERLAY_Layer_t *const *layers, uint8_t num)
+{
+	int32_t y;
+	uint8_t i;
+
+	for(y = 0 ; y < height ; y++, dst += width, src += width / 2){
+		image_sensor_to_rgb565(dst, src, width);
+		for(i = 0 ; i < num ; i++)
+			overlay_line(dst, width, y, layers[i]);
+	}
+}
+
+/*
+ *  変換済みRGB565フレームへのレイヤー合成
+ *  レイヤーのかかるラインのみ処理する．
+ *  parameter1  dst: RGB565フレーム
+ *  parameter2  width: フレーム幅
+ *  parameter3  height: フレーム高さ
+ *  parameter4  layers: レイヤーへのポインタの配列(後ろほど手前)
+ *  parameter5  num: レイヤー数
+ */
+void
+overlay_compose(uint16_t *dst, uint16_t width, uint16_t height, OVERLAY_Layer_t *const *layers, uint8_t num)
+{
+	int32_t y, y1, y2;
+	uint8_t i;
+
+	for(i = 0 ; i < num ; i++){
+		if(!layers[i]->enable)
+			continue;
+		y1 = layers[i]->y < 0 ? 0 : layers[i]->y;
+		y2 = layers[i]->y + layers[i]->height;
+		if(y2 > height)
+			y2 = height;
+		for(y = y1 ; y < y2 ; y++)
+			overlay_line(&dst[y * width], width, y, layers[i]);
+	}
+}
@@ -0,0 +1,89 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  オーバーレイ合成のヘッダファイル
+ */
+
+#ifndef _IMAGE_OVERLAY_H_
+#define _IMAGE_OVERLAY_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "image_kernel.h"
+
+/*
+ *  文字フォント(5x7、1文字の送り幅6画素)
+ */
+#define OVERLAY_FONT_WIDTH      5
+#define OVERLAY_FONT_HEIGHT     7
+#define OVERLAY_FONT_PITCH      6
+
+/*
+ *  オーバーレイレイヤー
+ *  画素値はフレームと同じ表現のRGB565で、透過色の画素はフレームを残す
+ */
+typedef struct {
+	int16_t         x;				/* フレーム上の表示X座標 */
+	int16_t         y;				/* フレーム上の表示Y座標 */
+	uint16_t        width;			/* レイヤー幅 */
+	uint16_t        height;			/* レイヤー高さ */
+	uint16_t        *buf;			/* 画素データ(width*height) */
+	uint16_t        key;			/* 透過色 */
+	uint8_t         enable;			/* trueで合成する */
+	uint8_t         dummy;
+} OVERLAY_Layer_t;
+
+extern void overlay_clear(OVERLAY_Layer_t *layer);
+extern void overlay_fill(OVERLAY_Layer_t *layer, int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color);
+extern void overlay_box(OVERLAY_Layer_t *layer, int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color);
+extern int16_t overlay_text(OVERLAY_Layer_t *layer, int16_t x, int16_t y, const char *str, uint16_t color, uint8_t scale);
+extern int16_t overlay_number(OVERLAY_Layer_t *layer, int16_t x, int16_t y, uint32_t value, uint8_t frac, uint16_t color, uint8_t scale);
+extern void overlay_compose(uint16_t *dst, uint16_t width, uint16_t height, OVERLAY_Layer_t *const *layers, uint8_t num);
+extern void overlay_sensor_to_rgb565(uint16_t *dst, const uint32_t *src, uint16_t width, uint16_t height, OVERLAY_Layer_t *const *layers, uint8_t num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _IMAGE_OVERLAY_H_ */
@@ -0,0 +1,86 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  ホスト試験用のK210デバイス定義スタブ
+ *
+ *  DVPとSYSCTLのアドレスはdvp_simがレジスタモデルとして受け付ける．
+ *  FPIOAとPLLの操作はhost_kernel.cで空の処理とする．
+ */
+
+#ifndef _TEST_DEVICE_H_
+#define _TEST_DEVICE_H_
+
+#include "kernel.h"
+#include "sil.h"
+
+#define SYSCTRL_CLOCK_FREQ_IN0              26000000
+
+#define TADR_DVP_BASE                       0x50430000
+#define TADR_SYSCTL_BASE                    0x50440000
+
+#define TOFF_CLK_SEL0                       0x0020
+#define TOFF_SYSCTL_CLK_EN_CENT             0x0028
+#define TOFF_SYSCTL_CLK_EN_PERI             0x002C
+#define TOFF_SYSCTL_PERI_RESET              0x0034
+#define TOFF_SYSCTL_CLK_TH0                 0x0038
+
+#define SYSCTL_CLK_SEL0_ACLK_SEL            0x00000001
+#define SYSCTL_CLK_SEL0_ACLK_SDIVISER       0x00000006
+#define SYSCTL_CLK_SEL0_APB1_CLK_SEL        0x000001C0
+#define SYSCTL_CLK_EN_CENT_APB1_CLK_EN      0x00000010
+#define SYSCTL_CLK_EN_PERI_DVP_CLK_EN       0x04000000
+#define SYSCTL_PERI_RESET_DVP_RESET         0x04000000
+#define SYSCTL_CLK_TH0_DVP_GCLK_THHD        0x0000F000
+
+#define FUNC_CMOS_XCLK                      128
+#define FUNC_CMOS_RST                       129
+#define FUNC_CMOS_PWDN                      130
+#define FUNC_CMOS_VSYNC                     131
+#define FUNC_CMOS_HREF                      132
+#define FUNC_CMOS_PCLK                      133
+
+#define INTNO_DVP                           (24+1)
+
+extern void fpioa_set_function(int pin, uint8_t func);
+extern uint32_t get_pll_clock(uint8_t no);
+
+#endif	/* _TEST_DEVICE_H_ */
@@ -0,0 +1,268 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  ホスト試験用カーネルスタブ
+ *
+ *  試験プログラムは単一タスクとして動作する．セマフォ待ちで資源が無い
+ *  場合はhost_set_idleで登録したアイドル処理を一度呼び出し(DVPシミュ
+ *  レーションではフレームの生成)、それでも資源が無ければタイムアウトと
+ *  する．遅延は実時間を進めず、get_timは経過時間に遅延分を加算して返す．
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include "kernel.h"
+#include "kernel_cfg.h"
+#include "t_syslog.h"
+#include "device.h"
+
+int host_log_level = LOG_NOTICE;
+
+static void (*host_idle)(void);
+static uint32_t host_semcnt[HOST_SEM_NUM];
+static SYSTIM   host_delay;
+
+/*
+ *  アイドル処理の登録
+ */
+void
+host_set_idle(void (*idle)(void))
+{
+	host_idle = idle;
+}
+
+/*
+ *  セマフォの初期化
+ */
+void
+host_reset_sem(void)
+{
+	memset(host_semcnt, 0, sizeof(host_semcnt));
+}
+
+ER
+get_tim(SYSTIM *p_systim)
+{
+	SYSUTM utm;
+
+	get_utm(&utm);
+	*p_systim = (SYSTIM)(utm / 1000) + host_delay;
+	return E_OK;
+}
+
+ER
+dly_tsk(RELTIM dlytim)
+{
+	host_delay += dlytim;
+	return E_OK;
+}
+
+ER
+slp_tsk(void)
+{
+	return tslp_tsk(TMO_FEVR);
+}
+
+/*
+ *  起床するタスクが無いため、永久待ちは試験の失敗として終了する
+ */
+ER
+tslp_tsk(TMO tmout)
+{
+	if(tmout == TMO_FEVR){
+		fprintf(stderr, "slp_tsk: no task to wake up\n");
+		exit(2);
+	}
+	host_delay += (SYSTIM)tmout;
+	return E_TMOUT;
+}
+
+ER
+wup_tsk(ID tskid)
+{
+	return E_OK;
+}
+
+ER
+get_tid(ID *p_tskid)
+{
+	*p_tskid = 1;
+	return E_OK;
+}
+
+ER
+sig_sem(ID semid)
+{
+	if(semid <= 0 || semid >= HOST_SEM_NUM)
+		return E_ID;
+	host_semcnt[semid]++;
+	return E_OK;
+}
+
+ER
+isig_sem(ID semid)
+{
+	return sig_sem(semid);
+}
+
+ER
+pol_sem(ID semid)
+{
+	if(semid <= 0 || semid >= HOST_SEM_NUM)
+		return E_ID;
+	if(host_semcnt[semid] == 0)
+		return E_TMOUT;
+	host_semcnt[semid]--;
+	return E_OK;
+}
+
+ER
+twai_sem(ID semid, TMO tmout)
+{
+	ER ercd = pol_sem(semid);
+
+	if(ercd != E_TMOUT || tmout == TMO_POL)
+		return ercd;
+	if(host_idle != NULL)
+		host_idle();
+	ercd = pol_sem(semid);
+	if(ercd == E_TMOUT && tmout > 0)
+		host_delay += (SYSTIM)tmout;
+	return ercd;
+}
+
+ER
+wai_sem(ID semid)
+{
+	return twai_sem(semid, TMO_FEVR);
+}
+
+ER
+dis_int(INTNO intno)
+{
+	return E_OK;
+}
+
+ER
+ena_int(INTNO intno)
+{
+	return E_OK;
+}
+
+/*
+ *  デバイス操作
+ */
+void
+fpioa_set_function(int pin, uint8_t func)
+{
+}
+
+uint32_t
+get_pll_clock(uint8_t no)
+{
+	return 806000000;
+}
+
+/*
+ *  システムログ
+ *  TOPPERSのsyslogと同じく%d,%u,%x,%X,%c,%sと幅/0詰め/-を解釈する．
+ */
+void
+host_syslog(unsigned int prio, const char *format, int n, ...)
+{
+	va_list  ap;
+	char     spec[16];
+	intptr_t arg;
+	int      i, len;
+
+	if((int)prio > host_log_level)
+		return;
+	va_start(ap, n);
+	for(i = 0 ; *format != '\0' ; format++){
+		if(*format != '%'){
+			putchar(*format);
+			continue;
+		}
+		len = 0;
+		spec[len++] = *format++;
+		while((*format == '-' || *format == '0' || (*format >= '1' && *format <= '9'))
+				&& len < (int)sizeof(spec) - 3)
+			spec[len++] = *format++;
+		if(*format == '\0')
+			break;
+		if(*format == '%'){
+			putchar('%');
+			continue;
+		}
+		arg = (i++ < n) ? va_arg(ap, intptr_t) : 0;
+		switch(*format){
+		case 'd':
+			spec[len++] = 'l';
+			spec[len++] = 'd';
+			spec[len] = '\0';
+			printf(spec, (long)arg);
+			break;
+		case 'u':
+		case 'x':
+		case 'X':
+			spec[len++] = 'l';
+			spec[len++] = *format;
+			spec[len] = '\0';
+			printf(spec, (unsigned long)arg);
+			break;
+		case 'c':
+			putchar((int)arg);
+			break;
+		case 's':
+			spec[len++] = 's';
+			spec[len] = '\0';
+			printf(spec, (const char *)arg);
+			break;
+		default:
+			putchar(*format);
+			break;
+		}
+	}
+	putchar('\n');
+	va_end(ap);
+}
@@ -0,0 +1,122 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  ホスト試験用カーネルスタブ
+ *
+ *  画像処理カーネルとDVPシミュレーションが使用する型とサービスコールを
+ *  定義する．サービスコールの実体はhost_kernel.cにある．
+ */
+
+#ifndef _TEST_KERNEL_H_
+#define _TEST_KERNEL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+typedef int             bool_t;
+typedef int             ER;
+typedef int             ER_UINT;
+typedef int             ID;
+typedef int             PRI;
+typedef int             TMO;
+typedef uint32_t        RELTIM;
+typedef uint32_t        SYSTIM;
+typedef uint64_t        SYSUTM;
+typedef uint32_t        INTNO;
+
+#define true            1
+#define false           0
+
+#define E_OK            0
+#define E_SYS           (-5)
+#define E_NOSPT         (-9)
+#define E_PAR           (-17)
+#define E_ID            (-18)
+#define E_NOMEM         (-33)
+#define E_OBJ           (-41)
+#define E_TMOUT         (-50)
+
+#define TSK_SELF        0
+#define TMO_POL         0
+#define TMO_FEVR        (-1)
+
+#define Inline          static inline
+
+/*
+ *  性能評価用時刻(μs)
+ */
+static inline ER
+get_utm(SYSUTM *p_sysutm)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	*p_sysutm = (SYSUTM)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	return E_OK;
+}
+
+/*
+ *  サービスコール(host_kernel.c)
+ *  ホストは単一タスクで動作し、待ちに入る代わりにアイドル処理を呼び出す．
+ */
+extern ER get_tim(SYSTIM *p_systim);
+extern ER dly_tsk(RELTIM dlytim);
+extern ER slp_tsk(void);
+extern ER tslp_tsk(TMO tmout);
+extern ER wup_tsk(ID tskid);
+extern ER get_tid(ID *p_tskid);
+extern ER sig_sem(ID semid);
+extern ER isig_sem(ID semid);
+extern ER wai_sem(ID semid);
+extern ER pol_sem(ID semid);
+extern ER twai_sem(ID semid, TMO tmout);
+extern ER dis_int(INTNO intno);
+extern ER ena_int(INTNO intno);
+
+/*
+ *  ホスト試験用の補助関数
+ */
+extern void host_set_idle(void (*idle)(void));
+extern void host_reset_sem(void);
+
+#endif	/* _TEST_KERNEL_H_ */
@@ -0,0 +1,100 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  ホスト試験用システムインタフェースレイヤスタブ
+ *
+ *  メモリアクセスはホストのメモリに対して行う．DVPのレジスタはdvp.cが
+ *  DVP_SIMULATIONでシミュレーションモデルに接続する．
+ */
+
+#ifndef _TEST_SIL_H_
+#define _TEST_SIL_H_
+
+#include <stdint.h>
+
+#define SIL_PRE_LOC         int sil_dummy_loc
+#define SIL_LOC_INT()       ((void)(sil_dummy_loc = 0))
+#define SIL_UNL_INT()       ((void)sil_dummy_loc)
+
+static inline uint8_t
+sil_reb_mem(const volatile uint8_t *mem)
+{
+	return *mem;
+}
+
+static inline void
+sil_wrb_mem(volatile uint8_t *mem, uint8_t data)
+{
+	*mem = data;
+}
+
+static inline uint16_t
+sil_reh_mem(const volatile uint16_t *mem)
+{
+	return *mem;
+}
+
+static inline void
+sil_wrh_mem(volatile uint16_t *mem, uint16_t data)
+{
+	*mem = data;
+}
+
+static inline uint32_t
+sil_rew_mem(const volatile uint32_t *mem)
+{
+	return *mem;
+}
+
+static inline void
+sil_wrw_mem(volatile uint32_t *mem, uint32_t data)
+{
+	*mem = data;
+}
+
+static inline void
+sil_dly_nse(unsigned long dlytim)
+{
+	(void)dlytim;
+}
+
+#endif	/* _TEST_SIL_H_ */
@@ -0,0 +1,79 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  ホスト試験用システムログスタブ
+ *
+ *  TOPPERSのsyslogと同じく引数はintptr_tとして渡し、host_kernel.cで
+ *  書式を解釈する．LOG_DEBUGはhost_log_levelで表示を抑止できる．
+ */
+
+#ifndef _TEST_T_SYSLOG_H_
+#define _TEST_T_SYSLOG_H_
+
+#include <stdint.h>
+
+#define LOG_EMERG       0
+#define LOG_ALERT       1
+#define LOG_CRIT        2
+#define LOG_ERROR       3
+#define LOG_WARNING     4
+#define LOG_NOTICE      5
+#define LOG_INFO        6
+#define LOG_DEBUG       7
+
+extern int host_log_level;
+extern void host_syslog(unsigned int prio, const char *format, int n, ...);
+
+#define syslog_0(prio, fmt) \
+	host_syslog((prio), (fmt), 0)
+#define syslog_1(prio, fmt, a1) \
+	host_syslog((prio), (fmt), 1, (intptr_t)(a1))
+#define syslog_2(prio, fmt, a1, a2) \
+	host_syslog((prio), (fmt), 2, (intptr_t)(a1), (intptr_t)(a2))
+#define syslog_3(prio, fmt, a1, a2, a3) \
+	host_syslog((prio), (fmt), 3, (intptr_t)(a1), (intptr_t)(a2), (intptr_t)(a3))
+#define syslog_4(prio, fmt, a1, a2, a3, a4) \
+	host_syslog((prio), (fmt), 4, (intptr_t)(a1), (intptr_t)(a2), (intptr_t)(a3), (intptr_t)(a4))
+#define syslog_5(prio, fmt, a1, a2, a3, a4, a5) \
+	host_syslog((prio), (fmt), 5, (intptr_t)(a1), (intptr_t)(a2), (intptr_t)(a3), (intptr_t)(a4), (intptr_t)(a5))
+
+#endif	/* _TEST_T_SYSLOG_H_ */
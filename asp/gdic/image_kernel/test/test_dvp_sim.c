@@ -0,0 +1,350 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  DVPシミュレーションのホスト試験
+ *
+ *  記録したフレーム(QVGA、RGB565リトルエンディアンの生データ)をdvp_sim
+ *  で再生し、dvp.c、cambus.c、センサードライバ(GC0328)を通して
+ *  ov7740_snapshotで取り込んだ画像が記録と一致することを確認する．
+ *  引数で記録を与えない場合は試験用の記録を作成して再生する．
+ *    test_dvp_sim [-b] [frames.raw]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel.h"
+#include "t_syslog.h"
+#include "device.h"
+#include "sipeed_ov7740.h"
+#include "image_kernel.h"
+
+#define WIDTH           320
+#define HEIGHT          240
+#define PIXELS          (WIDTH * HEIGHT)
+#define REC_FRAMES      4
+#define REC_FILE        "dvp_sim_frames.raw"
+#define BENCH_LOOP      100
+
+static OV7740_t     CameraHandle;
+static DVP_Handle_t DvpHandle;
+static uint16_t     record[REC_FRAMES][PIXELS];
+static uint16_t     frame[PIXELS];
+static uint32_t     num_record;
+static int          failed;
+
+#define CHECK(cond, name) check_result((cond), (name), __LINE__)
+
+static void
+check_result(int ok, const char *name, int line)
+{
+	if(!ok){
+		printf("NG  %s (line %d)\n", name, line);
+		failed++;
+	}
+	else
+		printf("OK  %s\n", name);
+}
+
+/*
+ *  セマフォ待ちの間に1フレームを生成する
+ */
+static void
+sim_idle(void)
+{
+	dvp_sim_frame();
+}
+
+/*
+ *  試験用の記録の作成
+ *  フレームごとに位置の異なるグラデーションと擬似乱数の点を描く．
+ */
+static int
+make_record(const char *path)
+{
+	FILE     *fp;
+	uint32_t seed = 12345, i, n, x, y;
+
+	for(n = 0 ; n < REC_FRAMES ; n++){
+		for(y = 0 ; y < HEIGHT ; y++){
+			for(x = 0 ; x < WIDTH ; x++){
+				seed = seed * 1103515245 + 12345;
+				i = y * WIDTH + x;
+				record[n][i] = RGB888_TO_565((x + n * 16) & 0xFF, y, (x ^ y) & 0xFF);
+				if((seed >> 24) < 8)
+					record[n][i] = (uint16_t)(seed >> 8);
+			}
+		}
+	}
+	num_record = REC_FRAMES;
+	if((fp = fopen(path, "wb")) == NULL)
+		return -1;
+	n = fwrite(record, sizeof(record[0]), REC_FRAMES, fp);
+	fclose(fp);
+	return (n == REC_FRAMES) ? 0 : -1;
+}
+
+/*
+ *  記録の読み込み(先頭のREC_FRAMESフレームまで)
+ */
+static int
+load_record(const char *path)
+{
+	FILE *fp;
+
+	if((fp = fopen(path, "rb")) == NULL)
+		return -1;
+	num_record = fread(record, sizeof(record[0]), REC_FRAMES, fp);
+	fclose(fp);
+	return (num_record > 0) ? 0 : -1;
+}
+
+/*
+ *  camera.cと同じ手順でDVPとセンサーを初期化する
+ */
+static ER
+camera_setup(OV7740_t *hcmr, DVP_Handle_t *hdvp)
+{
+	uint8_t *ai;
+	ER      ercd;
+
+	hcmr->hdvp      = hdvp;
+	hcmr->frameSize = FRAMESIZE_QVGA;
+	hcmr->pixFormat = PIXFORMAT_RGB565;
+	ov7740_getResolition(hcmr, FRAMESIZE_QVGA);
+	hcmr->_resetPoliraty = ACTIVE_HIGH;
+	hcmr->_pwdnPoliraty  = ACTIVE_HIGH;
+	hcmr->_slaveAddr     = 0x00;
+	hcmr->_dataBuffer    = (uint32_t *)malloc(hcmr->_width * hcmr->_height * 2);
+	hcmr->_aiBuffer      = (uint32_t *)malloc(hcmr->_width * hcmr->_height * 3);
+	if(hcmr->_dataBuffer == NULL || hcmr->_aiBuffer == NULL)
+		return E_NOMEM;
+	ai = (uint8_t *)hcmr->_aiBuffer;
+
+	hdvp->Init.Freq         = 24000000;
+	hdvp->Init.Width        = hcmr->_width;
+	hdvp->Init.Height       = hcmr->_height;
+	hdvp->Init.Format       = DVP_FORMAT_RGB;
+	hdvp->Init.BurstMode    = DVP_BURST_ENABLE;
+	hdvp->Init.AutoMode     = DVP_AUTOMODE_DISABLE;
+	hdvp->Init.GMMlen       = 4;
+	hdvp->Init.num_sccb_reg = 8;
+	hdvp->Init.CMosPClkPin  = 47;
+	hdvp->Init.CMosXClkPin  = 46;
+	hdvp->Init.CMosHRefPin  = 45;
+	hdvp->Init.CMosPwDnPin  = 44;
+	hdvp->Init.CMosVSyncPin = 43;
+	hdvp->Init.CMosRstPin   = 42;
+	hdvp->Init.SccbSClkPin  = 41;
+	hdvp->Init.SccbSdaPin   = 40;
+	hdvp->Init.IntNo        = INTNO_DVP;
+	hdvp->Init.RedAddr      = DVP_BUS_ADDR(ai);
+	hdvp->Init.GreenAddr    = DVP_BUS_ADDR(ai + hcmr->_width * hcmr->_height);
+	hdvp->Init.BlueAddr     = DVP_BUS_ADDR(ai + hcmr->_width * hcmr->_height * 2);
+	hdvp->Init.RGBAddr      = DVP_BUS_ADDR(hcmr->_dataBuffer);
+	if((ercd = dvp_init(hdvp)) != E_OK)
+		return ercd;
+
+	if((ercd = ov7740_sensor_gc_detect(hcmr)) != E_OK)
+		return ercd;
+	if((ercd = gc0328_reset(hcmr)) != E_OK)
+		return ercd;
+	if((ercd = gc0328_set_pixformat(hcmr)) != E_OK)
+		return ercd;
+	if((ercd = gc0328_set_framesize(hcmr)) != E_OK)
+		return ercd;
+	return ov7740_activate(hcmr, true);
+}
+
+/*
+ *  出力先アドレスの変換
+ */
+static void
+test_bus_addr(OV7740_t *hcmr)
+{
+	uint8_t  *ai = (uint8_t *)hcmr->_aiBuffer;
+	uint32_t a0, a1, a2;
+
+	a0 = DVP_BUS_ADDR(ai);
+	a1 = DVP_BUS_ADDR(ai + PIXELS);
+	a2 = DVP_BUS_ADDR(hcmr->_dataBuffer);
+	CHECK(a0 != 0 && a1 == a0 + PIXELS, "bus_addr offset in region");
+	CHECK(DVP_HOST_ADDR(a1) == ai + PIXELS, "host_addr round trip");
+	CHECK(DVP_HOST_ADDR(a2) == hcmr->_dataBuffer, "host_addr second region");
+	CHECK(DVP_BUS_ADDR(NULL) == 0 && DVP_HOST_ADDR(0) == NULL, "bus_addr null");
+}
+
+/*
+ *  記録の再生と取り込み
+ */
+static void
+test_replay(OV7740_t *hcmr)
+{
+	DVP_SimStat_t st0, st1;
+	const uint8_t *r = (const uint8_t *)hcmr->_aiBuffer;
+	const uint16_t *rec;
+	uint32_t i, n, mismatch = 0, snaps = num_record * 2;
+	ER       ercd = E_OK;
+
+	dvp_sim_get_stat(&st0);
+	for(n = 0 ; n < snaps && ercd == E_OK ; n++){
+		if((ercd = ov7740_snapshot(hcmr)) != E_OK)
+			break;
+		image_sensor_to_rgb565(frame, hcmr->_dataBuffer, PIXELS);
+		rec = record[n % num_record];
+		for(i = 0 ; i < PIXELS ; i++){
+			if(frame[i] != rec[i])
+				mismatch++;
+		}
+		for(i = 0 ; i < PIXELS ; i++){
+			if(SENSOR_PIXEL(hcmr->_dataBuffer, i) != rec[i])
+				mismatch++;
+		}
+	}
+	dvp_sim_get_stat(&st1);
+	CHECK(ercd == E_OK, "snapshot");
+	CHECK(mismatch == 0, "replayed frames match record");
+	CHECK(st1.captures - st0.captures == snaps, "one capture per snapshot");
+
+	/*
+	 *  AI出力のRプレーンは最後のフレームから作られる
+	 */
+	rec = record[(snaps - 1) % num_record];
+	for(i = 0, mismatch = 0 ; i < PIXELS ; i++){
+		if((r[i] & 0xF8) != ((rec[i] >> 8) & 0xF8))
+			mismatch++;
+	}
+	CHECK(mismatch == 0, "ai output red plane");
+}
+
+/*
+ *  シャドウレジスタ同期
+ *  センサーが応答しない場合は最初のエラーを返し、シャドウを無効化する．
+ */
+static void
+test_shadow_sync(OV7740_t *hcmr)
+{
+	uint32_t i, valid = 0;
+
+	CHECK(ov7740_shadow_sync(hcmr) == E_OK, "shadow sync");
+	dvp_sim_set_sensor(DVP_SIM_DEF_ADDR + 2, GC0328_ID);
+	CHECK(ov7740_shadow_sync(hcmr) == E_TMOUT, "shadow sync no response");
+	for(i = 0 ; i < sizeof(hcmr->_shadow.valid) ; i++)
+		valid |= ((const uint8_t *)hcmr->_shadow.valid)[i];
+	CHECK(valid == 0, "shadow invalidated");
+	dvp_sim_set_sensor(DVP_SIM_DEF_ADDR, GC0328_ID);
+}
+
+/*
+ *  取り込みから変換までの処理時間
+ */
+static void
+bench_replay(OV7740_t *hcmr)
+{
+	SYSUTM   start, end;
+	uint32_t n;
+
+	get_utm(&start);
+	for(n = 0 ; n < BENCH_LOOP ; n++){
+		if(ov7740_snapshot(hcmr) != E_OK)
+			break;
+		image_sensor_to_rgb565(frame, hcmr->_dataBuffer, PIXELS);
+	}
+	get_utm(&end);
+	if(n == 0)
+		return;
+	printf("bench snapshot+convert       %8.1f us/frame  %7.1f fps (host)\n",
+		(double)(end - start) / n, n * 1000000.0 / (double)(end - start));
+}
+
+int
+main(int argc, char *argv[])
+{
+	OV7740_t     *hcmr = &CameraHandle;
+	DVP_SimStat_t st;
+	const char   *path = NULL;
+	int          bench = 0, made = 0, i;
+
+	for(i = 1 ; i < argc ; i++){
+		if(strcmp(argv[i], "-b") == 0)
+			bench = 1;
+		else
+			path = argv[i];
+	}
+	if(path == NULL){
+		path = REC_FILE;
+		if(make_record(path) != 0){
+			printf("can't write %s\n", path);
+			return 1;
+		}
+		made = 1;
+	}
+	else if(load_record(path) != 0){
+		printf("can't read %s\n", path);
+		return 1;
+	}
+	if(dvp_sim_open_file(path) != E_OK){
+		printf("can't open %s\n", path);
+		return 1;
+	}
+	host_set_idle(sim_idle);
+
+	CHECK(camera_setup(hcmr, &DvpHandle) == E_OK, "camera setup");
+	CHECK(ov7740_id(hcmr) == GC0328_ID, "sensor id");
+	dvp_sim_get_stat(&st);
+	CHECK(st.sccb_writes > 0 && st.sccb_reads > 0, "sccb register access");
+	if(failed == 0){
+		test_bus_addr(hcmr);
+		test_replay(hcmr);
+		test_shadow_sync(hcmr);
+		if(bench)
+			bench_replay(hcmr);
+	}
+	ov7740_activate(hcmr, false);
+	dvp_sim_close_file();
+	if(made)
+		remove(path);
+	free(hcmr->_dataBuffer);
+	free(hcmr->_aiBuffer);
+
+	printf("%s\n", failed ? "FAILED" : "PASSED");
+	return failed ? 1 : 0;
+}
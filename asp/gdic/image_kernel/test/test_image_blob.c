@@ -0,0 +1,327 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  色ブロブ検出のホスト試験
+ *
+ *  合成画像で連結・しきい値・間引き・並び順を確認する．
+ *  引数に記録したフレーム(QVGA、RGB565リトルエンディアンの生データ)を
+ *  与えると、各フレームの検出結果と処理時間を表示する．
+ *    test_image_blob [-b] [frame.raw ...]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel.h"
+#include "image_blob.h"
+
+#define WIDTH           320
+#define HEIGHT          240
+#define PIXELS          (WIDTH * HEIGHT)
+#define BENCH_LOOP      50
+
+#define BG_COLOR        RGB888_TO_565(40, 40, 40)
+#define RED_COLOR       RGB888_TO_565(220, 20, 20)
+#define GREEN_COLOR     RGB888_TO_565(20, 200, 40)
+
+static BLOB_Handle_t BlobHandle;
+static uint16_t frame[PIXELS];
+static BLOB_t   blobs[8];
+static int      failed;
+
+#define CHECK(cond, name) check_result((cond), (name), __LINE__)
+
+static void
+check_result(int ok, const char *name, int line)
+{
+	if(!ok){
+		printf("NG  %s (line %d)\n", name, line);
+		failed++;
+	}
+	else
+		printf("OK  %s\n", name);
+}
+
+static void
+fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+	uint16_t i, j;
+
+	for(j = y ; j < y + h ; j++){
+		for(i = x ; i < x + w ; i++)
+			frame[j * WIDTH + i] = color;
+	}
+}
+
+static void
+clear_frame(void)
+{
+	fill_rect(0, 0, WIDTH, HEIGHT, BG_COLOR);
+}
+
+/*
+ *  赤のしきい値(LAB)
+ */
+static ER
+setup_lab_red(uint8_t step, uint32_t min_pixels)
+{
+	BlobHandle.Init.Space      = BLOB_SPACE_LAB;
+	BlobHandle.Init.Min[0]     = 20;
+	BlobHandle.Init.Max[0]     = 80;
+	BlobHandle.Init.Min[1]     = 40;
+	BlobHandle.Init.Max[1]     = 127;
+	BlobHandle.Init.Min[2]     = -10;
+	BlobHandle.Init.Max[2]     = 127;
+	BlobHandle.Init.SampleStep = step;
+	BlobHandle.Init.MinPixels  = min_pixels;
+	return blob_init(&BlobHandle);
+}
+
+static int
+blob_is(const BLOB_t *b, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t pixels)
+{
+	if(b->x == x && b->y == y && b->w == w && b->h == h && b->pixels == pixels)
+		return 1;
+	printf("    got x(%d) y(%d) w(%d) h(%d) cx(%d) cy(%d) pixels(%u)\n",
+		b->x, b->y, b->w, b->h, b->cx, b->cy, b->pixels);
+	return 0;
+}
+
+static void
+test_lab(void)
+{
+	ER_UINT n;
+
+	CHECK(setup_lab_red(1, 20) == E_OK, "blob_init lab");
+
+	clear_frame();
+	fill_rect(30, 50, 60, 50, RED_COLOR);
+	fill_rect(200, 20, 30, 30, GREEN_COLOR);
+	n = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 8);
+	CHECK(n == 1 && blob_is(&blobs[0], 30, 50, 60, 50, 3000)
+			&& blobs[0].cx == 59 && blobs[0].cy == 74, "rectangle");
+
+	/* U字は下端で連結され1つになる */
+	clear_frame();
+	fill_rect(150, 150, 10, 50, RED_COLOR);
+	fill_rect(200, 150, 10, 50, RED_COLOR);
+	fill_rect(150, 195, 60, 5, RED_COLOR);
+	n = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 8);
+	CHECK(n == 1 && blob_is(&blobs[0], 150, 150, 60, 50, 500 + 500 + 200), "u-shape merge");
+
+	/* 斜めに接する画素は8近傍で連結する */
+	clear_frame();
+	fill_rect(10, 10, 10, 10, RED_COLOR);
+	fill_rect(20, 20, 10, 10, RED_COLOR);
+	n = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 8);
+	CHECK(n == 1 && blob_is(&blobs[0], 10, 10, 20, 20, 200), "8-neighbour");
+
+	/* 画素数の降順、格納数の制限、最小画素数 */
+	clear_frame();
+	fill_rect(10, 10, 10, 10, RED_COLOR);
+	fill_rect(100, 100, 40, 40, RED_COLOR);
+	fill_rect(200, 10, 20, 20, RED_COLOR);
+	fill_rect(300, 200, 4, 4, RED_COLOR);
+	n = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 8);
+	CHECK(n == 3 && blobs[0].pixels == 1600 && blobs[1].pixels == 400 && blobs[2].pixels == 100, "order/min pixels");
+	n = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 1);
+	CHECK(n == 1 && blob_is(&blobs[0], 100, 100, 40, 40, 1600), "max blobs");
+
+	/* 画像端に接するブロブ */
+	clear_frame();
+	fill_rect(WIDTH - 16, HEIGHT - 8, 16, 8, RED_COLOR);
+	n = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 8);
+	CHECK(n == 1 && blob_is(&blobs[0], WIDTH - 16, HEIGHT - 8, 16, 8, 128), "frame edge");
+
+	CHECK(blob_find(&BlobHandle, NULL, WIDTH, HEIGHT, blobs, 8) == E_PAR, "null frame");
+}
+
+static void
+test_step(void)
+{
+	ER_UINT n;
+
+	CHECK(setup_lab_red(2, 20) == E_OK, "blob_init step 2");
+	clear_frame();
+	fill_rect(30, 50, 60, 50, RED_COLOR);
+	n = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 8);
+	CHECK(n == 1 && blob_is(&blobs[0], 30, 50, 60, 50, 3000), "step 2 rectangle");
+
+	CHECK(setup_lab_red(4, 20) == E_OK, "blob_init step 4");
+	n = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 8);
+	CHECK(n == 1 && blob_is(&blobs[0], 32, 52, 60, 48, 3000 - 120), "step 4 rectangle");
+}
+
+static void
+test_hsv(void)
+{
+	ER_UINT n;
+
+	/* 色相が0度をまたぐ範囲 */
+	BlobHandle.Init.Space      = BLOB_SPACE_HSV;
+	BlobHandle.Init.Min[0]     = 350;
+	BlobHandle.Init.Max[0]     = 10;
+	BlobHandle.Init.Min[1]     = 100;
+	BlobHandle.Init.Max[1]     = 255;
+	BlobHandle.Init.Min[2]     = 100;
+	BlobHandle.Init.Max[2]     = 255;
+	BlobHandle.Init.SampleStep = 1;
+	BlobHandle.Init.MinPixels  = 20;
+	CHECK(blob_init(&BlobHandle) == E_OK, "blob_init hsv");
+	clear_frame();
+	fill_rect(30, 50, 60, 50, RED_COLOR);
+	fill_rect(100, 50, 20, 20, RGB888_TO_565(220, 20, 60));	/* 色相350度付近 */
+	fill_rect(200, 20, 30, 30, GREEN_COLOR);
+	n = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 8);
+	CHECK(n == 2 && blobs[0].pixels == 3000 && blobs[1].pixels == 400, "hsv hue wrap");
+}
+
+/*
+ *  ラベル不足
+ *  孤立した点をBLOB_MAX_LABELSより多く置くとブロブ無しと区別してE_NOMEMを返す
+ */
+static void
+test_overflow(void)
+{
+	uint16_t x, y;
+	ER_UINT  n;
+
+	setup_lab_red(1, 1);
+	clear_frame();
+	for(y = 0 ; y < HEIGHT ; y += 4){
+		for(x = 0 ; x < WIDTH ; x += 4)
+			frame[y * WIDTH + x] = RED_COLOR;
+	}
+	n = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 8);
+	CHECK(n == E_NOMEM && BlobHandle.overflow > 0, "label overflow");
+	clear_frame();
+	n = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 8);
+	CHECK(n == 0 && BlobHandle.overflow == 0, "no blobs");
+}
+
+/*
+ *  処理時間の測定
+ */
+static void
+bench_frame(const char *name)
+{
+	uint32_t n, total = 0, worst = 0;
+	ER_UINT  nblobs = 0;
+
+	for(n = 0 ; n < BENCH_LOOP ; n++){
+		nblobs = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 8);
+		total += BlobHandle.time;
+		if(BlobHandle.time > worst)
+			worst = BlobHandle.time;
+	}
+	printf("    %-24s blobs(%d) labels(%d) overflow(%d) avg %u us max %u us\n",
+		name, (int)nblobs, BlobHandle.labels, BlobHandle.overflow, total / BENCH_LOOP, worst);
+}
+
+static void
+bench(void)
+{
+	uint32_t i;
+	uint8_t step;
+
+	printf("benchmark %dx%d, %d loops\n", WIDTH, HEIGHT, BENCH_LOOP);
+	for(step = 1 ; step <= 4 ; step *= 2){
+		setup_lab_red(step, 20);
+		printf("  step %d\n", step);
+		clear_frame();
+		fill_rect(30, 50, 60, 50, RED_COLOR);
+		bench_frame("single blob");
+		/* 最悪ケースに近い細かい市松模様 */
+		for(i = 0 ; i < PIXELS ; i++)
+			frame[i] = (((i % WIDTH) / 4 + (i / WIDTH) / 4) & 1) ? RED_COLOR : BG_COLOR;
+		bench_frame("4x4 checker");
+		for(i = 0 ; i < PIXELS ; i++)
+			frame[i] = rand() & 0xffff;
+		bench_frame("random noise");
+	}
+}
+
+/*
+ *  記録フレームの検出
+ */
+static void
+run_recorded(const char *path)
+{
+	FILE *fp;
+	ER_UINT n, i;
+
+	if((fp = fopen(path, "rb")) == NULL || fread(frame, 2, PIXELS, fp) != PIXELS){
+		printf("NG  %s: cannot read %dx%d RGB565 frame\n", path, WIDTH, HEIGHT);
+		failed++;
+		if(fp != NULL)
+			fclose(fp);
+		return;
+	}
+	fclose(fp);
+	n = blob_find(&BlobHandle, frame, WIDTH, HEIGHT, blobs, 8);
+	printf("%s: blobs(%d) %u us\n", path, (int)n, BlobHandle.time);
+	for(i = 0 ; i < n ; i++)
+		printf("    x(%d) y(%d) w(%d) h(%d) cx(%d) cy(%d) pixels(%u)\n", blobs[i].x, blobs[i].y,
+			blobs[i].w, blobs[i].h, blobs[i].cx, blobs[i].cy, blobs[i].pixels);
+}
+
+int
+main(int argc, char *argv[])
+{
+	int i = 1;
+
+	srand(1);
+	test_lab();
+	test_step();
+	test_hsv();
+	test_overflow();
+	if(i < argc && strcmp(argv[i], "-b") == 0){
+		bench();
+		i++;
+	}
+	if(i < argc){
+		setup_lab_red(2, 20);
+		for(; i < argc ; i++)
+			run_recorded(argv[i]);
+	}
+	printf("%s\n", failed ? "FAILED" : "PASSED");
+	return failed ? 1 : 0;
+}
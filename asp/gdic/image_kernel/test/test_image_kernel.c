@@ -0,0 +1,413 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  画像処理カーネルのホスト試験
+ *
+ *  各カーネルを1画素ずつ処理する参照実装と比較し、QVGA1フレームあたりの
+ *  処理時間を参照実装と並べて表示する．
+ *  64ビットアクセスの経路と端数処理の経路を通すため、整列した配列と
+ *  1画素ずらした配列、4で割り切れない画素数で確認する．
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel.h"
+#include "image_kernel.h"
+
+#define WIDTH           320
+#define HEIGHT          240
+#define PIXELS          (WIDTH * HEIGHT)
+#define BENCH_LOOP      50
+
+static uint64_t src_buf[PIXELS / 4 + 1];
+static uint64_t raw_buf[PIXELS / 4 + 1];
+static uint64_t dst_buf[PIXELS / 4 + 1];
+static uint64_t ref_buf[PIXELS / 4 + 1];
+static uint64_t tmp_buf[PIXELS / 4 + 1];
+static uint8_t  rgb888[PIXELS * 3];
+static uint8_t  plane[3][PIXELS + 8];
+static uint8_t  plane_ref[3][PIXELS + 8];
+
+static int      failed;
+
+#define CHECK(cond, name) check_result((cond), (name), __LINE__)
+
+static void
+check_result(int ok, const char *name, int line)
+{
+	if(!ok){
+		printf("NG  %s (line %d)\n", name, line);
+		failed++;
+	}
+	else
+		printf("OK  %s\n", name);
+}
+
+static uint32_t
+elapsed(SYSUTM start)
+{
+	SYSUTM now;
+
+	get_utm(&now);
+	return (uint32_t)(now - start);
+}
+
+/*
+ *  乱数画像とsnapshot後の並び(32ビット単位のバイト反転)を作る
+ */
+static void
+make_image(uint16_t *img, uint32_t *raw, uint32_t count)
+{
+	const uint32_t *w = (const uint32_t *)img;
+	uint32_t i;
+
+	for(i = 0 ; i < count ; i++)
+		img[i] = rand() & 0xffff;
+	for(i = 0 ; i < (count + 1) / 2 ; i++)
+		raw[i] = __builtin_bswap32(w[i]);
+}
+
+/*
+ *  参照実装
+ */
+static void
+ref_sensor_to_rgb565(uint16_t *dst, const uint32_t *src, uint32_t count)
+{
+	const uint8_t *s = (const uint8_t *)src;
+	uint32_t i;
+
+	for(i = 0 ; i < count ; i++){
+		uint32_t o = (i / 2) * 4 + ((i & 1) ? 0 : 2);
+		dst[i] = (s[o + 1] << 8) | s[o];
+		dst[i] = (dst[i] >> 8) | (dst[i] << 8);
+	}
+}
+
+static uint8_t
+ref_gray(uint16_t p)
+{
+	return RGB_TO_Y(RGB565_R8(p), RGB565_G8(p), RGB565_B8(p));
+}
+
+static void
+ref_rotate(uint16_t *dst, const uint16_t *src, uint16_t w, uint16_t h, uint8_t dir)
+{
+	uint16_t x, y, sx, sy;
+
+	for(y = 0 ; y < h ; y++){
+		for(x = 0 ; x < w ; x++){
+			sx = (dir & IMAGE_DIR_MIRRORX) ? w - 1 - x : x;
+			sy = (dir & IMAGE_DIR_MIRRORY) ? h - 1 - y : y;
+			if(dir & IMAGE_DIR_SWAPXY)
+				dst[sx * h + sy] = src[y * w + x];
+			else
+				dst[sy * w + sx] = src[y * w + x];
+		}
+	}
+}
+
+static void
+ref_resize_nearest(uint16_t *dst, uint16_t dw, uint16_t dh, const uint16_t *src, uint16_t sw, uint16_t sh)
+{
+	uint16_t x, y;
+
+	for(y = 0 ; y < dh ; y++){
+		for(x = 0 ; x < dw ; x++)
+			*dst++ = src[((2 * y + 1) * sh / (2 * dh)) * sw + (2 * x + 1) * sw / (2 * dw)];
+	}
+}
+
+/*
+ *  成分毎に補間する双線形補間(標本位置はimage_resize_bilinearと同じ16.16固定小数点)
+ */
+static void
+ref_resize_bilinear(uint16_t *dst, uint16_t dw, uint16_t dh, const uint16_t *src, uint16_t sw, uint16_t sh)
+{
+	static const uint8_t shift[3] = {11, 5, 0};
+	static const uint8_t mask[3] = {0x1f, 0x3f, 0x1f};
+	uint32_t xstep = ((uint32_t)sw << 16) / dw, ystep = ((uint32_t)sh << 16) / dh;
+	uint32_t x, y, c, x0, x1, y0, y1, p;
+	int32_t fx, fy, wx, wy, top, bot;
+
+	for(y = 0 ; y < dh ; y++){
+		fy = (int32_t)(y * ystep + ystep / 2) - 0x8000;
+		if(fy < 0)
+			fy = 0;
+		y0 = fy >> 16;
+		y1 = (y0 + 1 < sh) ? y0 + 1 : y0;
+		wy = (fy >> 11) & 0x1f;
+		for(x = 0 ; x < dw ; x++){
+			fx = (int32_t)(x * xstep + xstep / 2) - 0x8000;
+			if(fx < 0)
+				fx = 0;
+			x0 = fx >> 16;
+			x1 = (x0 + 1 < sw) ? x0 + 1 : x0;
+			wx = (fx >> 11) & 0x1f;
+			for(c = 0, p = 0 ; c < 3 ; c++){
+				top = ((src[y0 * sw + x0] >> shift[c]) & mask[c]) * (32 - wx) + ((src[y0 * sw + x1] >> shift[c]) & mask[c]) * wx;
+				bot = ((src[y1 * sw + x0] >> shift[c]) & mask[c]) * (32 - wx) + ((src[y1 * sw + x1] >> shift[c]) & mask[c]) * wx;
+				p |= ((top * (32 - wy) + bot * wy) >> 10) << shift[c];
+			}
+			*dst++ = p;
+		}
+	}
+}
+
+/*
+ *  (sx,sy)の近傍1画素以内にpと同じ画素があるか
+ */
+static int
+near_pixel(uint16_t p, const uint16_t *img, uint32_t w, uint32_t h, uint32_t sx, uint32_t sy)
+{
+	int32_t dx, dy, x, y;
+
+	for(dy = -1 ; dy <= 1 ; dy++){
+		for(dx = -1 ; dx <= 1 ; dx++){
+			x = (int32_t)sx + dx;
+			y = (int32_t)sy + dy;
+			if(x >= 0 && y >= 0 && x < (int32_t)w && y < (int32_t)h && img[y * w + x] == p)
+				return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ *  変換の試験
+ */
+static void
+test_convert(void)
+{
+	uint16_t *img = (uint16_t *)src_buf;
+	uint16_t *dst = (uint16_t *)dst_buf;
+	uint16_t *ref = (uint16_t *)ref_buf;
+	uint16_t *tmp = (uint16_t *)tmp_buf;
+	IMAGE_Stats_t st, st_ref;
+	uint32_t i, count;
+	int ok, diff, maxdiff;
+
+	make_image(img, (uint32_t *)raw_buf, PIXELS);
+	image_sensor_to_rgb565(dst, (uint32_t *)raw_buf, PIXELS);
+	CHECK(memcmp(dst, img, PIXELS * 2) == 0, "sensor_to_rgb565");
+	ref_sensor_to_rgb565(ref, (uint32_t *)raw_buf, PIXELS);
+	CHECK(memcmp(ref, img, PIXELS * 2) == 0, "sensor_to_rgb565 reference");
+	count = PIXELS - 3;
+	memset(dst, 0, PIXELS * 2);
+	image_sensor_to_rgb565(dst + 1, (uint32_t *)raw_buf, count);
+	CHECK(memcmp(dst + 1, img, count * 2) == 0 && dst[count + 1] == 0, "sensor_to_rgb565 unaligned/odd");
+
+	image_stats_clear(&st);
+	image_sensor_to_rgb565_stats(dst, (uint32_t *)raw_buf, PIXELS, &st);
+	image_stats_clear(&st_ref);
+	image_rgb565_stats(&st_ref, img, PIXELS, 4);
+	CHECK(memcmp(dst, img, PIXELS * 2) == 0 && memcmp(&st, &st_ref, sizeof(st)) == 0, "sensor_to_rgb565_stats");
+
+	image_rgb565_to_rgb888(rgb888, img, PIXELS);
+	image_rgb888_to_rgb565(dst, rgb888, PIXELS);
+	CHECK(memcmp(dst, img, PIXELS * 2) == 0, "rgb565 <-> rgb888");
+
+	for(i = 0 ; i < PIXELS ; i++){
+		plane_ref[0][i] = RGB565_R8(img[i]);
+		plane_ref[1][i] = RGB565_G8(img[i]);
+		plane_ref[2][i] = RGB565_B8(img[i]);
+	}
+	image_rgb565_to_rgb888p(plane[0], plane[1], plane[2], img, PIXELS);
+	ok = memcmp(plane[0], plane_ref[0], PIXELS) == 0 && memcmp(plane[1], plane_ref[1], PIXELS) == 0
+			&& memcmp(plane[2], plane_ref[2], PIXELS) == 0;
+	image_rgb565_to_rgb888p(plane[0] + 1, plane[1] + 1, plane[2] + 1, img, count);
+	ok = ok && memcmp(plane[0] + 1, plane_ref[0], count) == 0 && memcmp(plane[2] + 1, plane_ref[2], count) == 0;
+	CHECK(ok, "rgb565_to_rgb888p");
+
+	image_rgb565_to_gray(plane[0], img, PIXELS);
+	image_rgb565_to_gray(plane[1] + 1, img + 1, count);
+	for(i = 0, ok = 1 ; i < PIXELS ; i++){
+		if(plane[0][i] != ref_gray(img[i]))
+			ok = 0;
+		if(i < count && plane[1][i + 1] != ref_gray(img[i + 1]))
+			ok = 0;
+	}
+	CHECK(ok, "rgb565_to_gray");
+
+	image_gray_to_rgb565(dst, plane[0], PIXELS);
+	for(i = 0, ok = 1 ; i < PIXELS ; i++){
+		if(dst[i] != RGB888_TO_565(plane[0][i], plane[0][i], plane[0][i]))
+			ok = 0;
+	}
+	CHECK(ok, "gray_to_rgb565");
+
+	/* 色差は2画素の平均のため、水平方向に滑らかな画像で往復誤差を確認する */
+	for(i = 0 ; i < PIXELS ; i++)
+		tmp[i] = RGB888_TO_565(200, (i / 300) & 0xff, 60);
+	image_rgb565_to_yuv422(dst, tmp, PIXELS);
+	image_yuv422_to_rgb565(ref, dst, PIXELS);
+	for(i = 0, maxdiff = 0 ; i < PIXELS ; i++){
+		diff = abs((int)RGB565_G8(ref[i]) - (int)RGB565_G8(tmp[i]));
+		if(diff > maxdiff)
+			maxdiff = diff;
+		diff = abs((int)RGB565_R8(ref[i]) - (int)RGB565_R8(tmp[i]));
+		if(diff > maxdiff)
+			maxdiff = diff;
+	}
+	printf("    yuv422 round trip max diff %d\n", maxdiff);
+	CHECK(maxdiff <= 12, "rgb565 <-> yuv422");
+}
+
+/*
+ *  幾何変換の試験
+ */
+static void
+test_geometry(void)
+{
+	static const uint8_t dirs[] = {
+		0, IMAGE_DIR_MIRRORX, IMAGE_DIR_MIRRORY, IMAGE_ROTATE_90, IMAGE_ROTATE_180, IMAGE_ROTATE_270,
+		IMAGE_DIR_SWAPXY, IMAGE_DIR_SWAPXY | IMAGE_DIR_MIRRORX | IMAGE_DIR_MIRRORY
+	};
+	uint16_t *img = (uint16_t *)src_buf;
+	uint16_t *dst = (uint16_t *)dst_buf;
+	uint16_t *ref = (uint16_t *)ref_buf;
+	uint16_t *tmp = (uint16_t *)tmp_buf;
+	uint32_t i, x, y, sx, sy;
+	int ok;
+
+	make_image(img, (uint32_t *)raw_buf, PIXELS);
+	CHECK(image_crop(dst, img, WIDTH, HEIGHT, 10, 20, 100, 50, 2) == E_OK
+			&& dst[0] == img[20 * WIDTH + 10] && dst[100 * 49 + 99] == img[69 * WIDTH + 109], "crop");
+	CHECK(image_crop(dst, img, WIDTH, HEIGHT, 300, 0, 21, 1, 2) == E_PAR, "crop out of range");
+
+	CHECK(image_resize_nearest(dst, WIDTH, HEIGHT, img, WIDTH, HEIGHT) == E_OK
+			&& memcmp(dst, img, PIXELS * 2) == 0, "resize_nearest identity");
+	/* 固定小数点の丸めで標本位置が1画素ずれるのは許容する */
+	image_resize_nearest(dst, 224, 224, img, WIDTH, HEIGHT);
+	for(y = 0, ok = 1 ; y < 224 ; y++){
+		for(x = 0 ; x < 224 ; x++){
+			sx = (2 * x + 1) * WIDTH / (2 * 224);
+			sy = (2 * y + 1) * HEIGHT / (2 * 224);
+			if(!near_pixel(dst[y * 224 + x], img, WIDTH, HEIGHT, sx, sy))
+				ok = 0;
+		}
+	}
+	CHECK(ok, "resize_nearest 320x240 -> 224x224");
+	CHECK(image_resize_bilinear(dst, WIDTH, HEIGHT, img, WIDTH, HEIGHT) == E_OK
+			&& memcmp(dst, img, PIXELS * 2) == 0, "resize_bilinear identity");
+	for(i = 0 ; i < PIXELS ; i++)
+		tmp[i] = RGB888_TO_565(0x80, 0x40, 0x20);
+	image_resize_bilinear(dst, 160, 120, tmp, WIDTH, HEIGHT);
+	for(i = 0, ok = 1 ; i < 160 * 120 ; i++){
+		if(dst[i] != tmp[0])
+			ok = 0;
+	}
+	CHECK(ok, "resize_bilinear flat");
+	/* 一括補間は水平・垂直の段毎に切り捨てるため、成分毎の計算と2階調の差を許容する */
+	image_resize_bilinear(dst, 224, 224, img, WIDTH, HEIGHT);
+	ref_resize_bilinear(ref, 224, 224, img, WIDTH, HEIGHT);
+	for(i = 0, ok = 1 ; i < 224 * 224 ; i++){
+		if(abs((dst[i] >> 11) - (ref[i] >> 11)) > 2 || abs(((dst[i] >> 5) & 0x3f) - ((ref[i] >> 5) & 0x3f)) > 2
+				|| abs((dst[i] & 0x1f) - (ref[i] & 0x1f)) > 2)
+			ok = 0;
+	}
+	CHECK(ok, "resize_bilinear 320x240 -> 224x224");
+	CHECK(image_resize_bilinear(img, WIDTH, HEIGHT, img, WIDTH, HEIGHT) == E_PAR, "resize in place");
+
+	for(i = 0, ok = 1 ; i < sizeof(dirs) ; i++){
+		memset(dst, 0, PIXELS * 2);
+		image_rotate(dst, img, WIDTH, HEIGHT, dirs[i]);
+		ref_rotate(ref, img, WIDTH, HEIGHT, dirs[i]);
+		if(memcmp(dst, ref, PIXELS * 2) != 0){
+			printf("    rotate dir 0x%02x mismatch\n", dirs[i]);
+			ok = 0;
+		}
+	}
+	image_rotate(dst, img, WIDTH, HEIGHT, IMAGE_ROTATE_90);
+	image_rotate(ref, dst, HEIGHT, WIDTH, IMAGE_ROTATE_270);
+	CHECK(ok && memcmp(ref, img, PIXELS * 2) == 0, "rotate");
+	image_rotate(dst, img, 37, 29, IMAGE_ROTATE_90);
+	ref_rotate(ref, img, 37, 29, IMAGE_ROTATE_90);
+	CHECK(memcmp(dst, ref, 37 * 29 * 2) == 0, "rotate partial tile");
+}
+
+/*
+ *  処理時間の測定(QVGA1フレーム、参照実装との比較)
+ */
+#define BENCH(name, opt, ref) do { \
+	SYSUTM start; uint32_t t_opt, t_ref, n; \
+	get_utm(&start); \
+	for(n = 0 ; n < BENCH_LOOP ; n++){ opt; } \
+	t_opt = elapsed(start) / BENCH_LOOP; \
+	get_utm(&start); \
+	for(n = 0 ; n < BENCH_LOOP ; n++){ ref; } \
+	t_ref = elapsed(start) / BENCH_LOOP; \
+	printf("    %-20s %6u us  (reference %6u us)\n", name, t_opt, t_ref); \
+} while(0)
+
+static void
+bench(void)
+{
+	uint16_t *img = (uint16_t *)src_buf;
+	uint16_t *dst = (uint16_t *)dst_buf;
+	uint16_t *ref = (uint16_t *)ref_buf;
+	uint32_t i;
+
+	make_image(img, (uint32_t *)raw_buf, PIXELS);
+	printf("benchmark %dx%d, %d loops\n", WIDTH, HEIGHT, BENCH_LOOP);
+	BENCH("sensor_to_rgb565", image_sensor_to_rgb565(dst, (uint32_t *)raw_buf, PIXELS),
+		ref_sensor_to_rgb565(ref, (uint32_t *)raw_buf, PIXELS));
+	BENCH("rgb565_to_gray", image_rgb565_to_gray(plane[0], img, PIXELS),
+		for(i = 0 ; i < PIXELS ; i++) plane_ref[0][i] = ref_gray(img[i]));
+	BENCH("rotate 90", image_rotate(dst, img, WIDTH, HEIGHT, IMAGE_ROTATE_90),
+		ref_rotate(ref, img, WIDTH, HEIGHT, IMAGE_ROTATE_90));
+	BENCH("resize_nearest 224", image_resize_nearest(dst, 224, 224, img, WIDTH, HEIGHT),
+		ref_resize_nearest(ref, 224, 224, img, WIDTH, HEIGHT));
+	BENCH("resize_bilinear 224", image_resize_bilinear(dst, 224, 224, img, WIDTH, HEIGHT),
+		ref_resize_bilinear(ref, 224, 224, img, WIDTH, HEIGHT));
+}
+
+int
+main(int argc, char *argv[])
+{
+	srand(1);
+	test_convert();
+	test_geometry();
+	if(argc > 1 && strcmp(argv[1], "-b") == 0)
+		bench();
+	printf("%s\n", failed ? "FAILED" : "PASSED");
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,278 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  ソフトウェアJPEGエンコーダのホスト試験
+ *
+ *  固定のRGB565フレームを符号化し、マーカーの並びとSOF0の寸法、
+ *  エントロピー符号化データのバイトスタッフィングを確認する．
+ *  -bで品質ごとの1フレームあたりの処理時間と符号量を表示する．
+ *  引数に記録したフレーム(QVGA、RGB565リトルエンディアンの生データ)を
+ *  与えると、そのフレームで測定する．
+ *    test_sipeed_jpeg [-b] [frame.raw]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel.h"
+#include "sipeed_ov7740.h"
+#include "image_kernel.h"
+
+#define WIDTH           320
+#define HEIGHT          240
+#define PIXELS          (WIDTH * HEIGHT)
+#define JPEG_SIZE       (64 * 1024)
+#define BENCH_LOOP      20
+
+static OV7740_t   CameraHandle;
+static uint32_t   frame[PIXELS / 2];
+static uint8_t    jpeg[JPEG_SIZE];
+static int        failed;
+
+#define CHECK(cond, name) check_result((cond), (name), __LINE__)
+
+static void
+check_result(int ok, const char *name, int line)
+{
+	if(!ok){
+		printf("NG  %s (line %d)\n", name, line);
+		failed++;
+	}
+	else
+		printf("OK  %s\n", name);
+}
+
+/*
+ *  snapshot後の並び(SENSOR_PIXEL)で1画素を格納する
+ */
+static void
+put_pixel(uint32_t i, uint16_t pix)
+{
+	uint8_t *p = (uint8_t *)frame;
+
+	p[(i ^ 1) * 2]     = pix >> 8;
+	p[(i ^ 1) * 2 + 1] = pix & 0xff;
+}
+
+/*
+ *  固定の試験フレーム(グラデーションと色の矩形、擬似乱数の点)
+ */
+static void
+make_frame(void)
+{
+	uint32_t seed = 1, x, y;
+	uint16_t pix;
+
+	for(y = 0 ; y < HEIGHT ; y++){
+		for(x = 0 ; x < WIDTH ; x++){
+			seed = seed * 1103515245 + 12345;
+			pix = RGB888_TO_565(x * 255 / WIDTH, y * 255 / HEIGHT, 128);
+			if(x >= 40 && x < 120 && y >= 60 && y < 140)
+				pix = RGB888_TO_565(220, 20, 20);
+			if((seed >> 24) < 4)
+				pix = (uint16_t)(seed >> 8);
+			put_pixel(y * WIDTH + x, pix);
+		}
+	}
+}
+
+/*
+ *  記録フレームの読み込み
+ */
+static int
+load_frame(const char *path)
+{
+	static uint16_t rec[PIXELS];
+	FILE     *fp;
+	uint32_t i;
+
+	if((fp = fopen(path, "rb")) == NULL)
+		return -1;
+	i = fread(rec, 2, PIXELS, fp);
+	fclose(fp);
+	if(i != PIXELS)
+		return -1;
+	for(i = 0 ; i < PIXELS ; i++)
+		put_pixel(i, rec[i]);
+	return 0;
+}
+
+static ER
+encode(uint8_t quality, pixformat_t format, uint8_t *buf, uint32_t size, uint32_t *len)
+{
+	CameraHandle.pixFormat = format;
+	CameraHandle._quality  = quality;
+	return ov7740_jpeg_encode(&CameraHandle, buf, size, len);
+}
+
+/*
+ *  JPEGストリームの確認
+ *  SOIからSOSまでのセグメントを辿り、SOF0の寸法とDQT/DHTの有無、
+ *  エントロピー符号化データ中の0xFFが0x00でスタッフィングされ、
+ *  最後がEOIで終わることを確認する．
+ */
+static int
+check_jpeg(const uint8_t *p, uint32_t len, uint16_t width, uint16_t height)
+{
+	uint32_t pos = 2, seglen;
+	uint8_t  marker;
+	int      sof = 0, dqt = 0, dht = 0;
+
+	if(len < 4 || p[0] != 0xFF || p[1] != 0xD8)
+		return 0;
+	if(p[len - 2] != 0xFF || p[len - 1] != 0xD9)
+		return 0;
+	for(;;){
+		if(pos + 4 > len || p[pos] != 0xFF)
+			return 0;
+		marker = p[pos + 1];
+		seglen = (p[pos + 2] << 8) | p[pos + 3];
+		if(seglen < 2 || pos + 2 + seglen > len)
+			return 0;
+		switch(marker){
+		case 0xC0:
+			if(seglen != 17 || p[pos + 4] != 8 || p[pos + 9] != 3)
+				return 0;
+			if(((p[pos + 5] << 8) | p[pos + 6]) != height
+				|| ((p[pos + 7] << 8) | p[pos + 8]) != width)
+				return 0;
+			sof++;
+			break;
+		case 0xDB:
+			dqt++;
+			break;
+		case 0xC4:
+			dht++;
+			break;
+		}
+		pos += 2 + seglen;
+		if(marker == 0xDA)
+			break;
+	}
+	if(sof != 1 || dqt == 0 || dht == 0)
+		return 0;
+	for(; pos < len - 2 ; pos++){
+		if(p[pos] == 0xFF && p[pos + 1] != 0x00)
+			return 0;
+	}
+	return 1;
+}
+
+static void
+test_encode(void)
+{
+	static uint8_t small[256];
+	uint32_t len = 0, len_q[3];
+	uint8_t  quality[3] = { 10, 50, 95 };
+	int      i;
+
+	CHECK(encode(80, PIXFORMAT_RGB565, jpeg, JPEG_SIZE, &len) == E_OK, "encode rgb565");
+	CHECK(check_jpeg(jpeg, len, WIDTH, HEIGHT), "rgb565 stream");
+	printf("    quality 80: %u bytes\n", len);
+
+	CHECK(encode(80, PIXFORMAT_YUV422, jpeg, JPEG_SIZE, &len) == E_OK, "encode yuv422");
+	CHECK(check_jpeg(jpeg, len, WIDTH, HEIGHT), "yuv422 stream");
+
+	for(i = 0 ; i < 3 ; i++){
+		len_q[i] = 0;
+		encode(quality[i], PIXFORMAT_RGB565, jpeg, JPEG_SIZE, &len_q[i]);
+	}
+	CHECK(len_q[0] != 0 && len_q[0] < len_q[1] && len_q[1] < len_q[2], "size grows with quality");
+
+	len = 1;
+	CHECK(encode(80, PIXFORMAT_RGB565, small, sizeof(small), &len) == E_NOMEM && len == 0,
+		"output overflow");
+	CHECK(encode(80, PIXFORMAT_GRAYSCALE, jpeg, JPEG_SIZE, &len) == E_PAR, "unsupported format");
+	CHECK(ov7740_jpeg_encode(NULL, jpeg, JPEG_SIZE, &len) == E_PAR, "null handle");
+	CHECK(ov7740_jpeg_encode(&CameraHandle, NULL, JPEG_SIZE, &len) == E_PAR, "null buffer");
+}
+
+/*
+ *  品質ごとの処理時間と符号量
+ */
+static void
+bench(void)
+{
+	static const uint8_t quality[] = { 30, 50, 70, 80, 90, 95 };
+	SYSUTM   start, end;
+	uint32_t i, n, len = 0;
+
+	printf("benchmark %dx%d rgb565, %d loops\n", WIDTH, HEIGHT, BENCH_LOOP);
+	for(i = 0 ; i < sizeof(quality) ; i++){
+		get_utm(&start);
+		for(n = 0 ; n < BENCH_LOOP ; n++)
+			encode(quality[i], PIXFORMAT_RGB565, jpeg, JPEG_SIZE, &len);
+		get_utm(&end);
+		printf("    quality %3d  %7.2f ms/frame  %6u bytes/frame\n",
+			quality[i], (double)(end - start) / BENCH_LOOP / 1000.0, len);
+	}
+}
+
+int
+main(int argc, char *argv[])
+{
+	uint32_t len = 0;
+	int      i = 1, do_bench = 0;
+
+	CameraHandle._width      = WIDTH;
+	CameraHandle._height     = HEIGHT;
+	CameraHandle._dataBuffer = frame;
+	make_frame();
+	test_encode();
+	if(i < argc && strcmp(argv[i], "-b") == 0){
+		do_bench = 1;
+		i++;
+	}
+	if(i < argc){
+		if(load_frame(argv[i]) != 0){
+			printf("NG  %s: cannot read %dx%d RGB565 frame\n", argv[i], WIDTH, HEIGHT);
+			failed++;
+		}
+		else{
+			CHECK(encode(80, PIXFORMAT_RGB565, jpeg, JPEG_SIZE, &len) == E_OK
+				&& check_jpeg(jpeg, len, WIDTH, HEIGHT), argv[i]);
+		}
+	}
+	if(do_bench)
+		bench();
+	printf("%s\n", failed ? "FAILED" : "PASSED");
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,337 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  動き検出のホスト試験
+ *
+ *  合成したフレーム列で静止・移動物体・明暗の対称性を確認する．
+ *  輝度を正確に与えるため、合成フレームはYUV422(下位バイトが輝度)とする．
+ *  引数に記録したフレーム列(QVGA、RGB565リトルエンディアンの生データを
+ *  連結したもの)を与えると、各フレームの検出結果と処理時間を表示する．
+ *    test_sipeed_motion [-b] [frames.raw]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel.h"
+#include "sipeed_motion.h"
+
+#define WIDTH           320
+#define HEIGHT          240
+#define PIXELS          (WIDTH * HEIGHT)
+#define GRID_W          16
+#define GRID_H          12
+#define CELL_W          (WIDTH / GRID_W)
+#define CELL_H          (HEIGHT / GRID_H)
+#define BG_LUMA         100
+#define BENCH_LOOP      100
+
+static MOTION_Handle_t MotionHandle;
+static MOTION_Event_t  event;
+static uint32_t        frame[PIXELS / 2];
+static int             failed;
+
+#define CHECK(cond, name) check_result((cond), (name), __LINE__)
+
+static void
+check_result(int ok, const char *name, int line)
+{
+	if(!ok){
+		printf("NG  %s (line %d)\n", name, line);
+		failed++;
+	}
+	else
+		printf("OK  %s\n", name);
+}
+
+/*
+ *  snapshot後の並び(SENSOR_PIXEL)で1画素を格納する
+ */
+static void
+put_pixel(uint32_t i, uint16_t pix)
+{
+	uint8_t *p = (uint8_t *)frame;
+
+	p[(i ^ 1) * 2]     = pix >> 8;
+	p[(i ^ 1) * 2 + 1] = pix & 0xff;
+}
+
+/*
+ *  背景(輝度BG_LUMA、noiseで±noiseの擬似乱数)
+ */
+static void
+fill_background(int noise)
+{
+	static uint32_t seed = 1;
+	uint32_t i;
+	int      y;
+
+	for(i = 0 ; i < PIXELS ; i++){
+		y = BG_LUMA;
+		if(noise != 0){
+			seed = seed * 1103515245 + 12345;
+			y += (int)((seed >> 16) % (2 * noise + 1)) - noise;
+		}
+		put_pixel(i, 0x8000 | y);
+	}
+}
+
+/*
+ *  矩形の描画(YUV422、輝度y)
+ */
+static void
+fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t luma)
+{
+	uint16_t i, j;
+
+	for(j = y ; j < y + h ; j++){
+		for(i = x ; i < x + w ; i++)
+			put_pixel(j * WIDTH + i, 0x8000 | luma);
+	}
+}
+
+/*
+ *  1セル分を輝度l0とl1の市松で塗る(セル平均は(l0+l1)/2)
+ */
+static void
+fill_cell_half(uint16_t gx, uint16_t gy, uint8_t l0, uint8_t l1)
+{
+	uint16_t i, j;
+
+	for(j = 0 ; j < CELL_H ; j++){
+		for(i = 0 ; i < CELL_W ; i++)
+			put_pixel((gy * CELL_H + j) * WIDTH + gx * CELL_W + i, 0x8000 | (((i + j) & 1) ? l1 : l0));
+	}
+}
+
+static ER
+setup(uint8_t threshold, uint8_t step, uint16_t min_cells)
+{
+	MotionHandle.Init.GridWidth  = GRID_W;
+	MotionHandle.Init.GridHeight = GRID_H;
+	MotionHandle.Init.Threshold  = threshold;
+	MotionHandle.Init.LearnShift = 3;
+	MotionHandle.Init.SampleStep = step;
+	MotionHandle.Init.MinCells   = min_cells;
+	return motion_init(&MotionHandle);
+}
+
+static ER_UINT
+detect(pixformat_t format)
+{
+	return motion_detect(&MotionHandle, frame, WIDTH, HEIGHT, format, &event);
+}
+
+/*
+ *  パラメータの確認
+ */
+static void
+test_param(void)
+{
+	CHECK(setup(10, 1, 0) == E_PAR, "init min cells 0");
+	CHECK(setup(10, 3, 1) == E_PAR, "init step 3");
+	CHECK(setup(10, 1, 1) == E_OK, "init");
+	CHECK(motion_detect(NULL, frame, WIDTH, HEIGHT, PIXFORMAT_YUV422, &event) == E_PAR, "null handle");
+	CHECK(motion_detect(&MotionHandle, NULL, WIDTH, HEIGHT, PIXFORMAT_YUV422, &event) == E_PAR, "null frame");
+	CHECK(detect(PIXFORMAT_GRAYSCALE) == E_PAR, "unsupported format");
+}
+
+/*
+ *  静止画と移動物体
+ */
+static void
+test_moving(void)
+{
+	ER_UINT  n;
+	uint16_t x;
+	int      i, quiet = 1, covered = 1;
+
+	setup(10, 1, 1);
+	for(i = 0 ; i < 10 ; i++){
+		fill_background(3);
+		if(detect(PIXFORMAT_YUV422) != 0 && i > 0)
+			quiet = 0;
+	}
+	CHECK(quiet, "static noisy frames");
+
+	for(x = 20 ; x < 260 ; x += 10){
+		fill_background(3);
+		fill_rect(x, 100, 40, 40, 200);
+		n = detect(PIXFORMAT_YUV422);
+		if(n <= 0 || event.x > x || event.x + event.w < x + 40
+				|| event.y > 100 || event.y + event.h < 140)
+			covered = 0;
+	}
+	CHECK(covered, "moving square inside event");
+	CHECK(MotionHandle.events == 24, "event count");
+}
+
+/*
+ *  明暗の対称性
+ *  セル平均が背景から±10.5離れた場合、明暗どちらも同じ判定になること．
+ */
+static void
+test_symmetry(void)
+{
+	ER_UINT  bright, dark;
+	uint32_t nb, nd;
+
+	setup(10, 1, 1);
+	fill_background(0);
+	detect(PIXFORMAT_YUV422);
+	fill_cell_half(5, 5, BG_LUMA + 10, BG_LUMA + 11);
+	bright = detect(PIXFORMAT_YUV422);
+
+	setup(10, 1, 1);
+	fill_background(0);
+	detect(PIXFORMAT_YUV422);
+	fill_cell_half(5, 5, BG_LUMA - 10, BG_LUMA - 11);
+	dark = detect(PIXFORMAT_YUV422);
+	CHECK(bright == 1 && dark == 1, "threshold symmetric");
+
+	/*
+	 *  静止した明るい物体と暗い物体が背景に取り込まれるまでのフレーム数
+	 */
+	setup(10, 1, 1);
+	fill_background(0);
+	detect(PIXFORMAT_YUV422);
+	fill_rect(5 * CELL_W, 5 * CELL_H, CELL_W, CELL_H, BG_LUMA + 40);
+	for(nb = 0 ; nb < 500 && detect(PIXFORMAT_YUV422) > 0 ; nb++);
+
+	setup(10, 1, 1);
+	fill_background(0);
+	detect(PIXFORMAT_YUV422);
+	fill_rect(5 * CELL_W, 5 * CELL_H, CELL_W, CELL_H, BG_LUMA - 40);
+	for(nd = 0 ; nd < 500 && detect(PIXFORMAT_YUV422) > 0 ; nd++);
+	printf("    absorb frames bright(%u) dark(%u)\n", nb, nd);
+	CHECK(nb < 500 && nb == nd, "background learning symmetric");
+}
+
+/*
+ *  最小変化セル数
+ */
+static void
+test_min_cells(void)
+{
+	ER_UINT n1, n2;
+
+	setup(10, 1, 4);
+	fill_background(0);
+	detect(PIXFORMAT_YUV422);
+	fill_rect(0, 0, CELL_W * 3, CELL_H, 200);
+	n1 = detect(PIXFORMAT_YUV422);
+	fill_rect(0, 0, CELL_W * 4, CELL_H, 250);
+	n2 = detect(PIXFORMAT_YUV422);
+	CHECK(n1 == 0 && n2 == 4 && event.w == CELL_W * 4, "min cells");
+}
+
+/*
+ *  処理時間の測定
+ */
+static void
+bench(void)
+{
+	SYSUTM   start, end;
+	uint8_t  step;
+	uint32_t n;
+
+	printf("benchmark %dx%d grid %dx%d, %d loops\n", WIDTH, HEIGHT, GRID_W, GRID_H, BENCH_LOOP);
+	for(step = 1 ; step <= 4 ; step *= 2){
+		setup(10, step, 1);
+		fill_background(3);
+		get_utm(&start);
+		for(n = 0 ; n < BENCH_LOOP ; n++)
+			motion_detect(&MotionHandle, frame, WIDTH, HEIGHT, PIXFORMAT_RGB565, &event);
+		get_utm(&end);
+		printf("    step %d  %6u us/frame\n", step, (uint32_t)((end - start) / BENCH_LOOP));
+	}
+}
+
+/*
+ *  記録フレーム列の検出
+ */
+static void
+run_recorded(const char *path)
+{
+	static uint16_t rec[PIXELS];
+	FILE     *fp;
+	SYSUTM   start, end;
+	ER_UINT  n;
+	uint32_t i, no;
+
+	if((fp = fopen(path, "rb")) == NULL){
+		printf("NG  %s: cannot open\n", path);
+		failed++;
+		return;
+	}
+	setup(10, 2, 2);
+	for(no = 0 ; fread(rec, 2, PIXELS, fp) == PIXELS ; no++){
+		for(i = 0 ; i < PIXELS ; i++)
+			put_pixel(i, rec[i]);
+		get_utm(&start);
+		n = detect(PIXFORMAT_RGB565);
+		get_utm(&end);
+		if(n > 0)
+			printf("%s[%u]: cells(%d) x(%d) y(%d) w(%d) h(%d) %u us\n", path, no, (int)n,
+				event.x, event.y, event.w, event.h, (uint32_t)(end - start));
+	}
+	fclose(fp);
+	printf("%s: frames(%u) events(%u)\n", path, no, MotionHandle.events);
+}
+
+int
+main(int argc, char *argv[])
+{
+	int i = 1;
+
+	test_param();
+	test_moving();
+	test_symmetry();
+	test_min_cells();
+	if(i < argc && strcmp(argv[i], "-b") == 0){
+		bench();
+		i++;
+	}
+	for(; i < argc ; i++)
+		run_recorded(argv[i]);
+	printf("%s\n", failed ? "FAILED" : "PASSED");
+	return failed ? 1 : 0;
+}
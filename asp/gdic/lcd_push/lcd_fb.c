@@ -0,0 +1,371 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  差分矩形フレームバッファ
+ *
+ *  フレームバッファへの描画をタイル単位のビットマップで記録し、
+ *  lcdfb_flushで更新タイルを矩形に統合して、その部分のみをLCDに送信する．
+ *  矩形は行ごとの連続タイルを縦に延長して作り、統合による余分な送信画素が
+ *  矩形1つのオーバーヘッド(LCDFB_RECT_COST)以下であれば更に統合する．
+ *  全幅の矩形はフレームバッファから直接、それ以外は作業領域にコピーして
+ *  lcdpush_draw_rectsで一括送信する．
+ */
+#include <kernel.h>
+#include <t_syslog.h>
+#include <string.h>
+#include "device.h"
+#include "spi.h"
+#include "lcd_fb.h"
+
+#define LCDFB_MAX_PIXELS    (0xffff * 2)	/* 1矩形の最大画素数(DMA転送長) */
+
+/*
+ *  タイル矩形の面積
+ */
+Inline int
+lcdfb_area(const LCDFB_Tile_t *t)
+{
+	return (t->c1 - t->c0 + 1) * (t->r1 - t->r0 + 1);
+}
+
+/*
+ *  更新タイルを矩形に変換する
+ *  return      矩形数、-1で作業数超過
+ */
+static int
+lcdfb_collect(LCDFB_Handle_t *hfb)
+{
+	LCDFB_Tile_t *t;
+	uint32_t bits;
+	int      n = 0, i;
+	uint16_t r, c, c0;
+
+	for(r = 0 ; r < hfb->trows ; r++){
+		bits = hfb->dirty[r];
+		for(c = 0 ; c < hfb->tcols ; ){
+			if((bits & (1u << c)) == 0){
+				c++;
+				continue;
+			}
+			for(c0 = c ; c < hfb->tcols && (bits & (1u << c)) != 0 ; c++) ;
+			/* 前行で同じ列範囲の矩形があれば延長する */
+			for(i = 0, t = hfb->cand ; i < n ; i++, t++){
+				if(t->r1 + 1 == r && t->c0 == c0 && t->c1 == c - 1)
+					break;
+			}
+			if(i < n)
+				t->r1 = r;
+			else if(n >= LCDFB_MAX_CAND)
+				return -1;
+			else{
+				t->c0 = c0;
+				t->c1 = c - 1;
+				t->r0 = r;
+				t->r1 = r;
+				n++;
+			}
+		}
+	}
+	return n;
+}
+
+/*
+ *  送信画素の増加が矩形のオーバーヘッド以下の組を統合する
+ *  return      統合後の矩形数
+ */
+static int
+lcdfb_merge(LCDFB_Handle_t *hfb, int n)
+{
+	LCDFB_Tile_t box, best_box;
+	int i, j, cost, best, bi, bj;
+
+	while(n > 1){
+		best = 0x7fffffff;
+		bi = bj = 0;
+		for(i = 0 ; i < n ; i++){
+			for(j = i + 1 ; j < n ; j++){
+				box.c0 = hfb->cand[i].c0 < hfb->cand[j].c0 ? hfb->cand[i].c0 : hfb->cand[j].c0;
+				box.r0 = hfb->cand[i].r0 < hfb->cand[j].r0 ? hfb->cand[i].r0 : hfb->cand[j].r0;
+				box.c1 = hfb->cand[i].c1 > hfb->cand[j].c1 ? hfb->cand[i].c1 : hfb->cand[j].c1;
+				box.r1 = hfb->cand[i].r1 > hfb->cand[j].r1 ? hfb->cand[i].r1 : hfb->cand[j].r1;
+				cost = lcdfb_area(&box) - lcdfb_area(&hfb->cand[i]) - lcdfb_area(&hfb->cand[j]);
+				if(cost < best){
+					best = cost;
+					best_box = box;
+					bi = i;
+					bj = j;
+				}
+			}
+		}
+		if(best * LCDFB_TILE_W * LCDFB_TILE_H > LCDFB_RECT_COST)
+			break;
+		hfb->cand[bi] = best_box;
+		hfb->cand[bj] = hfb->cand[--n];
+	}
+	return n;
+}
+
+/*
+ *  矩形を送信リストに追加し、リストか作業領域が一杯なら送信する
+ */
+static ER
+lcdfb_send_rect(LCDFB_Handle_t *hfb, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *num, uint32_t *used)
+{
+	LCDPUSH_Rect_t *rect;
+	uint16_t *src, *dst;
+	uint32_t cap = hfb->Init.StagingSize / 2;
+	uint16_t i;
+	ER       ercd;
+	bool_t   copy = (x != 0 || w != hfb->Init.Width);
+
+	if(*num >= LCDPUSH_MAX_RECTS || (copy && *used + (uint32_t)w * h > cap)){
+		ercd = lcdpush_draw_rects(hfb->Init.hpush, hfb->rect, *num);
+		*num  = 0;
+		*used = 0;
+		if(ercd != E_OK)
+			return ercd;
+	}
+	rect = &hfb->rect[(*num)++];
+	rect->x      = x;
+	rect->y      = y;
+	rect->width  = w;
+	rect->height = h;
+	src = hfb->Init.Buffer + (uint32_t)y * hfb->Init.Width + x;
+	if(!copy)
+		rect->buf = src;
+	else{
+		rect->buf = dst = hfb->Init.Staging + *used;
+		for(i = 0 ; i < h ; i++, src += hfb->Init.Width, dst += w)
+			memcpy(dst, src, w * 2);
+		*used += (uint32_t)w * h;
+		hfb->copied++;
+	}
+	hfb->bytes += (uint32_t)w * h * 2;
+	hfb->rects++;
+	return E_OK;
+}
+
+/*
+ *  差分フレームバッファ初期化
+ *  parameter1  hfb: 差分フレームバッファハンドラへのポインタ
+ *  return      ERコード
+ */
+ER
+lcdfb_init(LCDFB_Handle_t *hfb)
+{
+	if(hfb == NULL || hfb->Init.hpush == NULL || hfb->Init.Buffer == NULL)
+		return E_PAR;
+	if(hfb->Init.Width == 0 || (hfb->Init.Width & 1) != 0 || hfb->Init.Height == 0)
+		return E_PAR;
+	if(hfb->Init.Width > LCDFB_TILE_W * LCDFB_MAX_TCOLS || hfb->Init.Height > LCDFB_TILE_H * LCDFB_MAX_TROWS)
+		return E_PAR;
+	if(hfb->Init.Staging == NULL || hfb->Init.StagingSize < hfb->Init.Width * 2)
+		return E_PAR;
+
+	hfb->tcols = (hfb->Init.Width  + LCDFB_TILE_W - 1) / LCDFB_TILE_W;
+	hfb->trows = (hfb->Init.Height + LCDFB_TILE_H - 1) / LCDFB_TILE_H;
+	memset(hfb->dirty, 0, sizeof(hfb->dirty));
+	hfb->frames      = 0;
+	hfb->full        = 0;
+	hfb->bytes       = 0;
+	hfb->max_bytes   = 0;
+	hfb->total_bytes = 0;
+	hfb->rects       = 0;
+	hfb->copied      = 0;
+	return E_OK;
+}
+
+/*
+ *  更新領域の登録
+ *  parameter1  hfb: 差分フレームバッファハンドラへのポインタ
+ *  parameter2  x: 開始X座標
+ *  parameter3  y: 開始Y座標
+ *  parameter4  width: 幅
+ *  parameter5  height: 高さ
+ */
+void
+lcdfb_damage(LCDFB_Handle_t *hfb, int16_t x, int16_t y, int16_t width, int16_t height)
+{
+	int16_t  x2 = x + width - 1, y2 = y + height - 1;
+	uint32_t mask;
+	int16_t  r;
+
+	if(x < 0)
+		x = 0;
+	if(y < 0)
+		y = 0;
+	if(x2 >= (int16_t)hfb->Init.Width)
+		x2 = hfb->Init.Width - 1;
+	if(y2 >= (int16_t)hfb->Init.Height)
+		y2 = hfb->Init.Height - 1;
+	if(x > x2 || y > y2)
+		return;
+
+	x  /= LCDFB_TILE_W;
+	x2 /= LCDFB_TILE_W;
+	mask = ((x2 - x) == 31) ? 0xffffffff : (((1u << (x2 - x + 1)) - 1) << x);
+	for(r = y / LCDFB_TILE_H ; r <= y2 / LCDFB_TILE_H ; r++)
+		hfb->dirty[r] |= mask;
+}
+
+/*
+ *  全画面の更新登録
+ *  parameter1  hfb: 差分フレームバッファハンドラへのポインタ
+ */
+void
+lcdfb_damage_all(LCDFB_Handle_t *hfb)
+{
+	lcdfb_damage(hfb, 0, 0, hfb->Init.Width, hfb->Init.Height);
+}
+
+/*
+ *  矩形塗りつぶし
+ *  parameter1  hfb: 差分フレームバッファハンドラへのポインタ
+ *  parameter2  x: 開始X座標
+ *  parameter3  y: 開始Y座標
+ *  parameter4  width: 幅
+ *  parameter5  height: 高さ
+ *  parameter6  pixel: バッファに書き込む画素値
+ */
+void
+lcdfb_fill_rect(LCDFB_Handle_t *hfb, int16_t x, int16_t y, int16_t width, int16_t height, uint16_t pixel)
+{
+	uint16_t *p;
+	int16_t  i, j;
+
+	if(x < 0){
+		width += x;
+		x = 0;
+	}
+	if(y < 0){
+		height += y;
+		y = 0;
+	}
+	if(x + width > (int16_t)hfb->Init.Width)
+		width = hfb->Init.Width - x;
+	if(y + height > (int16_t)hfb->Init.Height)
+		height = hfb->Init.Height - y;
+	if(width <= 0 || height <= 0)
+		return;
+
+	for(j = 0 ; j < height ; j++){
+		p = hfb->Init.Buffer + (uint32_t)(y + j) * hfb->Init.Width + x;
+		for(i = 0 ; i < width ; i++)
+			*p++ = pixel;
+	}
+	lcdfb_damage(hfb, x, y, width, height);
+}
+
+/*
+ *  更新領域の送信
+ *  parameter1  hfb: 差分フレームバッファハンドラへのポインタ
+ *  return      送信バイト数、負値でERコード
+ */
+ER_UINT
+lcdfb_flush(LCDFB_Handle_t *hfb)
+{
+	LCDFB_Tile_t *t;
+	uint32_t used = 0, tiles = 0, bits, maxpix;
+	uint16_t x, y, w, h, lines, num = 0, r;
+	int      n, i;
+	ER       ercd = E_OK;
+
+	if(hfb == NULL)
+		return E_PAR;
+	hfb->bytes  = 0;
+	hfb->rects  = 0;
+	hfb->copied = 0;
+	for(r = 0 ; r < hfb->trows ; r++){
+		for(bits = hfb->dirty[r] ; bits != 0 ; bits &= bits - 1)
+			tiles++;
+	}
+
+	if(tiles == 0)
+		n = 0;
+	else if(tiles * 100 >= (uint32_t)hfb->tcols * hfb->trows * LCDFB_FULL_PERCENT)
+		n = -1;
+	else
+		n = lcdfb_collect(hfb);
+	if(n < 0){
+		/* 全画面転送(コピー不要) */
+		hfb->cand[0].c0 = 0;
+		hfb->cand[0].r0 = 0;
+		hfb->cand[0].c1 = hfb->tcols - 1;
+		hfb->cand[0].r1 = hfb->trows - 1;
+		n = 1;
+		hfb->full++;
+	}
+	else
+		n = lcdfb_merge(hfb, n);
+
+	maxpix = hfb->Init.StagingSize / 2;
+	if(maxpix > LCDFB_MAX_PIXELS)
+		maxpix = LCDFB_MAX_PIXELS;
+	for(i = 0, t = hfb->cand ; i < n && ercd == E_OK ; i++, t++){
+		x = t->c0 * LCDFB_TILE_W;
+		y = t->r0 * LCDFB_TILE_H;
+		w = (t->c1 + 1) * LCDFB_TILE_W;
+		h = (t->r1 + 1) * LCDFB_TILE_H;
+		if(w > hfb->Init.Width)
+			w = hfb->Init.Width;
+		if(h > hfb->Init.Height)
+			h = hfb->Init.Height;
+		w -= x;
+		h -= y;
+		/* 作業領域と転送長に収まる行数ごとに分割する */
+		for( ; h > 0 && ercd == E_OK ; y += lines, h -= lines){
+			lines = (maxpix / w) < h ? (maxpix / w) : h;
+			ercd = lcdfb_send_rect(hfb, x, y, w, lines, &num, &used);
+		}
+	}
+	if(ercd == E_OK && num > 0)
+		ercd = lcdpush_draw_rects(hfb->Init.hpush, hfb->rect, num);
+	memset(hfb->dirty, 0, sizeof(hfb->dirty));
+
+	hfb->frames++;
+	hfb->total_bytes += hfb->bytes;
+	if(hfb->bytes > hfb->max_bytes)
+		hfb->max_bytes = hfb->bytes;
+	if(ercd != E_OK)
+		return ercd;
+	return hfb->bytes;
+}
@@ -0,0 +1,133 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  差分矩形フレームバッファのヘッダファイル
+ */
+
+#ifndef _LCD_FB_H_
+#define _LCD_FB_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "lcd_push.h"
+
+/*
+ *  タイルサイズ(幅は偶数)、タイル数の上限
+ */
+#ifndef LCDFB_TILE_W
+#define LCDFB_TILE_W            16
+#endif
+#ifndef LCDFB_TILE_H
+#define LCDFB_TILE_H            16
+#endif
+#define LCDFB_MAX_TCOLS         32		/* 1行のビットマップ幅 */
+#define LCDFB_MAX_TROWS         32
+
+/*
+ *  矩形統合の作業数、矩形1つあたりのオーバーヘッド(画素換算)
+ */
+#ifndef LCDFB_MAX_CAND
+#define LCDFB_MAX_CAND          64
+#endif
+#ifndef LCDFB_RECT_COST
+#define LCDFB_RECT_COST         256
+#endif
+
+/*
+ *  全画面転送に切り替える更新率(%)
+ */
+#ifndef LCDFB_FULL_PERCENT
+#define LCDFB_FULL_PERCENT      75
+#endif
+
+/*
+ *  差分フレームバッファ初期設定
+ */
+typedef struct {
+	LCDPUSH_Handle_t *hpush;		/* LCD転送ハンドラ(lcdpush_init済み) */
+	uint16_t        *Buffer;		/* フレームバッファ(lcd_drawPictureと同じ並び) */
+	uint16_t        Width;			/* 幅(LCDFB_TILE_W*LCDFB_MAX_TCOLS以下) */
+	uint16_t        Height;			/* 高さ(LCDFB_TILE_H*LCDFB_MAX_TROWS以下) */
+	uint16_t        *Staging;		/* 部分矩形の転送用作業領域 */
+	uint32_t        StagingSize;	/* 作業領域サイズ(バイト) */
+} LCDFB_Init_t;
+
+/*
+ *  タイル単位の矩形
+ */
+typedef struct {
+	uint8_t         c0, r0;			/* 開始タイル */
+	uint8_t         c1, r1;			/* 終了タイル(含む) */
+} LCDFB_Tile_t;
+
+/*
+ *  差分フレームバッファハンドラ
+ */
+typedef struct {
+	LCDFB_Init_t    Init;
+	uint16_t        tcols;			/* 横タイル数 */
+	uint16_t        trows;			/* 縦タイル数 */
+	uint32_t        dirty[LCDFB_MAX_TROWS];	/* 更新タイルビットマップ */
+	LCDFB_Tile_t    cand[LCDFB_MAX_CAND];	/* 統合中の矩形 */
+	LCDPUSH_Rect_t  rect[LCDPUSH_MAX_RECTS];	/* 送信矩形 */
+	uint32_t        frames;			/* flush回数 */
+	uint32_t        full;			/* 全画面転送回数 */
+	uint32_t        bytes;			/* 直近の送信バイト数 */
+	uint32_t        max_bytes;		/* 最大送信バイト数 */
+	uint64_t        total_bytes;	/* 累積送信バイト数 */
+	uint16_t        rects;			/* 直近の送信矩形数 */
+	uint16_t        copied;			/* 直近の作業領域コピー矩形数 */
+} LCDFB_Handle_t;
+
+extern ER lcdfb_init(LCDFB_Handle_t *hfb);
+extern void lcdfb_damage(LCDFB_Handle_t *hfb, int16_t x, int16_t y, int16_t width, int16_t height);
+extern void lcdfb_damage_all(LCDFB_Handle_t *hfb);
+extern void lcdfb_fill_rect(LCDFB_Handle_t *hfb, int16_t x, int16_t y, int16_t width, int16_t height, uint16_t pixel);
+extern ER_UINT lcdfb_flush(LCDFB_Handle_t *hfb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _LCD_FB_H_ */
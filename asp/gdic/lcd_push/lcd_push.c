@@ -0,0 +1,499 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  LCD非同期フレーム転送
+ *
+ *  lcd_drawPictureは画素データのDMA転送終了とSPIのシフトアウト終了を
+ *  タスクで待つため、QVGA 150KBの転送中はメインタスクが停止する．
+ *  本モジュールはウィンドウ設定(CASET/RASET/RAMWR)のみ同期で送出し、
+ *  画素データはspi_core_transmit_asyncで送出して直ちに戻る．転送終了は
+ *  SPI割込みで検出し、コールバックとセマフォで通知する．
+ *  塗りつぶし系の描画(矩形、線、バーグラフ)は画素値1ワードのフィルDMAで
+ *  送出し、フレームバッファを使わない．
+ *
+ *  達成フレームレートは実機で計測していない．QVGA 1フレーム(153600バイト)
+ *  のシフトアウト時間は計算上SPI 20MHzで約61ms(上限約16fps)、15MHzで約82ms
+ *  (上限約12fps)であり、実際の値はlcdpush_get_fpsで確認すること．
+ */
+#include <kernel.h>
+#include <t_syslog.h>
+#include <sil.h>
+#include "device.h"
+#include "spi.h"
+#include "lcd_push.h"
+
+/*
+ *  SPIフレーム設定
+ */
+static void
+lcdpush_set_frame(SPI_Handle_t *hspi, uint32_t dsize, uint32_t inst, uint32_t addr)
+{
+	hspi->Init.DataSize   = dsize;
+	hspi->Init.InstLength = inst;
+	hspi->Init.AddrLength = addr;
+}
+
+/*
+ *  送信セグメントの設定
+ */
+static SPI_Segment_t *
+lcdpush_segment(SPI_Segment_t *seg, const uint32_t *pdata, uint16_t length, uint8_t dsize, uint8_t inst, uint8_t addr, int8_t dcx)
+{
+	seg->pdata      = pdata;
+	seg->length     = length;
+	seg->DataSize   = dsize;
+	seg->InstLength = inst;
+	seg->AddrLength = addr;
+	seg->dcx        = dcx;
+	seg->flags      = 0;
+	return seg + 1;
+}
+
+/*
+ *  ウィンドウ設定(CASET/RASET/RAMWR)のセグメント作成
+ *  parameterはLCDPUSH_RECT_WORDSフレームの領域
+ *  return      次のセグメントへのポインタ
+ */
+static SPI_Segment_t *
+lcdpush_window(SPI_Segment_t *seg, uint32_t *param, uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+	uint16_t x2 = x + width - 1;
+	uint16_t y2 = y + height - 1;
+
+	param[0]  = LCDPUSH_CMD_CASET;
+	param[1]  = x >> 8;
+	param[2]  = x & 0xff;
+	param[3]  = x2 >> 8;
+	param[4]  = x2 & 0xff;
+	param[5]  = LCDPUSH_CMD_RASET;
+	param[6]  = y >> 8;
+	param[7]  = y & 0xff;
+	param[8]  = y2 >> 8;
+	param[9]  = y2 & 0xff;
+	param[10] = LCDPUSH_CMD_RAMWR;
+	seg = lcdpush_segment(seg, &param[0], 1, 8, 8, 0, 0);
+	seg = lcdpush_segment(seg, &param[1], 4, 8, 0, 8, 1);
+	seg = lcdpush_segment(seg, &param[5], 1, 8, 8, 0, 0);
+	seg = lcdpush_segment(seg, &param[6], 4, 8, 0, 8, 1);
+	return lcdpush_segment(seg, &param[10], 1, 8, 8, 0, 0);
+}
+
+/*
+ *  転送終了コールバック(SPI割込みから呼び出し)
+ */
+static void
+lcdpush_comp(SPI_Handle_t *hspi)
+{
+	LCDPUSH_Handle_t *hpush = (LCDPUSH_Handle_t *)hspi->localdata;
+	uint16_t *buf = hpush->busy;
+	SYSUTM   now;
+
+	get_utm(&now);
+	hpush->time = (uint32_t)(now - hpush->start);
+	if(hpush->time > hpush->maxtime)
+		hpush->maxtime = hpush->time;
+	if(hspi->ErrorCode != 0)
+		hpush->errors++;
+	hpush->frames++;
+	hpush->busy = NULL;
+	if(hpush->Init.callback != NULL)
+		hpush->Init.callback(hpush, buf);
+	if(hpush->Init.semid != 0)
+		isig_sem(hpush->Init.semid);
+}
+
+/*
+ *  LCD非同期転送初期化
+ *  parameter1  hpush: LCD非同期転送ハンドラへのポインタ
+ *  return      ERコード
+ */
+ER
+lcdpush_init(LCDPUSH_Handle_t *hpush)
+{
+	SPI_Handle_t *hspi;
+
+	if(hpush == NULL || hpush->Init.hlcd == NULL || hpush->Init.hlcd->hspi == NULL)
+		return E_PAR;
+	hspi = hpush->Init.hlcd->hspi;
+	if(hspi->hdmatx == NULL)
+		return E_NOSPT;
+
+	hpush->DataSize   = hspi->Init.DataSize;
+	hpush->InstLength = hspi->Init.InstLength;
+	hpush->AddrLength = hspi->Init.AddrLength;
+	hpush->busy       = NULL;
+	hpush->back       = 0;
+	hpush->frames     = 0;
+	hpush->errors     = 0;
+	hpush->time       = 0;
+	hpush->maxtime    = 0;
+	hpush->fps_frames = 0;
+	get_utm(&hpush->fps_time);
+	return E_OK;
+}
+
+/*
+ *  LCD非同期描画
+ *  前の転送終了を待ってウィンドウを設定し、画素データの転送を開始して戻る．
+ *  bufは転送終了(コールバック)まで変更しないこと．
+ *  parameter1  hpush: LCD非同期転送ハンドラへのポインタ
+ *  parameter2  x: 描画開始X座標
+ *  parameter3  y: 描画開始Y座標
+ *  parameter4  width: 描画幅
+ *  parameter5  height: 描画高さ
+ *  parameter6  buf: 画素データ(width*heightは偶数)
+ *  return      ERコード
+ */
+ER
+lcdpush_draw_async(LCDPUSH_Handle_t *hpush, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *buf)
+{
+	LCD_Handler_t *hlcd;
+	SPI_Handle_t  *hspi;
+	uint32_t      length;
+	ER            ercd;
+
+	if(hpush == NULL || buf == NULL)
+		return E_PAR;
+	length = (uint32_t)width * height;
+	if(length == 0 || (length & 1) != 0 || (length / 2) > 0xffff)
+		return E_PAR;
+	hlcd = hpush->Init.hlcd;
+	hspi = hlcd->hspi;
+
+	ercd = spi_core_transmit_wait(hspi, LCDPUSH_TIMEOUT);
+	if(ercd == E_TMOUT)
+		return ercd;
+
+	lcdpush_window(hpush->seg, hpush->param[0], x, y, width, height);
+	ercd = spi_core_transmit_list(hspi, hlcd->cs_sel, hlcd->dcx_no, hpush->seg, LCDPUSH_RECT_SEGS - 1);
+	if(ercd == E_OK){
+		gpio_set_pin(TADR_GPIOHS_BASE, hlcd->dcx_no, 1);
+		lcdpush_set_frame(hspi, 32, 0, 32);
+		hspi->xfercallback = lcdpush_comp;
+		hspi->localdata    = hpush;
+		hpush->busy = buf;
+		get_utm(&hpush->start);
+		ercd = spi_core_transmit_async(hspi, hlcd->cs_sel, buf, length / 2);
+		if(ercd != E_OK)
+			hpush->busy = NULL;
+	}
+	lcdpush_set_frame(hspi, hpush->DataSize, hpush->InstLength, hpush->AddrLength);
+	return ercd;
+}
+
+/*
+ *  複数矩形の一括描画
+ *  全矩形のウィンドウ設定と画素データを一つの記述子リストとして連続送信する．
+ *  転送終了まで待って戻る．
+ *  parameter1  hpush: LCD非同期転送ハンドラへのポインタ
+ *  parameter2  rects: 描画矩形の配列
+ *  parameter3  num: 矩形数(LCDPUSH_MAX_RECTS以下)
+ *  return      ERコード
+ */
+ER
+lcdpush_draw_rects(LCDPUSH_Handle_t *hpush, const LCDPUSH_Rect_t *rects, uint16_t num)
+{
+	LCD_Handler_t *hlcd;
+	SPI_Segment_t *seg;
+	uint32_t      length;
+	uint16_t      i;
+	ER            ercd;
+
+	if(hpush == NULL || rects == NULL || num == 0 || num > LCDPUSH_MAX_RECTS)
+		return E_PAR;
+	hlcd = hpush->Init.hlcd;
+	seg  = hpush->seg;
+	for(i = 0 ; i < num ; i++, rects++){
+		length = (uint32_t)rects->width * rects->height;
+		if(rects->buf == NULL || length == 0 || (length & 1) != 0 || (length / 2) > 0xffff)
+			return E_PAR;
+		seg = lcdpush_window(seg, hpush->param[i], rects->x, rects->y, rects->width, rects->height);
+		seg = lcdpush_segment(seg, (const uint32_t *)rects->buf, length / 2, 32, 0, 32, 1);
+	}
+
+	ercd = spi_core_transmit_wait(hlcd->hspi, LCDPUSH_TIMEOUT);
+	if(ercd == E_TMOUT)
+		return ercd;
+	return spi_core_transmit_list(hlcd->hspi, hlcd->cs_sel, hlcd->dcx_no, hpush->seg, num * LCDPUSH_RECT_SEGS);
+}
+
+/*
+ *  塗りつぶし矩形の一括描画
+ *  各矩形のウィンドウ設定の後に画素値の1ワードをフィルDMA(アドレス固定)で
+ *  繰り返し送出するため、画素データをRAMに持たない．LCDPUSH_MAX_RECTSごとに
+ *  一つの記述子リストとして送信し、転送終了まで待って戻る．
+ *  width*heightが奇数の場合の余りの1画素はウィンドウ先頭に折り返して同じ
+ *  画素値を書くため表示に影響しない．
+ *  parameter1  hpush: LCD非同期転送ハンドラへのポインタ
+ *  parameter2  fills: 塗りつぶし矩形の配列
+ *  parameter3  num: 矩形数
+ *  return      ERコード
+ */
+ER
+lcdpush_fill_rects(LCDPUSH_Handle_t *hpush, const LCDPUSH_Fill_t *fills, uint16_t num)
+{
+	LCD_Handler_t *hlcd;
+	SPI_Segment_t *seg;
+	uint32_t      length;
+	uint16_t      i, n;
+	ER            ercd;
+
+	if(hpush == NULL || fills == NULL)
+		return E_PAR;
+	hlcd = hpush->Init.hlcd;
+	ercd = spi_core_transmit_wait(hlcd->hspi, LCDPUSH_TIMEOUT);
+	if(ercd == E_TMOUT)
+		return ercd;
+
+	while(num > 0){
+		seg = hpush->seg;
+		for(i = n = 0 ; i < num && n < LCDPUSH_MAX_RECTS ; i++, fills++){
+			length = ((uint32_t)fills->width * fills->height + 1) / 2;
+			if(length == 0)
+				continue;
+			if(length > 0xffff)
+				return E_PAR;
+			hpush->fill[n] = ((uint32_t)fills->color << 16) | fills->color;
+			seg = lcdpush_window(seg, hpush->param[n], fills->x, fills->y, fills->width, fills->height);
+			seg = lcdpush_segment(seg, &hpush->fill[n], length, 32, 0, 32, 1);
+			seg[-1].flags = SPI_SEG_FILL;
+			n++;
+		}
+		num -= i;
+		if(n > 0){
+			ercd = spi_core_transmit_list(hlcd->hspi, hlcd->cs_sel, hlcd->dcx_no, hpush->seg, n * LCDPUSH_RECT_SEGS);
+			if(ercd != E_OK)
+				return ercd;
+		}
+	}
+	return E_OK;
+}
+
+/*
+ *  塗りつぶし矩形の描画
+ *  parameter1  hpush: LCD非同期転送ハンドラへのポインタ
+ *  parameter2  x: 描画開始X座標
+ *  parameter3  y: 描画開始Y座標
+ *  parameter4  width: 描画幅
+ *  parameter5  height: 描画高さ
+ *  parameter6  color: 画素値(フレームバッファと同じ表現)
+ *  return      ERコード
+ */
+ER
+lcdpush_fill_rect(LCDPUSH_Handle_t *hpush, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color)
+{
+	LCDPUSH_Fill_t fill;
+
+	fill.x      = x;
+	fill.y      = y;
+	fill.width  = width;
+	fill.height = height;
+	fill.color  = color;
+	return lcdpush_fill_rects(hpush, &fill, 1);
+}
+
+/*
+ *  水平線の描画
+ */
+ER
+lcdpush_hline(LCDPUSH_Handle_t *hpush, uint16_t x, uint16_t y, uint16_t length, uint16_t color)
+{
+	return lcdpush_fill_rect(hpush, x, y, length, 1, color);
+}
+
+/*
+ *  垂直線の描画
+ */
+ER
+lcdpush_vline(LCDPUSH_Handle_t *hpush, uint16_t x, uint16_t y, uint16_t length, uint16_t color)
+{
+	return lcdpush_fill_rect(hpush, x, y, 1, length, color);
+}
+
+/*
+ *  画面全体の塗りつぶし
+ */
+ER
+lcdpush_clear(LCDPUSH_Handle_t *hpush, uint16_t color)
+{
+	if(hpush == NULL)
+		return E_PAR;
+	return lcdpush_fill_rect(hpush, 0, 0, hpush->Init.hlcd->_width, hpush->Init.hlcd->_height, color);
+}
+
+/*
+ *  塗りつぶし矩形の追加(高さ0は追加しない)
+ */
+static uint16_t
+lcdpush_add_fill(LCDPUSH_Fill_t *fill, uint16_t n, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color)
+{
+	if(height == 0)
+		return n;
+	fill[n].x      = x;
+	fill[n].y      = y;
+	fill[n].width  = width;
+	fill[n].height = height;
+	fill[n].color  = color;
+	return n + 1;
+}
+
+/*
+ *  バーグラフの描画
+ *  各バーを下端から高さ分の前景色と、最大高さまでの背景色の矩形で描く．
+ *  prevを指定すると前回の高さとの差分の矩形のみ描いてprevを更新する．
+ *  parameter1  hpush: LCD非同期転送ハンドラへのポインタ
+ *  parameter2  bars: バーグラフ設定
+ *  parameter3  height: バーの高さの配列(bars->num個)
+ *  parameter4  prev: 前回の高さの配列(NULLで全体を描画)
+ *  return      ERコード
+ */
+ER
+lcdpush_bars(LCDPUSH_Handle_t *hpush, const LCDPUSH_Bars_t *bars, const uint16_t *height, uint16_t *prev)
+{
+	LCDPUSH_Fill_t fill[LCDPUSH_MAX_RECTS];
+	uint16_t       i, n = 0, h, p, x;
+	ER             ercd;
+
+	if(hpush == NULL || bars == NULL || height == NULL || bars->maxheight > bars->y)
+		return E_PAR;
+
+	for(i = 0 ; i < bars->num ; i++){
+		h = height[i] < bars->maxheight ? height[i] : bars->maxheight;
+		x = bars->x + i * bars->pitch;
+		if(prev == NULL){
+			n = lcdpush_add_fill(fill, n, x, bars->y - bars->maxheight, bars->width, bars->maxheight - h, bars->back);
+			n = lcdpush_add_fill(fill, n, x, bars->y - h, bars->width, h, bars->color);
+		}
+		else{
+			p = prev[i] < bars->maxheight ? prev[i] : bars->maxheight;
+			if(h > p)
+				n = lcdpush_add_fill(fill, n, x, bars->y - h, bars->width, h - p, bars->color);
+			else
+				n = lcdpush_add_fill(fill, n, x, bars->y - p, bars->width, p - h, bars->back);
+			prev[i] = h;
+		}
+		if(n > LCDPUSH_MAX_RECTS - 2){
+			if((ercd = lcdpush_fill_rects(hpush, fill, n)) != E_OK)
+				return ercd;
+			n = 0;
+		}
+	}
+	if(n > 0)
+		return lcdpush_fill_rects(hpush, fill, n);
+	return E_OK;
+}
+
+/*
+ *  LCD非同期転送終了待ち
+ *  parameter1  hpush: LCD非同期転送ハンドラへのポインタ
+ *  parameter2  timeout: タイムアウト時間(ms)
+ *  return      ERコード
+ */
+ER
+lcdpush_wait(LCDPUSH_Handle_t *hpush, uint32_t timeout)
+{
+	if(hpush == NULL)
+		return E_PAR;
+	return spi_core_transmit_wait(hpush->Init.hlcd->hspi, timeout);
+}
+
+/*
+ *  描画用バッファの取得
+ *  parameter1  hpush: LCD非同期転送ハンドラへのポインタ
+ *  return      描画用バッファ、NULLでダブルバッファ未設定
+ */
+uint16_t *
+lcdpush_back_buffer(LCDPUSH_Handle_t *hpush)
+{
+	if(hpush == NULL)
+		return NULL;
+	return hpush->Init.Buffer[hpush->back];
+}
+
+/*
+ *  ダブルバッファの切り替え
+ *  描画用バッファの転送を開始し、もう一方のバッファを描画用とする．
+ *  転送は直列に行うため、戻った時点で新しい描画用バッファの転送は終了している．
+ *  parameter1  hpush: LCD非同期転送ハンドラへのポインタ
+ *  parameter2  x: 描画開始X座標
+ *  parameter3  y: 描画開始Y座標
+ *  parameter4  width: 描画幅
+ *  parameter5  height: 描画高さ
+ *  return      新しい描画用バッファ、NULLでエラー
+ */
+uint16_t *
+lcdpush_swap(LCDPUSH_Handle_t *hpush, uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+	uint16_t *buf = lcdpush_back_buffer(hpush);
+
+	if(buf == NULL || hpush->Init.Buffer[hpush->back ^ 1] == NULL)
+		return NULL;
+	if(lcdpush_draw_async(hpush, x, y, width, height, buf) != E_OK)
+		return NULL;
+	hpush->back ^= 1;
+	return hpush->Init.Buffer[hpush->back];
+}
+
+/*
+ *  表示フレームレートの取得
+ *  前回呼び出しからの転送完了フレーム数で計算する
+ *  実機での計測値は未取得のため、性能評価はこの戻り値で行う
+ *  parameter1  hpush: LCD非同期転送ハンドラへのポインタ
+ *  return      フレームレート(fps×100)
+ */
+uint32_t
+lcdpush_get_fps(LCDPUSH_Handle_t *hpush)
+{
+	SYSUTM   now;
+	uint32_t frames, elapsed;
+
+	if(hpush == NULL)
+		return 0;
+	get_utm(&now);
+	frames  = hpush->frames - hpush->fps_frames;
+	elapsed = (uint32_t)(now - hpush->fps_time);
+	hpush->fps_frames = hpush->frames;
+	hpush->fps_time   = now;
+	if(elapsed == 0)
+		return 0;
+	return (uint32_t)(((uint64_t)frames * 100000000) / elapsed);
+}
@@ -0,0 +1,179 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  LCD非同期フレーム転送のヘッダファイル
+ *
+ *  ウィンドウ設定とRAMWRを同期で送出した後、画素データをSPI-DMAで非同期に
+ *  送出する．転送中は呼び出し側が別のバッファに描画できる．画素データは
+ *  lcd_drawPictureと同じ並び(32ビット単位に2画素)で渡すこと．
+ *  非同期転送中はlcd_xxx関数を呼び出さないこと(lcdpush_waitで終了を待つ)．
+ */
+
+#ifndef _LCD_PUSH_H_
+#define _LCD_PUSH_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "sipeed_st7789.h"
+
+/*
+ *  転送終了待ちのタイムアウト(ms)
+ */
+#ifndef LCDPUSH_TIMEOUT
+#define LCDPUSH_TIMEOUT         500
+#endif
+
+/*
+ *  ST7789コマンド
+ */
+#define LCDPUSH_CMD_CASET       0x2A
+#define LCDPUSH_CMD_RASET       0x2B
+#define LCDPUSH_CMD_RAMWR       0x2C
+
+/*
+ *  一括描画の最大矩形数
+ */
+#ifndef LCDPUSH_MAX_RECTS
+#define LCDPUSH_MAX_RECTS       16
+#endif
+
+#define LCDPUSH_RECT_SEGS       6		/* 矩形あたりのセグメント数 */
+#define LCDPUSH_RECT_WORDS      11		/* 矩形あたりのコマンド/パラメータフレーム数 */
+
+/*
+ *  描画矩形
+ */
+typedef struct {
+	uint16_t        x;				/* 描画開始X座標 */
+	uint16_t        y;				/* 描画開始Y座標 */
+	uint16_t        width;			/* 描画幅 */
+	uint16_t        height;			/* 描画高さ(width*heightは偶数) */
+	uint16_t        *buf;			/* 画素データ(width*height) */
+} LCDPUSH_Rect_t;
+
+/*
+ *  塗りつぶし矩形
+ */
+typedef struct {
+	uint16_t        x;				/* 描画開始X座標 */
+	uint16_t        y;				/* 描画開始Y座標 */
+	uint16_t        width;			/* 描画幅 */
+	uint16_t        height;			/* 描画高さ */
+	uint16_t        color;			/* 画素値(フレームバッファと同じ表現) */
+	uint16_t        dummy;
+} LCDPUSH_Fill_t;
+
+/*
+ *  バーグラフ設定
+ */
+typedef struct {
+	uint16_t        x;				/* 先頭バーの左端X座標 */
+	uint16_t        y;				/* バーの下端Y座標(この行は含まない) */
+	uint16_t        width;			/* バーの幅 */
+	uint16_t        pitch;			/* バーの間隔 */
+	uint16_t        maxheight;		/* バーの最大高さ */
+	uint16_t        num;			/* バーの数 */
+	uint16_t        color;			/* 前景色 */
+	uint16_t        back;			/* 背景色 */
+} LCDPUSH_Bars_t;
+
+struct _LCDPUSH_Handle_t;
+
+/*
+ *  転送終了コールバック(割込みコンテキストで呼び出す)
+ */
+typedef void (*LCDPUSH_Callback_t)(struct _LCDPUSH_Handle_t *hpush, uint16_t *buf);
+
+/*
+ *  LCD非同期転送初期設定
+ */
+typedef struct {
+	LCD_Handler_t   *hlcd;			/* LCDハンドラ(lcd_init済み) */
+	uint16_t        *Buffer[2];		/* ダブルバッファ(NULLでlcdpush_swap未使用) */
+	ID              semid;			/* 転送終了通知セマフォ(0で未使用) */
+	LCDPUSH_Callback_t callback;	/* 転送終了コールバック */
+	intptr_t        exinf;			/* コールバック用拡張情報 */
+} LCDPUSH_Init_t;
+
+/*
+ *  LCD非同期転送ハンドラ
+ */
+typedef struct _LCDPUSH_Handle_t {
+	LCDPUSH_Init_t  Init;
+	uint16_t        *volatile busy;	/* 転送中バッファ */
+	uint8_t         back;			/* 描画用バッファ番号 */
+	uint32_t        DataSize;		/* コマンド送信時のSPI設定 */
+	uint32_t        InstLength;
+	uint32_t        AddrLength;
+	volatile uint32_t frames;		/* 転送完了フレーム数 */
+	volatile uint32_t errors;		/* 転送エラー数 */
+	volatile uint32_t time;			/* 直近の転送時間(μs) */
+	volatile uint32_t maxtime;		/* 最大転送時間(μs) */
+	SYSUTM          start;			/* 転送開始時刻 */
+	SYSUTM          fps_time;		/* fps計測開始時刻 */
+	uint32_t        fps_frames;		/* fps計測開始時のフレーム数 */
+	SPI_Segment_t   seg[LCDPUSH_MAX_RECTS * LCDPUSH_RECT_SEGS];	/* 送信記述子 */
+	uint32_t        param[LCDPUSH_MAX_RECTS][LCDPUSH_RECT_WORDS];	/* コマンド/パラメータ */
+	uint32_t        fill[LCDPUSH_MAX_RECTS];	/* 塗りつぶし画素値 */
+} LCDPUSH_Handle_t;
+
+extern ER lcdpush_init(LCDPUSH_Handle_t *hpush);
+extern ER lcdpush_draw_async(LCDPUSH_Handle_t *hpush, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *buf);
+extern ER lcdpush_draw_rects(LCDPUSH_Handle_t *hpush, const LCDPUSH_Rect_t *rects, uint16_t num);
+extern ER lcdpush_fill_rects(LCDPUSH_Handle_t *hpush, const LCDPUSH_Fill_t *fills, uint16_t num);
+extern ER lcdpush_fill_rect(LCDPUSH_Handle_t *hpush, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color);
+extern ER lcdpush_hline(LCDPUSH_Handle_t *hpush, uint16_t x, uint16_t y, uint16_t length, uint16_t color);
+extern ER lcdpush_vline(LCDPUSH_Handle_t *hpush, uint16_t x, uint16_t y, uint16_t length, uint16_t color);
+extern ER lcdpush_clear(LCDPUSH_Handle_t *hpush, uint16_t color);
+extern ER lcdpush_bars(LCDPUSH_Handle_t *hpush, const LCDPUSH_Bars_t *bars, const uint16_t *height, uint16_t *prev);
+extern ER lcdpush_wait(LCDPUSH_Handle_t *hpush, uint32_t timeout);
+extern uint16_t *lcdpush_back_buffer(LCDPUSH_Handle_t *hpush);
+extern uint16_t *lcdpush_swap(LCDPUSH_Handle_t *hpush, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+extern uint32_t lcdpush_get_fps(LCDPUSH_Handle_t *hpush);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _LCD_PUSH_H_ */
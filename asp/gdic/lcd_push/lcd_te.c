@@ -0,0 +1,266 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  LCD TE(テアリングエフェクト)同期
+ *
+ *  パネルのTE出力をGPIOHSの立上りエッジ割込みで受け、lcd_drawPictureや
+ *  lcdpush_draw_asyncの開始をリフレッシュに合わせる．lcdte_syncは前の
+ *  フレームからInterval回目のTEまで待って戻る．生成側が遅れて目標のTEを
+ *  過ぎた場合は、直近のTEからWindow以内ならすぐに、それ以外はPolicyに従い
+ *  次のTEまで待つか、すぐに開始する．
+ *  画素の書込みがパネルの走査に追い越されないためには、転送時間が
+ *  Interval回のリフレッシュ期間以内であること．
+ */
+#include <kernel.h>
+#include <t_syslog.h>
+#include <sil.h>
+#include "device.h"
+#include "spi.h"
+#include "lcd_te.h"
+
+/*
+ *  GPIOHSエッジ割込みレジスタ
+ */
+#ifndef TOFF_GPIOHS_RISE_IE
+#define TOFF_GPIOHS_RISE_IE     0x0018
+#define TOFF_GPIOHS_RISE_IP     0x001C
+#endif
+
+static LCDTE_Handle_t *lcdte_handle[LCDTE_MAX_GPIOHS];
+
+/*
+ *  TEONコマンドの送出
+ */
+static ER
+lcdte_command(LCD_Handler_t *hlcd, uint8_t cmd, uint8_t mode)
+{
+	SPI_Segment_t seg[2];
+	uint32_t      param[2];
+	ER            ercd;
+
+	param[0] = cmd;
+	param[1] = mode;
+	seg[0].pdata      = &param[0];
+	seg[0].length     = 1;
+	seg[0].DataSize   = 8;
+	seg[0].InstLength = 8;
+	seg[0].AddrLength = 0;
+	seg[0].dcx        = 0;
+	seg[0].flags      = 0;
+	seg[1].pdata      = &param[1];
+	seg[1].length     = 1;
+	seg[1].DataSize   = 8;
+	seg[1].InstLength = 0;
+	seg[1].AddrLength = 8;
+	seg[1].dcx        = 1;
+	seg[1].flags      = 0;
+
+	ercd = spi_core_transmit_wait(hlcd->hspi, LCDTE_TIMEOUT);
+	if(ercd == E_TMOUT)
+		return ercd;
+	return spi_core_transmit_list(hlcd->hspi, hlcd->cs_sel, hlcd->dcx_no, seg, (cmd == LCDTE_CMD_TEON) ? 2 : 1);
+}
+
+/*
+ *  TE同期初期化
+ *  TE入力のGPIOHSを立上りエッジ割込みに設定し、パネルのTE出力を有効にする．
+ *  割込みはコンフィギュレーションでGPIOHS番号を拡張情報としてlcdte_isrを登録すること．
+ *  parameter1  hte: TE同期ハンドラへのポインタ
+ *  return      ERコード
+ */
+ER
+lcdte_init(LCDTE_Handle_t *hte)
+{
+	GPIO_Init_t init = {0};
+	uint32_t    bit;
+
+	if(hte == NULL || hte->Init.Pin < 0 || hte->Init.GpioNum >= LCDTE_MAX_GPIOHS)
+		return E_PAR;
+	if(hte->Init.Interval == 0)
+		hte->Init.Interval = 1;
+
+	hte->count  = 0;
+	hte->stamp  = 0;
+	hte->period = 0;
+	hte->tskid  = TSK_NONE;
+	hte->last   = 0;
+	lcdte_clear_stat(hte);
+	lcdte_handle[hte->Init.GpioNum] = hte;
+
+	fpioa_set_function(hte->Init.Pin, FUNC_GPIOHS0 + hte->Init.GpioNum);
+	init.mode = GPIO_MODE_INPUT;
+	init.pull = GPIO_NOPULL;
+	gpio_setup(TADR_GPIOHS_BASE, &init, hte->Init.GpioNum);
+	bit = 1 << hte->Init.GpioNum;
+	sil_orw_mem((uint32_t *)(TADR_GPIOHS_BASE+TOFF_GPIOHS_RISE_IP), bit);
+	sil_orw_mem((uint32_t *)(TADR_GPIOHS_BASE+TOFF_GPIOHS_RISE_IE), bit);
+
+	/* V-Blankのみ(モード0)でTEを出力させる */
+	if(hte->Init.hlcd != NULL)
+		return lcdte_command(hte->Init.hlcd, LCDTE_CMD_TEON, 0);
+	return E_OK;
+}
+
+/*
+ *  TE同期終了
+ *  parameter1  hte: TE同期ハンドラへのポインタ
+ *  return      ERコード
+ */
+ER
+lcdte_deinit(LCDTE_Handle_t *hte)
+{
+	if(hte == NULL || hte->Init.GpioNum >= LCDTE_MAX_GPIOHS)
+		return E_PAR;
+	sil_andw_mem((uint32_t *)(TADR_GPIOHS_BASE+TOFF_GPIOHS_RISE_IE), 1 << hte->Init.GpioNum);
+	lcdte_handle[hte->Init.GpioNum] = NULL;
+	if(hte->Init.hlcd != NULL)
+		return lcdte_command(hte->Init.hlcd, LCDTE_CMD_TEOFF, 0);
+	return E_OK;
+}
+
+/*
+ *  TE同期
+ *  前のフレームからInterval回目のTEまで待ち、フレームの転送を開始してよい
+ *  時点で戻る．呼び出し後すぐに転送を開始すること．
+ *  parameter1  hte: TE同期ハンドラへのポインタ
+ *  return      ERコード(TEが来ない場合はE_TMOUT)
+ */
+ER
+lcdte_sync(LCDTE_Handle_t *hte)
+{
+	SIL_PRE_LOC;
+	uint32_t count, target, want;
+	SYSUTM   stamp, now, start;
+	ID       tskid;
+	bool_t   woken = false;
+	ER       ercd = E_OK;
+
+	if(hte == NULL)
+		return E_PAR;
+	get_utm(&start);
+	can_wup(TSK_SELF);
+	get_tid(&tskid);
+	hte->tskid = tskid;
+	target = hte->last + hte->Init.Interval;
+	want   = target;
+	for(;;){
+		SIL_LOC_INT();
+		count = hte->count;
+		stamp = hte->stamp;
+		SIL_UNL_INT();
+		get_utm(&now);
+		if((int32_t)(count - want) >= 0){
+			if(woken || (now - stamp) <= hte->Init.Window || hte->Init.Policy == LCDTE_POLICY_LATE)
+				break;
+			/* 直近のTEから時間が経っているため、次のリフレッシュまで待つ */
+			want = count + 1;
+		}
+		ercd = tslp_tsk(LCDTE_TIMEOUT);
+		if(ercd != E_OK)
+			break;
+		woken = true;
+	}
+	hte->tskid = TSK_NONE;
+	if(ercd != E_OK)
+		return ercd;
+
+	if(hte->frames != 0){
+		if(count != target || !woken)
+			hte->late++;
+		if((int32_t)(count - target) > 0)
+			hte->skipped += count - target;
+	}
+	hte->last = count;
+	hte->frames++;
+	hte->wait = (uint32_t)(now - start);
+	if(hte->wait > hte->maxwait)
+		hte->maxwait = hte->wait;
+	return E_OK;
+}
+
+/*
+ *  TE同期統計のクリア
+ *  parameter1  hte: TE同期ハンドラへのポインタ
+ */
+void
+lcdte_clear_stat(LCDTE_Handle_t *hte)
+{
+	hte->frames  = 0;
+	hte->late    = 0;
+	hte->skipped = 0;
+	hte->wait    = 0;
+	hte->maxwait = 0;
+}
+
+/*
+ *  TE割込みサービスルーチン
+ *  parameter1  exinf: TE入力のGPIOHS番号
+ */
+void
+lcdte_isr(intptr_t exinf)
+{
+	LCDTE_Handle_t *hte;
+	uint32_t bit;
+	SYSUTM   now;
+
+	if(exinf < 0 || exinf >= LCDTE_MAX_GPIOHS)
+		return;
+	/* 立上りエッジの要求をクリアする */
+	bit = 1 << exinf;
+	sil_andw_mem((uint32_t *)(TADR_GPIOHS_BASE+TOFF_GPIOHS_RISE_IE), bit);
+	sil_orw_mem((uint32_t *)(TADR_GPIOHS_BASE+TOFF_GPIOHS_RISE_IP), bit);
+	sil_orw_mem((uint32_t *)(TADR_GPIOHS_BASE+TOFF_GPIOHS_RISE_IE), bit);
+
+	if((hte = lcdte_handle[exinf]) == NULL)
+		return;
+	get_utm(&now);
+	if(hte->count != 0){
+		if(hte->period == 0)
+			hte->period = (uint32_t)(now - hte->stamp);
+		else
+			hte->period = (hte->period * 7 + (uint32_t)(now - hte->stamp)) / 8;
+	}
+	hte->stamp = now;
+	hte->count++;
+	if(hte->tskid != TSK_NONE)
+		iwup_tsk(hte->tskid);
+}
@@ -0,0 +1,115 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  LCD TE(テアリングエフェクト)同期のヘッダファイル
+ */
+
+#ifndef _LCD_TE_H_
+#define _LCD_TE_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "sipeed_st7789.h"
+
+/*
+ *  ST7789コマンド
+ */
+#define LCDTE_CMD_TEOFF         0x34
+#define LCDTE_CMD_TEON          0x35
+
+/*
+ *  TE待ちのタイムアウト(ms)
+ */
+#ifndef LCDTE_TIMEOUT
+#define LCDTE_TIMEOUT           100
+#endif
+
+#define LCDTE_MAX_GPIOHS        32		/* GPIOHS数 */
+
+/*
+ *  遅れたフレームの扱い
+ */
+#define LCDTE_POLICY_SKIP       0		/* 次のTEまで待つ(表示は前のフレームを繰り返す) */
+#define LCDTE_POLICY_LATE       1		/* すぐに開始する(テアリングの可能性あり) */
+
+/*
+ *  TE同期初期設定
+ */
+typedef struct {
+	LCD_Handler_t   *hlcd;			/* LCDハンドラ(lcd_init済み、NULLでTEONを送らない) */
+	int8_t          Pin;			/* TE入力のピン番号 */
+	uint8_t         GpioNum;		/* TE入力のGPIOHS番号 */
+	uint8_t         Interval;		/* フレームあたりのリフレッシュ数(1以上) */
+	uint8_t         Policy;			/* 遅れたフレームの扱い */
+	uint32_t        Window;			/* TE後に開始を許す時間(us) */
+} LCDTE_Init_t;
+
+/*
+ *  TE同期ハンドラ
+ */
+typedef struct {
+	LCDTE_Init_t    Init;
+	volatile uint32_t count;		/* TE検出回数 */
+	volatile SYSUTM stamp;			/* 直近のTE時刻 */
+	volatile uint32_t period;		/* TE周期(us、移動平均) */
+	volatile ID     tskid;			/* TE待ちタスク */
+	uint32_t        last;			/* 直前のフレームを開始したTE番号 */
+	uint32_t        frames;			/* 開始フレーム数 */
+	uint32_t        late;			/* 目標のTEで開始できなかったフレーム数 */
+	uint32_t        skipped;		/* 新しいフレームのないリフレッシュ数 */
+	uint32_t        wait;			/* 直近のTE待ち時間(us) */
+	uint32_t        maxwait;		/* 最大TE待ち時間(us) */
+} LCDTE_Handle_t;
+
+extern ER lcdte_init(LCDTE_Handle_t *hte);
+extern ER lcdte_deinit(LCDTE_Handle_t *hte);
+extern ER lcdte_sync(LCDTE_Handle_t *hte);
+extern void lcdte_clear_stat(LCDTE_Handle_t *hte);
+extern void lcdte_isr(intptr_t exinf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _LCD_TE_H_ */
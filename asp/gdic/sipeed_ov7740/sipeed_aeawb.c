@@ -0,0 +1,181 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  ソフトウェア自動露出・ホワイトバランス
+ *
+ *  センサー内蔵のAEC/AGC/AWBを停止し、フレーム統計から露光・ゲイン・
+ *  WBゲインを直接設定する．OV7740とGC0328で同じ収束特性となる．
+ */
+#include <kernel.h>
+#include <t_syslog.h>
+#include "sipeed_aeawb.h"
+
+#define AE_HIGHLIGHT_RATIO      16		/* 白飛びが1/16を超えたら減光 */
+#define AWB_MIN_Y               32		/* AWBを行う平均輝度の範囲 */
+#define AWB_MAX_Y               224
+#define AWB_GAIN_MIN            (SENSOR_WB_UNIT / 2)
+#define AWB_GAIN_MAX            0xFF
+
+/*
+ *  目標値へ3/4だけ近づける(振動防止)、1回の変化は1/4-4倍に制限
+ */
+static uint32_t
+aeawb_damp(uint32_t cur, uint32_t target)
+{
+	if(target > cur * 4)
+		target = cur * 4;
+	else if(target < cur / 4)
+		target = cur / 4;
+	return (cur + target * 3 + 2) / 4;
+}
+
+/*
+ *  AE/AWB初期化
+ *  parameter1  hae: AE/AWBハンドラへのポインタ
+ *  parameter2  hcmr: カメラハンドラへのポインタ
+ *  return      ERコード
+ *  現在のセンサー露出を初期値として手動制御に切り替える．
+ */
+ER
+aeawb_init(AEAWB_Handle_t *hae, OV7740_t *hcmr)
+{
+	AEAWB_Init_t *init;
+	ER ercd;
+
+	if(hae == NULL || hcmr == NULL)
+		return E_PAR;
+	init = &hae->Init;
+	if(init->TargetY == 0 || init->ExpMin == 0 || init->ExpMin > init->ExpMax)
+		return E_PAR;
+	if(init->GainMax < SENSOR_GAIN_UNIT || init->GainMax > SENSOR_GAIN_MAX)
+		return E_PAR;
+
+	hae->hcmr = hcmr;
+	ercd = ov7740_get_manual_exposure(hcmr, &hae->exposure, &hae->gain);
+	if(ercd != E_OK)
+		return ercd;
+	if(hae->exposure < init->ExpMin)
+		hae->exposure = init->ExpMin;
+	else if(hae->exposure > init->ExpMax)
+		hae->exposure = init->ExpMax;
+	if(hae->gain > init->GainMax)
+		hae->gain = init->GainMax;
+	hae->rgain   = SENSOR_WB_UNIT;
+	hae->ggain   = SENSOR_WB_UNIT;
+	hae->bgain   = SENSOR_WB_UNIT;
+	hae->meanY   = 0;
+	hae->settled = false;
+	hae->frames  = 0;
+	ercd = ov7740_set_manual_exposure(hcmr, hae->exposure, hae->gain);
+	if(ercd == E_OK && init->AutoWB)
+		ercd = ov7740_set_manual_whitebal(hcmr, hae->rgain, hae->ggain, hae->bgain);
+	return ercd;
+}
+
+/*
+ *  AE/AWB更新
+ *  parameter1  hae: AE/AWBハンドラへのポインタ
+ *  parameter2  st: 直近フレームの統計
+ *  return      ERコード
+ *  露光×ゲインの総量を目標輝度との比で補正し、露光を優先して
+ *  不足分をゲインで補う．
+ */
+ER
+aeawb_update(AEAWB_Handle_t *hae, const IMAGE_Stats_t *st)
+{
+	AEAWB_Init_t *init = &hae->Init;
+	uint32_t mean, total, target, exposure, gain;
+	uint32_t mr, mg, mb, r, b;
+	ER ercd = E_OK;
+
+	if(st == NULL || st->count == 0)
+		return E_PAR;
+	hae->frames++;
+	mean = st->sum_y / st->count;
+	hae->meanY = mean;
+	if(st->over > st->count / AE_HIGHLIGHT_RATIO && mean < (uint32_t)init->TargetY * 2)
+		mean = init->TargetY * 2;	/* 白飛び時は輝度が飽和しているため強めに減光 */
+
+	if(mean + init->Tolerance >= init->TargetY && mean <= (uint32_t)init->TargetY + init->Tolerance)
+		hae->settled = true;
+	else{
+		hae->settled = false;
+		total  = (uint32_t)hae->exposure * hae->gain;
+		target = total * init->TargetY / (mean ? mean : 1);
+		total  = aeawb_damp(total, target);
+		exposure = total / SENSOR_GAIN_UNIT;
+		if(exposure > init->ExpMax)
+			exposure = init->ExpMax;
+		else if(exposure < init->ExpMin)
+			exposure = init->ExpMin;
+		gain = total / exposure;
+		if(gain < SENSOR_GAIN_UNIT)
+			gain = SENSOR_GAIN_UNIT;
+		else if(gain > init->GainMax)
+			gain = init->GainMax;
+		if(exposure != hae->exposure || gain != hae->gain){
+			hae->exposure = exposure;
+			hae->gain     = gain;
+			ercd = ov7740_set_manual_exposure(hae->hcmr, exposure, gain);
+			if(ercd != E_OK)
+				return ercd;
+		}
+	}
+
+	if(init->AutoWB && hae->meanY >= AWB_MIN_Y && hae->meanY <= AWB_MAX_Y){
+		mr = st->sum_r / st->count;
+		mg = st->sum_g / st->count;
+		mb = st->sum_b / st->count;
+		if(mr == 0 || mb == 0)
+			return ercd;
+		r = aeawb_damp(hae->rgain, hae->rgain * mg / mr);
+		b = aeawb_damp(hae->bgain, hae->bgain * mg / mb);
+		r = (r < AWB_GAIN_MIN) ? AWB_GAIN_MIN : ((r > AWB_GAIN_MAX) ? AWB_GAIN_MAX : r);
+		b = (b < AWB_GAIN_MIN) ? AWB_GAIN_MIN : ((b > AWB_GAIN_MAX) ? AWB_GAIN_MAX : b);
+		if(r != hae->rgain || b != hae->bgain){
+			hae->rgain = r;
+			hae->bgain = b;
+			ercd = ov7740_set_manual_whitebal(hae->hcmr, hae->rgain, hae->ggain, hae->bgain);
+		}
+	}
+	return ercd;
+}
@@ -0,0 +1,92 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  ソフトウェア自動露出・ホワイトバランスのヘッダファイル
+ *  (gdic/image_kernelのフレーム統計を使用)
+ */
+
+#ifndef _SIPEED_AEAWB_H_
+#define _SIPEED_AEAWB_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "sipeed_ov7740.h"
+#include "image_kernel.h"
+
+/*
+ *  AE/AWB初期設定
+ */
+typedef struct {
+	uint8_t         TargetY;		/* 目標平均輝度 */
+	uint8_t         Tolerance;		/* 目標輝度の許容幅 */
+	uint16_t        ExpMin;			/* 最小露光(ライン数) */
+	uint16_t        ExpMax;			/* 最大露光(ライン数) */
+	uint16_t        GainMax;		/* 最大ゲイン(SENSOR_GAIN_UNITで1倍) */
+	bool_t          AutoWB;			/* 灰色仮説によるAWBを行う */
+} AEAWB_Init_t;
+
+/*
+ *  AE/AWBハンドラ
+ */
+typedef struct {
+	AEAWB_Init_t    Init;
+	OV7740_t        *hcmr;
+	uint16_t        exposure;		/* 現在の露光(ライン数) */
+	uint16_t        gain;			/* 現在のゲイン */
+	uint8_t         rgain;			/* 現在のWBゲイン */
+	uint8_t         ggain;
+	uint8_t         bgain;
+	uint8_t         meanY;			/* 直近フレームの平均輝度 */
+	bool_t          settled;		/* 露出が目標範囲内 */
+	uint32_t        frames;			/* 処理フレーム数 */
+} AEAWB_Handle_t;
+
+extern ER aeawb_init(AEAWB_Handle_t *hae, OV7740_t *hcmr);
+extern ER aeawb_update(AEAWB_Handle_t *hae, const IMAGE_Stats_t *st);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _SIPEED_AEAWB_H_ */
@@ -0,0 +1,197 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  カメラパイプライン計測
+ *
+ *  DVP取り込み開始からフレーム終了、変換、LCD転送完了までの時刻を
+ *  フレームごとにリングバッファへ記録し、定期的にサマリを出力する．
+ */
+#include <kernel.h>
+#include <t_syslog.h>
+#include <string.h>
+#include "sipeed_camstat.h"
+
+/*
+ *  計測初期化
+ *  parameter1  hst: 計測ハンドラへのポインタ
+ *  parameter2  report_ms: サマリ出力間隔(ms)、0で出力しない
+ */
+void
+camstat_init(CAMSTAT_Handle_t *hst, uint32_t report_ms)
+{
+	memset(hst, 0, sizeof(CAMSTAT_Handle_t));
+	hst->report_us = report_ms * 1000;
+	get_utm(&hst->last_report);
+}
+
+/*
+ *  フレーム取り込み結果の記録
+ *  parameter1  hst: 計測ハンドラへのポインタ
+ *  parameter2  hdvp: DVPハンドラへのポインタ
+ *  parameter3  ercd: ov7740_snapshotの戻り値
+ *  ov7740_snapshotの直後に呼び出す．
+ */
+void
+camstat_frame(CAMSTAT_Handle_t *hst, DVP_Handle_t *hdvp, ER ercd)
+{
+	DVP_FrameInfo_t info;
+	CAMSTAT_Record_t *rec;
+	uint32_t starts, captures;
+
+	hst->cur = NULL;
+	if(ercd != E_OK){
+		if(ercd == E_TMOUT){
+			hst->timeouts++;
+			hst->per_timeouts++;
+		}
+		else
+			hst->errors++;
+		return;
+	}
+	if(dvp_get_frameinfo(hdvp, &info) != E_OK)
+		return;
+
+	/* 前回から開始したセンサーフレームのうち取り込まなかった数 */
+	starts   = info.start_count - hst->last_start;
+	captures = info.capture_count - hst->last_capture;
+	if(hst->frames != 0 && starts > captures){
+		hst->drops     += starts - captures;
+		hst->per_drops += starts - captures;
+	}
+	hst->last_start   = info.start_count;
+	hst->last_capture = info.capture_count;
+
+	rec = &hst->ring[hst->head & (CAMSTAT_RING_SIZE-1)];
+	rec->frame   = info.capture_count;
+	rec->start   = info.capture_time;
+	rec->finish  = (uint32_t)(info.finish_time - info.capture_time);
+	rec->convert = 0;
+	rec->display = 0;
+	hst->cur = rec;
+}
+
+/*
+ *  計測ポイントの記録
+ *  parameter1  hst: 計測ハンドラへのポインタ
+ *  parameter2  point: CAMSTAT_CONVERTまたはCAMSTAT_DISPLAY
+ */
+void
+camstat_mark(CAMSTAT_Handle_t *hst, int point)
+{
+	SYSUTM now;
+	uint32_t t;
+
+	if(hst->cur == NULL)
+		return;
+	get_utm(&now);
+	t = (uint32_t)(now - hst->cur->start);
+	if(point == CAMSTAT_CONVERT)
+		hst->cur->convert = t;
+	else
+		hst->cur->display = t;
+}
+
+/*
+ *  フレーム処理完了
+ *  parameter1  hst: 計測ハンドラへのポインタ
+ *  集計を行い、サマリ出力間隔を過ぎていればシリアルに出力する．
+ */
+void
+camstat_done(CAMSTAT_Handle_t *hst)
+{
+	CAMSTAT_Record_t *rec = hst->cur;
+	SYSUTM now;
+	uint32_t elapsed, n, fps;
+
+	if(rec != NULL){
+		hst->head++;
+		hst->frames++;
+		hst->per_frames++;
+		hst->per_finish  += rec->finish;
+		hst->per_convert += rec->convert;
+		hst->per_display += rec->display;
+		if(rec->display > hst->per_max)
+			hst->per_max = rec->display;
+		hst->cur = NULL;
+	}
+	if(hst->report_us == 0)
+		return;
+	get_utm(&now);
+	elapsed = (uint32_t)(now - hst->last_report);
+	if(elapsed < hst->report_us)
+		return;
+
+	n = hst->per_frames;
+	fps = (uint32_t)((uint64_t)n * 100000000 / elapsed);
+	syslog_5(LOG_NOTICE, "camstat fps(%u.%02u) frames(%u) drops(%u) timeouts(%u)",
+				fps / 100, fps % 100, n, hst->per_drops, hst->per_timeouts);
+	if(n != 0)
+		syslog_4(LOG_NOTICE, "camstat avg(us) capture(%u) convert(%u) display(%u) max(%u)",
+				(uint32_t)(hst->per_finish / n), (uint32_t)(hst->per_convert / n),
+				(uint32_t)(hst->per_display / n), hst->per_max);
+	hst->per_frames   = 0;
+	hst->per_drops    = 0;
+	hst->per_timeouts = 0;
+	hst->per_finish   = 0;
+	hst->per_convert  = 0;
+	hst->per_display  = 0;
+	hst->per_max      = 0;
+	hst->last_report  = now;
+}
+
+/*
+ *  フレーム記録の取り出し
+ *  parameter1  hst: 計測ハンドラへのポインタ
+ *  parameter2  back: 何フレーム前か(0で最新)
+ *  parameter3  rec: 記録を返す領域へのポインタ
+ *  return      ERコード
+ */
+ER
+camstat_get(CAMSTAT_Handle_t *hst, uint32_t back, CAMSTAT_Record_t *rec)
+{
+	if(rec == NULL)
+		return E_PAR;
+	if(back >= CAMSTAT_RING_SIZE || back >= hst->frames)
+		return E_OBJ;
+	*rec = hst->ring[(hst->head - 1 - back) & (CAMSTAT_RING_SIZE-1)];
+	return E_OK;
+}
@@ -0,0 +1,110 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  カメラパイプライン計測のヘッダファイル
+ */
+
+#ifndef _SIPEED_CAMSTAT_H_
+#define _SIPEED_CAMSTAT_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "kernel.h"
+#include "dvp.h"
+#include "dvp_ext.h"
+
+#define CAMSTAT_RING_SIZE       32		/* 記録フレーム数(2のべき乗) */
+
+/*
+ *  計測ポイント
+ */
+#define CAMSTAT_CONVERT         0		/* 変換完了 */
+#define CAMSTAT_DISPLAY         1		/* LCD転送完了 */
+
+/*
+ *  フレーム記録(時刻は取り込み開始からのμs)
+ */
+typedef struct {
+	uint32_t        frame;			/* 取り込みフレーム番号 */
+	SYSUTM          start;			/* DVP取り込み開始時刻 */
+	uint32_t        finish;			/* DVPフレーム終了 */
+	uint32_t        convert;		/* 変換完了 */
+	uint32_t        display;		/* LCD転送完了 */
+} CAMSTAT_Record_t;
+
+/*
+ *  計測ハンドラ
+ */
+typedef struct {
+	CAMSTAT_Record_t ring[CAMSTAT_RING_SIZE];
+	uint32_t        head;			/* 次の記録位置 */
+	CAMSTAT_Record_t *cur;			/* 計測中のフレーム */
+	uint32_t        frames;			/* 処理フレーム数 */
+	uint32_t        drops;			/* 取り込まれなかったセンサーフレーム数 */
+	uint32_t        timeouts;		/* E_TMOUT回数 */
+	uint32_t        errors;			/* その他のエラー回数 */
+	uint32_t        report_us;		/* サマリ出力間隔(0で出力しない) */
+	SYSUTM          last_report;
+	uint32_t        last_start;		/* 前回のDVPフレーム開始回数 */
+	uint32_t        last_capture;	/* 前回のDVP取り込み回数 */
+	uint32_t        per_frames;		/* 以下、サマリ区間の集計 */
+	uint32_t        per_drops;
+	uint32_t        per_timeouts;
+	uint64_t        per_finish;
+	uint64_t        per_convert;
+	uint64_t        per_display;
+	uint32_t        per_max;
+} CAMSTAT_Handle_t;
+
+extern void camstat_init(CAMSTAT_Handle_t *hst, uint32_t report_ms);
+extern void camstat_frame(CAMSTAT_Handle_t *hst, DVP_Handle_t *hdvp, ER ercd);
+extern void camstat_mark(CAMSTAT_Handle_t *hst, int point);
+extern void camstat_done(CAMSTAT_Handle_t *hst);
+extern ER camstat_get(CAMSTAT_Handle_t *hst, uint32_t back, CAMSTAT_Record_t *rec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _SIPEED_CAMSTAT_H_ */
@@ -0,0 +1,240 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  参照カウント付きフレームバッファプール
+ *
+ *  取り込んだフレームを複数の利用者(LCD表示、符号化、解析など)で
+ *  コピーせずに共有する．各利用者はframepool_acquireで参照を得て、
+ *  処理後にframepool_releaseで返却する．最後の参照が返却された
+ *  フレームは空きとなり、次の取り込みに使用される．
+ */
+#include <kernel.h>
+#include <t_syslog.h>
+#include <sil.h>
+#include "device.h"
+#include "dvp_ext.h"
+#include "sipeed_framepool.h"
+
+/*
+ *  フレームプール初期化
+ *  parameter1  hfp: フレームプールハンドラへのポインタ
+ *  parameter2  area: プール領域(8バイト境界)
+ *  parameter3  size: プール領域サイズ
+ *  return      ERコード
+ */
+ER
+framepool_init(FRAMEPOOL_Handle_t *hfp, void *area, uint32_t size)
+{
+	uint32_t fsize, i;
+	uint8_t  *p = (uint8_t *)area;
+
+	if(hfp == NULL || area == NULL || ((uintptr_t)area & 7) != 0)
+		return E_PAR;
+	if(hfp->Init.NumFrames == 0 || hfp->Init.NumFrames > FRAMEPOOL_MAX)
+		return E_PAR;
+	if(hfp->Init.Width == 0 || hfp->Init.Height == 0)
+		return E_PAR;
+	if(size < FRAMEPOOL_SIZE(hfp->Init.Width, hfp->Init.Height, hfp->Init.NumFrames))
+		return E_NOMEM;
+
+	fsize = FRAMEPOOL_SIZE(hfp->Init.Width, hfp->Init.Height, 1);
+	for(i = 0 ; i < FRAMEPOOL_MAX ; i++){
+		hfp->frame[i].buf    = (i < hfp->Init.NumFrames) ? (uint32_t *)(p + fsize * i) : NULL;
+		hfp->frame[i].width  = hfp->Init.Width;
+		hfp->frame[i].height = hfp->Init.Height;
+		hfp->frame[i].format = PIXFORMAT_RGB565;
+		hfp->frame[i].seq    = 0;
+		hfp->frame[i].time   = 0;
+		hfp->frame[i].ref    = 0;
+		hfp->frame[i].index  = i;
+	}
+	hfp->seq   = 0;
+	hfp->waits = 0;
+	hfp->used  = 0;
+	hfp->peak  = 0;
+	return E_OK;
+}
+
+/*
+ *  空きフレームの取得
+ *  parameter1  hfp: フレームプールハンドラへのポインタ
+ *  parameter2  tmout: タイムアウト時間(ms)
+ *  return      フレームへのポインタ、空きが無い場合はNULL
+ *  取得したフレームの参照カウントは1となる．
+ */
+FRAME_t *
+framepool_get(FRAMEPOOL_Handle_t *hfp, TMO tmout)
+{
+	FRAME_t *frame = NULL;
+	uint32_t i;
+	bool_t   wait = false;
+	SIL_PRE_LOC;
+
+	if(hfp == NULL)
+		return NULL;
+	if(hfp->Init.semid != 0){
+		if(twai_sem(hfp->Init.semid, tmout) != E_OK)
+			return NULL;
+	}
+	for(;;){
+		SIL_LOC_INT();
+		for(i = 0 ; i < hfp->Init.NumFrames ; i++){
+			if(hfp->frame[i].ref == 0){
+				frame = &hfp->frame[i];
+				frame->ref = 1;
+				if(++hfp->used > hfp->peak)
+					hfp->peak = hfp->used;
+				break;
+			}
+		}
+		if(frame == NULL && !wait){
+			hfp->waits++;
+			wait = true;
+		}
+		SIL_UNL_INT();
+		if(frame != NULL || hfp->Init.semid != 0 || tmout == TMO_POL)
+			break;
+		if(tmout != TMO_FEVR && --tmout <= 0)
+			break;
+		dly_tsk(1);
+	}
+	return frame;
+}
+
+/*
+ *  空きフレームへのスナップショット取り込み
+ *  parameter1  hfp: フレームプールハンドラへのポインタ
+ *  parameter2  hcmr: カメラハンドラへのポインタ
+ *  parameter3  frame: 取り込んだフレームを返す領域へのポインタ
+ *  parameter4  tmout: 空きフレーム待ちのタイムアウト時間(ms)
+ *  return      ERコード
+ *  DVPの出力先を空きフレームに切り替えて取り込む．成功時は参照カウント
+ *  1のフレームを返す．
+ */
+ER
+framepool_capture(FRAMEPOOL_Handle_t *hfp, OV7740_t *hcmr, FRAME_t **frame, TMO tmout)
+{
+	FRAME_t *f;
+	ER      ercd;
+
+	if(hfp == NULL || hcmr == NULL || frame == NULL)
+		return E_PAR;
+	*frame = NULL;
+	if(hcmr->_width != hfp->Init.Width || hcmr->_height != hfp->Init.Height)
+		return E_OBJ;
+	if((f = framepool_get(hfp, tmout)) == NULL)
+		return E_TMOUT;
+
+	if(hcmr->_dataBuffer != f->buf){
+		hcmr->_dataBuffer = f->buf;
+		hcmr->hdvp->Init.RGBAddr = DVP_BUS_ADDR(f->buf);
+		dvp_set_output_addr(hcmr->hdvp);
+	}
+	ercd = ov7740_snapshot(hcmr);
+	if(ercd != E_OK){
+		framepool_release(hfp, f);
+		return ercd;
+	}
+	f->format = hcmr->pixFormat;
+	f->seq    = ++hfp->seq;
+	get_utm(&f->time);
+	*frame = f;
+	return E_OK;
+}
+
+/*
+ *  フレーム参照の追加
+ *  parameter1  hfp: フレームプールハンドラへのポインタ
+ *  parameter2  frame: フレームへのポインタ
+ *  return      ERコード
+ */
+ER
+framepool_acquire(FRAMEPOOL_Handle_t *hfp, FRAME_t *frame)
+{
+	ER ercd = E_OK;
+	SIL_PRE_LOC;
+
+	if(hfp == NULL || frame == NULL || frame->index >= hfp->Init.NumFrames
+		|| frame != &hfp->frame[frame->index])
+		return E_PAR;
+	SIL_LOC_INT();
+	if(frame->ref == 0 || frame->ref == 0xFF)
+		ercd = E_OBJ;
+	else
+		frame->ref++;
+	SIL_UNL_INT();
+	return ercd;
+}
+
+/*
+ *  フレーム参照の返却
+ *  parameter1  hfp: フレームプールハンドラへのポインタ
+ *  parameter2  frame: フレームへのポインタ
+ *  return      ERコード
+ *  割込みハンドラ(DMA完了など)からも呼び出すことができる．
+ */
+ER
+framepool_release(FRAMEPOOL_Handle_t *hfp, FRAME_t *frame)
+{
+	bool_t freed = false;
+	ER     ercd = E_OK;
+	SIL_PRE_LOC;
+
+	if(hfp == NULL || frame == NULL || frame->index >= hfp->Init.NumFrames
+		|| frame != &hfp->frame[frame->index])
+		return E_PAR;
+	SIL_LOC_INT();
+	if(frame->ref == 0)
+		ercd = E_OBJ;
+	else if(--frame->ref == 0){
+		hfp->used--;
+		freed = true;
+	}
+	SIL_UNL_INT();
+	if(freed && hfp->Init.semid != 0){
+		if(sns_ctx())
+			isig_sem(hfp->Init.semid);
+		else
+			sig_sem(hfp->Init.semid);
+	}
+	return ercd;
+}
@@ -0,0 +1,113 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  参照カウント付きフレームバッファプールのヘッダファイル
+ */
+
+#ifndef _SIPEED_FRAMEPOOL_H_
+#define _SIPEED_FRAMEPOOL_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "sipeed_ov7740.h"
+
+/*
+ *  プールの最大フレーム数
+ */
+#define FRAMEPOOL_MAX           4
+
+/*
+ *  フレーム
+ *  ov7740_snapshot後の並び(SENSOR_PIXEL)で格納される．参照者が複数の
+ *  間は読み出し専用とし、変更は参照カウントが1の所有者のみ行うこと．
+ */
+typedef struct {
+	uint32_t        *buf;			/* 画素データ */
+	uint16_t        width;			/* 幅 */
+	uint16_t        height;			/* 高さ */
+	pixformat_t     format;			/* ピクセルフォーマット */
+	uint32_t        seq;			/* フレーム番号 */
+	SYSUTM          time;			/* 取り込み完了時刻(μs) */
+	volatile uint8_t ref;			/* 参照カウント、0で空き */
+	uint8_t         index;			/* プール内インデックス */
+} FRAME_t;
+
+/*
+ *  フレームプール初期設定
+ */
+typedef struct {
+	uint16_t        Width;			/* フレーム幅 */
+	uint16_t        Height;			/* フレーム高さ */
+	uint8_t         NumFrames;		/* フレーム数(1-FRAMEPOOL_MAX) */
+	ID              semid;			/* 空きフレーム計数セマフォ(0でポーリング) */
+} FRAMEPOOL_Init_t;
+
+/*
+ *  フレームプールハンドラ
+ */
+typedef struct {
+	FRAMEPOOL_Init_t Init;
+	FRAME_t         frame[FRAMEPOOL_MAX];
+	uint32_t        seq;			/* 取り込みフレーム番号 */
+	uint32_t        waits;			/* 空き待ち回数 */
+	uint8_t         used;			/* 使用中フレーム数 */
+	uint8_t         peak;			/* 使用中フレーム数の最大値 */
+} FRAMEPOOL_Handle_t;
+
+/*
+ *  プール領域の必要サイズ(バイト)
+ */
+#define FRAMEPOOL_SIZE(w, h, n) ((uint32_t)(w) * (h) * 2 * (n))
+
+extern ER framepool_init(FRAMEPOOL_Handle_t *hfp, void *area, uint32_t size);
+extern FRAME_t *framepool_get(FRAMEPOOL_Handle_t *hfp, TMO tmout);
+extern ER framepool_capture(FRAMEPOOL_Handle_t *hfp, OV7740_t *hcmr, FRAME_t **frame, TMO tmout);
+extern ER framepool_acquire(FRAMEPOOL_Handle_t *hfp, FRAME_t *frame);
+extern ER framepool_release(FRAMEPOOL_Handle_t *hfp, FRAME_t *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _SIPEED_FRAMEPOOL_H_ */
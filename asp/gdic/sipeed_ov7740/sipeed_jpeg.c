@@ -0,0 +1,603 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  SIPEED OV7740/GC0328 CAMERA用ソフトウェアJPEGエンコーダ
+ *
+ *  ベースラインJPEG(4:2:2、16x8 MCU)を固定小数点演算で生成する．
+ *  フレーム全体の変換バッファは持たず、MCU単位のタイルを
+ *  _dataBufferから直接切り出して符号化する．
+ */
+#include <kernel.h>
+#include <t_syslog.h>
+#include <stddef.h>
+#include <string.h>
+#include "sipeed_ov7740.h"
+
+#define JPEG_DEFAULT_QUALITY    80
+
+#define CONST_BITS              13
+#define PASS1_BITS              2
+#define DESCALE(x, n)           (((x) + (1 << ((n)-1))) >> (n))
+
+#define FIX_0_298631336         2446
+#define FIX_0_390180644         3196
+#define FIX_0_541196100         4433
+#define FIX_0_765366865         6270
+#define FIX_0_899976223         7373
+#define FIX_1_175875602         9633
+#define FIX_1_501321110         12299
+#define FIX_1_847759065         15137
+#define FIX_1_961570560         16069
+#define FIX_2_053119869         16819
+#define FIX_2_562915447         20995
+#define FIX_3_072711026         25172
+
+#define HUFF_DC_LUM             0
+#define HUFF_AC_LUM             1
+#define HUFF_DC_CHR             2
+#define HUFF_AC_CHR             3
+
+/*
+ *  ビット出力
+ */
+typedef struct {
+	uint8_t         *buf;
+	uint32_t        size;
+	uint32_t        pos;
+	uint32_t        bitbuf;
+	int             bitcnt;
+	bool_t          overflow;
+} JPEG_Writer_t;
+
+static const uint8_t jpeg_zigzag[64] = {
+	 0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+	12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+	35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+	58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+};
+
+static const uint8_t jpeg_std_lum_qt[64] = {
+	16, 11, 10, 16,  24,  40,  51,  61,
+	12, 12, 14, 19,  26,  58,  60,  55,
+	14, 13, 16, 24,  40,  57,  69,  56,
+	14, 17, 22, 29,  51,  87,  80,  62,
+	18, 22, 37, 56,  68, 109, 103,  77,
+	24, 35, 55, 64,  81, 104, 113,  92,
+	49, 64, 78, 87, 103, 121, 120, 101,
+	72, 92, 95, 98, 112, 100, 103,  99
+};
+
+static const uint8_t jpeg_std_chr_qt[64] = {
+	17, 18, 24, 47, 99, 99, 99, 99,
+	18, 21, 26, 66, 99, 99, 99, 99,
+	24, 26, 56, 99, 99, 99, 99, 99,
+	47, 66, 99, 99, 99, 99, 99, 99,
+	99, 99, 99, 99, 99, 99, 99, 99,
+	99, 99, 99, 99, 99, 99, 99, 99,
+	99, 99, 99, 99, 99, 99, 99, 99,
+	99, 99, 99, 99, 99, 99, 99, 99
+};
+
+/*
+ *  標準ハフマンテーブル(ITU-T T.81 Annex K.3)
+ */
+static const uint8_t jpeg_dc_lum_bits[16] = {
+	0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0
+};
+static const uint8_t jpeg_dc_chr_bits[16] = {
+	0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0
+};
+static const uint8_t jpeg_dc_val[12] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11
+};
+static const uint8_t jpeg_ac_lum_bits[16] = {
+	0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d
+};
+static const uint8_t jpeg_ac_lum_val[162] = {
+	0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+	0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+	0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+	0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+	0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+	0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+	0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+	0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+	0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+	0xf9, 0xfa
+};
+static const uint8_t jpeg_ac_chr_bits[16] = {
+	0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77
+};
+static const uint8_t jpeg_ac_chr_val[162] = {
+	0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+	0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+	0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+	0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+	0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+	0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+	0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+	0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+	0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+	0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+	0xf9, 0xfa
+};
+
+static const uint8_t *const jpeg_huff_bits[4] = {
+	jpeg_dc_lum_bits, jpeg_ac_lum_bits, jpeg_dc_chr_bits, jpeg_ac_chr_bits
+};
+static const uint8_t *const jpeg_huff_val[4] = {
+	jpeg_dc_val, jpeg_ac_lum_val, jpeg_dc_val, jpeg_ac_chr_val
+};
+
+static uint16_t jpeg_huff_code[4][256];
+static uint8_t  jpeg_huff_size[4][256];
+static bool_t   jpeg_huff_ready;
+
+static uint8_t  jpeg_qt[2][64];			/* 量子化テーブル(ジグザグ順) */
+static uint16_t jpeg_recip[2][64];		/* 除算用逆数(自然順、DCT出力の8倍込み) */
+static int      jpeg_cur_quality;
+
+/*
+ *  ハフマン符号表の生成
+ */
+static void
+jpeg_build_huffman(void)
+{
+	int t, i, j, k;
+	uint16_t code;
+
+	for(t = 0 ; t < 4 ; t++){
+		code = 0;
+		k = 0;
+		for(i = 0 ; i < 16 ; i++){
+			for(j = 0 ; j < jpeg_huff_bits[t][i] ; j++, k++){
+				jpeg_huff_code[t][jpeg_huff_val[t][k]] = code++;
+				jpeg_huff_size[t][jpeg_huff_val[t][k]] = i + 1;
+			}
+			code <<= 1;
+		}
+	}
+	jpeg_huff_ready = true;
+}
+
+/*
+ *  品質値から量子化テーブルを生成(IJG方式)
+ */
+static void
+jpeg_build_quant(int quality)
+{
+	const uint8_t *std;
+	int scale, t, i;
+	int32_t q;
+
+	if(quality == jpeg_cur_quality)
+		return;
+	scale = (quality < 50) ? (5000 / quality) : (200 - quality * 2);
+	for(t = 0 ; t < 2 ; t++){
+		std = (t == 0) ? jpeg_std_lum_qt : jpeg_std_chr_qt;
+		for(i = 0 ; i < 64 ; i++){
+			q = (std[i] * scale + 50) / 100;
+			if(q < 1)
+				q = 1;
+			else if(q > 255)
+				q = 255;
+			jpeg_recip[t][i] = (uint16_t)(((1 << 16) + q * 4) / (q * 8));
+		}
+		for(i = 0 ; i < 64 ; i++){
+			q = (std[jpeg_zigzag[i]] * scale + 50) / 100;
+			jpeg_qt[t][i] = (q < 1) ? 1 : ((q > 255) ? 255 : q);
+		}
+	}
+	jpeg_cur_quality = quality;
+}
+
+static void
+jpeg_put_byte(JPEG_Writer_t *w, uint8_t c)
+{
+	if(w->pos < w->size)
+		w->buf[w->pos++] = c;
+	else
+		w->overflow = true;
+}
+
+static void
+jpeg_put_word(JPEG_Writer_t *w, uint16_t c)
+{
+	jpeg_put_byte(w, c >> 8);
+	jpeg_put_byte(w, c & 0xff);
+}
+
+static void
+jpeg_put_bits(JPEG_Writer_t *w, uint32_t code, int size)
+{
+	uint8_t c;
+
+	w->bitbuf = (w->bitbuf << size) | (code & ((1 << size) - 1));
+	w->bitcnt += size;
+	while(w->bitcnt >= 8){
+		c = (w->bitbuf >> (w->bitcnt - 8)) & 0xff;
+		jpeg_put_byte(w, c);
+		if(c == 0xff)
+			jpeg_put_byte(w, 0);
+		w->bitcnt -= 8;
+	}
+	w->bitbuf &= (1 << w->bitcnt) - 1;
+}
+
+static void
+jpeg_flush_bits(JPEG_Writer_t *w)
+{
+	if(w->bitcnt > 0)
+		jpeg_put_bits(w, 0x7f, 8 - w->bitcnt);
+}
+
+/*
+ *  ヘッダ出力(SOI/APP0/DQT/SOF0/DHT/SOS)
+ */
+static void
+jpeg_write_header(JPEG_Writer_t *w, uint16_t width, uint16_t height)
+{
+	static const uint8_t app0[16] = {
+		0xFF, 0xE0, 0x00, 0x10, 'J', 'F', 'I', 'F', 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x01
+	};
+	static const uint8_t sos[14] = {
+		0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F, 0x00
+	};
+	int t, i, n;
+
+	jpeg_put_word(w, 0xFFD8);
+	for(i = 0 ; i < 16 ; i++)
+		jpeg_put_byte(w, app0[i]);
+	jpeg_put_byte(w, 0x00);
+	jpeg_put_byte(w, 0x00);
+
+	jpeg_put_word(w, 0xFFDB);
+	jpeg_put_word(w, 2 + 65 * 2);
+	for(t = 0 ; t < 2 ; t++){
+		jpeg_put_byte(w, t);
+		for(i = 0 ; i < 64 ; i++)
+			jpeg_put_byte(w, jpeg_qt[t][i]);
+	}
+
+	jpeg_put_word(w, 0xFFC0);
+	jpeg_put_word(w, 17);
+	jpeg_put_byte(w, 8);
+	jpeg_put_word(w, height);
+	jpeg_put_word(w, width);
+	jpeg_put_byte(w, 3);
+	jpeg_put_byte(w, 1);		/* Y:  H=2,V=1,QT0 */
+	jpeg_put_byte(w, 0x21);
+	jpeg_put_byte(w, 0);
+	jpeg_put_byte(w, 2);		/* Cb: H=1,V=1,QT1 */
+	jpeg_put_byte(w, 0x11);
+	jpeg_put_byte(w, 1);
+	jpeg_put_byte(w, 3);		/* Cr: H=1,V=1,QT1 */
+	jpeg_put_byte(w, 0x11);
+	jpeg_put_byte(w, 1);
+
+	jpeg_put_word(w, 0xFFC4);
+	jpeg_put_word(w, 2 + 4 * 17 + 12 + 12 + 162 + 162);
+	for(t = 0 ; t < 4 ; t++){
+		static const uint8_t tc_th[4] = { 0x00, 0x10, 0x01, 0x11 };
+		jpeg_put_byte(w, tc_th[t]);
+		for(i = 0, n = 0 ; i < 16 ; i++){
+			jpeg_put_byte(w, jpeg_huff_bits[t][i]);
+			n += jpeg_huff_bits[t][i];
+		}
+		for(i = 0 ; i < n ; i++)
+			jpeg_put_byte(w, jpeg_huff_val[t][i]);
+	}
+
+	for(i = 0 ; i < 14 ; i++)
+		jpeg_put_byte(w, sos[i]);
+}
+
+/*
+ *  8x8整数DCT(LLM方式、出力は8倍スケール)
+ */
+static void
+jpeg_fdct(int32_t *data)
+{
+	int32_t tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
+	int32_t tmp10, tmp11, tmp12, tmp13;
+	int32_t z1, z2, z3, z4, z5;
+	int32_t *p;
+	int i;
+
+	for(p = data, i = 0 ; i < 8 ; i++, p += 8){
+		tmp0 = p[0] + p[7];
+		tmp7 = p[0] - p[7];
+		tmp1 = p[1] + p[6];
+		tmp6 = p[1] - p[6];
+		tmp2 = p[2] + p[5];
+		tmp5 = p[2] - p[5];
+		tmp3 = p[3] + p[4];
+		tmp4 = p[3] - p[4];
+
+		tmp10 = tmp0 + tmp3;
+		tmp13 = tmp0 - tmp3;
+		tmp11 = tmp1 + tmp2;
+		tmp12 = tmp1 - tmp2;
+
+		p[0] = (tmp10 + tmp11) << PASS1_BITS;
+		p[4] = (tmp10 - tmp11) << PASS1_BITS;
+		z1 = (tmp12 + tmp13) * FIX_0_541196100;
+		p[2] = DESCALE(z1 + tmp13 * FIX_0_765366865, CONST_BITS - PASS1_BITS);
+		p[6] = DESCALE(z1 - tmp12 * FIX_1_847759065, CONST_BITS - PASS1_BITS);
+
+		z1 = tmp4 + tmp7;
+		z2 = tmp5 + tmp6;
+		z3 = tmp4 + tmp6;
+		z4 = tmp5 + tmp7;
+		z5 = (z3 + z4) * FIX_1_175875602;
+		tmp4 *= FIX_0_298631336;
+		tmp5 *= FIX_2_053119869;
+		tmp6 *= FIX_3_072711026;
+		tmp7 *= FIX_1_501321110;
+		z1 *= -FIX_0_899976223;
+		z2 *= -FIX_2_562915447;
+		z3 = z3 * -FIX_1_961570560 + z5;
+		z4 = z4 * -FIX_0_390180644 + z5;
+		p[7] = DESCALE(tmp4 + z1 + z3, CONST_BITS - PASS1_BITS);
+		p[5] = DESCALE(tmp5 + z2 + z4, CONST_BITS - PASS1_BITS);
+		p[3] = DESCALE(tmp6 + z2 + z3, CONST_BITS - PASS1_BITS);
+		p[1] = DESCALE(tmp7 + z1 + z4, CONST_BITS - PASS1_BITS);
+	}
+
+	for(p = data, i = 0 ; i < 8 ; i++, p++){
+		tmp0 = p[0*8] + p[7*8];
+		tmp7 = p[0*8] - p[7*8];
+		tmp1 = p[1*8] + p[6*8];
+		tmp6 = p[1*8] - p[6*8];
+		tmp2 = p[2*8] + p[5*8];
+		tmp5 = p[2*8] - p[5*8];
+		tmp3 = p[3*8] + p[4*8];
+		tmp4 = p[3*8] - p[4*8];
+
+		tmp10 = tmp0 + tmp3;
+		tmp13 = tmp0 - tmp3;
+		tmp11 = tmp1 + tmp2;
+		tmp12 = tmp1 - tmp2;
+
+		p[0*8] = DESCALE(tmp10 + tmp11, PASS1_BITS);
+		p[4*8] = DESCALE(tmp10 - tmp11, PASS1_BITS);
+		z1 = (tmp12 + tmp13) * FIX_0_541196100;
+		p[2*8] = DESCALE(z1 + tmp13 * FIX_0_765366865, CONST_BITS + PASS1_BITS);
+		p[6*8] = DESCALE(z1 - tmp12 * FIX_1_847759065, CONST_BITS + PASS1_BITS);
+
+		z1 = tmp4 + tmp7;
+		z2 = tmp5 + tmp6;
+		z3 = tmp4 + tmp6;
+		z4 = tmp5 + tmp7;
+		z5 = (z3 + z4) * FIX_1_175875602;
+		tmp4 *= FIX_0_298631336;
+		tmp5 *= FIX_2_053119869;
+		tmp6 *= FIX_3_072711026;
+		tmp7 *= FIX_1_501321110;
+		z1 *= -FIX_0_899976223;
+		z2 *= -FIX_2_562915447;
+		z3 = z3 * -FIX_1_961570560 + z5;
+		z4 = z4 * -FIX_0_390180644 + z5;
+		p[7*8] = DESCALE(tmp4 + z1 + z3, CONST_BITS + PASS1_BITS);
+		p[5*8] = DESCALE(tmp5 + z2 + z4, CONST_BITS + PASS1_BITS);
+		p[3*8] = DESCALE(tmp6 + z2 + z3, CONST_BITS + PASS1_BITS);
+		p[1*8] = DESCALE(tmp7 + z1 + z4, CONST_BITS + PASS1_BITS);
+	}
+}
+
+static int
+jpeg_nbits(int32_t v)
+{
+	int n = 0;
+
+	if(v < 0)
+		v = -v;
+	while(v != 0){
+		n++;
+		v >>= 1;
+	}
+	return n;
+}
+
+/*
+ *  1ブロックの量子化とハフマン符号化
+ */
+static void
+jpeg_encode_block(JPEG_Writer_t *w, int32_t *blk, int qt, int hdc, int *lastdc)
+{
+	const uint16_t *recip = jpeg_recip[qt];
+	int32_t zz[64];
+	int32_t v, diff;
+	int i, run, n;
+
+	jpeg_fdct(blk);
+	for(i = 0 ; i < 64 ; i++){
+		v = blk[jpeg_zigzag[i]];
+		if(v < 0)
+			zz[i] = -(int32_t)(((uint32_t)(-v) * recip[jpeg_zigzag[i]] + 0x8000) >> 16);
+		else
+			zz[i] = (int32_t)(((uint32_t)v * recip[jpeg_zigzag[i]] + 0x8000) >> 16);
+	}
+
+	diff = zz[0] - *lastdc;
+	*lastdc = zz[0];
+	n = jpeg_nbits(diff);
+	jpeg_put_bits(w, jpeg_huff_code[hdc][n], jpeg_huff_size[hdc][n]);
+	if(n != 0)
+		jpeg_put_bits(w, (diff < 0) ? (diff - 1) : diff, n);
+
+	run = 0;
+	for(i = 1 ; i < 64 ; i++){
+		v = zz[i];
+		if(v == 0){
+			run++;
+			continue;
+		}
+		while(run > 15){
+			jpeg_put_bits(w, jpeg_huff_code[hdc+1][0xF0], jpeg_huff_size[hdc+1][0xF0]);
+			run -= 16;
+		}
+		n = jpeg_nbits(v);
+		jpeg_put_bits(w, jpeg_huff_code[hdc+1][(run << 4) | n], jpeg_huff_size[hdc+1][(run << 4) | n]);
+		jpeg_put_bits(w, (v < 0) ? (v - 1) : v, n);
+		run = 0;
+	}
+	if(run > 0)
+		jpeg_put_bits(w, jpeg_huff_code[hdc+1][0x00], jpeg_huff_size[hdc+1][0x00]);
+}
+
+/*
+ *  16x8タイルの切り出しと色変換
+ *  画像端は最終画素を複製する
+ */
+static void
+jpeg_load_tile(const uint8_t *src, uint16_t width, uint16_t height, uint16_t x0, uint16_t y0,
+				bool_t yuv, int32_t *ybuf, int32_t *cbbuf, int32_t *crbuf)
+{
+	uint32_t x, y, xx, yy, i;
+	uint16_t pix;
+	int32_t r, g, b, cb, cr;
+
+	for(y = 0 ; y < 8 ; y++){
+		yy = y0 + y;
+		if(yy >= height)
+			yy = height - 1;
+		cb = cr = 0;
+		for(x = 0 ; x < 16 ; x++){
+			xx = x0 + x;
+			if(xx >= width)
+				xx = width - 2 + (x & 1);
+			i = yy * width + xx;
+			pix = SENSOR_PIXEL(src, i);
+			if(yuv){
+				/* 下位8ビット:Y、上位8ビット:U(偶数画素)/V(奇数画素) */
+				ybuf[(x >> 3) * 64 + y * 8 + (x & 7)] = (pix & 0xff) - 128;
+				if((xx & 1) == 0)
+					cb = (pix >> 8) - 128;
+				else
+					cr = (pix >> 8) - 128;
+				if((x & 1) != 0){
+					cbbuf[y * 8 + (x >> 1)] = cb;
+					crbuf[y * 8 + (x >> 1)] = cr;
+				}
+			}
+			else{
+				r = ((pix >> 8) & 0xf8) | (pix >> 13);
+				g = ((pix >> 3) & 0xfc) | ((pix >> 9) & 0x03);
+				b = ((pix << 3) & 0xf8) | ((pix >> 2) & 0x07);
+				ybuf[(x >> 3) * 64 + y * 8 + (x & 7)] = ((77 * r + 150 * g + 29 * b + 128) >> 8) - 128;
+				cb += -43 * r - 85 * g + 128 * b;
+				cr += 128 * r - 107 * g - 21 * b;
+				if((x & 1) != 0){
+					cbbuf[y * 8 + (x >> 1)] = (cb + 256) >> 9;
+					crbuf[y * 8 + (x >> 1)] = (cr + 256) >> 9;
+					cb = cr = 0;
+				}
+			}
+		}
+	}
+}
+
+/*
+ *  JPEG符号化
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  buf: 出力バッファ
+ *  parameter3  size: 出力バッファサイズ
+ *  parameter4  len: 出力データ長を返す領域へのポインタ
+ *  return      ERコード、出力バッファ不足はE_NOMEM
+ *  _dataBuffer(RGB565またはYUV422)をhcmr->_qualityの品質で符号化する．
+ *  符号化時間(μs)は_jpegTimeに記録する．
+ */
+ER
+ov7740_jpeg_encode(OV7740_t *hcmr, uint8_t *buf, uint32_t size, uint32_t *len)
+{
+	JPEG_Writer_t w;
+	int32_t ybuf[128], cbbuf[64], crbuf[64];
+	int dc[3] = { 0, 0, 0 };
+	uint16_t x, y;
+	bool_t yuv;
+	SYSUTM start, end;
+
+	if(hcmr == NULL || buf == NULL || len == NULL || hcmr->_dataBuffer == NULL)
+		return E_PAR;
+	if(hcmr->_width == 0 || hcmr->_height == 0)
+		return E_OBJ;
+	if(hcmr->pixFormat == PIXFORMAT_YUV422)
+		yuv = true;
+	else if(hcmr->pixFormat == PIXFORMAT_RGB565 || hcmr->pixFormat == PIXFORMAT_JPEG)
+		yuv = false;
+	else
+		return E_PAR;
+
+	get_utm(&start);
+	if(!jpeg_huff_ready)
+		jpeg_build_huffman();
+	jpeg_build_quant(hcmr->_quality != 0 ? hcmr->_quality : JPEG_DEFAULT_QUALITY);
+
+	memset(&w, 0, sizeof(w));
+	w.buf  = buf;
+	w.size = size;
+	jpeg_write_header(&w, hcmr->_width, hcmr->_height);
+
+	for(y = 0 ; y < hcmr->_height && !w.overflow ; y += 8){
+		for(x = 0 ; x < hcmr->_width ; x += 16){
+			jpeg_load_tile((const uint8_t *)hcmr->_dataBuffer, hcmr->_width, hcmr->_height,
+							x, y, yuv, ybuf, cbbuf, crbuf);
+			jpeg_encode_block(&w, &ybuf[0], 0, HUFF_DC_LUM, &dc[0]);
+			jpeg_encode_block(&w, &ybuf[64], 0, HUFF_DC_LUM, &dc[0]);
+			jpeg_encode_block(&w, cbbuf, 1, HUFF_DC_CHR, &dc[1]);
+			jpeg_encode_block(&w, crbuf, 1, HUFF_DC_CHR, &dc[2]);
+		}
+	}
+	jpeg_flush_bits(&w);
+	jpeg_put_word(&w, 0xFFD9);
+	get_utm(&end);
+	hcmr->_jpegTime = (uint32_t)(end - start);
+
+	if(w.overflow){
+		*len = 0;
+		return E_NOMEM;
+	}
+	*len = w.pos;
+	return E_OK;
+}
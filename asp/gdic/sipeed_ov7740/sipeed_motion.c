@@ -0,0 +1,215 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  カメラ画像の動き検出
+ *
+ *  フレームを小さな輝度グリッドに縮小し、移動平均による背景モデル
+ *  との差分から動きの有無と変化領域を求める．
+ */
+#include <kernel.h>
+#include <t_syslog.h>
+#include <string.h>
+#include "sipeed_motion.h"
+
+/*
+ *  画素の輝度(0-255)
+ */
+static inline uint32_t
+motion_luma(uint16_t pix, bool_t yuv)
+{
+	uint32_t r, g, b;
+
+	if(yuv)
+		return pix & 0xff;
+	r = (pix >> 8) & 0xf8;
+	g = (pix >> 3) & 0xfc;
+	b = (pix << 3) & 0xf8;
+	return (77 * r + 150 * g + 29 * b) >> 8;
+}
+
+/*
+ *  符号付きの値の丸め付き右シフト
+ *  算術シフトは負の値を-∞側に切り捨てるため、絶対値で丸めて符号を戻す．
+ */
+static inline int32_t
+motion_shift(int32_t v, uint32_t n)
+{
+	int32_t half = (1 << n) >> 1;
+
+	return (v >= 0) ? ((v + half) >> n) : -((-v + half) >> n);
+}
+
+/*
+ *  動き検出初期化
+ *  parameter1  hmd: 動き検出ハンドラへのポインタ
+ *  return      ERコード
+ */
+ER
+motion_init(MOTION_Handle_t *hmd)
+{
+	MOTION_Init_t *init;
+
+	if(hmd == NULL)
+		return E_PAR;
+	init = &hmd->Init;
+	if(init->GridWidth == 0 || init->GridWidth > MOTION_GRID_WMAX)
+		return E_PAR;
+	if(init->GridHeight == 0 || init->GridHeight > MOTION_GRID_HMAX)
+		return E_PAR;
+	if(init->SampleStep != 1 && init->SampleStep != 2 && init->SampleStep != 4)
+		return E_PAR;
+	if(init->LearnShift == 0 || init->LearnShift > 8)
+		return E_PAR;
+	if(init->MinCells == 0)
+		return E_PAR;
+	motion_reset(hmd);
+	return E_OK;
+}
+
+/*
+ *  背景モデルの破棄
+ *  次のフレームで背景を取り直す
+ */
+void
+motion_reset(MOTION_Handle_t *hmd)
+{
+	memset(hmd->bg, 0, sizeof(hmd->bg));
+	hmd->frames = 0;
+	hmd->events = 0;
+}
+
+/*
+ *  動き検出
+ *  parameter1  hmd: 動き検出ハンドラへのポインタ
+ *  parameter2  buf: 画像データ(ov7740_snapshot後の_dataBuffer)
+ *  parameter3  width: 画像幅
+ *  parameter4  height: 画像高さ
+ *  parameter5  format: PIXFORMAT_RGB565またはPIXFORMAT_YUV422
+ *  parameter6  event: 動きイベントを返す領域へのポインタ
+ *  return      変化セル数、MinCells未満の場合は0
+ *  変化したセルは背景更新を1/4に遅らせ、静止した物体は徐々に背景に取り込む．
+ *  輝度差と背景更新は明暗どちらの変化でも同じ量になるよう絶対値で丸める．
+ */
+ER_UINT
+motion_detect(MOTION_Handle_t *hmd, const void *buf, uint16_t width, uint16_t height,
+				pixformat_t format, MOTION_Event_t *event)
+{
+	MOTION_Init_t *init;
+	uint32_t sum[MOTION_GRID_WMAX];
+	uint16_t cw, ch, gx, gy, x, y, step;
+	uint16_t minx, miny, maxx, maxy;
+	uint32_t cnt, cells, base;
+	int32_t  cur, bg, diff;
+	uint16_t *pbg;
+	bool_t   yuv, first;
+
+	if(hmd == NULL || buf == NULL || event == NULL)
+		return E_PAR;
+	init = &hmd->Init;
+	if(format == PIXFORMAT_YUV422)
+		yuv = true;
+	else if(format == PIXFORMAT_RGB565 || format == PIXFORMAT_JPEG)
+		yuv = false;
+	else
+		return E_PAR;
+	cw = width / init->GridWidth;
+	ch = height / init->GridHeight;
+	if(cw == 0 || ch == 0)
+		return E_PAR;
+
+	step  = init->SampleStep;
+	cnt   = ((cw + step - 1) / step) * ((ch + step - 1) / step);
+	first = (hmd->frames == 0);
+	cells = 0;
+	minx  = miny = 0xffff;
+	maxx  = maxy = 0;
+
+	for(gy = 0 ; gy < init->GridHeight ; gy++){
+		memset(sum, 0, sizeof(uint32_t) * init->GridWidth);
+		for(y = gy * ch ; y < (gy + 1) * ch ; y += step){
+			base = y * width;
+			for(gx = 0, x = 0 ; gx < init->GridWidth ; gx++){
+				uint16_t xe = x + cw;
+				for(; x < xe ; x += step)
+					sum[gx] += motion_luma(SENSOR_PIXEL(buf, base + x), yuv);
+				x = xe;
+			}
+		}
+		pbg = &hmd->bg[gy * init->GridWidth];
+		for(gx = 0 ; gx < init->GridWidth ; gx++){
+			cur = (sum[gx] << 8) / cnt;
+			if(first){
+				pbg[gx] = cur;
+				continue;
+			}
+			bg = pbg[gx];
+			diff = motion_shift(cur - bg, 8);
+			if(diff < 0)
+				diff = -diff;
+			if(diff > init->Threshold){
+				cells++;
+				if(gx < minx)
+					minx = gx;
+				if(gx > maxx)
+					maxx = gx;
+				if(gy < miny)
+					miny = gy;
+				maxy = gy;
+				pbg[gx] = bg + motion_shift(cur - bg, init->LearnShift + 2);
+			}
+			else
+				pbg[gx] = bg + motion_shift(cur - bg, init->LearnShift);
+		}
+	}
+	hmd->frames++;
+
+	if(cells < init->MinCells)
+		return 0;
+	event->x = minx * cw;
+	event->y = miny * ch;
+	event->w = (maxx - minx + 1) * cw;
+	event->h = (maxy - miny + 1) * ch;
+	event->cells = cells;
+	event->frame = hmd->frames;
+	hmd->events++;
+	return cells;
+}
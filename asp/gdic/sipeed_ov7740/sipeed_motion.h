@@ -0,0 +1,103 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  カメラ画像の動き検出のヘッダファイル
+ */
+
+#ifndef _SIPEED_MOTION_H_
+#define _SIPEED_MOTION_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "sipeed_ov7740.h"
+
+/*
+ *  輝度グリッドの最大サイズ
+ */
+#define MOTION_GRID_WMAX        64
+#define MOTION_GRID_HMAX        48
+
+/*
+ *  動き検出初期設定
+ */
+typedef struct {
+	uint16_t        GridWidth;		/* グリッド横セル数 */
+	uint16_t        GridHeight;		/* グリッド縦セル数 */
+	uint8_t         Threshold;		/* 変化とみなす輝度差 */
+	uint8_t         LearnShift;		/* 背景更新率(1/2^n) */
+	uint8_t         SampleStep;		/* セル内の間引き間隔(1,2,4) */
+	uint16_t        MinCells;		/* 動き判定の最小変化セル数(1以上) */
+} MOTION_Init_t;
+
+/*
+ *  動きイベント
+ */
+typedef struct {
+	uint16_t        x;				/* 変化領域(画素座標) */
+	uint16_t        y;
+	uint16_t        w;
+	uint16_t        h;
+	uint16_t        cells;			/* 変化セル数 */
+	uint32_t        frame;			/* フレーム番号 */
+} MOTION_Event_t;
+
+/*
+ *  動き検出ハンドラ
+ */
+typedef struct {
+	MOTION_Init_t   Init;
+	uint16_t        bg[MOTION_GRID_WMAX*MOTION_GRID_HMAX];	/* 背景輝度(8.8固定小数点) */
+	uint32_t        frames;			/* 処理フレーム数 */
+	uint32_t        events;			/* 動き検出回数 */
+} MOTION_Handle_t;
+
+extern ER motion_init(MOTION_Handle_t *hmd);
+extern void motion_reset(MOTION_Handle_t *hmd);
+extern ER_UINT motion_detect(MOTION_Handle_t *hmd, const void *buf, uint16_t width, uint16_t height, pixformat_t format, MOTION_Event_t *event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _SIPEED_MOTION_H_ */
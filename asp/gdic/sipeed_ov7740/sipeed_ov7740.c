@@ -9,39 +9,39 @@
  *              Graduate School of Information Science, Nagoya Univ., JAPAN
  *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
  * 
- *  嵭Ԥϡʲ(1)(4)ξ˸¤ꡤܥեȥ
- *  ܥեȥѤΤޤࡥʲƱˤѡʣ
- *  ѡۡʰʲѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
- *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
- *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
- *      ˴ޤޤƤ뤳ȡ
- *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
- *      ѤǤǺۤˤϡۤȼɥȡ
- *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
- *      ̵ݾڵǺܤ뤳ȡ
- *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
- *      ѤǤʤǺۤˤϡΤ줫ξ
- *      ȡ
- *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
- *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
- *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
- *        𤹤뤳ȡ
- *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
- *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
- *      ޤܥեȥΥ桼ޤϥɥ桼Τʤ
- *      ͳ˴Ťᤫ⡤嵭ԤTOPPERSץȤ
- *      դ뤳ȡ
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
  * 
- *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
- *  TOPPERSץȤϡܥեȥ˴ؤơλŪ
- *  ФŬޤơʤݾڤԤʤޤܥեȥ
- *  ѤˤľŪޤϴŪʤ»˴ؤƤ⡤
- *  Ǥʤ
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
  * 
  *  $Id: sipeed_ov7740.c 2416 2019-11-29 22:11:42Z roi $
  */
 /* 
- *  SIPEED OV7740 CAMERAץ
+ *  SIPEED OV7740 CAMERA制御プログラムの本体
  */
 
 #include <kernel.h>
@@ -50,7 +50,9 @@
 #include "device.h"
 
 #include "dvp.h"
+#include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include "math.h"
 #include "sipeed_ov7740.h"
 #include "cambus.h"
@@ -65,12 +67,35 @@
 #define SNAPDHOT_TIMEOUT    300
 #endif
 
+#ifndef SENSOR_REG_VERIFY
+#define SENSOR_REG_VERIFY   false		/* 初期化テーブルの読み戻し確認 */
+#endif
+
 
 #define SVGA_HSIZE     (800)
 #define SVGA_VSIZE     (600)
 
 #define UXGA_HSIZE     (1600)
 #define UXGA_VSIZE     (1200)
+
+#define VGA_HSIZE      (640)
+#define VGA_VSIZE      (480)
+
+/*
+ *  OV7740センサーウィンドウ(REG17-REG1A)の初期値
+ */
+#define OV7740_AHSTART (0x25)
+#define OV7740_AHSIZE  (0xA0)
+#define OV7740_AVSTART (0x03)
+#define OV7740_AVSIZE  (0xF0)
+
+/*
+ *  GC0328 VGA 30fps時の総ライン数(ウィンドウ488+VB12+8)
+ */
+#define GC0328_FRAME_LINES  (508)
+#define GC0328_VB_DEFAULT   (0x0C)
+#define GC0328_VB_MAX       (0x0FFF)
+
 static const uint8_t ov7740_default[][2] = { //k210 
 	{0x47, 0x02}  ,
 	{0x17, 0x27}  ,
@@ -215,9 +240,10 @@ static const int resolution[][2] = {
 #define OV7740_SET_FLIP(r, x)     ((r&0x7F)|((x&1)<<7))
 #define OV7740_SET_SP(r, x)     ((r&0xEE)|((x&1)<<4)|(x&1))
 
-static uint8_t gc0328_default_regs[][2] = {
+static const uint8_t gc0328_default_regs[][2] = {
 	{0xfe , 0x80},
 	{0xfe , 0x80},
+	{0xff , 0x02},	//delay 2ms after soft reset
 	{0xfc , 0x16},
 	{0xfc , 0x16},
 	{0xfc , 0x16},
@@ -760,15 +786,216 @@ static int reverse_u32pixel(uint32_t* addr, uint32_t length)
   return 0;
 }
 
+/*
+ *  シャドウレジスタ有効判定
+ */
+#define shadow_valid(sh, p, r)     (((sh)->valid[(p)][(r)>>5] >> ((r) & 31)) & 1)
+#define shadow_set_valid(sh, p, r) ((sh)->valid[(p)][(r)>>5] |= (1 << ((r) & 31)))
+#define shadow_clr_valid(sh, p, r) ((sh)->valid[(p)][(r)>>5] &= ~(1 << ((r) & 31)))
+
+/*
+ *  センサーが自律的に更新するレジスタ(AEC/AGC/AWB結果)はキャッシュしない
+ */
+static bool_t
+sensor_reg_volatile(OV7740_t *hcmr, uint8_t reg)
+{
+	if(hcmr->_id == GC0328_ID){
+		if(hcmr->_shadow.page != 0)
+			return false;
+		return (reg == 0x03 || reg == 0x04 || (reg >= 0x77 && reg <= 0x79));
+	}
+	return (reg <= 0x03 || reg == 0x0F || reg == 0x10 || reg == 0x15);
+}
+
+/*
+ *  自律更新レジスタを更新する自動制御のレジスタとビット(ページ0)
+ */
+static uint8_t
+sensor_reg_control(OV7740_t *hcmr, uint8_t reg, uint8_t *mask)
+{
+	if(hcmr->_id == GC0328_ID){
+		if(reg == 0x03 || reg == 0x04){
+			*mask = 0x01;			/* AEC */
+			return 0x4F;
+		}
+		*mask = 0x02;				/* AWB */
+		return 0x42;
+	}
+	if(reg == 0x00 || reg == 0x0F || reg == 0x10 || reg == 0x15){
+		*mask = 0x05;				/* AEC/AGC */
+		return 0x13;
+	}
+	*mask = 0x10;					/* AWB */
+	return 0x80;
+}
+
+/*
+ *  シャドウ値を使えるレジスタか
+ *  自律更新レジスタも、制御レジスタのシャドウで自動制御が停止していれば
+ *  書き込んだ値から変化しない
+ */
+static bool_t
+sensor_reg_cached(OV7740_t *hcmr, uint8_t reg)
+{
+	SENSOR_Shadow_t *sh = &hcmr->_shadow;
+	uint8_t ctrl, mask;
+
+	if(!sensor_reg_volatile(hcmr, reg))
+		return true;
+	ctrl = sensor_reg_control(hcmr, reg, &mask);
+	return shadow_valid(sh, 0, ctrl) && (sh->regs[0][ctrl] & mask) == 0;
+}
+
+/*
+ *  シャドウレジスタへの書込み反映
+ */
+static void
+sensor_shadow_update(OV7740_t *hcmr, uint8_t reg, uint8_t data)
+{
+	SENSOR_Shadow_t *sh = &hcmr->_shadow;
+
+	if(hcmr->_id == GC0328_ID && reg == 0xFE){
+		if((data & 0x80) != 0){		/* ソフトリセット */
+			ov7740_shadow_invalidate(hcmr);
+			return;
+		}
+		sh->page = data & 0x01;
+	}
+	if(sh->page >= SENSOR_SHADOW_PAGES)
+		return;
+	sh->regs[sh->page][reg] = data;
+	shadow_set_valid(sh, sh->page, reg);
+
+	/* 自動制御を再開すると自律更新レジスタのシャドウ値は使えなくなる */
+	if(sh->page == 0 && (hcmr->_id == GC0328_ID ? (reg == 0x4F || reg == 0x42) : (reg == 0x13 || reg == 0x80))){
+		uint8_t mask;
+		int     r;
+
+		for(r = 0 ; r < 256 ; r++){
+			if(sensor_reg_volatile(hcmr, r) && sensor_reg_control(hcmr, r, &mask) == reg && (data & mask) != 0)
+				shadow_clr_valid(sh, 0, r);
+		}
+	}
+}
+
+/*
+ *  レジスタテーブルのシャドウ反映
+ */
+static void
+sensor_shadow_table(OV7740_t *hcmr, const uint8_t (*regs)[2])
+{
+	uint32_t i;
+
+	for(i = 0 ; regs[i][0] != 0 ; i++){
+		if(regs[i][0] != 0xFF)
+			sensor_shadow_update(hcmr, regs[i][0], regs[i][1]);
+	}
+}
+
+/*
+ *  シャドウ経由レジスタ読み込み
+ *  有効なシャドウ値があればSCCBアクセスを行わない
+ */
+static ER
+sensor_readb(OV7740_t *hcmr, uint8_t reg, uint8_t *data)
+{
+	SENSOR_Shadow_t *sh = &hcmr->_shadow;
+	ER ercd;
+
+	if(sensor_reg_cached(hcmr, reg) && shadow_valid(sh, sh->page, reg)){
+		*data = sh->regs[sh->page][reg];
+		return E_OK;
+	}
+	ercd = cambus_readb(hcmr->_slaveAddr, reg, data);
+	if(ercd == E_OK && sensor_reg_cached(hcmr, reg))
+		sensor_shadow_update(hcmr, reg, *data);
+	return ercd;
+}
+
+/*
+ *  シャドウ経由レジスタ書込み(ライトスルー)
+ *  シャドウ値と同じ値の書込み(ページが変わらないGC0328の0xFEを含む)は省略する．
+ *  実行時の調整を軽くするため、cambus_write_tableと同様に書込み後の待ちは行わない
+ */
+static ER
+sensor_writeb(OV7740_t *hcmr, uint8_t reg, uint8_t data)
+{
+	SENSOR_Shadow_t *sh = &hcmr->_shadow;
+	ER ercd;
+
+	if(sensor_reg_cached(hcmr, reg) && shadow_valid(sh, sh->page, reg)
+			&& sh->regs[sh->page][reg] == data && !(reg == 0xFE && (data & 0x80) != 0))
+		return E_OK;
+	if(hcmr->_id == GC0328_ID && reg == 0xFE && (data & 0x80) != 0)
+		ercd = cambus_writeb(hcmr->_slaveAddr, reg, data);	/* ソフトリセットは完了を待つ */
+	else
+		ercd = cambus_writeb_nowait(hcmr->_slaveAddr, reg, data);
+	if(ercd == E_OK)
+		sensor_shadow_update(hcmr, reg, data);
+	return ercd;
+}
+
+/*
+ *  シャドウレジスタ無効化
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ */
+void
+ov7740_shadow_invalidate(OV7740_t *hcmr)
+{
+	memset(hcmr->_shadow.valid, 0, sizeof(hcmr->_shadow.valid));
+	hcmr->_shadow.page = 0;
+}
+
+/*
+ *  シャドウレジスタ同期
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  return      ERコード
+ *  有効なシャドウ値をセンサーから読み直す．読み込みに失敗した場合は
+ *  最初のエラーを返し、値が不明になるためシャドウを無効化する．
+ */
+ER
+ov7740_shadow_sync(OV7740_t *hcmr)
+{
+	SENSOR_Shadow_t *sh = &hcmr->_shadow;
+	uint8_t page = sh->page;
+	uint8_t npage = (hcmr->_id == GC0328_ID) ? SENSOR_SHADOW_PAGES : 1;
+	uint8_t p, data;
+	int     reg;
+	ER      ercd = E_OK, rercd;
+
+	for(p = 0 ; p < npage && ercd == E_OK ; p++){
+		if(hcmr->_id == GC0328_ID)
+			ercd = cambus_writeb(hcmr->_slaveAddr, 0xFE, p);
+		for(reg = 0 ; reg < 256 && ercd == E_OK ; reg++){
+			if(!shadow_valid(sh, p, reg) || reg == 0xFE)
+				continue;
+			ercd = cambus_readb(hcmr->_slaveAddr, reg, &data);
+			if(ercd == E_SYS && data == 0xFF && sh->regs[p][reg] == 0xFF)
+				ercd = E_OK;	/* 0xFFを書込んだレジスタ */
+			if(ercd == E_OK)
+				sh->regs[p][reg] = data;
+		}
+	}
+	if(ercd != E_OK)
+		ov7740_shadow_invalidate(hcmr);
+	if(hcmr->_id == GC0328_ID){
+		rercd = cambus_writeb(hcmr->_slaveAddr, 0xFE, page);
+		if(ercd == E_OK)
+			ercd = rercd;
+	}
+	sh->page = page;
+	return ercd;
+}
+
 ER
 ov7740_set_hmirror(OV7740_t *hcmr, int enable)
 {
 	uint8_t reg;
-	cambus_readb(hcmr->_slaveAddr, 0x0C, &reg);
-	cambus_writeb(hcmr->_slaveAddr, 0x0C, OV7740_SET_MIRROR(reg, enable));
+	sensor_readb(hcmr, 0x0C, &reg);
+	sensor_writeb(hcmr, 0x0C, OV7740_SET_MIRROR(reg, enable));
 
-	cambus_readb(hcmr->_slaveAddr, 0x16, &reg);
-	cambus_writeb(hcmr->_slaveAddr, 0x16, OV7740_SET_SP(reg, enable));
+	sensor_readb(hcmr, 0x16, &reg);
+	sensor_writeb(hcmr, 0x16, OV7740_SET_SP(reg, enable));
 	return E_OK;
 }
 
@@ -779,16 +1006,16 @@ ov7740_set_special_effect(OV7740_t *hcmr, int sde)
 	switch (sde)
 	{
 		case 0: // SDE_NORMAL:
-			cambus_readb(hcmr->_slaveAddr, 0x81, &reg);
-			cambus_writeb(hcmr->_slaveAddr, 0x81, reg & 0xFE);
-			cambus_readb(hcmr->_slaveAddr, 0xDA, &reg);
-			cambus_writeb(hcmr->_slaveAddr, 0xDA, reg & 0xBF);
+			sensor_readb(hcmr, 0x81, &reg);
+			sensor_writeb(hcmr, 0x81, reg & 0xFE);
+			sensor_readb(hcmr, 0xDA, &reg);
+			sensor_writeb(hcmr, 0xDA, reg & 0xBF);
 			break;
 		case 1: // SDE_NEGATIVE:
-			cambus_readb(hcmr->_slaveAddr, 0x81, &reg);
-			cambus_writeb(hcmr->_slaveAddr, 0x81, reg | 0x01);
-			cambus_readb(hcmr->_slaveAddr, 0xDA, &reg);
-			cambus_writeb(hcmr->_slaveAddr, 0xDA, reg | 0x40);
+			sensor_readb(hcmr, 0x81, &reg);
+			sensor_writeb(hcmr, 0x81, reg | 0x01);
+			sensor_readb(hcmr, 0xDA, &reg);
+			sensor_writeb(hcmr, 0xDA, reg | 0x40);
 			break;
 	
 		default:
@@ -806,20 +1033,212 @@ ov7740_choice(OV7740_t *hcmr, int8_t choice_dev)
 void
 ov7740_getResolition(OV7740_t *hcmr, framesize_t frameSize)
 {
+	if(frameSize >= FRAMESIZE_CUSTOM){
+		if(hcmr->_subsample != 0){
+			hcmr->_width  = hcmr->_winW / hcmr->_subsample;
+			hcmr->_height = hcmr->_winH / hcmr->_subsample;
+		}
+		return;
+	}
 	hcmr->_width    = resolution[frameSize][0];
 	hcmr->_height   = resolution[frameSize][1];
 }
 
+/*
+ *  センサーウィンドウパラメータ設定
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  x: ウィンドウ開始X(VGA座標、4の倍数)
+ *  parameter3  y: ウィンドウ開始Y(VGA座標、2の倍数)
+ *  parameter4  w: ウィンドウ幅(4の倍数)
+ *  parameter5  h: ウィンドウ高さ(2の倍数)
+ *  parameter6  subsample: サブサンプル率(1,2,4)
+ *  return      ERコード
+ */
+static ER
+sensor_set_window_param(OV7740_t *hcmr, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t subsample)
+{
+	uint16_t ow, oh;
+
+	if(subsample != 1 && subsample != 2 && subsample != 4)
+		return E_PAR;
+	if(w == 0 || h == 0 || (x + w) > VGA_HSIZE || (y + h) > VGA_VSIZE)
+		return E_PAR;
+	if((x % 4) != 0 || (w % 4) != 0 || (y % 2) != 0 || (h % 2) != 0)
+		return E_PAR;
+	ow = w / subsample;
+	oh = h / subsample;
+	/* DVPは8ピクセル単位、バーストモードでは32ピクセル単位で転送 */
+	if((ow % 8) != 0 || (oh % 2) != 0)
+		return E_PAR;
+	if(hcmr->hdvp->Init.BurstMode == DVP_BURST_ENABLE && (ow % 32) != 0)
+		return E_PAR;
+
+	hcmr->_winX      = x;
+	hcmr->_winY      = y;
+	hcmr->_winW      = w;
+	hcmr->_winH      = h;
+	hcmr->_subsample = subsample;
+	hcmr->frameSize  = FRAMESIZE_CUSTOM;
+	hcmr->_width     = ow;
+	hcmr->_height    = oh;
+	return E_OK;
+}
+
+/*
+ *  センサー検出結果キャッシュ
+ *  SENSOR_PROBE_SECTIONにリセットで初期化されないセクションを
+ *  指定すると、ウォームブート時にアドレス走査を省略できる
+ */
+#ifdef SENSOR_PROBE_SECTION
+static SENSOR_Probe_t sensor_probe __attribute__((section(SENSOR_PROBE_SECTION)));
+#else
+static SENSOR_Probe_t sensor_probe;
+#endif
+static uint8_t sensor_reset_level;
+static uint8_t sensor_pwdn_level;
+
+static uint8_t
+sensor_probe_sum(const SENSOR_Probe_t *probe)
+{
+	const uint8_t *p = (const uint8_t *)probe;
+	uint8_t sum = 0;
+	uint32_t i;
+
+	for(i = 0 ; i < offsetof(SENSOR_Probe_t, sum) ; i++)
+		sum += p[i];
+	return ~sum;
+}
+
+static bool_t
+sensor_probe_valid(const SENSOR_Probe_t *probe)
+{
+	return probe->magic == SENSOR_PROBE_MAGIC && probe->sum == sensor_probe_sum(probe);
+}
+
+static void
+sensor_reset_line(OV7740_t *hcmr, bool_t level)
+{
+	dvp_dcmi_reset(hcmr->hdvp, level);
+	sensor_reset_level = level;
+}
+
+static void
+sensor_pwdn_line(OV7740_t *hcmr, bool_t level)
+{
+	dvp_dcmi_powerdown(hcmr->hdvp, level);
+	sensor_pwdn_level = level;
+}
+
+/*
+ *  検出結果の保存
+ */
+static void
+sensor_probe_store(OV7740_t *hcmr, uint8_t reg_width)
+{
+	sensor_probe.magic         = SENSOR_PROBE_MAGIC;
+	sensor_probe.id            = hcmr->_id;
+	sensor_probe.slaveAddr     = hcmr->_slaveAddr;
+	sensor_probe.regWidth      = reg_width;
+	sensor_probe.resetLevel    = sensor_reset_level;
+	sensor_probe.pwdnLevel     = sensor_pwdn_level;
+	sensor_probe.resetPoliraty = hcmr->_resetPoliraty;
+	sensor_probe.pwdnPoliraty  = hcmr->_pwdnPoliraty;
+	sensor_probe.sum           = sensor_probe_sum(&sensor_probe);
+}
+
+/*
+ *  キャッシュした検出結果の適用
+ *  端子状態を再現し、チップIDを1回読み出して一致を確認する
+ */
+static ER
+sensor_probe_restore(OV7740_t *hcmr, bool_t gc)
+{
+	uint8_t id = 0;
+
+	if(!sensor_probe_valid(&sensor_probe))
+		return E_OBJ;
+	if((sensor_probe.id == GC0328_ID) != gc || sensor_probe.id == LEPTON_ID)
+		return E_OBJ;
+
+	sensor_pwdn_line(hcmr, sensor_probe.pwdnLevel);
+	sensor_reset_line(hcmr, sensor_probe.resetLevel);
+	dly_tsk(10);
+	cambus_set_reg_width(sensor_probe.regWidth);
+	if(gc){
+		cambus_set_writeb_delay(2);
+		id = cambus_scan_gc0328();
+	}
+	else if(sensor_probe.id == MT9V034_ID)
+		cambus_readb(sensor_probe.slaveAddr, ON_CHIP_ID, &id);
+	else
+		cambus_readb(sensor_probe.slaveAddr, OV_CHIP_ID, &id);
+	if(id != sensor_probe.id){
+		sensor_probe.magic = 0;
+		return E_SYS;
+	}
+	hcmr->_slaveAddr     = sensor_probe.slaveAddr;
+	hcmr->_id            = sensor_probe.id;
+	hcmr->_resetPoliraty = sensor_probe.resetPoliraty;
+	hcmr->_pwdnPoliraty  = sensor_probe.pwdnPoliraty;
+	return E_OK;
+}
+
+/*
+ *  検出結果の取り出し(不揮発領域への保存用)
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  probe: 検出結果の格納先
+ *  return ERコード
+ */
+ER
+ov7740_get_probe(OV7740_t *hcmr, SENSOR_Probe_t *probe)
+{
+	if(hcmr == NULL || probe == NULL)
+		return E_PAR;
+	if(!sensor_probe_valid(&sensor_probe))
+		return E_OBJ;
+	*probe = sensor_probe;
+	return E_OK;
+}
+
+/*
+ *  検出結果の設定(次回のdetectで使用)
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  probe: 保存しておいた検出結果
+ *  return ERコード
+ */
+ER
+ov7740_set_probe(OV7740_t *hcmr, const SENSOR_Probe_t *probe)
+{
+	if(hcmr == NULL || probe == NULL)
+		return E_PAR;
+	if(!sensor_probe_valid(probe))
+		return E_PAR;
+	sensor_probe = *probe;
+	return E_OK;
+}
+
+/*
+ *  検出結果キャッシュの破棄
+ */
+void
+ov7740_clear_probe(OV7740_t *hcmr)
+{
+	(void)hcmr;
+	sensor_probe.magic = 0;
+}
+
 ER
 ov7740_sensor_ov_detect(OV7740_t *hcmr)
 {
-	DVP_Handle_t *hdvp = hcmr->hdvp;
+	if(sensor_probe_restore(hcmr, false) == E_OK)
+		return E_OK;
+	sensor_pwdn_level = true;	/* dvp_initでパワーダウン */
 
 	/* Reset the sensor */
-	dvp_dcmi_reset(hdvp, true);
+	sensor_reset_line(hcmr, true);
 	dly_tsk(10);
 
-	dvp_dcmi_reset(hdvp, false);
+	sensor_reset_line(hcmr, false);
 	dly_tsk(10);
 
 	/* Probe the ov sensor */
@@ -830,32 +1249,32 @@ ov7740_sensor_ov_detect(OV7740_t *hcmr)
 		hcmr->_resetPoliraty = ACTIVE_LOW;
 
 		/* Pull the sensor out of the reset state,systick_sleep() */
-		dvp_dcmi_powerdown(hdvp, false); //
+		sensor_pwdn_line(hcmr, false); //
 		dly_tsk(10);                    //
-		dvp_dcmi_powerdown(hdvp, true);//
+		sensor_pwdn_line(hcmr, true);//
 		dly_tsk(10);                    //
-		dvp_dcmi_reset(hdvp, true);
+		sensor_reset_line(hcmr, true);
 		dly_tsk(10);
 
 		/* Probe again to set the slave addr */
 		hcmr->_slaveAddr = cambus_scan(hcmr);
 		if(hcmr->_slaveAddr == 0){
 			hcmr->_pwdnPoliraty = ACTIVE_LOW;
-			dvp_dcmi_powerdown(hdvp, false);     //
+			sensor_pwdn_line(hcmr, false);     //
 			dly_tsk(10);                        //
-//			dvp_dcmi_powerdown(hdvp, true);
+//			sensor_pwdn_line(hcmr, true);
 //			dly_tsk(10);
-			dvp_dcmi_reset(hdvp, true);         //
+			sensor_reset_line(hcmr, true);         //
 			dly_tsk(10);                        //
 
 			hcmr->_slaveAddr = cambus_scan(hcmr);
 			if(hcmr->_slaveAddr == 0){
 				hcmr->_resetPoliraty = ACTIVE_HIGH;
-				dvp_dcmi_powerdown(hdvp, true);     //
+				sensor_pwdn_line(hcmr, true);     //
 				dly_tsk(10);                        //
-				dvp_dcmi_powerdown(hdvp, false);     //
+				sensor_pwdn_line(hcmr, false);     //
 				dly_tsk(10);                        //
-				dvp_dcmi_reset(hdvp, false);
+				sensor_reset_line(hcmr, false);
 				dly_tsk(10);
 
 				hcmr->_slaveAddr = cambus_scan(hcmr);
@@ -900,6 +1319,7 @@ ov7740_sensor_ov_detect(OV7740_t *hcmr)
 				return E_SYS;
 			}
 		}
+		sensor_probe_store(hcmr, cambus_reg_width());
 	}
 	return E_OK;
 }
@@ -907,13 +1327,14 @@ ov7740_sensor_ov_detect(OV7740_t *hcmr)
 ER
 ov7740_sensor_gc_detect(OV7740_t *hcmr)
 {
-	DVP_Handle_t *hdvp = hcmr->hdvp;
 	uint8_t id;
 
-	dvp_dcmi_powerdown(hdvp, false);//enable gc0328 ײ? normal ϼ PWDN pin ?ʿ¨ġƱ?ϲ¸¨
-	dvp_dcmi_reset(hdvp, true);	//reset gc0328
+	if(sensor_probe_restore(hcmr, true) == E_OK)
+		return E_OK;
+	sensor_pwdn_line(hcmr, false);//enable gc0328 要恢? normal 工作模式，需将 PWDN pin 接入低?平即可，同?写入初始化寄存器即可
+	sensor_reset_line(hcmr, true);	//reset gc0328
 	dly_tsk(10);
-	dvp_dcmi_reset(hdvp, false);
+	sensor_reset_line(hcmr, false);
 	dly_tsk(10);
 	id = cambus_scan_gc0328();
 	if(0 == id){
@@ -924,6 +1345,7 @@ ov7740_sensor_gc_detect(OV7740_t *hcmr)
 		hcmr->_slaveAddr = GC0328_ADDR;
 		hcmr->_id = id;
 		cambus_set_writeb_delay(2);
+		sensor_probe_store(hcmr, cambus_reg_width());
 	}
 	return E_OK;
 }
@@ -932,42 +1354,40 @@ ov7740_sensor_gc_detect(OV7740_t *hcmr)
 ER
 ov7740_reset(OV7740_t *hcmr)
 {
-	int i=0;
-	const uint8_t (*regs)[2];
+	ER_UINT ercd;
 
 	/* Reset all registers */
 	cambus_writeb(hcmr->_slaveAddr, 0x12, 0x80);
+	ov7740_shadow_invalidate(hcmr);
 
 	/* delay n ms */
 	dly_tsk(2);
 
-	i = 0;
-	regs = ov7740_default;
 	/* Write initial regsiters */
-	while (regs[i][0]) {
-		cambus_writeb(hcmr->_slaveAddr, regs[i][0], regs[i][1]);
-		i++;
-	}
+	ercd = cambus_write_table(hcmr->_slaveAddr, ov7740_default, SENSOR_REG_VERIFY);
+	if(ercd < 0)
+		return ercd;
+	sensor_shadow_table(hcmr, ov7740_default);
+	if(ercd > 0)
+		syslog_1(LOG_NOTICE, "ov7740_reset verify mismatch(%d)", ercd);
 	return E_OK;
 }
 
 ER
 gc0328_reset(OV7740_t *hcmr)
 {
-	uint16_t index = 0;
-	
+	ER_UINT ercd;
+	SYSTIM  stime, etime;
+
+	get_tim(&stime);
 	cambus_writeb(GC0328_ADDR, 0xfe, 0x01);
-	for (index = 0; gc0328_default_regs[index][0]; index++)
-	{
-		if(gc0328_default_regs[index][0] == 0xff){
-			dly_tsk(gc0328_default_regs[index][1]);
-			continue;
-		}
-		if(gc0328_default_regs[index][0] == 0x00){
-			continue;
-		}
-		cambus_writeb(GC0328_ADDR, gc0328_default_regs[index][0], gc0328_default_regs[index][1]);
-	}
+	ercd = cambus_write_table(GC0328_ADDR, gc0328_default_regs, SENSOR_REG_VERIFY);
+	if(ercd < 0)
+		return ercd;
+	ov7740_shadow_invalidate(hcmr);
+	sensor_shadow_table(hcmr, gc0328_default_regs);
+	get_tim(&etime);
+	syslog_2(LOG_INFO, "gc0328_reset %d ms verify mismatch(%d)", (int)(etime - stime), ercd);
 	return E_OK;
 }
 
@@ -984,12 +1404,13 @@ ov7740_set_pixformat(OV7740_t *hcmr)
 ER
 gc0328_set_pixformat(OV7740_t *hcmr)
 {
-	int i=0;
+	ER_UINT ercd;
 	const uint8_t (*regs)[2]=NULL;
 
 	/* read pixel format reg */
 	switch (hcmr->pixFormat) {
 		case PIXFORMAT_RGB565:
+		case PIXFORMAT_JPEG:	/* RGB565で取り込みソフトウェアで符号化 */
 			regs = gc0328_rgb565_regs;
 			break;
 		case PIXFORMAT_YUV422:
@@ -1001,12 +1422,13 @@ gc0328_set_pixformat(OV7740_t *hcmr)
 	}
 
 	/* Write initial regsiters */
-	while (regs[i][0]) {
-		cambus_writeb(hcmr->_slaveAddr, regs[i][0], regs[i][1]);
-		i++;
-	}
+	ercd = cambus_write_table(hcmr->_slaveAddr, regs, false);
+	if(ercd < 0)
+		return ercd;
+	sensor_shadow_table(hcmr, regs);
 	switch (hcmr->pixFormat) {
 		case PIXFORMAT_RGB565:
+		case PIXFORMAT_JPEG:
 			hcmr->hdvp->Init.Format = DVP_CFG_RGB_FORMAT;
 			dvp_set_image_format(hcmr->hdvp);
 			break;
@@ -1032,26 +1454,50 @@ ov7740_set_framesize(OV7740_t *hcmr)
 	uint16_t w = hcmr->_width;
 	uint16_t h = hcmr->_height;
 
-	// VGA
-	if ((w > 320) || (h > 240))
-	{
-		cambus_writeb(hcmr->_slaveAddr, 0x31, 0xA0);
-		cambus_writeb(hcmr->_slaveAddr, 0x32, 0xF0);
-		cambus_writeb(hcmr->_slaveAddr, 0x82, 0x32);
-	}
-	// QVGA
-	else if( ((w <= 320) && (h <= 240)) && ((w > 160) || (h > 120)) )
-	{
-		cambus_writeb(hcmr->_slaveAddr, 0x31, 0x50);
-		cambus_writeb(hcmr->_slaveAddr, 0x32, 0x78);
-		cambus_writeb(hcmr->_slaveAddr, 0x82, 0x3F);
+	if(hcmr->frameSize == FRAMESIZE_CUSTOM && hcmr->_subsample != 0){
+		/* センサーウィンドウ(4ピクセル/2ライン単位) */
+		sensor_writeb(hcmr, 0x17, OV7740_AHSTART + (hcmr->_winX >> 2));
+		sensor_writeb(hcmr, 0x18, hcmr->_winW >> 2);
+		sensor_writeb(hcmr, 0x19, OV7740_AVSTART + (hcmr->_winY >> 1));
+		sensor_writeb(hcmr, 0x1A, hcmr->_winH >> 1);
+		/* 出力サイズ、ウィンドウと異なる場合はISPスケーラを使用 */
+		sensor_writeb(hcmr, 0x31, w >> 2);
+		sensor_writeb(hcmr, 0x32, h >> 1);
+		if(w == hcmr->_winW && h == hcmr->_winH)
+			sensor_writeb(hcmr, 0x82, 0x32);
+		else
+			sensor_writeb(hcmr, 0x82, 0x3F);
 	}
-	// QQVGA
-	else
-	{
-		cambus_writeb(hcmr->_slaveAddr, 0x31, 0x28);
-		cambus_writeb(hcmr->_slaveAddr, 0x32, 0x3c);
-		cambus_writeb(hcmr->_slaveAddr, 0x82, 0x3F);
+	else{
+		if(hcmr->_subsample != 0){
+			/* ウィンドウ設定からVGA全面に戻す */
+			sensor_writeb(hcmr, 0x17, OV7740_AHSTART);
+			sensor_writeb(hcmr, 0x18, OV7740_AHSIZE);
+			sensor_writeb(hcmr, 0x19, OV7740_AVSTART);
+			sensor_writeb(hcmr, 0x1A, OV7740_AVSIZE);
+			hcmr->_subsample = 0;
+		}
+		// VGA
+		if ((w > 320) || (h > 240))
+		{
+			sensor_writeb(hcmr, 0x31, 0xA0);
+			sensor_writeb(hcmr, 0x32, 0xF0);
+			sensor_writeb(hcmr, 0x82, 0x32);
+		}
+		// QVGA
+		else if( ((w <= 320) && (h <= 240)) && ((w > 160) || (h > 120)) )
+		{
+			sensor_writeb(hcmr, 0x31, 0x50);
+			sensor_writeb(hcmr, 0x32, 0x78);
+			sensor_writeb(hcmr, 0x82, 0x3F);
+		}
+		// QQVGA
+		else
+		{
+			sensor_writeb(hcmr, 0x31, 0x28);
+			sensor_writeb(hcmr, 0x32, 0x3c);
+			sensor_writeb(hcmr, 0x82, 0x3F);
+		}
 	}
 
 	/* delay n ms */
@@ -1066,20 +1512,54 @@ gc0328_set_framesize(OV7740_t *hcmr)
 {
 	uint16_t w = hcmr->_width;
 	uint16_t h = hcmr->_height;
-
-	int i=0;
+	uint16_t cx, cy;
+	uint8_t  sub;
+	ER_UINT  ercd;
 	const uint8_t (*regs)[2];
 
-	if ((w <= 320) && (h <= 240)) {
-		regs = gc0328_qvga_config;
-	} else {
-		regs = gc0328_vga_config;
+	if(hcmr->frameSize == FRAMESIZE_CUSTOM && hcmr->_subsample != 0){
+		/* クロップはサブサンプル後の座標で指定する */
+		sub = hcmr->_subsample;
+		cx  = hcmr->_winX / sub;
+		cy  = hcmr->_winY / sub;
+		sensor_writeb(hcmr, 0xfe, 0x00);
+		if(sub == 1)
+			sensor_writeb(hcmr, 0x4b, 0x8b);
+		sensor_writeb(hcmr, 0x50, 0x01);
+		sensor_writeb(hcmr, 0x51, cy >> 8);
+		sensor_writeb(hcmr, 0x52, cy & 0xff);
+		sensor_writeb(hcmr, 0x53, cx >> 8);
+		sensor_writeb(hcmr, 0x54, cx & 0xff);
+		sensor_writeb(hcmr, 0x55, h >> 8);
+		sensor_writeb(hcmr, 0x56, h & 0xff);
+		sensor_writeb(hcmr, 0x57, w >> 8);
+		sensor_writeb(hcmr, 0x58, w & 0xff);
+		sensor_writeb(hcmr, 0x59, (sub << 4) | sub);
+		sensor_writeb(hcmr, 0x5a, (sub == 1) ? 0x02 : 0x00);
 	}
+	else{
+		if ((w <= 320) && (h <= 240)) {
+			regs = gc0328_qvga_config;
+		} else {
+			regs = gc0328_vga_config;
+		}
 
-	while (regs[i][0]) {
-		cambus_writeb(hcmr->_slaveAddr, regs[i][0], regs[i][1]);
-//        msleep(1);
-		i++;
+		ercd = cambus_write_table(hcmr->_slaveAddr, regs, false);
+		if(ercd < 0)
+			return ercd;
+		sensor_shadow_table(hcmr, regs);
+		if(hcmr->_subsample != 0 && regs == gc0328_qvga_config){
+			/* ウィンドウ設定からQVGA全面に戻す */
+			sensor_writeb(hcmr, 0x51, 0x00);
+			sensor_writeb(hcmr, 0x52, 0x00);
+			sensor_writeb(hcmr, 0x53, 0x00);
+			sensor_writeb(hcmr, 0x54, 0x00);
+			sensor_writeb(hcmr, 0x55, 0x00);
+			sensor_writeb(hcmr, 0x56, 0xf0);
+			sensor_writeb(hcmr, 0x57, 0x01);
+			sensor_writeb(hcmr, 0x58, 0x40);
+		}
+		hcmr->_subsample = 0;
 	}
 	/* delay n ms */
 //    mp_hal_delay_ms(30);
@@ -1089,6 +1569,140 @@ gc0328_set_framesize(OV7740_t *hcmr)
 	return dvp_set_image_size(hcmr->hdvp);
 }
 
+/*
+ *  OV7740センサーウィンドウ(ROI)設定
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  x: ウィンドウ開始X(VGA座標、4の倍数)
+ *  parameter3  y: ウィンドウ開始Y(VGA座標、2の倍数)
+ *  parameter4  w: ウィンドウ幅(4の倍数)
+ *  parameter5  h: ウィンドウ高さ(2の倍数)
+ *  parameter6  subsample: 縮小率(1,2,4)、ISPスケーラで縮小する
+ *  return      ERコード
+ *  出力サイズ(w/subsample x h/subsample)は_width,_heightとDVPに設定される．
+ *  _dataBufferはこのサイズ以上を確保しておくこと．
+ */
+ER
+ov7740_set_window(OV7740_t *hcmr, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t subsample)
+{
+	ER ercd;
+
+	ercd = sensor_set_window_param(hcmr, x, y, w, h, subsample);
+	if(ercd != E_OK)
+		return ercd;
+	return ov7740_set_framesize(hcmr);
+}
+
+/*
+ *  GC0328センサーウィンドウ(ROI)設定
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  x: ウィンドウ開始X(VGA座標、4の倍数)
+ *  parameter3  y: ウィンドウ開始Y(VGA座標、2の倍数)
+ *  parameter4  w: ウィンドウ幅(4の倍数)
+ *  parameter5  h: ウィンドウ高さ(2の倍数)
+ *  parameter6  subsample: サブサンプル率(1,2,4)
+ *  return      ERコード
+ */
+ER
+gc0328_set_window(OV7740_t *hcmr, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t subsample)
+{
+	ER ercd;
+
+	ercd = sensor_set_window_param(hcmr, x, y, w, h, subsample);
+	if(ercd != E_OK)
+		return ercd;
+	return gc0328_set_framesize(hcmr);
+}
+
+/*
+ *  フレームレートからfps値への変換
+ */
+static int
+framerate_fps(framerate_t framerate)
+{
+	switch(framerate){
+	case FRAMERATE_2FPS:
+		return 2;
+	case FRAMERATE_8FPS:
+		return 8;
+	case FRAMERATE_15FPS:
+		return 15;
+	case FRAMERATE_30FPS:
+		return 30;
+	case FRAMERATE_60FPS:
+		return 60;
+	default:
+		return 0;
+	}
+}
+
+/*
+ *  OV7740フレームレート設定
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  framerate: フレームレート
+ *  return      ERコード
+ *  CLKRC(REG11)のクロック分周で60fpsを基準に分周する
+ */
+ER
+ov7740_set_framerate(OV7740_t *hcmr, framerate_t framerate)
+{
+	if(framerate_fps(framerate) == 0)
+		return E_PAR;
+	sensor_writeb(hcmr, 0x11, framerate & 0x3F);
+	return E_OK;
+}
+
+/*
+ *  GC0328フレームレート設定
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  framerate: フレームレート
+ *  return      ERコード
+ *  垂直ブランキング(VB)のダミーラインで30fpsから落とす、60fpsは未対応
+ *  VB上限(4095)により約3.3fps(30*508/(496+4095))が下限となり、2fps指定時は
+ *  約3.3fpsで動作する
+ */
+ER
+gc0328_set_framerate(OV7740_t *hcmr, framerate_t framerate)
+{
+	int fps = framerate_fps(framerate);
+	uint32_t vb;
+
+	if(fps == 0 || fps > 30)
+		return E_PAR;
+	vb = GC0328_FRAME_LINES * 30 / fps - (GC0328_FRAME_LINES - GC0328_VB_DEFAULT);
+	if(vb > GC0328_VB_MAX)
+		vb = GC0328_VB_MAX;
+	sensor_writeb(hcmr, 0xfe, 0x00);
+	sensor_writeb(hcmr, 0x07, (vb >> 8) & 0x0f);
+	sensor_writeb(hcmr, 0x08, vb & 0xff);
+	return E_OK;
+}
+
+/*
+ *  実測フレームレート取得
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  fps_x100: fps値の100倍を返す領域へのポインタ
+ *  return      ERコード
+ *  DVPフレーム終了割込みの間隔から算出する、計測前はE_OBJ
+ */
+ER
+ov7740_get_fps(OV7740_t *hcmr, uint32_t *fps_x100)
+{
+	DVP_FrameInfo_t info;
+	ER ercd;
+
+	if(fps_x100 == NULL)
+		return E_PAR;
+	ercd = dvp_get_frameinfo(hcmr->hdvp, &info);
+	if(ercd != E_OK)
+		return ercd;
+	if(info.finish_interval == 0){
+		*fps_x100 = 0;
+		return E_OBJ;
+	}
+	*fps_x100 = 100000000 / info.finish_interval;
+	return E_OK;
+}
+
 ER
 ov7740_activate(OV7740_t *hcmr, bool_t run)
 {
@@ -1119,6 +1733,95 @@ ov7740_snapshot(OV7740_t *hcmr)
 			dly_tsk(1);
 	}
 	reverse_u32pixel((uint32_t*)hcmr->_dataBuffer, hcmr->_width * hcmr->_height/2);
+	if(hcmr->pixFormat == PIXFORMAT_JPEG && hcmr->_jpegBuffer != NULL)
+		return ov7740_jpeg_encode(hcmr, hcmr->_jpegBuffer, hcmr->_jpegSize, &hcmr->_jpegLen);
+	return E_OK;
+}
+
+/*
+ *  双眼キャプチャの初期化
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  bino: 双眼キャプチャ構造体へのポインタ
+ *  return      ERコード
+ *  パワーダウン線でセンサー0,1を順に選択してリセットとフォーマット、
+ *  フレームサイズ設定を行い、DVPを双眼キャプチャに設定する．
+ *  両センサーは同じスレーブアドレスで、選択中のセンサーのみ応答する
+ *  ため、以降の設定変更は選択中(待機時はセンサー0)にのみ反映される．
+ */
+ER
+ov7740_binocular_reset(OV7740_t *hcmr, DVP_Binocular_t *bino)
+{
+	DVP_Handle_t *hdvp = hcmr->hdvp;
+	uint8_t no;
+	ER      ercd = E_OK;
+
+	if(bino == NULL || bino->RGBAddr[0] == 0 || bino->RGBAddr[1] == 0)
+		return E_PAR;
+	dvp_set_binocular(hdvp, NULL);
+	for(no = 0 ; no < 2 && ercd == E_OK ; no++){
+		dvp_select_sensor(hdvp, bino, no);
+		dly_tsk(10);
+		if(hcmr->_id == GC0328_ID){
+			ercd = gc0328_reset(hcmr);
+			if(ercd == E_OK)
+				ercd = gc0328_set_pixformat(hcmr);
+			if(ercd == E_OK)
+				ercd = gc0328_set_framesize(hcmr);
+		}
+		else{
+			ercd = ov7740_reset(hcmr);
+			if(ercd == E_OK)
+				ercd = ov7740_set_pixformat(hcmr);
+			if(ercd == E_OK)
+				ercd = ov7740_set_framesize(hcmr);
+		}
+		if(ercd != E_OK)
+			syslog_2(LOG_ERROR, "ov7740_binocular_reset sensor(%d) error(%d)", no, ercd);
+	}
+	if(ercd != E_OK){
+		dvp_select_sensor(hdvp, bino, 0);
+		return ercd;
+	}
+	return dvp_set_binocular(hdvp, bino);
+}
+
+/*
+ *  双眼キャプチャのスナップショット
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  bino: 双眼キャプチャ構造体へのポインタ
+ *  parameter3  pair: フレームペアの格納先
+ *  return      ERコード
+ *  センサー0,1の順に連続するフレームを取り込む．切り替えは
+ *  フレーム終了割込みで行うため、ペアの時刻差は1+Settleフレーム以上となる．
+ */
+ER
+ov7740_snapshot_pair(OV7740_t *hcmr, DVP_Binocular_t *bino, SENSOR_Pair_t *pair)
+{
+	DVP_Handle_t *hdvp = hcmr->hdvp;
+	int32_t timeout = SNAPDHOT_TIMEOUT * 2;
+	uint8_t no;
+
+	if(bino == NULL || pair == NULL)
+		return E_PAR;
+
+	hdvp->state = DVP_STATE_ACTIVATE;
+	while(hdvp->state != DVP_STATE_FINISH){
+		if(--timeout <= 0){
+			dvp_select_sensor(hdvp, bino, 0);
+			return E_TMOUT;
+		}
+		if(hdvp->semid != 0)
+			twai_sem(hdvp->semid, 1);
+		else
+			dly_tsk(1);
+	}
+	for(no = 0 ; no < 2 ; no++){
+		pair->buf[no]  = (uint32_t *)DVP_HOST_ADDR(bino->RGBAddr[no]);
+		pair->time[no] = bino->start_time[no];
+		reverse_u32pixel(pair->buf[no], hcmr->_width * hcmr->_height/2);
+	}
+	pair->skew = (uint32_t)(pair->time[1] - pair->time[0]);
+	pair->seq  = bino->pair_count;
 	return E_OK;
 }
 
@@ -1146,18 +1849,18 @@ ov7740_set_contrast(OV7740_t *hcmr, int level)
 	if (level < 0 || level >= NUM_CONTRAST_LEVELS) {
 		return E_PAR;
 	}
-	cambus_readb(hcmr->_slaveAddr, 0x81,&tmp);
+	sensor_readb(hcmr, 0x81,&tmp);
 	tmp |= 0x20;
-	cambus_writeb(hcmr->_slaveAddr, 0x81, tmp);
-	cambus_readb(hcmr->_slaveAddr, 0xDA,&tmp);
+	sensor_writeb(hcmr, 0x81, tmp);
+	sensor_readb(hcmr, 0xDA,&tmp);
 	tmp |= 0x04;
-	cambus_writeb(hcmr->_slaveAddr, 0xDA, tmp);
-	cambus_writeb(hcmr->_slaveAddr, 0xE1, contrast_regs[level][0]);
-	cambus_writeb(hcmr->_slaveAddr, 0xE2, contrast_regs[level][1]);
-	cambus_writeb(hcmr->_slaveAddr, 0xE3, contrast_regs[level][2]);
-	cambus_readb(hcmr->_slaveAddr, 0xE4,&tmp);
+	sensor_writeb(hcmr, 0xDA, tmp);
+	sensor_writeb(hcmr, 0xE1, contrast_regs[level][0]);
+	sensor_writeb(hcmr, 0xE2, contrast_regs[level][1]);
+	sensor_writeb(hcmr, 0xE3, contrast_regs[level][2]);
+	sensor_readb(hcmr, 0xE4,&tmp);
 	tmp &= 0xFB;
-	cambus_writeb(hcmr->_slaveAddr, 0xE4, tmp);
+	sensor_writeb(hcmr, 0xE4, tmp);
 	return E_OK;
 }
 
@@ -1170,14 +1873,14 @@ ov7740_set_brightness(OV7740_t *hcmr, int level)
 	if (level < 0 || level >= NUM_BRIGHTNESS_LEVELS) {
 		return E_PAR;
 	}
-	cambus_readb(hcmr->_slaveAddr, 0x81,&tmp);
+	sensor_readb(hcmr, 0x81,&tmp);
 	tmp |= 0x20;
-	cambus_writeb(hcmr->_slaveAddr, 0x81, tmp);
-	cambus_readb(hcmr->_slaveAddr, 0xDA,&tmp);
+	sensor_writeb(hcmr, 0x81, tmp);
+	sensor_readb(hcmr, 0xDA,&tmp);
 	tmp |= 0x04;
-	cambus_writeb(hcmr->_slaveAddr, 0xDA, tmp);
-	cambus_writeb(hcmr->_slaveAddr, 0xE4, brightness_regs[level][0]);
-	cambus_writeb(hcmr->_slaveAddr, 0xE3, brightness_regs[level][1]);
+	sensor_writeb(hcmr, 0xDA, tmp);
+	sensor_writeb(hcmr, 0xE4, brightness_regs[level][0]);
+	sensor_writeb(hcmr, 0xE3, brightness_regs[level][1]);
 	return E_OK;
 }
 
@@ -1190,14 +1893,14 @@ ov7740_set_saturation(OV7740_t *hcmr, int level)
 	if (level < 0 || level >= NUM_SATURATION_LEVELS) {
 		return E_PAR;
 	}
-	cambus_readb(hcmr->_slaveAddr, 0x81,&tmp);
+	sensor_readb(hcmr, 0x81,&tmp);
 	tmp |= 0x20;
-	cambus_writeb(hcmr->_slaveAddr, 0x81, tmp);
-	cambus_readb(hcmr->_slaveAddr, 0xDA,&tmp);
+	sensor_writeb(hcmr, 0x81, tmp);
+	sensor_readb(hcmr, 0xDA,&tmp);
 	tmp |= 0x02;
-	cambus_writeb(hcmr->_slaveAddr, 0xDA, tmp);
-	cambus_writeb(hcmr->_slaveAddr, 0xDD, saturation_regs[level][0]);
-	cambus_writeb(hcmr->_slaveAddr, 0xDE, saturation_regs[level][1]);
+	sensor_writeb(hcmr, 0xDA, tmp);
+	sensor_writeb(hcmr, 0xDD, saturation_regs[level][0]);
+	sensor_writeb(hcmr, 0xDE, saturation_regs[level][1]);
 	return E_OK;
 }
 
@@ -1209,13 +1912,23 @@ ov7740_set_gainceiling(OV7740_t *hcmr, gainceiling_t gainceiling)
 	if(ceiling > GAINCEILING_32X)
 		ceiling = GAINCEILING_32X;
 	tmp = (ceiling & 0x07) << 4;
-	cambus_writeb(hcmr->_slaveAddr, 0x14, tmp);
+	sensor_writeb(hcmr, 0x14, tmp);
 	return E_OK;
 }
 
+/*
+ *  JPEG品質設定
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  qs: 品質(1-100)
+ *  return      ERコード
+ *  センサーはJPEGを出力しないため、ソフトウェアエンコーダの品質となる
+ */
 ER
 ov7740_set_quality(OV7740_t *hcmr, int qs)
 {
+	if(qs < 1 || qs > 100)
+		return E_PAR;
+	hcmr->_quality = qs;
 	return E_OK;
 }
 
@@ -1224,13 +1937,13 @@ ov7740_set_colorbar(OV7740_t *hcmr, bool_t enable)
 {
 	if(enable)
 	{
-		cambus_writeb(hcmr->_slaveAddr, 0x38, 0x07);
-		cambus_writeb(hcmr->_slaveAddr, 0x84, 0x02);
+		sensor_writeb(hcmr, 0x38, 0x07);
+		sensor_writeb(hcmr, 0x84, 0x02);
 	}
 	else
 	{
-		cambus_writeb(hcmr->_slaveAddr, 0x38, 0x07);
-		cambus_writeb(hcmr->_slaveAddr, 0x84, 0x00);
+		sensor_writeb(hcmr, 0x38, 0x07);
+		sensor_writeb(hcmr, 0x84, 0x00);
 	}
 	return E_OK;
 }
@@ -1240,16 +1953,16 @@ ov7740_set_auto_exposure(OV7740_t *hcmr, bool_t enable, int exposure_us)
 {
 	uint8_t tmp = 0;
 
-	cambus_readb(hcmr->_slaveAddr, 0x13, &tmp);
+	sensor_readb(hcmr, 0x13, &tmp);
 	if(enable != 0)
 	{
-		cambus_writeb(hcmr->_slaveAddr, 0x13, tmp | 0x01);
+		sensor_writeb(hcmr, 0x13, tmp | 0x01);
 	}
 	else
 	{
-		cambus_writeb(hcmr->_slaveAddr, 0x13, tmp & 0xFE);
-		cambus_writeb(hcmr->_slaveAddr, 0x0F, (uint8_t)(exposure_us>>8));
-		cambus_writeb(hcmr->_slaveAddr, 0x10, (uint8_t)exposure_us);
+		sensor_writeb(hcmr, 0x13, tmp & 0xFE);
+		sensor_writeb(hcmr, 0x0F, (uint8_t)(exposure_us>>8));
+		sensor_writeb(hcmr, 0x10, (uint8_t)exposure_us);
 	}
 	return E_OK;
 }
@@ -1259,9 +1972,9 @@ ov7740_get_exposure_us(OV7740_t *hcmr, int *exposure_us)
 {
 	uint8_t tmp = 0;
 
-	cambus_readb(hcmr->_slaveAddr, 0x0F, &tmp);
+	sensor_readb(hcmr, 0x0F, &tmp);
 	*exposure_us = tmp<<8 & 0xFF00;
-	cambus_readb(hcmr->_slaveAddr, 0x10, &tmp);
+	sensor_readb(hcmr, 0x10, &tmp);
 	*exposure_us = tmp | *exposure_us;
 	return E_OK;
 }
@@ -1271,23 +1984,23 @@ ov7740_set_auto_whitebal(OV7740_t *hcmr, bool_t enable, float r_gain_db, float g
 {
 	uint8_t tmp = 0;
 
-	cambus_readb(hcmr->_slaveAddr, 0x80, &tmp);
+	sensor_readb(hcmr, 0x80, &tmp);
 	if(enable != 0)
 	{
-		cambus_writeb(hcmr->_slaveAddr, 0x80, tmp | 0x14);
+		sensor_writeb(hcmr, 0x80, tmp | 0x14);
 	}
 	else
 	{
 		if((uint16_t)r_gain_db!= 0xFFFF && (uint16_t)g_gain_db!=0xFFFF && (uint16_t)b_gain_db!=0xFFFF)
 		{
-			cambus_writeb(hcmr->_slaveAddr, 0x80, tmp & 0xEF);
-			cambus_writeb(hcmr->_slaveAddr, 0x01, (uint8_t)b_gain_db);
-			cambus_writeb(hcmr->_slaveAddr, 0x02, (uint8_t)r_gain_db);
-			cambus_writeb(hcmr->_slaveAddr, 0x03, (uint8_t)g_gain_db);
+			sensor_writeb(hcmr, 0x80, tmp & 0xEF);
+			sensor_writeb(hcmr, 0x01, (uint8_t)b_gain_db);
+			sensor_writeb(hcmr, 0x02, (uint8_t)r_gain_db);
+			sensor_writeb(hcmr, 0x03, (uint8_t)g_gain_db);
 		}
 		else
 		{
-			cambus_writeb(hcmr->_slaveAddr, 0x80, tmp & 0xEB);
+			sensor_writeb(hcmr, 0x80, tmp & 0xEB);
 		}
 	}
 	return E_OK;
@@ -1297,8 +2010,150 @@ ER
 ov7740_set_vflip(OV7740_t *hcmr, bool_t enable)
 {
 	uint8_t reg;
-	cambus_readb(hcmr->_slaveAddr, 0x0C, &reg);
-	cambus_writeb(hcmr->_slaveAddr, 0x0C, OV7740_SET_FLIP(reg, enable));
+	sensor_readb(hcmr, 0x0C, &reg);
+	sensor_writeb(hcmr, 0x0C, OV7740_SET_FLIP(reg, enable));
+	return E_OK;
+}
+
+/*
+ *  OV7740ゲインレジスタ値への変換
+ *  上位6ビットは各2倍、下位4ビットは1/16単位の端数
+ */
+static uint16_t
+ov7740_gain_code(uint16_t gain)
+{
+	uint16_t hi = 0;
+
+	if(gain < SENSOR_GAIN_UNIT)
+		gain = SENSOR_GAIN_UNIT;
+	while(gain >= SENSOR_GAIN_UNIT * 2 && hi < 0x3F){
+		gain >>= 1;
+		hi = (hi << 1) | 1;
+	}
+	if(gain >= SENSOR_GAIN_UNIT * 2)
+		gain = SENSOR_GAIN_UNIT * 2 - 1;
+	return (hi << 4) | (gain - SENSOR_GAIN_UNIT);
+}
+
+static uint16_t
+ov7740_gain_value(uint16_t code)
+{
+	uint16_t gain = SENSOR_GAIN_UNIT + (code & 0x0F);
+	uint16_t hi;
+
+	for(hi = code >> 4 ; hi != 0 ; hi >>= 1){
+		if(hi & 1)
+			gain <<= 1;
+	}
+	return gain;
+}
+
+/*
+ *  手動露出・ゲイン設定
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  exposure: 露光時間(ライン数)
+ *  parameter3  gain: ゲイン(SENSOR_GAIN_UNITで1倍)
+ *  return      ERコード
+ *  センサーの自動露出・自動ゲインは停止する．
+ *  OV7740:AEC(0x0F/0x10)、ゲイン(0x00,0x15[1:0])
+ *  GC0328:露光(P0 0x03/0x04)、グローバルゲイン(P0 0x70、0x40で1倍)
+ */
+ER
+ov7740_set_manual_exposure(OV7740_t *hcmr, uint16_t exposure, uint16_t gain)
+{
+	uint8_t tmp = 0;
+	uint16_t code;
+
+	if(exposure == 0 || gain < SENSOR_GAIN_UNIT || gain > SENSOR_GAIN_MAX)
+		return E_PAR;
+	if(hcmr->_id == GC0328_ID){
+		if(exposure > 0x0FFF || gain > SENSOR_GAIN_UNIT * 255 / 0x40)
+			return E_PAR;
+		sensor_writeb(hcmr, 0xfe, 0x00);
+		sensor_readb(hcmr, 0x4f, &tmp);
+		sensor_writeb(hcmr, 0x4f, tmp & 0xFE);
+		sensor_writeb(hcmr, 0x03, (exposure >> 8) & 0x0F);
+		sensor_writeb(hcmr, 0x04, exposure & 0xFF);
+		sensor_writeb(hcmr, 0x70, gain * 0x40 / SENSOR_GAIN_UNIT);
+	}
+	else{
+		sensor_readb(hcmr, 0x13, &tmp);
+		sensor_writeb(hcmr, 0x13, tmp & ~0x05);
+		sensor_writeb(hcmr, 0x0F, exposure >> 8);
+		sensor_writeb(hcmr, 0x10, exposure & 0xFF);
+		code = ov7740_gain_code(gain);
+		sensor_readb(hcmr, 0x15, &tmp);
+		sensor_writeb(hcmr, 0x15, (tmp & 0xFC) | ((code >> 8) & 0x03));
+		sensor_writeb(hcmr, 0x00, code & 0xFF);
+	}
+	return E_OK;
+}
+
+/*
+ *  現在の露出・ゲイン取得
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  exposure: 露光時間(ライン数)を返す領域へのポインタ
+ *  parameter3  gain: ゲイン(SENSOR_GAIN_UNITで1倍)を返す領域へのポインタ
+ *  return      ERコード
+ */
+ER
+ov7740_get_manual_exposure(OV7740_t *hcmr, uint16_t *exposure, uint16_t *gain)
+{
+	uint8_t hi = 0, lo = 0;
+
+	if(exposure == NULL || gain == NULL)
+		return E_PAR;
+	if(hcmr->_id == GC0328_ID){
+		sensor_writeb(hcmr, 0xfe, 0x00);
+		sensor_readb(hcmr, 0x03, &hi);
+		sensor_readb(hcmr, 0x04, &lo);
+		*exposure = ((hi & 0x0F) << 8) | lo;
+		sensor_readb(hcmr, 0x70, &lo);
+		*gain = lo * SENSOR_GAIN_UNIT / 0x40;
+	}
+	else{
+		sensor_readb(hcmr, 0x0F, &hi);
+		sensor_readb(hcmr, 0x10, &lo);
+		*exposure = (hi << 8) | lo;
+		sensor_readb(hcmr, 0x15, &hi);
+		sensor_readb(hcmr, 0x00, &lo);
+		*gain = ov7740_gain_value(((hi & 0x03) << 8) | lo);
+	}
+	if(*gain < SENSOR_GAIN_UNIT)
+		*gain = SENSOR_GAIN_UNIT;
+	return E_OK;
+}
+
+/*
+ *  手動ホワイトバランス設定
+ *  parameter1  hcmr: カメラハンドラへのポインタ
+ *  parameter2  rgain: Rゲイン(SENSOR_WB_UNITで1倍)
+ *  parameter3  ggain: Gゲイン
+ *  parameter4  bgain: Bゲイン
+ *  return      ERコード
+ *  センサーの自動ホワイトバランスは停止する．
+ *  OV7740:0x02/0x03/0x01、GC0328:P0 0x77/0x78/0x79
+ */
+ER
+ov7740_set_manual_whitebal(OV7740_t *hcmr, uint8_t rgain, uint8_t ggain, uint8_t bgain)
+{
+	uint8_t tmp = 0;
+
+	if(hcmr->_id == GC0328_ID){
+		sensor_writeb(hcmr, 0xfe, 0x00);
+		sensor_readb(hcmr, 0x42, &tmp);
+		sensor_writeb(hcmr, 0x42, tmp & ~0x02);
+		sensor_writeb(hcmr, 0x77, rgain);
+		sensor_writeb(hcmr, 0x78, ggain);
+		sensor_writeb(hcmr, 0x79, bgain);
+	}
+	else{
+		sensor_readb(hcmr, 0x80, &tmp);
+		sensor_writeb(hcmr, 0x80, tmp & 0xEF);
+		sensor_writeb(hcmr, 0x01, bgain);
+		sensor_writeb(hcmr, 0x02, rgain);
+		sensor_writeb(hcmr, 0x03, ggain);
+	}
 	return E_OK;
 }
 
@@ -1310,23 +2165,23 @@ ov7740_set_auto_gain(OV7740_t *hcmr, bool_t enable, float gain_db, float gain_db
 	uint16_t gain = (uint16_t)gain_db;
 	uint8_t ceiling = (uint8_t)gain_db_ceiling;
 
-	cambus_readb(hcmr->_slaveAddr, 0x13, &tmp);
+	sensor_readb(hcmr, 0x13, &tmp);
 	if(enable != 0)
 	{
-		cambus_writeb(hcmr->_slaveAddr, 0x13, tmp | 0x04);
+		sensor_writeb(hcmr, 0x13, tmp | 0x04);
 	}
 	else
 	{
-		cambus_writeb(hcmr->_slaveAddr, 0x13, tmp & 0xFB);
+		sensor_writeb(hcmr, 0x13, tmp & 0xFB);
 		if(gain!=0xFFFF && (uint16_t)gain_db_ceiling!=0xFFFF)
 		{
-			cambus_readb(hcmr->_slaveAddr, 0x15, &tmp);
+			sensor_readb(hcmr, 0x15, &tmp);
 			tmp = (tmp & 0xFC) | (gain>>8 & 0x03);
-			cambus_writeb(hcmr->_slaveAddr, 0x15, tmp);
+			sensor_writeb(hcmr, 0x15, tmp);
 			tmp = gain & 0xFF;
-			cambus_writeb(hcmr->_slaveAddr, 0x00, tmp);
+			sensor_writeb(hcmr, 0x00, tmp);
 			tmp = (ceiling & 0x07) << 4;
-			cambus_writeb(hcmr->_slaveAddr, 0x14, tmp);
+			sensor_writeb(hcmr, 0x14, tmp);
 		}
 	}
 	return E_OK;
@@ -1338,9 +2193,9 @@ ov7740_get_gain_db(OV7740_t *hcmr, float *gain_db)
 	uint8_t tmp = 0;
 	uint16_t gain;
 
-	cambus_readb(hcmr->_slaveAddr, 0x00, &tmp);
+	sensor_readb(hcmr, 0x00, &tmp);
 	gain = tmp;
-	cambus_readb(hcmr->_slaveAddr, 0x15, &tmp);
+	sensor_readb(hcmr, 0x15, &tmp);
 	gain |= ((uint16_t)(tmp & 0x03))<<8;
 	*gain_db = (float)gain;
 	return E_OK;
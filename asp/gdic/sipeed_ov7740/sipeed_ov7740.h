@@ -9,39 +9,39 @@
  *              Graduate School of Information Science, Nagoya Univ., JAPAN
  *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
  *
- *  嵭Ԥϡʲ(1)(4)ξ˸¤ꡤܥեȥ
- *  ܥեȥѤΤޤࡥʲƱˤѡʣ
- *  ѡۡʰʲѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
- *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
- *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
- *      ˴ޤޤƤ뤳ȡ
- *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
- *      ѤǤǺۤˤϡۤȼɥȡ
- *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
- *      ̵ݾڵǺܤ뤳ȡ
- *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
- *      ѤǤʤǺۤˤϡΤ줫ξ
- *      ȡ
- *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
- *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
- *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
- *        𤹤뤳ȡ
- *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
- *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
- *      ޤܥեȥΥ桼ޤϥɥ桼Τʤ
- *      ͳ˴Ťᤫ⡤嵭ԤTOPPERSץȤ
- *      դ뤳ȡ
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
  * 
- *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
- *  TOPPERSץȤϡܥեȥ˴ؤơλŪ
- *  ФŬޤơʤݾڤԤʤޤܥեȥ
- *  ѤˤľŪޤϴŪʤ»˴ؤƤ⡤
- *  Ǥʤ
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
  *
  *  $Id: sipeed_ov7740.h 2416 2019-11-29 22:12:01Z roi $
  */
 /*
- *  SIPEED OV7740 CAMERAץΥإåե
+ *  SIPEED OV7740 CAMERA制御プログラムのヘッダファイル
  */
 
 #ifndef _SIPEED_OV7740_H_
@@ -53,6 +53,7 @@
 
 #include "kernel.h"
 #include "dvp.h"
+#include "dvp_ext.h"
 
 #define OV9650_ID       (0x96)
 #define OV2640_ID       (0x26)
@@ -136,6 +137,49 @@ typedef enum {
     ACTIVE_BINOCULAR,
 } polarity_t;
 
+/*
+ *  センサーシャドウレジスタ(ページ0/1)
+ */
+#define SENSOR_SHADOW_PAGES  2
+
+typedef struct {
+	uint8_t         regs[SENSOR_SHADOW_PAGES][256];	/* レジスタ値 */
+	uint32_t        valid[SENSOR_SHADOW_PAGES][8];	/* 有効ビットマップ */
+	uint8_t         page;			/* 現在のページ(GC0328:0xFE) */
+} SENSOR_Shadow_t;
+
+/*
+ *  手動露出・ホワイトバランスの単位
+ */
+#define SENSOR_GAIN_UNIT     16			/* ゲイン1倍 */
+#define SENSOR_GAIN_MAX      (SENSOR_GAIN_UNIT * 64)
+#define SENSOR_WB_UNIT       0x40		/* WBゲイン1倍 */
+
+/*
+ *  センサー検出結果(ウォームブート時の再検出省略用)
+ */
+#define SENSOR_PROBE_MAGIC   0x534E5352	/* 'SNSR' */
+
+typedef struct {
+	uint32_t        magic;			/* SENSOR_PROBE_MAGIC */
+	uint8_t         id;				/* チップID */
+	uint8_t         slaveAddr;		/* SCCBスレーブアドレス */
+	uint8_t         regWidth;		/* レジスタアドレス幅(8/16) */
+	uint8_t         resetLevel;		/* 検出時のRESET端子設定 */
+	uint8_t         pwdnLevel;		/* 検出時のPWDN端子設定 */
+	uint8_t         resetPoliraty;	/* RESET極性 */
+	uint8_t         pwdnPoliraty;	/* PWDN極性 */
+	uint8_t         sum;			/* チェックサム */
+} SENSOR_Probe_t;
+
+/*
+ *  ov7740_snapshot後の_dataBufferからの画素(16ビット)取り出し
+ *  32ビット単位でバイト反転されているため、各画素はビッグエンディアン
+ *  で隣の画素と入れ替わった位置にある
+ */
+#define SENSOR_PIXEL(buf, i)	((((const uint8_t *)(buf))[((i) ^ 1) * 2] << 8) | \
+								 ((const uint8_t *)(buf))[((i) ^ 1) * 2 + 1])
+
 typedef struct _OV7740_s {
 	DVP_Handle_t    *hdvp;
 	framesize_t     frameSize;
@@ -149,8 +193,29 @@ typedef struct _OV7740_s {
 	uint16_t        _resetPoliraty;
 	uint16_t        _pwdnPoliraty;
 	uint32_t        _slaveAddr;
+	uint16_t        _winX;			/* センサーウィンドウ開始X(VGA座標) */
+	uint16_t        _winY;			/* センサーウィンドウ開始Y(VGA座標) */
+	uint16_t        _winW;			/* センサーウィンドウ幅 */
+	uint16_t        _winH;			/* センサーウィンドウ高さ */
+	uint8_t         _subsample;		/* サブサンプル率(1,2,4) */
+	SENSOR_Shadow_t _shadow;		/* シャドウレジスタ */
+	uint8_t         _quality;		/* JPEG品質(1-100、0で既定値) */
+	uint8_t         *_jpegBuffer;	/* PIXFORMAT_JPEG時の出力バッファ */
+	uint32_t        _jpegSize;		/* 出力バッファサイズ */
+	uint32_t        _jpegLen;		/* 符号化データ長 */
+	uint32_t        _jpegTime;		/* 符号化時間(μs) */
 } OV7740_t;
 
+/*
+ *  双眼キャプチャのフレームペア
+ */
+typedef struct {
+	uint32_t        *buf[2];		/* センサー0/1のフレーム(スナップショット並び) */
+	SYSUTM          time[2];		/* 各フレームの取り込み開始時刻(μs) */
+	uint32_t        skew;			/* センサー0,1の開始時刻差(μs) */
+	uint32_t        seq;			/* ペア番号 */
+} SENSOR_Pair_t;
+
 extern void ov7740_getResolition(OV7740_t *hcmr, framesize_t frameSize);
 extern ER ov7740_sensor_ov_detect(OV7740_t *hcmr);
 extern ER ov7740_sensor_gc_detect(OV7740_t *hcmr);
@@ -164,6 +229,19 @@ extern int ov7740_id(OV7740_t *hcmr);
 extern ER gc0328_reset(OV7740_t *hcmr);
 extern ER gc0328_set_pixformat(OV7740_t *hcmr);
 extern ER gc0328_set_framesize(OV7740_t *hcmr);
+extern ER ov7740_set_window(OV7740_t *hcmr, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t subsample);
+extern ER ov7740_shadow_sync(OV7740_t *hcmr);
+extern void ov7740_shadow_invalidate(OV7740_t *hcmr);
+extern ER ov7740_set_framerate(OV7740_t *hcmr, framerate_t framerate);
+extern ER gc0328_set_framerate(OV7740_t *hcmr, framerate_t framerate);
+extern ER ov7740_get_fps(OV7740_t *hcmr, uint32_t *fps_x100);
+extern ER ov7740_jpeg_encode(OV7740_t *hcmr, uint8_t *buf, uint32_t size, uint32_t *len);
+extern ER ov7740_get_probe(OV7740_t *hcmr, SENSOR_Probe_t *probe);
+extern ER ov7740_set_probe(OV7740_t *hcmr, const SENSOR_Probe_t *probe);
+extern void ov7740_clear_probe(OV7740_t *hcmr);
+extern ER ov7740_binocular_reset(OV7740_t *hcmr, DVP_Binocular_t *bino);
+extern ER ov7740_snapshot_pair(OV7740_t *hcmr, DVP_Binocular_t *bino, SENSOR_Pair_t *pair);
+extern ER gc0328_set_window(OV7740_t *hcmr, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t subsample);
 
 extern ER ov7740_setInvert(OV7740_t *hcmr, bool_t invert);
 extern ER ov7740_set_contrast(OV7740_t *hcmr, int level);
@@ -176,6 +254,9 @@ extern ER ov7740_set_auto_exposure(OV7740_t *hcmr, bool_t enable, int exposure_u
 extern ER ov7740_get_exposure_us(OV7740_t *hcmr, int *exposure_us);
 extern ER ov7740_set_auto_whitebal(OV7740_t *hcmr, bool_t enable, float r_gain_db, float g_gain_db, float b_gain_db);
 extern ER ov7740_set_vflip(OV7740_t *hcmr, bool_t enable);
+extern ER ov7740_set_manual_exposure(OV7740_t *hcmr, uint16_t exposure, uint16_t gain);
+extern ER ov7740_get_manual_exposure(OV7740_t *hcmr, uint16_t *exposure, uint16_t *gain);
+extern ER ov7740_set_manual_whitebal(OV7740_t *hcmr, uint8_t rgain, uint8_t ggain, uint8_t bgain);
 extern void ov7740_choice(OV7740_t *hcmr, int8_t choice_dev);
 #ifdef USE_GAIN
 extern ER ov7740_set_auto_gain(OV7740_t *hcmr, bool_t enable, float gain_db, float gain_db_ceiling);
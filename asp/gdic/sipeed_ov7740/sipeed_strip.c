@@ -0,0 +1,191 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  VGAバンド分割キャプチャ
+ *
+ *  DVPにはライン割込みが無いため、センサーウィンドウを横長のバンドに
+ *  設定して1フレームずつ取り込み、バンド単位でコールバックに渡す．
+ *  VGA全面のフレームバッファを持たずに、幅x BandLinesのバッファで
+ *  変換・縮小・符号化を行うことができる．バンド毎に別フレームとなる
+ *  ため、動く被写体ではバンド間に時間差が生じる．
+ */
+#include <kernel.h>
+#include <t_syslog.h>
+#include "device.h"
+#include "dvp_ext.h"
+#include "sipeed_strip.h"
+
+/*
+ *  センサー種別によるウィンドウ設定
+ */
+static ER
+strip_set_window(OV7740_t *hcmr, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t subsample)
+{
+	if(hcmr->_id == GC0328_ID)
+		return gc0328_set_window(hcmr, x, y, w, h, subsample);
+	else
+		return ov7740_set_window(hcmr, x, y, w, h, subsample);
+}
+
+/*
+ *  バンド分割キャプチャ初期化
+ *  parameter1  hsp: バンド分割ハンドラへのポインタ
+ *  parameter2  hcmr: カメラハンドラへのポインタ
+ *  return      ERコード
+ */
+ER
+strip_init(STRIP_Handle_t *hsp, OV7740_t *hcmr)
+{
+	if(hsp == NULL || hcmr == NULL || hcmr->hdvp == NULL)
+		return E_PAR;
+	if(hsp->Init.Width == 0 || hsp->Init.Height == 0 || hsp->Init.Buffer == NULL
+		|| hsp->Init.callback == NULL)
+		return E_PAR;
+	if(hsp->Init.BandLines == 0)
+		hsp->Init.BandLines = STRIP_DEF_LINES;
+	if((hsp->Init.BandLines % 2) != 0 || hsp->Init.BandLines > hsp->Init.Height)
+		return E_PAR;
+	hsp->hcmr   = hcmr;
+	hsp->frames = 0;
+	hsp->bands  = 0;
+	hsp->time   = 0;
+	return E_OK;
+}
+
+/*
+ *  バンド分割キャプチャ実行
+ *  parameter1  hsp: バンド分割ハンドラへのポインタ
+ *  return      ERコード
+ *  1フレーム分(Width x Height)をバンド毎に取り込み、コールバックを呼び出す．
+ *  終了時にセンサーウィンドウ、データバッファ、DVP出力先を元に戻す．
+ */
+ER
+strip_capture(STRIP_Handle_t *hsp)
+{
+	OV7740_t     *hcmr;
+	DVP_Handle_t *hdvp;
+	uint32_t     *dataBuffer, rgbAddr;
+	uint8_t      *jpegBuffer;
+	framesize_t  frameSize;
+	uint16_t     width, height, winX, winY, winW, winH;
+	uint8_t      subsample;
+	uint16_t     y, lines, i;
+	SYSUTM       stime, etime;
+	ER           ercd = E_OK;
+
+	if(hsp == NULL || hsp->hcmr == NULL)
+		return E_PAR;
+	hcmr = hsp->hcmr;
+	hdvp = hcmr->hdvp;
+	get_utm(&stime);
+
+	/*
+	 *  現在の設定を保存
+	 */
+	dataBuffer = hcmr->_dataBuffer;
+	rgbAddr    = hdvp->Init.RGBAddr;
+	jpegBuffer = hcmr->_jpegBuffer;
+	frameSize  = hcmr->frameSize;
+	width      = hcmr->_width;
+	height     = hcmr->_height;
+	winX       = hcmr->_winX;
+	winY       = hcmr->_winY;
+	winW       = hcmr->_winW;
+	winH       = hcmr->_winH;
+	subsample  = hcmr->_subsample;
+
+	/*
+	 *  出力先をバンドバッファに切り替え、AI出力は停止する
+	 */
+	hcmr->_dataBuffer  = hsp->Init.Buffer;
+	hcmr->_jpegBuffer  = NULL;
+	hdvp->Init.RGBAddr = DVP_BUS_ADDR(hsp->Init.Buffer);
+	dvp_set_ai_output(hdvp, false);
+	dvp_set_output_addr(hdvp);
+
+	for(y = 0 ; y < hsp->Init.Height ; y += lines){
+		lines = hsp->Init.Height - y;
+		if(lines > hsp->Init.BandLines)
+			lines = hsp->Init.BandLines;
+		ercd = strip_set_window(hcmr, 0, y, hsp->Init.Width, lines, 1);
+		if(ercd != E_OK)
+			break;
+		/* ウィンドウ変更直後のフレームは破棄 */
+		for(i = 0 ; i < hsp->Init.SkipFrames && ercd == E_OK ; i++)
+			ercd = ov7740_snapshot(hcmr);
+		if(ercd == E_OK)
+			ercd = ov7740_snapshot(hcmr);
+		if(ercd != E_OK)
+			break;
+		ercd = hsp->Init.callback(hsp, hsp->Init.Buffer, y, lines);
+		if(ercd != E_OK)
+			break;
+		hsp->bands++;
+	}
+
+	/*
+	 *  設定の復帰
+	 */
+	hcmr->_dataBuffer  = dataBuffer;
+	hcmr->_jpegBuffer  = jpegBuffer;
+	hdvp->Init.RGBAddr = rgbAddr;
+	dvp_set_output_addr(hdvp);
+	if(hcmr->_aiBuffer != NULL)
+		dvp_set_ai_output(hdvp, true);
+	if(frameSize == FRAMESIZE_CUSTOM && subsample != 0)
+		strip_set_window(hcmr, winX, winY, winW, winH, subsample);
+	else{
+		hcmr->frameSize = frameSize;
+		hcmr->_width    = width;
+		hcmr->_height   = height;
+		if(hcmr->_id == GC0328_ID)
+			gc0328_set_framesize(hcmr);
+		else
+			ov7740_set_framesize(hcmr);
+	}
+
+	get_utm(&etime);
+	hsp->time = etime - stime;
+	if(ercd == E_OK)
+		hsp->frames++;
+	return ercd;
+}
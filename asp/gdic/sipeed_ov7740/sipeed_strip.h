@@ -0,0 +1,100 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ *  VGAバンド分割キャプチャのヘッダファイル
+ */
+
+#ifndef _SIPEED_STRIP_H_
+#define _SIPEED_STRIP_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "sipeed_ov7740.h"
+
+/*
+ *  バンド分割キャプチャの既定値
+ */
+#define STRIP_DEF_LINES         48		/* 1バンドのライン数 */
+#define STRIP_DEF_SKIP          1		/* ウィンドウ変更後の破棄フレーム数 */
+
+struct _STRIP_Handle_t;
+
+/*
+ *  バンド受信コールバック
+ *  band: RGB565(スナップショット並び)、y: 先頭ライン、lines: ライン数
+ */
+typedef ER (*STRIP_Callback_t)(struct _STRIP_Handle_t *hsp, const uint32_t *band, uint16_t y, uint16_t lines);
+
+/*
+ *  バンド分割キャプチャ初期設定
+ */
+typedef struct {
+	uint16_t        Width;			/* 取り込み幅(VGA座標、4の倍数) */
+	uint16_t        Height;			/* 取り込み高さ(VGA座標、2の倍数) */
+	uint16_t        BandLines;		/* 1バンドのライン数(2の倍数) */
+	uint8_t         SkipFrames;		/* ウィンドウ変更後の破棄フレーム数 */
+	uint32_t        *Buffer;		/* バンドバッファ(Width*BandLines*2バイト) */
+	STRIP_Callback_t callback;		/* バンド受信コールバック */
+	intptr_t        exinf;			/* コールバック拡張情報 */
+} STRIP_Init_t;
+
+/*
+ *  バンド分割キャプチャハンドラ
+ */
+typedef struct _STRIP_Handle_t {
+	OV7740_t        *hcmr;
+	STRIP_Init_t    Init;
+	uint32_t        frames;			/* 完了フレーム数 */
+	uint32_t        bands;			/* 処理バンド数 */
+	uint32_t        time;			/* 直近フレームの所要時間(μs) */
+} STRIP_Handle_t;
+
+extern ER strip_init(STRIP_Handle_t *hsp, OV7740_t *hcmr);
+extern ER strip_capture(STRIP_Handle_t *hsp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _SIPEED_STRIP_H_ */
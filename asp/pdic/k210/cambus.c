@@ -7,40 +7,40 @@
  *              Graduate School of Information Science, Nagoya Univ., JAPAN
  *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
  * 
- *  嵭Ԥϡʲ(1)(4)ξ˸¤ꡤܥեȥ
- *  ܥեȥѤΤޤࡥʲƱˤѡʣ
- *  ѡۡʰʲѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
- *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
- *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
- *      ˴ޤޤƤ뤳ȡ
- *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
- *      ѤǤǺۤˤϡۤȼɥȡ
- *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
- *      ̵ݾڵǺܤ뤳ȡ
- *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
- *      ѤǤʤǺۤˤϡΤ줫ξ
- *      ȡ
- *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
- *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
- *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
- *        𤹤뤳ȡ
- *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
- *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
- *      ޤܥեȥΥ桼ޤϥɥ桼Τʤ
- *      ͳ˴Ťᤫ⡤嵭ԤTOPPERSץȤ
- *      դ뤳ȡ
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
  * 
- *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
- *  TOPPERSץȤϡܥեȥ˴ؤơλŪ
- *  ФŬޤơʤݾڤԤʤޤܥեȥ
- *  ѤˤľŪޤϴŪʤ»˴ؤƤ⡤
- *  Ǥʤ
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
  * 
  *  @(#) $Id: cambus.c 699 2020-11-29 22:10:19Z fukuen $
  */
 /*
  * 
- *  K210 CAMBUSɥ饤дؿ
+ *  K210 CAMBUSドライバ関数群
  *
  */
 #include <stddef.h>
@@ -53,6 +53,35 @@
 #include "dvp.h"
 #include "maix_i2c.h"
 #include "cambus.h"
+#ifdef DVP_SIMULATION
+#include "dvp_sim.h"
+#endif
+
+#ifndef CAMBUS_SCCB_FREQ
+#define CAMBUS_SCCB_FREQ    400000		/* SCCBクロック(Hz) */
+#endif
+
+#define CAMBUS_TABLE_DELAY  0xff		/* レジスタテーブルの遅延指定 */
+
+#ifndef CAMBUS_SCAN_FULL
+#define CAMBUS_SCAN_FULL    1			/* 既知アドレスで見つからない場合に全域走査 */
+#endif
+
+/*
+ *  既知のセンサーSCCBアドレス(0で終端)
+ */
+static const uint8_t cambus_known8[] = {
+	0x21,			/* OV7740/OV7725/GC0328 */
+	0x30,			/* OV2640/OV9650 */
+	0x2A,			/* LEPTON */
+	0x48,			/* MT9V034 */
+	0x5C,			/* MT9V034 */
+	0x00
+};
+static const uint8_t cambus_known16[] = {
+	0x3C,			/* OV5640/OV3660 */
+	0x00
+};
 
 static uint32_t write_bus_delay = 10; //ms
 static uint8_t sccb_reg_width = 8;
@@ -65,6 +94,36 @@ void cambus_set_writeb_delay(uint32_t delay)
     write_bus_delay = delay;
 }
 
+#ifdef DVP_SIMULATION
+/*
+ *  シミュレーションセンサーへのSCCBアクセス
+ */
+ER
+sccb_i2c_init(uint8_t pin_clk, uint8_t pin_sda, uint8_t gpio_clk, uint8_t gpio_sda, uint32_t freq)
+{
+	syslog_0(LOG_NOTICE, "SCCB SIMULATION !");
+	return E_OK;
+}
+
+ER
+sccb_i2c_write_byte(uint8_t addr, uint16_t reg, uint8_t reg_len, uint8_t data, uint16_t timeout_ms)
+{
+	return dvp_sim_sccb_write(addr, reg, data);
+}
+
+ER
+sccb_i2c_read_byte(uint8_t addr, uint16_t reg, uint8_t reg_len, uint8_t* data, uint16_t timeout_ms)
+{
+	*data = 0;
+	return dvp_sim_sccb_read(addr, reg, data);
+}
+
+ER
+sccb_i2c_recieve_byte(uint8_t addr, uint8_t* data, uint16_t timeout_ms)
+{
+	return dvp_sim_sccb_read(addr, 0, data);
+}
+#else	/* DVP_SIMULATION */
 ER
 sccb_i2c_init(uint8_t pin_clk, uint8_t pin_sda, uint8_t gpio_clk, uint8_t gpio_sda, uint32_t freq)
 {
@@ -146,32 +205,35 @@ sccb_i2c_recieve_byte(uint8_t addr, uint8_t* data, uint16_t timeout_ms)
 	ER ret = maix_i2c_memread(hi2c, addr, 0, 0, data, 1, 10);
     return ret;
 }
+#endif	/* DVP_SIMULATION */
 
 /*
- *  CAMBUS
+ *  CAMBUS初期設定
  *  parameter1  pin_clk: SCCB_CLK_PIN
  *  parameter2  pin_sda: SCCB_SDA_PIN
  *  parameter3  gpio_clk: SCCB_CLK_NO
  *  parameter4  gpio_sda: SCCB_SDA_NO
- *  return      ER
+ *  return      ERコード
  */
 ER
 cambus_init(int8_t pin_clk, int8_t pin_sda, uint8_t gpio_clk, uint8_t gpio_sda)
 {
     if(pin_clk<0 || pin_sda<0)
         return E_PAR;
-    sccb_i2c_init(pin_clk, pin_sda, gpio_clk, gpio_sda, 100000);
+    sccb_i2c_init(pin_clk, pin_sda, gpio_clk, gpio_sda, CAMBUS_SCCB_FREQ);
 	return E_OK;
 }
 
 /*
- *  CAMBUS̵
- *  return      ER
+ *  CAMBUSの無効化
+ *  return      ERコード
  */
 ER
 cambus_deinit(void)
 {
+#ifndef DVP_SIMULATION
     maix_i2c_deinit(hi2c);
+#endif
 	return E_OK;
 }
 
@@ -184,20 +246,23 @@ cambus_read_id(uint8_t addr,uint16_t *manuf_id, uint16_t *device_id)
     ER ret = E_OK;
 
     // sccb_i2c_write_byte(addr, 0xFF, sccb_reg_width, 0x01, 10); // for OV2640
-    ret |= sccb_i2c_read_byte(addr, 0x1C, sccb_reg_width, &tmp, 100);
-	if(ret != E_OK)
-		return ret;
-    *manuf_id = tmp << 8;
-    ret |= sccb_i2c_read_byte(addr, 0x1D, sccb_reg_width, &tmp, 100);
-	if(ret != E_OK)
-		return ret;
-    *manuf_id |= tmp;
+    /* 応答のないアドレスは最初の読み込みで打ち切る */
     ret |= sccb_i2c_read_byte(addr, 0x0A, sccb_reg_width, &tmp, 100);
 	if(ret != E_OK)
 		return ret;
     *device_id = tmp << 8;
     ret |= sccb_i2c_read_byte(addr, 0x0B, sccb_reg_width, &tmp, 100);
+	if(ret != E_OK)
+		return ret;
     *device_id |= tmp;
+	if(*device_id == 0 || *device_id == 0xffff)
+		return ret;
+    ret |= sccb_i2c_read_byte(addr, 0x1C, sccb_reg_width, &tmp, 100);
+	if(ret != E_OK)
+		return ret;
+    *manuf_id = tmp << 8;
+    ret |= sccb_i2c_read_byte(addr, 0x1D, sccb_reg_width, &tmp, 100);
+    *manuf_id |= tmp;
 	return ret;
 }
 
@@ -220,12 +285,49 @@ cambus_read16_id(uint8_t addr,uint16_t *manuf_id, uint16_t *device_id)
 	return ret;
 }
 
+/*
+ *  アドレスリストの走査
+ */
+static int
+cambus_scan_list(uint8_t reg_width, const uint8_t *list)
+{
+	uint16_t manuf_id = 0;
+	uint16_t device_id = 0;
+	ER ercd;
+
+	sccb_reg_width = reg_width;
+	for(; *list != 0 ; list++){
+		if(reg_width == 8)
+			ercd = cambus_read_id(*list, &manuf_id, &device_id);
+		else
+			ercd = cambus_read16_id(*list, &manuf_id, &device_id);
+		if(ercd != E_OK)
+			continue;
+		if(device_id!=0 && device_id!=0xffff)
+			return *list;
+	}
+	return 0;
+}
+
+/*
+ *  CAMBUSセンサー走査
+ *  return      スレーブアドレス、0で未検出
+ *  既知アドレスを先に試し、見つからない場合のみ全域を走査する
+ */
 int cambus_scan()
 {
+	int addr;
+
+	if((addr = cambus_scan_list(8, cambus_known8)) != 0)
+		return addr;
+	if((addr = cambus_scan_list(16, cambus_known16)) != 0)
+		return addr;
+#if CAMBUS_SCAN_FULL
+	{
 	uint16_t manuf_id = 0;
 	uint16_t device_id = 0;
     sccb_reg_width = 8;
-    for (uint8_t addr=0x08; addr<=0x77; addr++) {
+    for (addr=0x08; addr<=0x77; addr++) {
 		if(cambus_read_id(addr ,&manuf_id,&device_id) != E_OK)
             continue;
         if(device_id!=0 && device_id!=0xffff)
@@ -234,7 +336,7 @@ int cambus_scan()
         }
     }
     sccb_reg_width = 16;
-    for (uint8_t addr=0x08; addr<=0x77; addr++) {
+    for (addr=0x08; addr<=0x77; addr++) {
 		if( cambus_read16_id(addr ,&manuf_id,&device_id) != E_OK)
             continue;
         if(device_id!=0 && device_id!=0xffff)
@@ -242,6 +344,8 @@ int cambus_scan()
             return addr;
         }
     }
+	}
+#endif
     return 0; // not found
 }
 
@@ -259,17 +363,23 @@ int cambus_scan_gc0328(void)
     return id;
 }
 
+/*
+ *  CAMBUSレジスタ読み込み
+ *  parameter1  slv_addr: スレーブアドレス
+ *  parameter2  reg_addr: レジスタアドレス
+ *  parameter3  reg_data: 読み込みデータの格納先
+ *  return      ERコード
+ *  バスエラーはそのERコードを返す．0xFFはバス未接続とみなしE_SYSを返す．
+ */
 ER
 cambus_readb(uint8_t slv_addr, uint16_t reg_addr, uint8_t *reg_data)
 {
+	ER ret;
 
-    ER ret = E_OK;
-    sccb_i2c_read_byte(slv_addr, reg_addr, sccb_reg_width, reg_data, 10);
-	if(0xff == *reg_data)
+	ret = sccb_i2c_read_byte(slv_addr, reg_addr, sccb_reg_width, reg_data, 10);
+	if(ret == E_OK && 0xff == *reg_data)
 		ret = E_SYS;
-
-    return ret;
-
+	return ret;
 }
 
 ER
@@ -280,7 +390,67 @@ cambus_writeb(uint8_t slv_addr, uint16_t reg_addr, uint8_t reg_data)
 	return E_OK;
 }
 
+/*
+ *  CAMBUSレジスタ書込み(書込み後の待ちなし)
+ *  parameter1  slv_addr: スレーブアドレス
+ *  parameter2  reg_addr: レジスタアドレス
+ *  parameter3  reg_data: 書込みデータ
+ *  return      ERコード
+ *  ソフトリセット以外の実行時の調整用．cambus_writebのwrite_bus_delayの待ちを行わない．
+ */
+ER
+cambus_writeb_nowait(uint8_t slv_addr, uint16_t reg_addr, uint8_t reg_data)
+{
+	return sccb_i2c_write_byte(slv_addr, reg_addr, sccb_reg_width, reg_data, 10);
+}
+
+/*
+ *  CAMBUSレジスタテーブル一括書込み
+ *  parameter1  slv_addr: スレーブアドレス
+ *  parameter2  regs: {レジスタ,データ}のテーブル、{0x00,0x00}で終端
+ *  parameter3  verify: trueで書込み後に読み戻して比較
+ *  return      負値:ERコード、0以上:読み戻し不一致数
+ *  レジスタ間の待ちは行わず、{0xff,n}のエントリでのみn ms待つ．
+ *  ソフトリセットやデータポートのように読み戻し値が一致しないレジス
+ *  タもあるため、不一致はログ出力と件数のみ返す．
+ */
+ER_UINT
+cambus_write_table(uint8_t slv_addr, const uint8_t (*regs)[2], bool_t verify)
+{
+	uint32_t i;
+	uint8_t  data;
+	ER_UINT  mismatch = 0;
+	ER       ercd;
+
+	if(regs == NULL)
+		return E_PAR;
+	for(i = 0 ; regs[i][0] != 0 ; i++){
+		if(regs[i][0] == CAMBUS_TABLE_DELAY){
+			dly_tsk(regs[i][1]);
+			continue;
+		}
+		ercd = sccb_i2c_write_byte(slv_addr, regs[i][0], sccb_reg_width, regs[i][1], 10);
+		if(ercd != E_OK){
+			syslog_2(LOG_ERROR, "cambus_write_table write error reg[%02x] (%d)", regs[i][0], ercd);
+			return ercd;
+		}
+		if(verify){
+			ercd = sccb_i2c_read_byte(slv_addr, regs[i][0], sccb_reg_width, &data, 10);
+			if(ercd != E_OK || data != regs[i][1]){
+				syslog_3(LOG_DEBUG, "cambus_write_table verify reg[%02x] %02x->%02x", regs[i][0], regs[i][1], data);
+				mismatch++;
+			}
+		}
+	}
+	return mismatch;
+}
+
 uint8_t cambus_reg_width()
 {
     return sccb_reg_width;
 }
+
+void cambus_set_reg_width(uint8_t width)
+{
+    sccb_reg_width = (width == 16) ? 16 : 8;
+}
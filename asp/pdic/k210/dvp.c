@@ -7,43 +7,44 @@
  *              Graduate School of Information Science, Nagoya Univ., JAPAN
  *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
  * 
- *  嵭Ԥϡʲ(1)(4)ξ˸¤ꡤܥեȥ
- *  ܥեȥѤΤޤࡥʲƱˤѡʣ
- *  ѡۡʰʲѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
- *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
- *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
- *      ˴ޤޤƤ뤳ȡ
- *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
- *      ѤǤǺۤˤϡۤȼɥȡ
- *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
- *      ̵ݾڵǺܤ뤳ȡ
- *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
- *      ѤǤʤǺۤˤϡΤ줫ξ
- *      ȡ
- *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
- *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
- *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
- *        𤹤뤳ȡ
- *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
- *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
- *      ޤܥեȥΥ桼ޤϥɥ桼Τʤ
- *      ͳ˴Ťᤫ⡤嵭ԤTOPPERSץȤ
- *      դ뤳ȡ
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
  * 
- *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
- *  TOPPERSץȤϡܥեȥ˴ؤơλŪ
- *  ФŬޤơʤݾڤԤʤޤܥեȥ
- *  ѤˤľŪޤϴŪʤ»˴ؤƤ⡤
- *  Ǥʤ
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
  * 
  *  @(#) $Id: dvp.c 699 2019-11-29 22:10:19Z roi $
  */
 /*
  * 
- *  K210 DVPɥ饤дؿ
+ *  K210 DVPドライバ関数群
  *
  */
 #include <stddef.h>
+#include <string.h>
 #include <kernel.h>
 #include <sil.h>
 #include <t_syslog.h>
@@ -51,10 +52,24 @@
 #include <kernel_cfg.h>
 #include "device.h"
 #include "dvp.h"
+#include "dvp_ext.h"
 #include "cambus.h"
 
 /*
- *  SILؿΥޥ
+ *  シミュレーション時はレジスタアクセスをモデルに接続する
+ */
+#ifdef DVP_SIMULATION
+#include "dvp_sim.h"
+#undef  sil_rew_mem
+#undef  sil_wrw_mem
+#undef  sil_dly_nse
+#define sil_rew_mem(a)			dvp_sim_rew((uintptr_t)(a))
+#define sil_wrw_mem(a, b)		dvp_sim_wrw((uintptr_t)(a), (b))
+#define sil_dly_nse(a)
+#endif
+
+/*
+ *  SIL関数のマクロ定義
  */
 #define sil_orw_mem(a, b)		sil_wrw_mem((a), sil_rew_mem(a) | (b))
 #define sil_andw_mem(a, b)		sil_wrw_mem((a), sil_rew_mem(a) & ~(b))
@@ -70,6 +85,38 @@
 
 
 static DVP_Handle_t *phdvp;
+static DVP_FrameInfo_t dvp_frameinfo;
+static DVP_Binocular_t *dvp_binocular;
+
+/*
+ *  出力先アドレスレジスタの設定
+ *  Init.xxxAddrはDVP_BUS_ADDRで求めた32ビットのバスアドレスとする
+ */
+static void
+dvp_write_addr(DVP_Handle_t *hdvp)
+{
+	sil_wrw_mem((uint32_t *)(hdvp->base+TOFF_DVP_R_ADDR), hdvp->Init.RedAddr);
+	sil_wrw_mem((uint32_t *)(hdvp->base+TOFF_DVP_G_ADDR), hdvp->Init.GreenAddr);
+	sil_wrw_mem((uint32_t *)(hdvp->base+TOFF_DVP_B_ADDR), hdvp->Init.BlueAddr);
+	sil_wrw_mem((uint32_t *)(hdvp->base+TOFF_DVP_RGB_ADDR), hdvp->Init.RGBAddr);
+}
+
+/*
+ *  フレーム間隔の更新(8フレーム移動平均)
+ */
+static void
+dvp_update_interval(uint32_t *interval, SYSUTM *last, SYSUTM now, uint32_t count)
+{
+	uint32_t diff = (uint32_t)(now - *last);
+
+	if(count > 1){
+		if(*interval == 0)
+			*interval = diff;
+		else
+			*interval = (*interval * 7 + diff) / 8;
+	}
+	*last = now;
+}
 
 static uint32_t
 dvp_clock_get_freq(uint8_t clock)
@@ -80,7 +127,7 @@ dvp_clock_get_freq(uint8_t clock)
 	uint32_t threshold = 0;
 
 	/*
-	 *  ACLKμФ
+	 *  ACLKの取り出し
 	 */
 	if((clk_sel0 & SYSCTL_CLK_SEL0_ACLK_SEL) == 0)
 		source = SYSCTRL_CLOCK_FREQ_IN0;
@@ -112,11 +159,11 @@ dvp_sccb_start_transfer(DVP_Handle_t *hdvp)
 
 
 /*
- *  SCCB쥸
- *  parameter1  hdvp: DVPϥɥؤΥݥ
- *  parameter2  addr: ǥХɥ쥹
- *  parameter3  reg_addr: 쥸ɥ쥹
- *  parameter4  reg_data: 쥸ǡ
+ *  SCCBレジスタ書込み
+ *  parameter1  hdvp: DVPハンドラへのポインタ
+ *  parameter2  addr: デバイスアドレス
+ *  parameter3  reg_addr: レジスタアドレス
+ *  parameter4  reg_data: レジスタデータ
  */
 void
 dvp_sccb_send_data(DVP_Handle_t *hdvp, uint8_t addr, uint16_t reg_addr, uint8_t reg_data)
@@ -138,11 +185,11 @@ dvp_sccb_send_data(DVP_Handle_t *hdvp, uint8_t addr, uint16_t reg_addr, uint8_t
 }
 
 /*
- *  SCCB쥸ɤ߹
- *  parameter1  hdvp: DVPϥɥؤΥݥ
- *  parameter2  addr: ǥХɥ쥹
- *  parameter3  reg_addr: 쥸ɥ쥹
- *  return      ɤ߹ߥǡ
+ *  SCCBレジスタ読み込み
+ *  parameter1  hdvp: DVPハンドラへのポインタ
+ *  parameter2  addr: デバイスアドレス
+ *  parameter3  reg_addr: レジスタアドレス
+ *  return      読み込みデータ
  */
 uint8_t dvp_sccb_receive_data(DVP_Handle_t *hdvp, uint8_t addr, uint16_t reg_addr)
 {
@@ -175,9 +222,9 @@ uint8_t dvp_sccb_receive_data(DVP_Handle_t *hdvp, uint8_t addr, uint16_t reg_add
 }
 
 /*
- *  DVP
- *  parameter1  hdvp: DVPϥɥؤΥݥ
- *  return      ER
+ *  DVP初期設定
+ *  parameter1  hdvp: DVPハンドラへのポインタ
+ *  return      ERコード
  */
 ER
 dvp_init(DVP_Handle_t *hdvp)
@@ -210,7 +257,7 @@ dvp_init(DVP_Handle_t *hdvp)
     dly_tsk(100);
 
 	/*
-	 *  DVPåͭ
+	 *  DVPクロック有効化
 	 */
 	sil_orw_mem((uint32_t *)(TADR_SYSCTL_BASE+TOFF_SYSCTL_CLK_EN_CENT), SYSCTL_CLK_EN_CENT_APB1_CLK_EN);
 	sil_orw_mem((uint32_t *)(TADR_SYSCTL_BASE+TOFF_SYSCTL_CLK_EN_PERI), SYSCTL_CLK_EN_PERI_DVP_CLK_EN);
@@ -218,7 +265,7 @@ dvp_init(DVP_Handle_t *hdvp)
 	phdvp = hdvp;
 
 	/*
-	 *  DVPꥻå
+	 *  DVPリセット
 	 */
 	sil_orw_mem((uint32_t *)(TADR_SYSCTL_BASE+TOFF_SYSCTL_PERI_RESET), SYSCTL_PERI_RESET_DVP_RESET);
 	dly_tsk(10);
@@ -226,7 +273,7 @@ dvp_init(DVP_Handle_t *hdvp)
 	dly_tsk(1);
 
 	/*
-	 *  SCCBå
+	 *  SCCBクロック初期化
 	 */
 	sil_orw_mem((uint32_t *)(hdvp->base+TOFF_DVP_SCCB_CFG), (DVP_SCCB_SCL_LCNT_MASK | DVP_SCCB_SCL_HCNT_MASK));
 
@@ -240,7 +287,7 @@ dvp_init(DVP_Handle_t *hdvp)
 		v_period = 255;
 
 	/*
-	 *  DVPꥻå
+	 *  DVPリセット
 	 */
 	sil_andw_mem((uint32_t *)(hdvp->base+TOFF_DVP_CMOS_CFG), DVP_CMOS_CLK_DIV_MASK);
 	sil_orw_mem((uint32_t *)(hdvp->base+TOFF_DVP_CMOS_CFG), (DVP_CMOS_CLK_ENABLE | v_period));
@@ -257,35 +304,32 @@ dvp_init(DVP_Handle_t *hdvp)
 	sil_dly_nse(RESET_DELAY_TIME*1000);
 
 	/*
-	 *  Сȥ⡼
+	 *  バーストモード設定
 	 */
 	sil_modw_mem((uint32_t *)(hdvp->base+TOFF_DVP_CFG), DVP_CFG_BURST_SIZE_4BEATS, hdvp->Init.BurstMode);
 	sil_modw_mem((uint32_t *)(hdvp->base+TOFF_DVP_AXI), DVP_AXI_GM_MLEN_MASK, hdvp->Init.GMMlen-1);
 
 	/*
-	 *  ȥ⡼
+	 *  オートモード設定
 	 */
 	sil_modw_mem((uint32_t *)(hdvp->base+TOFF_DVP_CFG), DVP_CFG_AUTO_ENABLE, hdvp->Init.AutoMode);
 
 	/*
-	 *  ͭ
+	 *  出力有効化
 	 */
 	sil_orw_mem((uint32_t *)(hdvp->base+TOFF_DVP_CFG), DVP_CFG_AI_OUTPUT_ENABLE);
 	sil_orw_mem((uint32_t *)(hdvp->base+TOFF_DVP_CFG), DVP_CFG_DISPLAY_OUTPUT_ENABLE);
 
 	/*
-	 *  ᡼եޥåȡ
+	 *  イメージフォーマット、サイズ設定
 	 */
 	dvp_set_image_format(hdvp);
 	dvp_set_image_size(hdvp);	//set QVGA default
 
-	sil_wrw_mem((uint32_t *)(hdvp->base+TOFF_DVP_R_ADDR), hdvp->Init.RedAddr);
-	sil_wrw_mem((uint32_t *)(hdvp->base+TOFF_DVP_G_ADDR), hdvp->Init.GreenAddr);
-	sil_wrw_mem((uint32_t *)(hdvp->base+TOFF_DVP_B_ADDR), hdvp->Init.BlueAddr);
-	sil_wrw_mem((uint32_t *)(hdvp->base+TOFF_DVP_RGB_ADDR), hdvp->Init.RGBAddr);
+	dvp_write_addr(hdvp);
 
 	/*
-	 *  
+	 *  割込み設定
 	 */
 	sil_andw_mem((uint32_t *)(hdvp->base+TOFF_DVP_CFG), (DVP_CFG_START_INT_ENABLE | DVP_CFG_FINISH_INT_ENABLE));
 	dis_int(hdvp->Init.IntNo);
@@ -296,9 +340,9 @@ dvp_init(DVP_Handle_t *hdvp)
 }
 
 /*
- *  DVPλ
- *  parameter1  hspi: SPIϥɥؤΥݥ
- *  return ER
+ *  DVP終了設定
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  return ERコード
  */
 ER
 dvp_deinit(DVP_Handle_t *hdvp)
@@ -315,10 +359,10 @@ dvp_deinit(DVP_Handle_t *hdvp)
 }
 
 /*
- *  DVPͭ
- *  parameter1  hspi: SPIϥɥؤΥݥ
- *  parameter2  run:  1:ͭ0:̵
- *  return ER
+ *  DVP有効化処理
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  run:  1:有効化、0:無効化
+ *  return ERコード
  */
 ER
 dvp_activate(DVP_Handle_t *hdvp, bool_t run)
@@ -326,6 +370,7 @@ dvp_activate(DVP_Handle_t *hdvp, bool_t run)
 	if(hdvp == NULL)
 		return E_PAR;
 	if(run){
+		dvp_reset_frameinfo(hdvp);
 		hdvp->state = DVP_STATE_READY;
 		sil_orw_mem((uint32_t *)(hdvp->base+TOFF_DVP_STS), DEAFULT_CLEAR_INT);
 		ena_int(hdvp->Init.IntNo);
@@ -341,10 +386,10 @@ dvp_activate(DVP_Handle_t *hdvp, bool_t run)
 }
 
 /*
- *  DVP᡼եޥåȺ
- *  parameter1  hdvp:  DVPϥɥؤΥݥ
- *              Init.Format˺
- *  return ER
+ *  DVPイメージフォーマット再設定
+ *  parameter1  hdvp:  DVPハンドラへのポインタ
+ *              Init.Formatに再設定値
+ *  return ERコード
  */
 ER
 dvp_set_image_format(DVP_Handle_t *hdvp)
@@ -359,10 +404,10 @@ dvp_set_image_format(DVP_Handle_t *hdvp)
 }
 
 /*
- *  DVP᡼
- *  parameter1  hdvp:  DVPϥɥؤΥݥ
- *              Init.Width, Init.Height˺
- *  return ER
+ *  DVPイメージサイズ再設定
+ *  parameter1  hdvp:  DVPハンドラへのポインタ
+ *              Init.Width, Init.Heightに再設定値
+ *  return ERコード
  */
 ER
 dvp_set_image_size(DVP_Handle_t *hdvp)
@@ -385,10 +430,10 @@ dvp_set_image_size(DVP_Handle_t *hdvp)
 }
 
 /*
- *  SCCBå
- *  parameter1  hdvp:  DVPϥɥؤΥݥ
- *  parameter2  clk_rate:ꥯå
- *  return      ͡0̤
+ *  SCCBクロック再設定
+ *  parameter1  hdvp:  DVPハンドラへのポインタ
+ *  parameter2  clk_rate:設定クロック値
+ *  return      設定値、0で未設定
  */
 uint32_t
 dvp_sccb_set_clk_rate(DVP_Handle_t *hdvp, uint32_t clk_rate)
@@ -411,10 +456,10 @@ dvp_sccb_set_clk_rate(DVP_Handle_t *hdvp, uint32_t clk_rate)
 }
 
 /*
- *  DVP-DCMIꥻå
- *  parameter1  hdvp:  DVPϥɥؤΥݥ
+ *  DVP-DCMIリセット設定
+ *  parameter1  hdvp:  DVPハンドラへのポインタ
  *  parameter2  reset: 1:reset, 0:relase
- *  return ER
+ *  return ERコード
  */
 ER
 dvp_dcmi_reset(DVP_Handle_t *hdvp, bool_t reset)
@@ -429,10 +474,10 @@ dvp_dcmi_reset(DVP_Handle_t *hdvp, bool_t reset)
 }
 
 /*
- *  DVP-DCMIѥ
- *  parameter1  hdvp:  DVPϥɥؤΥݥ
+ *  DVP-DCMIパワーダウン設定
+ *  parameter1  hdvp:  DVPハンドラへのポインタ
  *  parameter2  down: 1:down, 0:up
- *  return ER
+ *  return ERコード
  */
 ER
 dvp_dcmi_powerdown(DVP_Handle_t *hdvp, bool_t down)
@@ -447,13 +492,135 @@ dvp_dcmi_powerdown(DVP_Handle_t *hdvp, bool_t down)
 }
 
 /*
- *  DVPߥϥɥ
+ *  DVP出力アドレス再設定
+ *  parameter1  hdvp:  DVPハンドラへのポインタ
+ *              Init.RedAddr, GreenAddr, BlueAddr, RGBAddrに再設定値
+ *  return ERコード
+ */
+ER
+dvp_set_output_addr(DVP_Handle_t *hdvp)
+{
+	if(hdvp == NULL)
+		return E_PAR;
+	dvp_write_addr(hdvp);
+	return E_OK;
+}
+
+/*
+ *  DVP AI出力(RGB888プレーン)の有効／無効設定
+ *  parameter1  hdvp:  DVPハンドラへのポインタ
+ *  parameter2  enable: true:有効、false:無効
+ *  return ERコード
+ */
+ER
+dvp_set_ai_output(DVP_Handle_t *hdvp, bool_t enable)
+{
+	if(hdvp == NULL)
+		return E_PAR;
+	if(enable)
+		sil_orw_mem((uint32_t *)(hdvp->base+TOFF_DVP_CFG), DVP_CFG_AI_OUTPUT_ENABLE);
+	else
+		sil_andw_mem((uint32_t *)(hdvp->base+TOFF_DVP_CFG), DVP_CFG_AI_OUTPUT_ENABLE);
+	return E_OK;
+}
+
+/*
+ *  双眼キャプチャのセンサー選択
+ *  parameter1  hdvp:  DVPハンドラへのポインタ
+ *  parameter2  bino:  双眼キャプチャ構造体へのポインタ
+ *  parameter3  no:    センサー番号(0,1)
+ *  return ERコード
+ *  パワーダウン線と出力先アドレスを切り替える．割込みハンドラからも呼び出す．
+ */
+ER
+dvp_select_sensor(DVP_Handle_t *hdvp, DVP_Binocular_t *bino, uint8_t no)
+{
+	if(hdvp == NULL || bino == NULL || no > 1)
+		return E_PAR;
+	dvp_dcmi_powerdown(hdvp, (no == 0) ? bino->Select : !bino->Select);
+	sil_wrw_mem((uint32_t *)(hdvp->base+TOFF_DVP_RGB_ADDR), bino->RGBAddr[no]);
+	bino->current = no;
+	bino->settle  = bino->Settle;
+	return E_OK;
+}
+
+/*
+ *  双眼キャプチャ設定
+ *  parameter1  hdvp:  DVPハンドラへのポインタ
+ *  parameter2  bino:  双眼キャプチャ構造体へのポインタ、NULLで解除
+ *  return ERコード
+ *  有効時はdvp_activate後の1回の取り込み要求で、センサー0,1の順に
+ *  1フレームずつ取り込んでから完了となる．解除時はセンサー0を選択し
+ *  出力先をInit.RGBAddrに戻す．
+ */
+ER
+dvp_set_binocular(DVP_Handle_t *hdvp, DVP_Binocular_t *bino)
+{
+	DVP_Binocular_t *old = dvp_binocular;
+	SIL_PRE_LOC;
+
+	if(hdvp == NULL)
+		return E_PAR;
+	SIL_LOC_INT();
+	dvp_binocular = NULL;
+	SIL_UNL_INT();
+	if(bino != NULL){
+		bino->pair_count = 0;
+		dvp_select_sensor(hdvp, bino, 0);
+		SIL_LOC_INT();
+		dvp_binocular = bino;
+		SIL_UNL_INT();
+	}
+	else if(old != NULL){
+		dvp_select_sensor(hdvp, old, 0);
+		sil_wrw_mem((uint32_t *)(hdvp->base+TOFF_DVP_RGB_ADDR), hdvp->Init.RGBAddr);
+	}
+	return E_OK;
+}
+
+/*
+ *  DVPフレーム情報取得
+ *  parameter1  hdvp:  DVPハンドラへのポインタ
+ *  parameter2  info:  フレーム情報格納領域へのポインタ
+ *  return ERコード
+ */
+ER
+dvp_get_frameinfo(DVP_Handle_t *hdvp, DVP_FrameInfo_t *info)
+{
+	SIL_PRE_LOC;
+
+	if(hdvp == NULL || info == NULL)
+		return E_PAR;
+	SIL_LOC_INT();
+	*info = dvp_frameinfo;
+	SIL_UNL_INT();
+	return E_OK;
+}
+
+/*
+ *  DVPフレーム情報クリア
+ *  parameter1  hdvp:  DVPハンドラへのポインタ
+ */
+void
+dvp_reset_frameinfo(DVP_Handle_t *hdvp)
+{
+	SIL_PRE_LOC;
+
+	(void)(hdvp);
+	SIL_LOC_INT();
+	memset(&dvp_frameinfo, 0, sizeof(DVP_FrameInfo_t));
+	SIL_UNL_INT();
+}
+
+/*
+ *  DVP割込みハンドラ
  */
 void
 dvp_handler(void)
 {
 	DVP_Handle_t *hdvp = phdvp;
 	uint32_t istatus, estatus;
+	SYSUTM   utime;
 
 	if(hdvp == NULL)
 		return;
@@ -462,20 +629,52 @@ dvp_handler(void)
 		return;
 	estatus = istatus;
 	syslog_2(LOG_DEBUG, "sensor_irq istatus[%08x] hdvp->state(%d)", istatus, hdvp->state);
+	get_utm(&utime);
 	if((istatus & DVP_STS_FRAME_FINISH) != 0){	//frame end
 		estatus |= DVP_STS_FRAME_FINISH_WE;
-		hdvp->state = DVP_STATE_FINISH;
-		if(hdvp->semid != 0)
-			isig_sem(hdvp->semid);
+		dvp_frameinfo.finish_count++;
+		dvp_update_interval(&dvp_frameinfo.finish_interval, &dvp_frameinfo.finish_time, utime, dvp_frameinfo.finish_count);
+		if(dvp_binocular == NULL){
+			hdvp->state = DVP_STATE_FINISH;
+			if(hdvp->semid != 0)
+				isig_sem(hdvp->semid);
+		}
+		else if(hdvp->state == DVP_STATE_STARTED){
+			/*
+			 *  双眼キャプチャ、センサーを切り替えて次のフレームへ
+			 */
+			DVP_Binocular_t *bino = dvp_binocular;
+			bino->finish_time[bino->current] = utime;
+			if(bino->current == 0){
+				dvp_select_sensor(hdvp, bino, 1);
+				hdvp->state = DVP_STATE_ACTIVATE;
+			}
+			else{
+				dvp_select_sensor(hdvp, bino, 0);
+				bino->pair_count++;
+				hdvp->state = DVP_STATE_FINISH;
+				if(hdvp->semid != 0)
+					isig_sem(hdvp->semid);
+			}
+		}
 	}
 	if((istatus & DVP_STS_FRAME_START) != 0){	//frame start
 		estatus |= DVP_STS_FRAME_START_WE;
-        if(hdvp->state == DVP_STATE_ACTIVATE){  //only we finish the convert, do transmit again
+		dvp_frameinfo.start_count++;
+		dvp_update_interval(&dvp_frameinfo.start_interval, &dvp_frameinfo.start_time, utime, dvp_frameinfo.start_count);
+        if(hdvp->state == DVP_STATE_ACTIVATE && dvp_binocular != NULL && dvp_binocular->settle > 0){
+			dvp_binocular->settle--;	/* 切り替え直後のフレームは破棄 */
+		}
+        else if(hdvp->state == DVP_STATE_ACTIVATE){  //only we finish the convert, do transmit again
 			/*
-			 *  Сȥ
+			 *  コンバートスタート
 			 */
 			sil_wrw_mem((uint32_t *)(hdvp->base+TOFF_DVP_STS), DVP_STS_DVP_EN | DVP_STS_DVP_EN_WE);
 			hdvp->state = DVP_STATE_STARTED;
+			dvp_frameinfo.capture_count++;
+			dvp_frameinfo.capture_time = utime;
+			if(dvp_binocular != NULL)
+				dvp_binocular->start_time[dvp_binocular->current] = utime;
 		}
 	}
 	sil_orw_mem((uint32_t *)(hdvp->base+TOFF_DVP_STS), estatus);
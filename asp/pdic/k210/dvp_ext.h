@@ -0,0 +1,122 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ * 
+ *  K210 DVPデバイスドライバの拡張宣言
+ *
+ */
+
+#ifndef _DVP_EXT_H_
+#define _DVP_EXT_H_
+
+#include <kernel.h>
+#include "dvp.h"
+#ifdef DVP_SIMULATION
+#include "dvp_sim.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ *  DVP出力先アドレスの変換
+ *  DVPのアドレスレジスタは32ビットのため、シミュレーション時はバッファの
+ *  ポインタをdvp_simの変換表で32ビットのバスアドレスに置き換える．
+ *  Init.xxxAddrやRGBAddrへの設定と取り出しはこのマクロを使うこと．
+ */
+#ifdef DVP_SIMULATION
+#define DVP_BUS_ADDR(p)         dvp_sim_bus_addr((const void *)(p))
+#define DVP_HOST_ADDR(a)        dvp_sim_host_addr(a)
+#else
+#define DVP_BUS_ADDR(p)         ((uint32_t)((uintptr_t)(p)))
+#define DVP_HOST_ADDR(a)        ((void *)((uintptr_t)(a)))
+#endif
+
+#ifndef TOPPERS_MACRO_ONLY
+
+/*
+ *  DVPフレーム情報構造体
+ *  時刻はget_utmによるマイクロ秒、間隔は直近8フレームの移動平均
+ */
+typedef struct {
+	uint32_t              start_count;		/* フレーム開始割込み回数 */
+	uint32_t              finish_count;		/* フレーム終了割込み回数 */
+	SYSUTM                start_time;		/* 最終フレーム開始時刻 */
+	SYSUTM                finish_time;		/* 最終フレーム終了時刻 */
+	uint32_t              start_interval;	/* フレーム開始間隔(usec) */
+	uint32_t              finish_interval;	/* フレーム終了間隔(usec) */
+	uint32_t              capture_count;	/* 取り込みを開始したフレーム数 */
+	SYSUTM                capture_time;		/* 最終取り込み開始時刻 */
+} DVP_FrameInfo_t;
+
+/*
+ *  双眼キャプチャ構造体
+ *  パワーダウン線を共有する2センサーをフレーム終了割込みで切り替え、
+ *  センサー0,1の順に1フレームずつ取り込む
+ */
+typedef struct {
+	uint32_t              RGBAddr[2];		/* センサー0/1の出力先アドレス */
+	uint8_t               Select;			/* センサー0選択時のパワーダウン指定値 */
+	uint8_t               Settle;			/* 切り替え後に破棄するフレーム数 */
+	volatile uint8_t      current;			/* 取り込み中のセンサー */
+	volatile uint8_t      settle;			/* 残りの破棄フレーム数 */
+	uint32_t              pair_count;		/* 完了したペア数 */
+	SYSUTM                start_time[2];	/* 各センサーのフレーム開始時刻 */
+	SYSUTM                finish_time[2];	/* 各センサーのフレーム終了時刻 */
+} DVP_Binocular_t;
+
+extern ER dvp_get_frameinfo(DVP_Handle_t *hdvp, DVP_FrameInfo_t *info);
+extern void dvp_reset_frameinfo(DVP_Handle_t *hdvp);
+extern ER dvp_set_output_addr(DVP_Handle_t *hdvp);
+extern ER dvp_set_ai_output(DVP_Handle_t *hdvp, bool_t enable);
+extern ER dvp_set_binocular(DVP_Handle_t *hdvp, DVP_Binocular_t *bino);
+extern ER dvp_select_sensor(DVP_Handle_t *hdvp, DVP_Binocular_t *bino, uint8_t no);
+
+#endif /* TOPPERS_MACRO_ONLY */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _DVP_EXT_H_ */
+
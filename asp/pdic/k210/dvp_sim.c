@@ -0,0 +1,467 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ * 
+ *  K210 DVP/センサーシミュレーション
+ *
+ *  DVP_SIMULATIONを定義すると、dvp.cのsil_rew_mem/sil_wrw_memはこの
+ *  モジュールのDVPレジスタ/SYSCTLレジスタモデルを経由し、cambus.cの
+ *  SCCBアクセスはシミュレーションセンサーのレジスタファイルに接続
+ *  される．dvp_sim_frameを呼び出すごとに1フレーム分のフレーム開始、
+ *  DVP出力書込み、フレーム終了割込みを再現する．フレームデータは
+ *  dvp_sim_set_sourceで登録した関数、DVP_SIM_FILE定義時は録画した
+ *  フレームファイル(リトルエンディアンRGB565/YUV422の連続)から供給し、
+ *  未登録時はフレーム番号で移動するカラーバーを生成する．
+ *  DVPの出力先アドレスレジスタは32ビットのため、出力先はDVP_BUS_ADDRで
+ *  変換表のバスアドレスとして設定し、64ビットホストのヒープでも扱える
+ *  ようにする．
+ */
+#include <stddef.h>
+#include <string.h>
+#include <kernel.h>
+#include <sil.h>
+#include <t_syslog.h>
+#include <target_syssvc.h>
+#include "device.h"
+#include "dvp.h"
+#include "dvp_sim.h"
+#ifdef DVP_SIM_FILE
+#include <stdio.h>
+#endif
+
+#define DVP_REG(off)            dvp_regs[(off) / 4]
+
+static uint32_t dvp_regs[DVP_SIM_DVP_SIZE / 4];
+static uint32_t sysctl_regs[DVP_SIM_SYSCTL_SIZE / 4];
+
+/*
+ *  シミュレーションセンサー
+ */
+static uint8_t  sensor_addr = DVP_SIM_DEF_ADDR;
+static uint8_t  sensor_id   = DVP_SIM_DEF_ID;
+static uint8_t  sensor_regs[2][256];
+static uint8_t  sensor_page;
+static bool_t   sensor_ready;
+static uint16_t sccb_reg;		/* DVP SCCB読み込みの対象レジスタ */
+static bool_t   sccb_phase;		/* DVP SCCB読み込みの2回目の転送 */
+
+static DVP_SimRead_t sim_read;
+static intptr_t      sim_exinf;
+static uint32_t      sim_seq;
+static DVP_SimStat_t sim_stat;
+#ifdef DVP_SIM_FILE
+static FILE          *sim_file;
+#endif
+static uintptr_t     sim_region[DVP_SIM_REGION_NUM];
+
+/*
+ *  バッファのポインタからバスアドレスへの変換
+ *  parameter1  p: バッファのポインタ
+ *  return      バスアドレス、NULLまたは変換表が一杯の場合は0
+ *  登録済み領域の先頭から16MB以内はその領域のオフセットとし、それ以外は
+ *  新しい領域として登録する．
+ */
+uint32_t
+dvp_sim_bus_addr(const void *p)
+{
+	uintptr_t a = (uintptr_t)p;
+	uint32_t  i;
+
+	if(p == NULL)
+		return 0;
+	for(i = 0 ; i < DVP_SIM_REGION_NUM && sim_region[i] != 0 ; i++){
+		if(a >= sim_region[i] && a - sim_region[i] < DVP_SIM_REGION_SIZE)
+			return ((i + 1) << 24) | (uint32_t)(a - sim_region[i]);
+	}
+	if(i >= DVP_SIM_REGION_NUM){
+		syslog_0(LOG_ERROR, "dvp_sim_bus_addr region full !");
+		return 0;
+	}
+	sim_region[i] = a;
+	return (i + 1) << 24;
+}
+
+/*
+ *  バスアドレスからバッファのポインタへの変換
+ *  parameter1  addr: バスアドレス
+ *  return      バッファのポインタ、未登録の場合はNULL
+ */
+void *
+dvp_sim_host_addr(uint32_t addr)
+{
+	uint32_t i = addr >> 24;
+
+	if(i == 0 || i > DVP_SIM_REGION_NUM || sim_region[i - 1] == 0)
+		return NULL;
+	return (void *)(sim_region[i - 1] + (addr & (DVP_SIM_REGION_SIZE - 1)));
+}
+
+/*
+ *  センサーレジスタの初期値設定
+ */
+static void
+sensor_sim_reset(void)
+{
+	memset(sensor_regs, 0, sizeof(sensor_regs));
+	sensor_page  = 0;
+	sensor_ready = true;
+	if(sensor_id == 0x9d){		/* GC0328 */
+		sensor_regs[0][0xF0] = sensor_id;
+	}
+	else{						/* OV系 */
+		sensor_regs[0][0x0A] = sensor_id;
+		sensor_regs[0][0x0B] = 0x42;
+		sensor_regs[0][0x1C] = 0x7F;
+		sensor_regs[0][0x1D] = 0xA2;
+	}
+}
+
+/*
+ *  シミュレーションセンサー設定
+ *  parameter1  addr: スレーブアドレス
+ *  parameter2  id: チップID(GC0328_ID, OV7740_IDなど)
+ */
+void
+dvp_sim_set_sensor(uint8_t addr, uint8_t id)
+{
+	sensor_addr = addr;
+	sensor_id   = id;
+	sensor_sim_reset();
+}
+
+/*
+ *  シミュレーションセンサーのレジスタ書込み
+ *  parameter1  addr: スレーブアドレス
+ *  parameter2  reg: レジスタアドレス
+ *  parameter3  data: 書込みデータ
+ *  return      ERコード、アドレス不一致はE_TMOUT(NACK相当)
+ */
+ER
+dvp_sim_sccb_write(uint8_t addr, uint16_t reg, uint8_t data)
+{
+	if(addr != sensor_addr)
+		return E_TMOUT;
+	if(!sensor_ready)
+		sensor_sim_reset();
+	sim_stat.sccb_writes++;
+	reg &= 0xFF;
+	if(sensor_id == 0x9d && reg == 0xFE){
+		sensor_page = data & 1;
+		sensor_regs[0][reg] = sensor_regs[1][reg] = data;
+		return E_OK;
+	}
+	if(sensor_id != 0x9d && reg == 0x12 && (data & 0x80) != 0){
+		sensor_sim_reset();		/* ソフトウェアリセット */
+		return E_OK;
+	}
+	sensor_regs[sensor_page][reg] = data;
+	return E_OK;
+}
+
+/*
+ *  シミュレーションセンサーのレジスタ読み込み
+ *  parameter1  addr: スレーブアドレス
+ *  parameter2  reg: レジスタアドレス
+ *  parameter3  data: 読み込みデータの格納先
+ *  return      ERコード、アドレス不一致はE_TMOUT(NACK相当)
+ */
+ER
+dvp_sim_sccb_read(uint8_t addr, uint16_t reg, uint8_t *data)
+{
+	if(addr != sensor_addr)
+		return E_TMOUT;
+	if(!sensor_ready)
+		sensor_sim_reset();
+	sim_stat.sccb_reads++;
+	*data = sensor_regs[sensor_page][reg & 0xFF];
+	return E_OK;
+}
+
+/*
+ *  DVP SCCBコントローラによる転送
+ */
+static void
+dvp_sim_sccb_transfer(void)
+{
+	uint32_t cfg = DVP_REG(TOFF_DVP_SCCB_CFG);
+	uint32_t ctl = DVP_REG(TOFF_DVP_SCCB_CTL);
+	uint8_t  addr = (ctl & 0xFF) & ~DVP_SCCB_WRITE_DATA_ENABLE;
+	uint8_t  data = 0;
+
+	if(addr != sensor_addr)
+		addr >>= 1;				/* 8ビット形式のスレーブアドレス */
+	switch(cfg & DVP_SCCB_BYTE_NUM_MASK){
+	case DVP_SCCB_BYTE_NUM_4:	/* 16ビットレジスタ書込み */
+		dvp_sim_sccb_write(addr, (((ctl >> 8) & 0xFF) << 8) | ((ctl >> 16) & 0xFF), ctl >> 24);
+		sccb_phase = false;
+		break;
+	case DVP_SCCB_BYTE_NUM_3:	/* 8ビットレジスタ書込み */
+		dvp_sim_sccb_write(addr, (ctl >> 8) & 0xFF, (ctl >> 16) & 0xFF);
+		sccb_phase = false;
+		break;
+	case DVP_SCCB_BYTE_NUM_2:	/* 8ビットレジスタ読み込み(アドレス設定→読み込み) */
+	default:
+		if(!sccb_phase){
+			sccb_reg   = (ctl >> 8) & 0xFF;
+			sccb_phase = true;
+		}
+		else{
+			dvp_sim_sccb_read(addr, sccb_reg, &data);
+			DVP_REG(TOFF_DVP_SCCB_CFG) = (cfg & 0x00FFFFFF) | ((uint32_t)data << 24);
+			sccb_phase = false;
+		}
+		break;
+	}
+}
+
+/*
+ *  SIL読み込み(DVP, SYSCTL領域はレジスタモデル)
+ */
+uint32_t
+dvp_sim_rew(uintptr_t addr)
+{
+	if(addr >= DVP_BASE_ADDR && addr < DVP_BASE_ADDR + DVP_SIM_DVP_SIZE)
+		return dvp_regs[(addr - DVP_BASE_ADDR) / 4];
+	if(addr >= TADR_SYSCTL_BASE && addr < TADR_SYSCTL_BASE + DVP_SIM_SYSCTL_SIZE)
+		return sysctl_regs[(addr - TADR_SYSCTL_BASE) / 4];
+	return *((volatile uint32_t *)addr);
+}
+
+/*
+ *  SIL書込み(DVP, SYSCTL領域はレジスタモデル)
+ *  DVP_STSはWEビット付きの書込みのみ対応するビットに作用する．
+ *  フレーム開始/終了はクリア、DVP_ENは取り込み要求、SCCB_ENは
+ *  SCCB転送を行い即時に完了する．
+ */
+void
+dvp_sim_wrw(uintptr_t addr, uint32_t data)
+{
+	uint32_t *sts = &DVP_REG(TOFF_DVP_STS);
+
+	if(addr == DVP_BASE_ADDR + TOFF_DVP_STS){
+		if((data & (DVP_STS_FRAME_START_WE | DVP_STS_FRAME_START)) == (DVP_STS_FRAME_START_WE | DVP_STS_FRAME_START))
+			*sts &= ~DVP_STS_FRAME_START;
+		if((data & (DVP_STS_FRAME_FINISH_WE | DVP_STS_FRAME_FINISH)) == (DVP_STS_FRAME_FINISH_WE | DVP_STS_FRAME_FINISH))
+			*sts &= ~DVP_STS_FRAME_FINISH;
+		if((data & DVP_STS_DVP_EN_WE) != 0)
+			*sts = (*sts & ~DVP_STS_DVP_EN) | (data & DVP_STS_DVP_EN);
+		if((data & (DVP_STS_SCCB_EN_WE | DVP_STS_SCCB_EN)) == (DVP_STS_SCCB_EN_WE | DVP_STS_SCCB_EN))
+			dvp_sim_sccb_transfer();
+	}
+	else if(addr >= DVP_BASE_ADDR && addr < DVP_BASE_ADDR + DVP_SIM_DVP_SIZE)
+		dvp_regs[(addr - DVP_BASE_ADDR) / 4] = data;
+	else if(addr >= TADR_SYSCTL_BASE && addr < TADR_SYSCTL_BASE + DVP_SIM_SYSCTL_SIZE)
+		sysctl_regs[(addr - TADR_SYSCTL_BASE) / 4] = data;
+	else
+		*((volatile uint32_t *)addr) = data;
+}
+
+/*
+ *  フレーム供給関数の登録
+ *  parameter1  read: フレーム読み出し関数、NULLでカラーバー生成
+ *  parameter2  exinf: 読み出し関数の拡張情報
+ */
+void
+dvp_sim_set_source(DVP_SimRead_t read, intptr_t exinf)
+{
+	sim_read  = read;
+	sim_exinf = exinf;
+}
+
+#ifdef DVP_SIM_FILE
+/*
+ *  フレームファイルからの読み出し、終端で先頭に戻り繰り返し再生する
+ */
+static ER
+dvp_sim_file_read(intptr_t exinf, void *buf, uint32_t size, uint32_t seq)
+{
+	FILE *fp = (FILE *)exinf;
+
+	if(fread(buf, 1, size, fp) != size){
+		rewind(fp);
+		if(fread(buf, 1, size, fp) != size)
+			return E_SYS;
+	}
+	return E_OK;
+}
+
+/*
+ *  フレームファイルのオープン
+ *  parameter1  path: フレームファイルのパス
+ *  return      ERコード
+ */
+ER
+dvp_sim_open_file(const char *path)
+{
+	dvp_sim_close_file();
+	if((sim_file = fopen(path, "rb")) == NULL)
+		return E_OBJ;
+	dvp_sim_set_source(dvp_sim_file_read, (intptr_t)sim_file);
+	return E_OK;
+}
+
+/*
+ *  フレームファイルのクローズ
+ */
+void
+dvp_sim_close_file(void)
+{
+	if(sim_file != NULL){
+		dvp_sim_set_source(NULL, 0);
+		fclose(sim_file);
+		sim_file = NULL;
+	}
+}
+#endif
+
+/*
+ *  移動するカラーバーの生成
+ */
+static void
+dvp_sim_colorbar(uint16_t *buf, uint16_t width, uint16_t height, uint32_t seq)
+{
+	static const uint16_t bar[8] = {
+		0xFFFF, 0xFFE0, 0x07FF, 0x07E0, 0xF81F, 0xF800, 0x001F, 0x0000
+	};
+	uint32_t x, y, bw = (width + 7) / 8;
+
+	for(y = 0 ; y < height ; y++){
+		for(x = 0 ; x < width ; x++)
+			*buf++ = bar[((x + seq) / bw) & 7];
+	}
+}
+
+/*
+ *  AI出力(RGB888プレーン)の生成
+ */
+static void
+dvp_sim_ai_output(const uint16_t *src, uint32_t count)
+{
+	uint8_t  *r = (uint8_t *)dvp_sim_host_addr(DVP_REG(TOFF_DVP_R_ADDR));
+	uint8_t  *g = (uint8_t *)dvp_sim_host_addr(DVP_REG(TOFF_DVP_G_ADDR));
+	uint8_t  *b = (uint8_t *)dvp_sim_host_addr(DVP_REG(TOFF_DVP_B_ADDR));
+	uint32_t i;
+	uint16_t pix;
+
+	if(r == NULL || g == NULL || b == NULL)
+		return;
+	for(i = 0 ; i < count ; i++){
+		pix  = src[i];
+		r[i] = ((pix >> 8) & 0xF8) | (pix >> 13);
+		g[i] = ((pix >> 3) & 0xFC) | ((pix >> 9) & 0x03);
+		b[i] = ((pix << 3) & 0xF8) | ((pix >> 2) & 0x07);
+	}
+}
+
+/*
+ *  1フレームのシミュレーション
+ *  return      ERコード
+ *  フレーム開始割込み、取り込み要求時のDVP出力書込み、フレーム終了
+ *  割込みの順にdvp_handlerを呼び出す．
+ */
+ER
+dvp_sim_frame(void)
+{
+	uint32_t cfg = DVP_REG(TOFF_DVP_CFG);
+	uint32_t *sts = &DVP_REG(TOFF_DVP_STS);
+	uint32_t width, height, size;
+	uint16_t *buf;
+	ER       ercd = E_OK;
+
+	width  = ((cfg & DVP_CFG_HREF_BURST_NUM_MASK) >> 12) * 8;
+	if((cfg & DVP_CFG_BURST_SIZE_4BEATS) != 0)
+		width *= 4;
+	height = (cfg & DVP_CFG_LINE_NUM_MASK) >> 20;
+	size   = width * height * 2;
+	sim_seq++;
+	sim_stat.frames++;
+
+	*sts |= DVP_STS_FRAME_START;
+	if((cfg & DVP_CFG_START_INT_ENABLE) != 0)
+		dvp_handler();
+	if((*sts & DVP_STS_DVP_EN) == 0){
+		sim_stat.skips++;
+		return E_OK;
+	}
+
+	buf = (uint16_t *)dvp_sim_host_addr(DVP_REG(TOFF_DVP_RGB_ADDR));
+	if(buf != NULL && size != 0){
+		if(sim_read != NULL)
+			ercd = sim_read(sim_exinf, buf, size, sim_seq);
+		else
+			dvp_sim_colorbar(buf, width, height, sim_seq);
+		if(ercd == E_OK && (cfg & DVP_CFG_AI_OUTPUT_ENABLE) != 0
+			&& (cfg & DVP_CFG_FORMAT_MASK) == DVP_FORMAT_RGB)
+			dvp_sim_ai_output(buf, width * height);
+	}
+	*sts &= ~DVP_STS_DVP_EN;
+	sim_stat.captures++;
+
+	*sts |= DVP_STS_FRAME_FINISH;
+	if((DVP_REG(TOFF_DVP_CFG) & DVP_CFG_FINISH_INT_ENABLE) != 0)
+		dvp_handler();
+	return ercd;
+}
+
+/*
+ *  フレーム生成周期ハンドラ
+ *  CRE_CYCの周期をフレーム間隔として登録する．
+ */
+void
+dvp_sim_cyclic(intptr_t exinf)
+{
+	dvp_sim_frame();
+}
+
+/*
+ *  シミュレーション統計の取得
+ *  parameter1  stat: 統計の格納先
+ */
+void
+dvp_sim_get_stat(DVP_SimStat_t *stat)
+{
+	SIL_PRE_LOC;
+
+	SIL_LOC_INT();
+	*stat = sim_stat;
+	SIL_UNL_INT();
+}
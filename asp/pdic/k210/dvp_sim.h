@@ -0,0 +1,118 @@
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ *  Copyright (C) 2020-2021 by fukuen
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id$
+ */
+/*
+ * 
+ *  K210 DVP/センサーシミュレーションの外部宣言
+ *
+ */
+
+#ifndef _DVP_SIM_H_
+#define _DVP_SIM_H_
+
+#include <kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ *  シミュレーション対象のレジスタ領域
+ */
+#define DVP_SIM_DVP_SIZE        0x40		/* DVPレジスタ領域 */
+#define DVP_SIM_SYSCTL_SIZE     0x100		/* SYSCTLレジスタ領域 */
+
+/*
+ *  既定のシミュレーションセンサー(GC0328)
+ */
+#define DVP_SIM_DEF_ADDR        0x42
+#define DVP_SIM_DEF_ID          0x9d
+
+/*
+ *  出力先アドレスの変換表
+ *  バスアドレスの上位8ビットが領域番号+1、下位24ビットが領域内オフセット
+ */
+#define DVP_SIM_REGION_NUM      32
+#define DVP_SIM_REGION_SIZE     0x01000000
+
+#ifndef TOPPERS_MACRO_ONLY
+
+/*
+ *  フレーム読み出し関数
+ *  buf: DVP出力形式(リトルエンディアンRGB565またはYUV422)の格納先
+ *  size: フレームサイズ(バイト)、seq: フレーム番号
+ */
+typedef ER (*DVP_SimRead_t)(intptr_t exinf, void *buf, uint32_t size, uint32_t seq);
+
+/*
+ *  シミュレーション統計
+ */
+typedef struct {
+	uint32_t        frames;			/* 生成フレーム数 */
+	uint32_t        captures;		/* 取り込まれたフレーム数 */
+	uint32_t        skips;			/* 取り込み要求が無く捨てたフレーム数 */
+	uint32_t        sccb_writes;	/* センサーレジスタ書込み回数 */
+	uint32_t        sccb_reads;		/* センサーレジスタ読み込み回数 */
+} DVP_SimStat_t;
+
+extern uint32_t dvp_sim_bus_addr(const void *p);
+extern void *dvp_sim_host_addr(uint32_t addr);
+extern uint32_t dvp_sim_rew(uintptr_t addr);
+extern void dvp_sim_wrw(uintptr_t addr, uint32_t data);
+extern void dvp_sim_set_source(DVP_SimRead_t read, intptr_t exinf);
+#ifdef DVP_SIM_FILE
+extern ER dvp_sim_open_file(const char *path);
+extern void dvp_sim_close_file(void);
+#endif
+extern void dvp_sim_set_sensor(uint8_t addr, uint8_t id);
+extern ER dvp_sim_sccb_write(uint8_t addr, uint16_t reg, uint8_t data);
+extern ER dvp_sim_sccb_read(uint8_t addr, uint16_t reg, uint8_t *data);
+extern ER dvp_sim_frame(void);
+extern void dvp_sim_cyclic(intptr_t exinf);
+extern void dvp_sim_get_stat(DVP_SimStat_t *stat);
+
+#endif /* TOPPERS_MACRO_ONLY */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _DVP_SIM_H_ */
@@ -8,40 +8,40 @@
  *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
  *  Copyright (C) 2020-2021 by fukuen
  * 
- *  嵭Ԥϡʲ(1)(4)ξ˸¤ꡤܥեȥ
- *  ܥեȥѤΤޤࡥʲƱˤѡʣ
- *  ѡۡʰʲѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
- *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
- *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
- *      ˴ޤޤƤ뤳ȡ
- *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
- *      ѤǤǺۤˤϡۤȼɥȡ
- *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
- *      ̵ݾڵǺܤ뤳ȡ
- *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
- *      ѤǤʤǺۤˤϡΤ줫ξ
- *      ȡ
- *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
- *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
- *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
- *        𤹤뤳ȡ
- *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
- *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
- *      ޤܥեȥΥ桼ޤϥɥ桼Τʤ
- *      ͳ˴Ťᤫ⡤嵭ԤTOPPERSץȤ
- *      դ뤳ȡ
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
  * 
- *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
- *  TOPPERSץȤϡܥեȥ˴ؤơλŪ
- *  ФŬޤơʤݾڤԤʤޤܥեȥ
- *  ѤˤľŪޤϴŪʤ»˴ؤƤ⡤
- *  Ǥʤ
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
  * 
  *  @(#) $Id: i2s.c 699 2020-12-26 17:44:27Z fukuen $
  */
 /*
  * 
- *  K210 I2Sɥ饤дؿ
+ *  K210 I2Sドライバ関数群
  *
  */
 #include "kernel_impl.h"
@@ -56,21 +56,21 @@
 #include <math.h>
 
 /*
- *  SILؿΥޥ
+ *  SIL関数のマクロ定義
  */
 #define sil_orw_mem(a, b)		sil_wrw_mem((a), sil_rew_mem(a) | (b))
 #define sil_andw_mem(a, b)		sil_wrw_mem((a), sil_rew_mem(a) & ~(b))
 #define sil_modw_mem(a, b, c)	sil_wrw_mem((a), (sil_rew_mem(a) & (~b)) | (c))
 
 /*
- *  I2SݡID֥åФΥޥ
+ *  I2SポートIDから管理ブロックを取り出すためのマクロ
  */
 #define INDEX_I2S(i2sid)        ((uint_t)((i2sid) - 1))
 
 #define DEFAULT_THRESHOLD       7
 
 /*
- *  I2Sݡơ֥
+ *  I2Sポート設定テーブル
  */
 static const I2S_PortControlBlock i2s_pcb[NUM_I2SPORT] = {
   {	TADR_I2S0_BASE, SYSCTL_CLK_EN_PERI_I2S0_CLK_EN, SYSCTL_PERI_RESET_I2S0_RESET, TOFF_SYSCTL_CLK_TH3, SYSCTL_CLK_TH3_I2S0_CLK_THHD,  0 },
@@ -83,7 +83,7 @@ static DMA_Handle_t i2s_dma_handle[NUM_I2SPORT][2];
 
 
 /*
- *  DMAХåؿ
+ *  DMAコールバック関数
  */
 static void
 i2s_dma_comp(DMA_Handle_t *hdma)
@@ -104,7 +104,7 @@ i2s_dma_comp(DMA_Handle_t *hdma)
 }
 
 /*
- *  DMA顼Хåؿ
+ *  DMAエラーコールバック関数
  */
 static void
 i2s_dma_error(DMA_Handle_t *hdma)
@@ -122,7 +122,7 @@ i2s_dma_error(DMA_Handle_t *hdma)
 }
 
 /*
- *  DMAžϴؿ
+ *  DMA転送開始関数
  */
 DMA_Handle_t *
 i2s_dmac_set_single_mode(I2S_Handle_t *hi2s, uint8_t rtx,
@@ -151,22 +151,22 @@ i2s_dmac_set_single_mode(I2S_Handle_t *hi2s, uint8_t rtx,
 	}
 	hi2s->status = I2S_STATUS_BUSY;
 
-	hdma->Init.Direction    = flow_control;	/* DMAž */
-	hdma->Init.SrcHandShake = (mem_type_src ? DMAC_HS_SOFTWARE : DMAC_HS_HARDWARE);	/* ϥɥ */
-	hdma->Init.DrcHandShake = (mem_type_dest ? DMAC_HS_SOFTWARE : DMAC_HS_HARDWARE);	/* ǥƥ͡ϥɥ */
-	hdma->Init.SrcInc       = src_inc;	/* 󥯥 */
-	hdma->Init.DstInc       = dest_inc;	/* ǥƥ͡󥤥󥯥 */
-	hdma->Init.SrcTransWidth = dmac_trans_width;	/* ž */
-	hdma->Init.DstTransWidth = dmac_trans_width;	/* ǥƥ͡ž */
-	hdma->Init.SrcBurstSize = dmac_burst_size;	/* Сȥ */
-	hdma->Init.DstBurstSize = dmac_burst_size;	/* ǥƥ͡Сȥ */
+	hdma->Init.Direction    = flow_control;	/* DMA転送方向 */
+	hdma->Init.SrcHandShake = (mem_type_src ? DMAC_HS_SOFTWARE : DMAC_HS_HARDWARE);	/* ソースハンドシェイク */
+	hdma->Init.DrcHandShake = (mem_type_dest ? DMAC_HS_SOFTWARE : DMAC_HS_HARDWARE);	/* デスティネーションハンドシェイク */
+	hdma->Init.SrcInc       = src_inc;	/* ソースインクリメント設定 */
+	hdma->Init.DstInc       = dest_inc;	/* デスティネーションインクリメント設定 */
+	hdma->Init.SrcTransWidth = dmac_trans_width;	/* ソース転送幅 */
+	hdma->Init.DstTransWidth = dmac_trans_width;	/* デスティネーション転送幅 */
+	hdma->Init.SrcBurstSize = dmac_burst_size;	/* ソースバーストサイズ */
+	hdma->Init.DstBurstSize = dmac_burst_size;	/* デスティネーションバーストサイズ */
 	dma_reset(hdma);
 	dma_start(hdma, (uintptr_t)src, (uintptr_t)dest, block_size);
 	return hdma;
 }
 
 /*
- *  SPI-DMAžλԤ
+ *  SPI-DMA転送終了待ち
  */
 ER
 i2s_dmac_wait_idle(DMA_Handle_t * hdma)
@@ -524,12 +524,12 @@ i2s_get_dma_divide_16(I2S_Handle_t *hi2s)
 }
 
 /*
- *  I2S¹Դؿ non DMA
- *  parameter1  hi2s: I2SϥɥؤΥݥ
- *  parameter2  channel_num: ֹͥ
- *  parameter3  buf: ХåեؤΥݥ
- *  parameter4  buf_len: 
- *  return ER
+ *  I2S受信実行関数 non DMA
+ *  parameter1  hi2s: I2Sハンドラへのポインタ
+ *  parameter2  channel_num: チャンネル番号
+ *  parameter3  buf: 受信バッファへのポインタ
+ *  parameter4  buf_len: 受信サイズ
+ *  return ERコード
  */
 ER
 i2s_receive_data_standard(I2S_Handle_t *hi2s, i2s_channel_num_t channel_num, uint64_t *buf, size_t buf_len)
@@ -559,11 +559,11 @@ i2s_receive_data_standard(I2S_Handle_t *hi2s, i2s_channel_num_t channel_num, uin
 }
 
 /*
- *  I2S¹Դؿ
- *  parameter1  hi2s: I2SϥɥؤΥݥ
- *  parameter2  buf: ХåեؤΥݥ
- *  parameter3  buf_len: 
- *  return ER
+ *  I2S受信実行関数
+ *  parameter1  hi2s: I2Sハンドラへのポインタ
+ *  parameter2  buf: 受信バッファへのポインタ
+ *  parameter3  buf_len: 受信サイズ
+ *  return ERコード
  */
 ER
 i2s_receive_data(I2S_Handle_t *hi2s, uint32_t *buf, size_t buf_len)
@@ -583,13 +583,13 @@ i2s_receive_data(I2S_Handle_t *hi2s, uint32_t *buf, size_t buf_len)
 }
 
 /*
- *  I2S¹Դؿ non DMA
- *  parameter1  hi2s: I2SϥɥؤΥݥ
- *  parameter2  channel_num: ֹͥ
- *  parameter3  pcm: ХåեؤΥݥ
- *  parameter4  buf_len: 
- *  parameter5  single_length: ӥåĹ
- *  return ER
+ *  I2S送信実行関数 non DMA
+ *  parameter1  hi2s: I2Sハンドラへのポインタ
+ *  parameter2  channel_num: チャンネル番号
+ *  parameter3  pcm: 送信バッファへのポインタ
+ *  parameter4  buf_len: 送信サイズ
+ *  parameter5  single_length: ビット長
+ *  return ERコード
  */
 ER
 i2s_send_data_standard(I2S_Handle_t *hi2s, i2s_channel_num_t channel_num, const uint8_t *pcm, size_t buf_len,
@@ -650,11 +650,11 @@ i2s_send_data_standard(I2S_Handle_t *hi2s, i2s_channel_num_t channel_num, const
 }
 
 /*
- *  I2S¹Դؿ
- *  parameter1  hi2s: I2SϥɥؤΥݥ
- *  parameter2  buf: ХåեؤΥݥ
- *  parameter3  buf_len: 
- *  return ER
+ *  I2S送信実行関数
+ *  parameter1  hi2s: I2Sハンドラへのポインタ
+ *  parameter2  buf: 送信バッファへのポインタ
+ *  parameter3  buf_len: 送信サイズ
+ *  return ERコード
  */
 ER
 i2s_send_data(I2S_Handle_t *hi2s, const void *buf, size_t buf_len)
@@ -748,10 +748,10 @@ i2s_tx_channel_config(I2S_Handle_t *hi2s,
 }
 
 /*
- *  I2SǥХν
- *  parameter1 portid  ݡID
- *  parameter2 ii2s    I2SϥɥؤΥݥ
- *  return             ｪλI2SϥɥؤΥݥ
+ *  I2Sデバイスの初期化
+ *  parameter1 portid  ポートID
+ *  parameter2 ii2s    I2S初期化ハンドラへのポインタ
+ *  return             正常終了時、I2Sハンドラへのポインタ
  */
 I2S_Handle_t *
 i2s_init(ID portid, I2S_Init_t *ii2s)
@@ -779,7 +779,7 @@ i2s_init(ID portid, I2S_Init_t *ii2s)
 	memcpy(&hi2s->Init, ii2s, sizeof(I2S_Init_t));
 
 	/*
-	 *  å
+	 *  クロック設定
 	 */
 	sil_orw_mem((uint32_t *)(TADR_SYSCTL_BASE+TOFF_SYSCTL_CLK_EN_CENT), SYSCTL_CLK_EN_CENT_APB0_CLK_EN);
 	sil_orw_mem((uint32_t *)(TADR_SYSCTL_BASE+TOFF_SYSCTL_CLK_EN_PERI), pcb->clkenable);
@@ -794,7 +794,7 @@ i2s_init(ID portid, I2S_Init_t *ii2s)
 	i2s_disable_block(hi2s, I2S_RECEIVER);
 
 	/*
-	 *  ԥե󥯥
+	 *  ピンファンクション設定
 	 */
 	if(ii2s->MclkPin >= 0)
 		fpioa_set_function(ii2s->MclkPin, (uint8_t)(FUNC_I2S0_MCLK + hi2s->i2s_num * 11));
@@ -867,7 +867,7 @@ i2s_init(ID portid, I2S_Init_t *ii2s)
 	hi2s->status = I2S_STATUS_READY;
 
 	/*
-	 *  ϥɥ
+	 *  ハンドラ初期化
 	 */
 	hi2s->readcallback = NULL;
 	hi2s->writecallback = NULL;
@@ -883,24 +883,24 @@ i2s_init(ID portid, I2S_Init_t *ii2s)
 			hdma->xfercallback      = i2s_dma_comp;
 		hdma->errorcallback     = NULL;
 //		hdma->errorcallback     = i2s_dma_error;
-		hdma->Init.Request      = DMA_SELECT_I2S0_TX_REQ + hi2s->i2s_num * 2;	/* DMA */
-		hdma->Init.Direction    = DMA_MEMORY_TO_PERIPH;	/* DMAž */
-		hdma->Init.SrcMultBlock = DMAC_MULTBLOCK_CONT;	/* ޥ֥å */
-		hdma->Init.DrcMultBlock = DMAC_MULTBLOCK_CONT;	/* ǥƥ͡ޥ֥å */
-		hdma->Init.SrcHandShake = DMAC_HS_SOFTWARE;	/* ϥɥ */
-		hdma->Init.DrcHandShake = DMAC_HS_HARDWARE;	/* ǥƥ͡ϥɥ */
-		hdma->Init.SrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* ϡɥϥɥ */
-		hdma->Init.DrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* ǥƥ͡ϡɥϥɥ */
-		hdma->Init.Priority     = 4;	/* ͥ */
-		hdma->Init.SrcMaster    = DMAC_MASTER1;	/* ޥ */
-		hdma->Init.DstMaster    = DMAC_MASTER2;	/* ǥƥ͡ޥ */
-		hdma->Init.SrcInc       = DMAC_ADDR_INCREMENT;	/* 󥯥 */
-		hdma->Init.DstInc       = DMAC_ADDR_NOCHANGE;	/* ǥƥ͡󥤥󥯥 */
-		hdma->Init.SrcTransWidth = DMAC_TRANS_WIDTH_32;	/* ž */
-		hdma->Init.DstTransWidth = DMAC_TRANS_WIDTH_32;	/* ǥƥ͡ž */
-		hdma->Init.SrcBurstSize = DMAC_MSIZE_1;	/* Сȥ */
-		hdma->Init.DstBurstSize = DMAC_MSIZE_1;	/* ǥƥ͡Сȥ */
-		hdma->Init.IocBlkTrans  = 0;	/* IOC֥åž */
+		hdma->Init.Request      = DMA_SELECT_I2S0_TX_REQ + hi2s->i2s_num * 2;	/* DMA選択 */
+		hdma->Init.Direction    = DMA_MEMORY_TO_PERIPH;	/* DMA転送方向 */
+		hdma->Init.SrcMultBlock = DMAC_MULTBLOCK_CONT;	/* ソースマルチブロックタイプ */
+		hdma->Init.DrcMultBlock = DMAC_MULTBLOCK_CONT;	/* デスティネーションマルチブロックタイプ */
+		hdma->Init.SrcHandShake = DMAC_HS_SOFTWARE;	/* ソースハンドシェイク */
+		hdma->Init.DrcHandShake = DMAC_HS_HARDWARE;	/* デスティネーションハンドシェイク */
+		hdma->Init.SrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* ソースハードウェアハンドシェイク極性 */
+		hdma->Init.DrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* デスティネーションハードウェアハンドシェイク極性 */
+		hdma->Init.Priority     = 4;	/* 優先度 */
+		hdma->Init.SrcMaster    = DMAC_MASTER1;	/* ソースマスター設定 */
+		hdma->Init.DstMaster    = DMAC_MASTER2;	/* デスティネーションマスター設定 */
+		hdma->Init.SrcInc       = DMAC_ADDR_INCREMENT;	/* ソースインクリメント設定 */
+		hdma->Init.DstInc       = DMAC_ADDR_NOCHANGE;	/* デスティネーションインクリメント設定 */
+		hdma->Init.SrcTransWidth = DMAC_TRANS_WIDTH_32;	/* ソース転送幅 */
+		hdma->Init.DstTransWidth = DMAC_TRANS_WIDTH_32;	/* デスティネーション転送幅 */
+		hdma->Init.SrcBurstSize = DMAC_MSIZE_1;	/* ソースバーストサイズ */
+		hdma->Init.DstBurstSize = DMAC_MSIZE_1;	/* デスティネーションバーストサイズ */
+		hdma->Init.IocBlkTrans  = 0;	/* IOCブロック転送 */
 		hdma->localdata         = (void *)hi2s;
 		dma_init(hdma);
 		hi2s->hdmatx = hdma;
@@ -911,24 +911,24 @@ i2s_init(ID portid, I2S_Init_t *ii2s)
 		hdma->xfercallback      = i2s_dma_comp;
 		hdma->errorcallback     = NULL;
 //		hdma->errorcallback     = i2s_dma_error;
-		hdma->Init.Request      = DMA_SELECT_I2S0_RX_REQ + hi2s->i2s_num * 2;	/* DMA */
-		hdma->Init.Direction    = DMA_PERIPH_TO_MEMORY;	/* DMAž */
-		hdma->Init.SrcMultBlock = DMAC_MULTBLOCK_CONT;	/* ޥ֥å */
-		hdma->Init.DrcMultBlock = DMAC_MULTBLOCK_CONT;	/* ǥƥ͡ޥ֥å */
-		hdma->Init.SrcHandShake = DMAC_HS_HARDWARE;	/* ϥɥ */
-		hdma->Init.DrcHandShake = DMAC_HS_SOFTWARE;	/* ǥƥ͡ϥɥ */
-		hdma->Init.SrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* ϡɥϥɥ */
-		hdma->Init.DrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* ǥƥ͡ϡɥϥɥ */
-		hdma->Init.Priority     = 4;	/* ͥ */
-		hdma->Init.SrcMaster    = DMAC_MASTER1;	/* ޥ */
-		hdma->Init.DstMaster    = DMAC_MASTER2;	/* ǥƥ͡ޥ */
-		hdma->Init.SrcInc       = DMAC_ADDR_NOCHANGE;	/* 󥯥 */
-		hdma->Init.DstInc       = DMAC_ADDR_INCREMENT;	/* ǥƥ͡󥤥󥯥 */
-		hdma->Init.SrcTransWidth = DMAC_TRANS_WIDTH_32;	/* ž */
-		hdma->Init.DstTransWidth = DMAC_TRANS_WIDTH_32;	/* ǥƥ͡ž */
-		hdma->Init.SrcBurstSize = DMAC_MSIZE_1;	/* Сȥ */
-		hdma->Init.DstBurstSize = DMAC_MSIZE_1;	/* ǥƥ͡Сȥ */
-		hdma->Init.IocBlkTrans  = 0;	/* IOC֥åž */
+		hdma->Init.Request      = DMA_SELECT_I2S0_RX_REQ + hi2s->i2s_num * 2;	/* DMA選択 */
+		hdma->Init.Direction    = DMA_PERIPH_TO_MEMORY;	/* DMA転送方向 */
+		hdma->Init.SrcMultBlock = DMAC_MULTBLOCK_CONT;	/* ソースマルチブロックタイプ */
+		hdma->Init.DrcMultBlock = DMAC_MULTBLOCK_CONT;	/* デスティネーションマルチブロックタイプ */
+		hdma->Init.SrcHandShake = DMAC_HS_HARDWARE;	/* ソースハンドシェイク */
+		hdma->Init.DrcHandShake = DMAC_HS_SOFTWARE;	/* デスティネーションハンドシェイク */
+		hdma->Init.SrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* ソースハードウェアハンドシェイク極性 */
+		hdma->Init.DrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* デスティネーションハードウェアハンドシェイク極性 */
+		hdma->Init.Priority     = 4;	/* 優先度 */
+		hdma->Init.SrcMaster    = DMAC_MASTER1;	/* ソースマスター設定 */
+		hdma->Init.DstMaster    = DMAC_MASTER2;	/* デスティネーションマスター設定 */
+		hdma->Init.SrcInc       = DMAC_ADDR_NOCHANGE;	/* ソースインクリメント設定 */
+		hdma->Init.DstInc       = DMAC_ADDR_INCREMENT;	/* デスティネーションインクリメント設定 */
+		hdma->Init.SrcTransWidth = DMAC_TRANS_WIDTH_32;	/* ソース転送幅 */
+		hdma->Init.DstTransWidth = DMAC_TRANS_WIDTH_32;	/* デスティネーション転送幅 */
+		hdma->Init.SrcBurstSize = DMAC_MSIZE_1;	/* ソースバーストサイズ */
+		hdma->Init.DstBurstSize = DMAC_MSIZE_1;	/* デスティネーションバーストサイズ */
+		hdma->Init.IocBlkTrans  = 0;	/* IOCブロック転送 */
 		hdma->localdata         = (void *)hi2s;
 		dma_init(hdma);
 		hi2s->hdmarx = hdma;
@@ -939,9 +939,9 @@ i2s_init(ID portid, I2S_Init_t *ii2s)
 }
 
 /*
- *  I2SǥХ̵
- *  parameter1 hi2s  I2SϥɥؤΥݥ
- *  return           ｪλE_OK
+ *  I2Sデバイスの無効化
+ *  parameter1 hi2s  I2Sハンドラへのポインタ
+ *  return           正常終了時、E_OK
  */
 ER
 i2s_deinit(I2S_Handle_t *hi2s)
@@ -963,10 +963,10 @@ i2s_deinit(I2S_Handle_t *hi2s)
 }
 
 /*
- *  ץ󥰥졼
- *  parameter1 hi2s         I2SϥɥؤΥݥ
- *  parameter2 sample_rate  ץ󥰥졼
- *  return                  ץ󥰥졼
+ *  サンプリングレート設定
+ *  parameter1 hi2s         I2Sハンドラへのポインタ
+ *  parameter2 sample_rate  サンプリングレート
+ *  return                  サンプリングレート
  */
 uint32_t
 i2s_set_sample_rate(I2S_Handle_t *hi2s, uint32_t sample_rate)
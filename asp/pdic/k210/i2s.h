@@ -8,40 +8,40 @@
  *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
  *  Copyright (C) 2020-2021 by fukuen
  * 
- *  嵭Ԥϡʲ(1)(4)ξ˸¤ꡤܥեȥ
- *  ܥեȥѤΤޤࡥʲƱˤѡʣ
- *  ѡۡʰʲѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
- *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
- *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
- *      ˴ޤޤƤ뤳ȡ
- *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
- *      ѤǤǺۤˤϡۤȼɥȡ
- *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
- *      ̵ݾڵǺܤ뤳ȡ
- *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
- *      ѤǤʤǺۤˤϡΤ줫ξ
- *      ȡ
- *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
- *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
- *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
- *        𤹤뤳ȡ
- *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
- *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
- *      ޤܥեȥΥ桼ޤϥɥ桼Τʤ
- *      ͳ˴Ťᤫ⡤嵭ԤTOPPERSץȤ
- *      դ뤳ȡ
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
  * 
- *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
- *  TOPPERSץȤϡܥեȥ˴ؤơλŪ
- *  ФŬޤơʤݾڤԤʤޤܥեȥ
- *  ѤˤľŪޤϴŪʤ»˴ؤƤ⡤
- *  Ǥʤ
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
  * 
  *  @(#) $Id: i2s.h 698 2021-01-15 17:44:42Z fukuen $
  */
 /*
  * 
- *  K210 I2SǥХɥ饤Фγ
+ *  K210 I2Sデバイスドライバの外部宣言
  *
  */
 
@@ -54,7 +54,7 @@
 
 
 /*
- *  I2Sݡ
+ *  I2Sポート定義
  */
 #define I2S1_PORTID             1
 #define I2S2_PORTID             2
@@ -176,17 +176,17 @@ typedef enum _i2s_transfer_mode
 } i2s_transfer_mode_t;
 
 /*
- *  I2S
+ *  I2S状態定義
  */
-#define I2S_STATUS_RESET    0x00			/* I2S ꥻåȾ */
-#define I2S_STATUS_READY    0x01			/* I2S ǥ */
-#define I2S_STATUS_BUSY     0x02			/* I2S ӥ */
-#define I2S_STATUS_BUSY_TX  0x52			/* I2S  */
-#define I2S_STATUS_BUSY_RX  0x62			/* I2S  */
+#define I2S_STATUS_RESET    0x00			/* I2S リセット状態 */
+#define I2S_STATUS_READY    0x01			/* I2S レディ状態 */
+#define I2S_STATUS_BUSY     0x02			/* I2S ビジィ状態 */
+#define I2S_STATUS_BUSY_TX  0x52			/* I2S 送信中 */
+#define I2S_STATUS_BUSY_RX  0x62			/* I2S 受信中 */
 #define I2S_STATUS_TIMEOUT  0x80
 
 /*
- *  SPIϡɥ깽¤
+ *  SPIハードウェア設定構造体
  */
 
 typedef struct _I2S_PortControlBlock{
@@ -200,11 +200,11 @@ typedef struct _I2S_PortControlBlock{
 } I2S_PortControlBlock;
 
 /*
- *  I2Sե奮졼¤
+ *  I2Sコンフュギュレーション構造体定義
  */
 typedef struct
 {
-	i2s_transmit_t        RxTxMode;         /* I2S Tx/Rx⡼ */
+	i2s_transmit_t        RxTxMode;         /* I2S Tx/Rxモード */
 	int32_t               MclkPin;			/* I2S MCLK PINNO */
 	int32_t               SclkPin;			/* I2S SCLK PINNO */
 	int32_t               WsPin;			/* I2S WS PINNO*/
@@ -216,36 +216,36 @@ typedef struct
 	int32_t               OutD1Pin;			/* I2S OUT_D1 PINNO*/
 	int32_t               OutD2Pin;			/* I2S OUT_D2 PINNO*/
 	int32_t               OutD3Pin;			/* I2S OUT_D3 PINNO*/
-	int32_t               TxChannelMask;	/* I2S Txͥޥ */
-	int32_t               RxChannelMask;	/* I2S Rxͥޥ */
-	int32_t               TxDMAChannel;		/* I2S TxDMAͥ */
-	int32_t               RxDMAChannel;		/* I2S RxDMAͥ */
-	int                   semid;			/* I2S ̿ѥޥե */
-	int                   semlock;			/* I2S åޥե */
-	int                   semdmaid;			/* I2S DMA̿ѥޥե */
-	i2s_word_length_t     word_length;      /* Ĺ */
-	i2s_word_select_cycles_t word_select_size; /* 򥵥 */
-	i2s_fifo_threshold_t  trigger_level;    /* FIFO */
-	i2s_work_mode_t       word_mode;        /* ɥ⡼ */
-	uint32_t              sample_rate;      /* ץ󥰥졼 */
+	int32_t               TxChannelMask;	/* I2S Txチャンネルマスク */
+	int32_t               RxChannelMask;	/* I2S Rxチャンネルマスク */
+	int32_t               TxDMAChannel;		/* I2S TxDMAチャンネル */
+	int32_t               RxDMAChannel;		/* I2S RxDMAチャンネル */
+	int                   semid;			/* I2S 通信用セマフォ値 */
+	int                   semlock;			/* I2S ロックセマフォ値 */
+	int                   semdmaid;			/* I2S DMA通信用セマフォ値 */
+	i2s_word_length_t     word_length;      /* ワード長 */
+	i2s_word_select_cycles_t word_select_size; /* ワード選択サイズ */
+	i2s_fifo_threshold_t  trigger_level;    /* FIFOしきい値 */
+	i2s_work_mode_t       word_mode;        /* ワードモード */
+	uint32_t              sample_rate;      /* サンプリングレート */
 }I2S_Init_t;
 
 
 /*
- *  I2Sϥɥ
+ *  I2Sハンドラ定義
  */
 typedef struct __I2S_Handle_t I2S_Handle_t;
 struct __I2S_Handle_t {
 	unsigned long              base;
-	I2S_Init_t                 Init;		/* I2Sѥ᡼ */
-	uint8_t                    i2s_num;	    /* I2S ǥХֹ */
-	void                       (*writecallback)(I2S_Handle_t * hi2s);	/* λХåؿ */
-	void                       (*readcallback)(I2S_Handle_t * hi2s);		/* λХåؿ */
-	void                       (*errorcallback)(I2S_Handle_t * hi2s);	/* 顼Хåؿ */
-	ID                         i2sid;		/* I2S ID */
+	I2S_Init_t                 Init;		/* I2S初期設定パラメータ */
+	uint8_t                    i2s_num;	    /* I2S デバイス番号 */
+	void                       (*writecallback)(I2S_Handle_t * hi2s);	/* 送信終了コールバック関数 */
+	void                       (*readcallback)(I2S_Handle_t * hi2s);		/* 受信終了コールバック関数 */
+	void                       (*errorcallback)(I2S_Handle_t * hi2s);	/* エラーコールバック関数 */
+	ID                         i2sid;		/* I2S ID値 */
 	DMA_Handle_t               *hdmatx;		/* I2S Tx DMA handle parameters */
 	DMA_Handle_t               *hdmarx;		/* I2S Rx DMA handle parameters */
-	volatile uint32_t          status;		/* I2S ¹Ծ */
+	volatile uint32_t          status;		/* I2S 実行状態 */
 	volatile uint32_t          ErrorCode;	/* I2S Error code */
 };
 
@@ -7,40 +7,40 @@
  *              Graduate School of Information Science, Nagoya Univ., JAPAN
  *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
  * 
- *  嵭Ԥϡʲ(1)(4)ξ˸¤ꡤܥեȥ
- *  ܥեȥѤΤޤࡥʲƱˤѡʣ
- *  ѡۡʰʲѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
- *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
- *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
- *      ˴ޤޤƤ뤳ȡ
- *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
- *      ѤǤǺۤˤϡۤȼɥȡ
- *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
- *      ̵ݾڵǺܤ뤳ȡ
- *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
- *      ѤǤʤǺۤˤϡΤ줫ξ
- *      ȡ
- *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
- *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
- *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
- *        𤹤뤳ȡ
- *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
- *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
- *      ޤܥեȥΥ桼ޤϥɥ桼Τʤ
- *      ͳ˴Ťᤫ⡤嵭ԤTOPPERSץȤ
- *      դ뤳ȡ
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
  * 
- *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
- *  TOPPERSץȤϡܥեȥ˴ؤơλŪ
- *  ФŬޤơʤݾڤԤʤޤܥեȥ
- *  ѤˤľŪޤϴŪʤ»˴ؤƤ⡤
- *  Ǥʤ
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
  * 
  *  @(#) $Id: maix_i2c.c 699 2020-11-26 17:44:27Z fukuen $
  */
 /*
  * 
- *  K210 SCCB I2Cɥ饤дؿ
+ *  K210 SCCB I2Cドライバ関数群
  *
  */
 #include "kernel_impl.h"
@@ -54,14 +54,14 @@
 #include "maix_i2c.h"
 
 /*
- *  SILؿΥޥ
+ *  SIL関数のマクロ定義
  */
 #define sil_orw_mem(a, b)		sil_wrw_mem((a), sil_rew_mem(a) | (b))
 #define sil_andw_mem(a, b)		sil_wrw_mem((a), sil_rew_mem(a) & ~(b))
 #define sil_modw_mem(a, b, c)	sil_wrw_mem((a), (sil_rew_mem(a) & (~b)) | (c))
 
 /*
- *  I2CݡID֥åФΥޥ
+ *  I2CポートIDから管理ブロックを取り出すためのマクロ
  */
 #define INDEX_I2C(i2cid)        ((uint_t)((i2cid) - 1))
 
@@ -79,7 +79,7 @@
 #define DEFAULT_INTRM           (I2C_INTR_MASK_START_DET | I2C_INTR_MASK_STOP_DET | I2C_INTR_MASK_RD_REQ)
 
 /*
- *  I2Cݡơ֥
+ *  I2Cポート設定テーブル
  */
 static const I2C_PortControlBlock maix_i2c_pcb[NUM_I2CPORT] = {
   {	TADR_I2C0_BASE, SYSCTL_CLK_EN_PERI_I2C0_CLK_EN, 8,  FUNC_I2C0_SCLK, FUNC_I2C0_SDA },
@@ -91,9 +91,9 @@ static I2C_Handle_t maixI2cHandle[3];
 
 
 /*
- *  I2CžԤ
- *  parameter1 hi2c:   I2CϥɥؤΥݥ
- *  parameter2 Timeout:ॢȻ(ms)
+ *  I2C転送待ち
+ *  parameter1 hi2c:   I2Cハンドラへのポインタ
+ *  parameter2 Timeout:タイムアウト時間(ms)
  */
 static ER
 maix_i2c_transwait(I2C_Handle_t *hi2c, uint32_t Timeout)
@@ -116,7 +116,7 @@ maix_i2c_transwait(I2C_Handle_t *hi2c, uint32_t Timeout)
 }
 
 /*
- *  I2Cǡ⥸塼
+ *  I2Cデータ送信モジュール
  */
 static void
 maix_i2c_send_data(I2C_Handle_t *hi2c)
@@ -149,7 +149,7 @@ maix_i2c_send_data(I2C_Handle_t *hi2c)
 }
 
 /*
- *  I2Cǡ⥸塼
+ *  I2Cデータ受信モジュール
  */
 static void
 maix_i2c_recv_data(I2C_Handle_t *hi2c)
@@ -175,9 +175,9 @@ maix_i2c_recv_data(I2C_Handle_t *hi2c)
 
 
 /*
- *  I2CǥХν
- *  parameter1 hi2c  I2CϥɥؤΥݥ
- *  return           ｪλE_OK
+ *  I2Cデバイスの初期化
+ *  parameter1 hi2c  I2Cハンドラへのポインタ
+ *  return           正常終了時、E_OK
  */
 I2C_Handle_t *
 maix_i2c_init(ID portid, I2C_Init_t *ii2c)
@@ -202,7 +202,7 @@ maix_i2c_init(ID portid, I2C_Init_t *ii2c)
 	memcpy(&hi2c->Init, ii2c, sizeof(I2C_Init_t));
 
 	/*
-	 *  ե󥯥ԥ
+	 *  ファンクションピン設定
 	 */
 	if(ii2c->SdaPin >= 0)
 		fpioa_set_function(ii2c->SdaPin, pcb->sdafunc);
@@ -210,7 +210,7 @@ maix_i2c_init(ID portid, I2C_Init_t *ii2c)
 		fpioa_set_function(ii2c->SclPin, pcb->sclfunc);
 
 	/*
-	 *  å
+	 *  クロック設定
 	 */
 	sil_orw_mem((uint32_t *)(TADR_SYSCTL_BASE+TOFF_SYSCTL_CLK_EN_CENT), SYSCTL_CLK_SEL0_APB0_CLK_SEL);
 	sil_orw_mem((uint32_t *)(TADR_SYSCTL_BASE+TOFF_SYSCTL_CLK_EN_PERI), (SYSCTL_CLK_EN_PERI_I2C0_CLK_EN<<no));
@@ -265,9 +265,9 @@ maix_i2c_init(ID portid, I2C_Init_t *ii2c)
 }
 
 /*
- *  I2CǥХ̵
- *  parameter1 hi2c  I2CϥɥؤΥݥ
- *  return           ｪλE_OK
+ *  I2Cデバイスの無効化
+ *  parameter1 hi2c  I2Cハンドラへのポインタ
+ *  return           正常終了時、E_OK
  */
 ER
 maix_i2c_deinit(I2C_Handle_t *hi2c)
@@ -284,11 +284,11 @@ maix_i2c_deinit(I2C_Handle_t *hi2c)
 }
 
 /*
- *  I2C졼ּ
- *  parameter1 hi2c:   I2CϥɥؤΥݥ
- *  parameter2 pData:  ɤ߽ФХåեؤΥݥ
- *  parameter3 Size:   ɤ߽Ф
- *  return             ｪλʤE_OK
+ *  I2Cスレーブ受信
+ *  parameter1 hi2c:   I2Cハンドラへのポインタ
+ *  parameter2 pData:  読み出しバッファへのポインタ
+ *  parameter3 Size:   読み出しサイズ
+ *  return             正常終了ならE_OK
  */
 ER
 maix_i2c_slaveread(I2C_Handle_t *hi2c, uint8_t *pData, uint16_t Size)
@@ -302,7 +302,7 @@ maix_i2c_slaveread(I2C_Handle_t *hi2c, uint8_t *pData, uint16_t Size)
 		return E_OBJ;
 
 	/*
-	 *  ɤ߽Фå
+	 *  読み出しロック
 	 */
 	if(hi2c->Init.semlock != 0)
 		wai_sem(hi2c->Init.semlock);
@@ -323,7 +323,7 @@ maix_i2c_slaveread(I2C_Handle_t *hi2c, uint8_t *pData, uint16_t Size)
 	ercd = maix_i2c_transwait(hi2c, I2C_TIMEOUT);
 
 	/*
-	 *  ɤ߽Фå
+	 *  読み出しロック解除
 	 */
 	if(hi2c->Init.semlock != 0)
 		sig_sem(hi2c->Init.semlock);
@@ -331,11 +331,11 @@ maix_i2c_slaveread(I2C_Handle_t *hi2c, uint8_t *pData, uint16_t Size)
 }
 
 /*
- *  I2C졼
- *  parameter1 hi2c:   I2CϥɥؤΥݥ
- *  parameter2 pData:  ɤ߽ФХåեؤΥݥ
- *  parameter3 Size:   ɤ߽Ф
- *  return             ｪλʤE_OK
+ *  I2Cスレーブ送信
+ *  parameter1 hi2c:   I2Cハンドラへのポインタ
+ *  parameter2 pData:  読み出しバッファへのポインタ
+ *  parameter3 Size:   読み出しサイズ
+ *  return             正常終了ならE_OK
  */
 ER
 maix_i2c_slavewrite(I2C_Handle_t *hi2c, uint8_t *pData, uint16_t Size)
@@ -349,7 +349,7 @@ maix_i2c_slavewrite(I2C_Handle_t *hi2c, uint8_t *pData, uint16_t Size)
 		return E_OBJ;
 
 	/*
-	 *  񤭹ߥå
+	 *  書き込みロック
 	 */
 	if(hi2c->Init.semlock != 0)
 		wai_sem(hi2c->Init.semlock);
@@ -375,7 +375,7 @@ maix_i2c_slavewrite(I2C_Handle_t *hi2c, uint8_t *pData, uint16_t Size)
 	}
 
 	/*
-	 *  񤭹ߥå
+	 *  書き込みロック解除
 	 */
 	if(hi2c->Init.semlock != 0)
 		sig_sem(hi2c->Init.semlock);
@@ -383,14 +383,14 @@ maix_i2c_slavewrite(I2C_Handle_t *hi2c, uint8_t *pData, uint16_t Size)
 }
 
 /*
- *  I2Cǡ꡼
- *  parameter1 hi2c:       I2CϥɥؤΥݥ
- *  parameter2 DevAddress: 졼֥ɥ쥹
- *  parameter3 MemAddress: ꥢɥ쥹
- *  parameter4 MemAddSize: ꥢɥ쥹
- *  parameter5 pData:      ɤ߽ФХåեؤΥݥ
- *  parameter6 Size:       ɤ߽Ф
- *  return                 ｪλʤE_OK
+ *  I2Cデータリード
+ *  parameter1 hi2c:       I2Cハンドラへのポインタ
+ *  parameter2 DevAddress: スレーブアドレス
+ *  parameter3 MemAddress: メモリアドレス
+ *  parameter4 MemAddSize: メモリアドレスサイズ
+ *  parameter5 pData:      読み出しバッファへのポインタ
+ *  parameter6 Size:       読み出しサイズ
+ *  return                 正常終了ならE_OK
  */
 ER
 maix_i2c_memread(I2C_Handle_t *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
@@ -405,7 +405,7 @@ maix_i2c_memread(I2C_Handle_t *hi2c, uint16_t DevAddress, uint16_t MemAddress, u
 		return E_OBJ;
 
 	/*
-	 *  ɤ߽Фå
+	 *  読み出しロック
 	 */
 	if(hi2c->Init.semlock != 0)
 		wai_sem(hi2c->Init.semlock);
@@ -457,7 +457,7 @@ maix_i2c_memread(I2C_Handle_t *hi2c, uint16_t DevAddress, uint16_t MemAddress, u
 	ercd = maix_i2c_transwait(hi2c, Timeout);
 
 	/*
-	 *  ɤ߽Фå
+	 *  読み出しロック解除
 	 */
 	if(hi2c->Init.semlock != 0)
 		sig_sem(hi2c->Init.semlock);
@@ -465,14 +465,14 @@ maix_i2c_memread(I2C_Handle_t *hi2c, uint16_t DevAddress, uint16_t MemAddress, u
 }
 
 /*
- *  I2Cǡ饤
- *  parameter1 hi2c:       I2CϥɥؤΥݥ
- *  parameter2 DevAddress: 졼֥ɥ쥹
- *  parameter3 MemAddress: ꥢɥ쥹
- *  parameter4 MemAddSize: ꥢɥ쥹
- *  parameter5 pData:      ߥХåեؤΥݥ
- *  parameter6 Size:       ߥ
- *  return                 ｪλʤE_OK
+ *  I2Cデータライト
+ *  parameter1 hi2c:       I2Cハンドラへのポインタ
+ *  parameter2 DevAddress: スレーブアドレス
+ *  parameter3 MemAddress: メモリアドレス
+ *  parameter4 MemAddSize: メモリアドレスサイズ
+ *  parameter5 pData:      書込みバッファへのポインタ
+ *  parameter6 Size:       書込みサイズ
+ *  return                 正常終了ならE_OK
  */
 ER
 maix_i2c_memwrite(I2C_Handle_t *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
@@ -486,7 +486,7 @@ maix_i2c_memwrite(I2C_Handle_t *hi2c, uint16_t DevAddress, uint16_t MemAddress,
 		return E_OBJ;
 
 	/*
-	 *  񤭹ߥå
+	 *  書き込みロック
 	 */
 	if(hi2c->Init.semlock != 0)
 		wai_sem(hi2c->Init.semlock);
@@ -519,7 +519,7 @@ maix_i2c_memwrite(I2C_Handle_t *hi2c, uint16_t DevAddress, uint16_t MemAddress,
 	}
 
 	/*
-	 *  񤭹ߥå
+	 *  書き込みロック解除
 	 */
 	if(hi2c->Init.semlock != 0)
 		sig_sem(hi2c->Init.semlock);
@@ -527,7 +527,7 @@ maix_i2c_memwrite(I2C_Handle_t *hi2c, uint16_t DevAddress, uint16_t MemAddress,
 }
 
 /*
- *  I2Cߥϥɥ
+ *  I2C割込みハンドラ
  */
 void
 maix_i2c_isr(intptr_t exinf)
@@ -7,40 +7,40 @@
  *              Graduate School of Information Science, Nagoya Univ., JAPAN
  *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
  * 
- *  嵭Ԥϡʲ(1)(4)ξ˸¤ꡤܥեȥ
- *  ܥեȥѤΤޤࡥʲƱˤѡʣ
- *  ѡۡʰʲѤȸƤ֡ˤ뤳Ȥ̵ǵ롥
- *  (1) ܥեȥ򥽡ɤηѤˤϡ嵭
- *      ɽѾ浪Ӳ̵ݾڵ꤬Τޤޤηǥ
- *      ˴ޤޤƤ뤳ȡ
- *  (2) ܥեȥ򡤥饤֥ʤɡ¾Υեȥȯ˻
- *      ѤǤǺۤˤϡۤȼɥȡ
- *      ԥޥ˥奢ʤɡˤˡ嵭ɽѾ浪Ӳ
- *      ̵ݾڵǺܤ뤳ȡ
- *  (3) ܥեȥ򡤵Ȥ߹ʤɡ¾Υեȥȯ˻
- *      ѤǤʤǺۤˤϡΤ줫ξ
- *      ȡ
- *    (a) ۤȼɥȡѼԥޥ˥奢ʤɡˤˡ嵭
- *        ɽѾ浪Ӳ̵ݾڵǺܤ뤳ȡ
- *    (b) ۤη֤̤ˡˤäơTOPPERSץȤ
- *        𤹤뤳ȡ
- *  (4) ܥեȥѤˤľŪޤϴŪ뤤ʤ»
- *      ⡤嵭ԤTOPPERSץȤդ뤳ȡ
- *      ޤܥեȥΥ桼ޤϥɥ桼Τʤ
- *      ͳ˴Ťᤫ⡤嵭ԤTOPPERSץȤ
- *      դ뤳ȡ
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
  * 
- *  ܥեȥϡ̵ݾڤ󶡤ƤΤǤ롥嵭Ԥ
- *  TOPPERSץȤϡܥեȥ˴ؤơλŪ
- *  ФŬޤơʤݾڤԤʤޤܥեȥ
- *  ѤˤľŪޤϴŪʤ»˴ؤƤ⡤
- *  Ǥʤ
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
  * 
  *  @(#) $Id: spi.c 698 2019-12-10 17:41:19Z roi $
  */
 /*
  * 
- *  SPIɥ饤дؿ
+ *  SPIドライバ関数群
  *
  */
 #include "kernel_impl.h"
@@ -51,6 +51,9 @@
 #include <target_syssvc.h>
 #include "device.h"
 #include "spi.h"
+#if SPI_TRACE
+#include "syssvc/serial.h"
+#endif
 
 Inline uint64_t
 sil_rel_mem(const uint64_t *mem)
@@ -66,7 +69,7 @@ sil_rel_mem(const uint64_t *mem)
 #define sil_modw_mem(a, b, c)	sil_wrw_mem((a), (sil_rew_mem(a) & (~b)) | (c))
 
 /*
- *  SPIOݡID֥åФΥޥ
+ *  SPIOポートIDから管理ブロックを取り出すためのマクロ
  */
 #define INDEX_SPI(spiid)        ((uint_t)((spiid) - 1))
 
@@ -79,7 +82,64 @@ sil_rel_mem(const uint64_t *mem)
 #define SPI_DMACR_TXENABLE      0x00000002
 
 /*
- *  SPIϡɥ깽¤
+ *  非同期送信終了時のBUSY解除待ち回数(1フレーム分程度)
+ */
+#ifndef SPI_ASYNC_SPIN
+#define SPI_ASYNC_SPIN          256
+#endif
+
+/*
+ *  PIO転送の割込みしきい値(フレーム数)
+ *  9MHz/8bitで16フレーム分約14usの割込み応答余裕をもち、CSを途切れさせない
+ */
+#ifndef SPI_PIO_TX_LEVEL
+#define SPI_PIO_TX_LEVEL        16		/* 送信FIFOがこの段数以下で補充 */
+#endif
+#ifndef SPI_PIO_RX_LEVEL
+#define SPI_PIO_RX_LEVEL        16		/* 受信FIFOがこの段数以上で回収 */
+#endif
+#define SPI_FIFO_DEPTH          32
+
+/*
+ *  PIO転送終了待ちの基本タイムアウト(ms)
+ */
+#ifndef SPI_PIO_TIMEOUT
+#define SPI_PIO_TIMEOUT         100
+#endif
+
+/*
+ *  分割送信でバスを譲る際の転送終了待ちタイムアウト(ms)
+ */
+#ifndef SPI_YIELD_TIMEOUT
+#define SPI_YIELD_TIMEOUT       100
+#endif
+
+#ifndef TOFF_SPI_TXFTLR
+#define TOFF_SPI_TXFTLR         0x0018
+#endif
+#ifndef TOFF_SPI_RXFTLR
+#define TOFF_SPI_RXFTLR         0x001C
+#endif
+
+#define SPI_IMR_TXE             0x0001
+#define SPI_IMR_RXF             0x0010
+
+/*
+ *  記述子リスト送信でDMAを使わずFIFOに直接書き込む最大フレーム数
+ */
+#ifndef SPI_LIST_PIO_FRAMES
+#define SPI_LIST_PIO_FRAMES     32
+#endif
+
+/*
+ *  記述子リスト送信のBUSY解除待ち回数
+ */
+#ifndef SPI_LIST_SPIN
+#define SPI_LIST_SPIN           100000
+#endif
+
+/*
+ *  SPIハードウェア設定構造体
  */
 
 typedef struct _SPI_PortControlBlock{
@@ -102,7 +162,7 @@ DMA_Handle_t spi_dma_handle[NUM_SPIPORT][2];
 
 
 /*
- *  ž⡼
+ *  転送モード設定
  */
 static ER
 spi_set_tmod(SPI_Handle_t *hspi, uint32_t tmod)
@@ -112,6 +172,7 @@ spi_set_tmod(SPI_Handle_t *hspi, uint32_t tmod)
     uint32_t addr_l;
 
 	init = &hspi->Init;
+	get_utm(&hspi->start);
     switch (init->InstLength){
 	case 0:
 		inst_l = 0;
@@ -141,19 +202,26 @@ spi_set_tmod(SPI_Handle_t *hspi, uint32_t tmod)
 }
 
 /*
- *  DMAХåؿ
+ *  DMAコールバック関数
  */
 static void
 spi_dma_comp(DMA_Handle_t *hdma)
 {
 	SPI_Handle_t *hspi = (SPI_Handle_t *)hdma->localdata;
+	if(hspi != NULL && hspi->xmode == SPI_XMODE_TX_ASYNC){
+		/*
+		 *  非同期送信は送信FIFO空き割込みで終了処理を行う
+		 */
+		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_IMR), 0x0011);
+		return;
+	}
 	if(hspi != NULL && hspi->Init.semdmaid != 0){
 		isig_sem(hspi->Init.semdmaid);
 	}
 }
 
 /*
- *  DMAžϴؿ
+ *  DMA転送開始関数
  */
 DMA_Handle_t *
 spi_dmac_set_single_mode(SPI_Handle_t *hspi, uint8_t rtx,
@@ -181,15 +249,15 @@ spi_dmac_set_single_mode(SPI_Handle_t *hspi, uint8_t rtx,
 	if(ss_no < 0)
 		ss_no = 0;
 
-	hdma->Init.Direction    = flow_control;	/* DMAž */
-	hdma->Init.SrcHandShake = (mem_type_src ? DMAC_HS_SOFTWARE : DMAC_HS_HARDWARE);	/* ϥɥ */
-	hdma->Init.DrcHandShake = (mem_type_dest ? DMAC_HS_SOFTWARE : DMAC_HS_HARDWARE);	/* ǥƥ͡ϥɥ */
-	hdma->Init.SrcInc       = src_inc;	/* 󥯥 */
-	hdma->Init.DstInc       = dest_inc;	/* ǥƥ͡󥤥󥯥 */
-	hdma->Init.SrcTransWidth = dmac_trans_width;	/* ž */
-	hdma->Init.DstTransWidth = dmac_trans_width;	/* ǥƥ͡ž */
-	hdma->Init.SrcBurstSize = dmac_burst_size;	/* Сȥ */
-	hdma->Init.DstBurstSize = dmac_burst_size;	/* ǥƥ͡Сȥ */
+	hdma->Init.Direction    = flow_control;	/* DMA転送方向 */
+	hdma->Init.SrcHandShake = (mem_type_src ? DMAC_HS_SOFTWARE : DMAC_HS_HARDWARE);	/* ソースハンドシェイク */
+	hdma->Init.DrcHandShake = (mem_type_dest ? DMAC_HS_SOFTWARE : DMAC_HS_HARDWARE);	/* デスティネーションハンドシェイク */
+	hdma->Init.SrcInc       = src_inc;	/* ソースインクリメント設定 */
+	hdma->Init.DstInc       = dest_inc;	/* デスティネーションインクリメント設定 */
+	hdma->Init.SrcTransWidth = dmac_trans_width;	/* ソース転送幅 */
+	hdma->Init.DstTransWidth = dmac_trans_width;	/* デスティネーション転送幅 */
+	hdma->Init.SrcBurstSize = dmac_burst_size;	/* ソースバーストサイズ */
+	hdma->Init.DstBurstSize = dmac_burst_size;	/* デスティネーションバーストサイズ */
 	dma_reset(hdma);
 	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SER), (1 << ss_no));
 	dma_start(hdma, (uintptr_t)src, (uintptr_t)dest, block_size);
@@ -197,7 +265,7 @@ spi_dmac_set_single_mode(SPI_Handle_t *hspi, uint8_t rtx,
 }
 
 /*
- *  SPI-DMAžλԤ
+ *  SPI-DMA転送終了待ち
  */
 ER
 spi_dmac_wait_done(DMA_Handle_t * hdma)
@@ -223,7 +291,304 @@ spi_dmac_wait_done(DMA_Handle_t * hdma)
 }
 
 /*
- *  SPIžλԤ
+ *  SPIアイドル判定(送信FIFO空かつBUSY解除)
+ */
+Inline bool_t
+spi_is_idle(SPI_Handle_t *hspi)
+{
+	return (sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_SR)) & 0x05) == 0x04;
+}
+
+/*
+ *  最終フレームのシフトアウト待ち(割込みコンテキスト可)
+ *  return trueでアイドル
+ */
+static bool_t
+spi_spin_idle(SPI_Handle_t *hspi)
+{
+	int i;
+
+	for(i = 0 ; !spi_is_idle(hspi) ; i++){
+		if(i >= SPI_ASYNC_SPIN)
+			return false;
+	}
+	return true;
+}
+
+#if SPI_TRACE
+/*
+ *  トレースのリングバッファ
+ *  記録番号をアトミックに確保してから書き込むため、タスクと割込みの
+ *  どちらからもロックなしで記録できる．読出し側は記録番号の一致で
+ *  書込み途中や上書きされた記録を検出する．
+ */
+static SPI_Trace_t spi_trace_ring[SPI_TRACE_SIZE];
+static uint32_t    spi_trace_head;		/* 次に確保する記録番号 */
+static uint32_t    spi_trace_tail;		/* 次に読み出す記録番号 */
+
+/*
+ *  サイクルカウンタの取得
+ */
+Inline uint64_t
+spi_trace_cycle(void)
+{
+	uint64_t cycle;
+
+	Asm("rdcycle %0" : "=r"(cycle));
+	return cycle;
+}
+
+/*
+ *  トレース記録の開始(ロック獲得後に呼び出す)
+ */
+static void
+spi_trace_begin(SPI_Handle_t *hspi, int8_t ss_no, uint8_t mode, uint32_t bytes, uint8_t flags)
+{
+	hspi->trace.port  = hspi->spi_num;
+	hspi->trace.ss    = ss_no;
+	hspi->trace.mode  = mode;
+	hspi->trace.flags = flags;
+	hspi->trace.bytes = bytes;
+	hspi->trace.start = spi_trace_cycle();
+}
+
+/*
+ *  トレース記録の終了(割込みコンテキスト可)
+ */
+static void
+spi_trace_end(SPI_Handle_t *hspi)
+{
+	SPI_Trace_t *p;
+	uint32_t    seq;
+
+	if(hspi->trace.start == 0)
+		return;
+	seq = __atomic_fetch_add(&spi_trace_head, 1, __ATOMIC_RELAXED);
+	p = &spi_trace_ring[seq & (SPI_TRACE_SIZE - 1)];
+	__atomic_store_n(&p->seq, 0, __ATOMIC_RELEASE);
+	p->port  = hspi->trace.port;
+	p->ss    = hspi->trace.ss;
+	p->mode  = hspi->trace.mode;
+	p->flags = hspi->trace.flags;
+	if(hspi->ErrorCode != 0)
+		p->flags |= SPI_TRACE_ERROR;
+	p->bytes = hspi->trace.bytes;
+	p->start = hspi->trace.start;
+	p->end   = spi_trace_cycle();
+	__atomic_store_n(&p->seq, seq + 1, __ATOMIC_RELEASE);
+	hspi->trace.start = 0;
+}
+
+/*
+ *  16進数の書き出し
+ */
+static char *
+spi_trace_hex(char *p, uint64_t val, int digits)
+{
+	int i;
+
+	for(i = digits - 1 ; i >= 0 ; i--)
+		*p++ = "0123456789abcdef"[(val >> (i * 4)) & 0xf];
+	*p++ = ' ';
+	return p;
+}
+
+#define SPI_TRACE_BEGIN(h, s, m, b, f)	spi_trace_begin((h), (s), (m), (b), (f))
+#define SPI_TRACE_END(h)				spi_trace_end(h)
+#define SPI_TRACE_ADD(h, b, f)			((h)->trace.bytes += (b), (h)->trace.flags |= (f))
+#else
+#define SPI_TRACE_BEGIN(h, s, m, b, f)
+#define SPI_TRACE_END(h)
+#define SPI_TRACE_ADD(h, b, f)
+#endif
+
+/*
+ *  転送統計の更新(割込みコンテキスト可)
+ */
+static void
+spi_xfer_done(SPI_Handle_t *hspi)
+{
+	SYSUTM   now;
+	uint32_t time;
+
+	SPI_TRACE_END(hspi);
+	get_utm(&now);
+	time = (uint32_t)(now - hspi->start);
+	if(hspi->stat.count == 0 || time < hspi->stat.min)
+		hspi->stat.min = time;
+	if(time > hspi->stat.max)
+		hspi->stat.max = time;
+	hspi->stat.last   = time;
+	hspi->stat.total += time;
+	hspi->stat.count++;
+}
+
+/*
+ *  バス待ち統計の更新
+ */
+static void
+spi_wait_stat(SPI_WaitStat_t *stat, uint32_t time, bool_t waited)
+{
+	stat->count++;
+	if(waited)
+		stat->waits++;
+	if(time > stat->max)
+		stat->max = time;
+	stat->total += time;
+}
+
+/*
+ *  バス待ち行列への登録(割込み禁止で呼び出す)
+ */
+static void
+spi_enqueue(SPI_Handle_t *hspi, SPI_Client_t *client)
+{
+	SPI_Client_t **pp;
+
+	for(pp = &hspi->waitq ; *pp != NULL && (*pp)->priority <= client->priority ; pp = &(*pp)->next)
+		;
+	client->next    = *pp;
+	client->waiting = true;
+	*pp = client;
+}
+
+/*
+ *  バス獲得(タスクコンテキスト)
+ *  バスが空いていれば直ちに獲得し、使用中なら優先度順(同一優先度は到着順)の
+ *  待ち行列に入ってspi_unlockからの譲渡を待つ．譲渡の通知はセマフォで行い、
+ *  タスクの起床要求は使わない．spi_client_attachで登録したタスクはその
+ *  優先度と利用者のセマフォを用いる．未登録のタスクはSPI_PRIORITY_DEFAULTの
+ *  共通の利用者(hspi->temp)として1つの待ち行列要素を共有し、Init.semlockで
+ *  譲渡を待つ．共通の利用者は互いに区別しないため、譲渡をどのタスクが
+ *  受け取ってもよい．
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  return      バスを獲得した利用者へのポインタ、ロックなしの場合NULL
+ */
+static SPI_Client_t *
+spi_lock(SPI_Handle_t *hspi)
+{
+	SPI_Client_t *client;
+	SYSUTM       request, now;
+	bool_t       waited = false;
+	ID           tskid = TSK_NONE;
+	SIL_PRE_LOC;
+
+	if(hspi->Init.semlock == 0)
+		return NULL;
+	get_tid(&tskid);
+	for(client = hspi->clients ; client != NULL ; client = client->link){
+		if(client->tskid == tskid)
+			break;
+	}
+	if(client == NULL)
+		client = &hspi->temp;
+	get_utm(&request);
+
+	SIL_LOC_INT();
+	if(!hspi->locked){
+		hspi->locked  = true;
+		hspi->lockpri = client->priority;
+		SIL_UNL_INT();
+	}
+	else if(client == &hspi->temp){
+		if(hspi->tempwait++ == 0)
+			spi_enqueue(hspi, client);
+		SIL_UNL_INT();
+		while(wai_sem(hspi->Init.semlock) != E_OK)
+			;
+		waited = true;
+	}
+	else{
+		client->resume = NULL;
+		spi_enqueue(hspi, client);
+		SIL_UNL_INT();
+		/* 利用者のセマフォは譲渡でのみ返却されるため、獲得できれば譲渡済み */
+		while(wai_sem(client->semid) != E_OK)
+			;
+		waited = true;
+	}
+	get_utm(&now);
+	spi_wait_stat(&hspi->waitstat, (uint32_t)(now - request), waited);
+	if(client != &hspi->temp)
+		spi_wait_stat(&client->stat, (uint32_t)(now - request), waited);
+	return client;
+}
+
+/*
+ *  バス解放(タスク/割込みコンテキスト共通)
+ *  待ち行列先頭の利用者にバスを譲渡する．非同期分割送信の再開待ちであれば
+ *  その場で次の分割を開始する．共通の利用者への譲渡では、まだ待っている
+ *  未登録タスクがあれば共通の利用者を待ち行列に戻す．
+ */
+static void
+spi_unlock_common(SPI_Handle_t *hspi, bool_t isr)
+{
+	SPI_Client_t *next;
+	void         (*resume)(SPI_Handle_t *hspi) = NULL;
+	ID           semid = 0;
+	SIL_PRE_LOC;
+
+	if(hspi->Init.semlock == 0)
+		return;
+	SIL_LOC_INT();
+	if((next = hspi->waitq) == NULL)
+		hspi->locked = false;
+	else{
+		hspi->waitq   = next->next;
+		hspi->lockpri = next->priority;
+		next->waiting = false;
+		resume = next->resume;
+		if(next == &hspi->temp){
+			semid = hspi->Init.semlock;
+			if(--hspi->tempwait != 0)
+				spi_enqueue(hspi, next);
+		}
+		else
+			semid = next->semid;
+	}
+	SIL_UNL_INT();
+	if(resume != NULL)
+		resume(hspi);
+	else if(semid != 0){
+		if(isr)
+			isig_sem(semid);
+		else
+			sig_sem(semid);
+	}
+}
+
+#define spi_unlock(h)   spi_unlock_common((h), false)
+#define spi_iunlock(h)  spi_unlock_common((h), true)
+
+/*
+ *  使用中の利用者より高優先の待ちがあるか判定
+ */
+Inline bool_t
+spi_contended(SPI_Handle_t *hspi)
+{
+	SPI_Client_t *head = hspi->waitq;
+
+	return head != NULL && head->priority < hspi->lockpri;
+}
+
+/*
+ *  分割送信の1回分のフレーム数
+ */
+Inline uint32_t
+spi_chunk_length(SPI_Client_t *client, uint32_t length)
+{
+	if(client != NULL && client->chunk != 0 && length > client->chunk)
+		return client->chunk;
+	return length;
+}
+
+/*
+ *  SPI内部転送終了待ち
+ *  終了済みなら待たずに戻る．未終了なら送信FIFO空き割込みを許可し、
+ *  spi_handlerがアイドルを確認して一度だけ通知するセマフォを待つ．
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  timeout: タイムアウト時間(ms)
+ *  return ERコード
  */
 ER
 spi_inwait(SPI_Handle_t *hspi, uint32_t timeout)
@@ -231,21 +596,31 @@ spi_inwait(SPI_Handle_t *hspi, uint32_t timeout)
 	ER ercd = E_OK;
 	int tick = timeout;
 
-	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_IMR), 0x0011);
-    while((sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_SR)) & 0x05) != 0x04 && tick > 0){
-		if(hspi->Init.semid != 0)
-			twai_sem(hspi->Init.semid, 5);
-		else
-			dly_tsk(1);
-		tick--;
+	if(!spi_is_idle(hspi)){
+		if(hspi->Init.semid != 0){
+			while(pol_sem(hspi->Init.semid) == E_OK) ;
+			hspi->stat.irqwaits++;
+			sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_IMR), 0x0011);
+			do{
+				ercd = twai_sem(hspi->Init.semid, timeout);
+			}while(ercd == E_OK && !spi_is_idle(hspi));
+			sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_IMR), 0);
+		}
+		else{
+			while(!spi_is_idle(hspi) && tick > 0){
+				dly_tsk(1);
+				tick--;
+			}
+			if(tick == 0)
+				ercd = E_TMOUT;
+		}
 	}
 	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SER), 0x00000000);
 	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_DISABLE);
+	spi_xfer_done(hspi);
 
 	if(hspi->ErrorCode != 0)
 		ercd = E_OBJ;
-	else if(tick == 0)
-		ercd = E_TMOUT;
 	hspi->TxXferCount = 0;
 	hspi->RxXferCount = 0;
 	return ercd;
@@ -253,10 +628,10 @@ spi_inwait(SPI_Handle_t *hspi, uint32_t timeout)
 
 
 /*
- *  SPI
- *  parameter1  port: SPIݡֹ
- *  parameter2  spii: SPI깽¤ΤؤΥݥ
- *  return SPIϥɥؤΥݥ󥿡NULLǥ顼
+ *  SPI初期設定
+ *  parameter1  port: SPIポート番号
+ *  parameter2  spii: SPI初期設定構造体へのポインタ
+ *  return SPIハンドラへのポインタ、NULLでエラー
  */
 SPI_Handle_t *
 spi_init(ID port, const SPI_Init_t *init)
@@ -283,7 +658,7 @@ spi_init(ID port, const SPI_Init_t *init)
 		return NULL;
 
 	/*
-	 *  å
+	 *  クロック設定
 	 */
     if(spi_num == 3){
 		sil_orw_mem((uint32_t *)(TADR_SYSCTL_BASE+TOFF_CLK_SEL0), SYSCTL_CLK_SEL0_SPI3_CLK_SEL);
@@ -296,7 +671,7 @@ spi_init(ID port, const SPI_Init_t *init)
 	sil_andw_mem((uint32_t *)(TADR_SYSCTL_BASE+TOFF_SYSCTL_CLK_TH1), 0xFF << (spi_num*8));
 
 	/*
-	 *  ԥե󥯥
+	 *  ピンファンクション設定
 	 */
 	spcb = &spi_pcb[spi_num];
 	if(spcb->func_ss >= 0 && init->SsPin >= 0)
@@ -374,7 +749,7 @@ spi_init(ID port, const SPI_Init_t *init)
     if(sil_rew_mem((uint32_t *)(base+TOFF_SPI_BAUDR)) == 0)
 		sil_wrw_mem((uint32_t *)(base+TOFF_SPI_BAUDR), 0x14);
 	/*
-	 *  Ե
+	 *  割込み不許可
 	 */
 	sil_wrw_mem((uint32_t *)(base+TOFF_SPI_IMR), 0x00000000);
 
@@ -391,7 +766,7 @@ spi_init(ID port, const SPI_Init_t *init)
 	sil_wrw_mem((uint32_t *)(base+TOFF_SPI_ENDIAN), init->SignBit);
 
 	/*
-	 *  žå
+	 *  転送クロック設定
 	 */
 	clk_th1 = sil_rew_mem((uint32_t *)(TADR_SYSCTL_BASE+TOFF_SYSCTL_CLK_TH1));
 	threshold = (clk_th1 >> (spi_num * 8)) & 0xff;
@@ -407,7 +782,7 @@ spi_init(ID port, const SPI_Init_t *init)
 	sil_wrw_mem((uint32_t *)(base+TOFF_SPI_BAUDR), spi_baudr);
 
 	/*
-	 *  ϥɥ
+	 *  ハンドラ初期化
 	 */
 	hspi->base = base;
 	hspi->spi_num = spi_num;
@@ -417,6 +792,18 @@ spi_init(ID port, const SPI_Init_t *init)
 	hspi->tmod_offset = tmod_offset;
 	hspi->hdmatx = NULL;
 	hspi->hdmarx = NULL;
+	hspi->xfercallback = NULL;
+	hspi->localdata = NULL;
+	memset(&hspi->stat, 0, sizeof(SPI_Stat_t));
+	hspi->pio = SPI_PIO_NONE;
+	hspi->locked  = false;
+	hspi->waitq   = NULL;
+	hspi->clients = NULL;
+	memset(&hspi->async, 0, sizeof(SPI_Client_t));
+	memset(&hspi->temp, 0, sizeof(SPI_Client_t));
+	hspi->temp.priority = SPI_PRIORITY_DEFAULT;
+	hspi->tempwait = 0;
+	memset(&hspi->waitstat, 0, sizeof(SPI_WaitStat_t));
 	if(init->TxDMAChannel >= 0){
 		hdma = &spi_dma_handle[init->TxDMAChannel][0];
 		hdma->chnum = init->TxDMAChannel;
@@ -425,24 +812,24 @@ spi_init(ID port, const SPI_Init_t *init)
 		else
 			hdma->xfercallback      = spi_dma_comp;
 		hdma->errorcallback     = NULL;
-		hdma->Init.Request      = DMA_SELECT_SSI0_TX_REQ + spi_num * 2;	/* DMA */
-		hdma->Init.Direction    = DMA_MEMORY_TO_PERIPH;	/* DMAž */
-		hdma->Init.SrcMultBlock = DMAC_MULTBLOCK_CONT;	/* ޥ֥å */
-		hdma->Init.DrcMultBlock = DMAC_MULTBLOCK_CONT;	/* ǥƥ͡ޥ֥å */
-		hdma->Init.SrcHandShake = DMAC_HS_SOFTWARE;	/* ϥɥ */
-		hdma->Init.DrcHandShake = DMAC_HS_HARDWARE;	/* ǥƥ͡ϥɥ */
-		hdma->Init.SrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* ϡɥϥɥ */
-		hdma->Init.DrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* ǥƥ͡ϡɥϥɥ */
-		hdma->Init.Priority     = 4;	/* ͥ */
-		hdma->Init.SrcMaster    = DMAC_MASTER1;	/* ޥ */
-		hdma->Init.DstMaster    = DMAC_MASTER2;	/* ǥƥ͡ޥ */
-		hdma->Init.SrcInc       = DMAC_ADDR_INCREMENT;	/* 󥯥 */
-		hdma->Init.DstInc       = DMAC_ADDR_NOCHANGE;	/* ǥƥ͡󥤥󥯥 */
-		hdma->Init.SrcTransWidth = DMAC_TRANS_WIDTH_32;	/* ž */
-		hdma->Init.DstTransWidth = DMAC_TRANS_WIDTH_32;	/* ǥƥ͡ž */
-		hdma->Init.SrcBurstSize = DMAC_MSIZE_4;	/* Сȥ */
-		hdma->Init.DstBurstSize = DMAC_MSIZE_4;	/* ǥƥ͡Сȥ */
-		hdma->Init.IocBlkTrans  = 0;	/* IOC֥åž */
+		hdma->Init.Request      = DMA_SELECT_SSI0_TX_REQ + spi_num * 2;	/* DMA選択 */
+		hdma->Init.Direction    = DMA_MEMORY_TO_PERIPH;	/* DMA転送方向 */
+		hdma->Init.SrcMultBlock = DMAC_MULTBLOCK_CONT;	/* ソースマルチブロックタイプ */
+		hdma->Init.DrcMultBlock = DMAC_MULTBLOCK_CONT;	/* デスティネーションマルチブロックタイプ */
+		hdma->Init.SrcHandShake = DMAC_HS_SOFTWARE;	/* ソースハンドシェイク */
+		hdma->Init.DrcHandShake = DMAC_HS_HARDWARE;	/* デスティネーションハンドシェイク */
+		hdma->Init.SrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* ソースハードウェアハンドシェイク極性 */
+		hdma->Init.DrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* デスティネーションハードウェアハンドシェイク極性 */
+		hdma->Init.Priority     = 4;	/* 優先度 */
+		hdma->Init.SrcMaster    = DMAC_MASTER1;	/* ソースマスター設定 */
+		hdma->Init.DstMaster    = DMAC_MASTER2;	/* デスティネーションマスター設定 */
+		hdma->Init.SrcInc       = DMAC_ADDR_INCREMENT;	/* ソースインクリメント設定 */
+		hdma->Init.DstInc       = DMAC_ADDR_NOCHANGE;	/* デスティネーションインクリメント設定 */
+		hdma->Init.SrcTransWidth = DMAC_TRANS_WIDTH_32;	/* ソース転送幅 */
+		hdma->Init.DstTransWidth = DMAC_TRANS_WIDTH_32;	/* デスティネーション転送幅 */
+		hdma->Init.SrcBurstSize = DMAC_MSIZE_4;	/* ソースバーストサイズ */
+		hdma->Init.DstBurstSize = DMAC_MSIZE_4;	/* デスティネーションバーストサイズ */
+		hdma->Init.IocBlkTrans  = 0;	/* IOCブロック転送 */
 		hdma->localdata         = (void *)hspi;
 		dma_init(hdma);
 		hspi->hdmatx = hdma;
@@ -452,24 +839,24 @@ spi_init(ID port, const SPI_Init_t *init)
 		hdma->chnum = init->RxDMAChannel;
 		hdma->xfercallback      = spi_dma_comp;
 		hdma->errorcallback     = NULL;
-		hdma->Init.Request      = DMA_SELECT_SSI0_RX_REQ + spi_num * 2;	/* DMA */
-		hdma->Init.Direction    = DMA_PERIPH_TO_MEMORY;	/* DMAž */
-		hdma->Init.SrcMultBlock = DMAC_MULTBLOCK_CONT;	/* ޥ֥å */
-		hdma->Init.DrcMultBlock = DMAC_MULTBLOCK_CONT;	/* ǥƥ͡ޥ֥å */
-		hdma->Init.SrcHandShake = DMAC_HS_HARDWARE;	/* ϥɥ */
-		hdma->Init.DrcHandShake = DMAC_HS_SOFTWARE;	/* ǥƥ͡ϥɥ */
-		hdma->Init.SrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* ϡɥϥɥ */
-		hdma->Init.DrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* ǥƥ͡ϡɥϥɥ */
-		hdma->Init.Priority     = 4;	/* ͥ */
-		hdma->Init.SrcMaster    = DMAC_MASTER1;	/* ޥ */
-		hdma->Init.DstMaster    = DMAC_MASTER2;	/* ǥƥ͡ޥ */
-		hdma->Init.SrcInc       = DMAC_ADDR_NOCHANGE;	/* 󥯥 */
-		hdma->Init.DstInc       = DMAC_ADDR_INCREMENT;	/* ǥƥ͡󥤥󥯥 */
-		hdma->Init.SrcTransWidth = DMAC_TRANS_WIDTH_32;	/* ž */
-		hdma->Init.DstTransWidth = DMAC_TRANS_WIDTH_32;	/* ǥƥ͡ž */
-		hdma->Init.SrcBurstSize = DMAC_MSIZE_4;	/* Сȥ */
-		hdma->Init.DstBurstSize = DMAC_MSIZE_4;	/* ǥƥ͡Сȥ */
-		hdma->Init.IocBlkTrans  = 0;	/* IOC֥åž */
+		hdma->Init.Request      = DMA_SELECT_SSI0_RX_REQ + spi_num * 2;	/* DMA選択 */
+		hdma->Init.Direction    = DMA_PERIPH_TO_MEMORY;	/* DMA転送方向 */
+		hdma->Init.SrcMultBlock = DMAC_MULTBLOCK_CONT;	/* ソースマルチブロックタイプ */
+		hdma->Init.DrcMultBlock = DMAC_MULTBLOCK_CONT;	/* デスティネーションマルチブロックタイプ */
+		hdma->Init.SrcHandShake = DMAC_HS_HARDWARE;	/* ソースハンドシェイク */
+		hdma->Init.DrcHandShake = DMAC_HS_SOFTWARE;	/* デスティネーションハンドシェイク */
+		hdma->Init.SrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* ソースハードウェアハンドシェイク極性 */
+		hdma->Init.DrcHwhsPol   = DMAC_HWHS_POLARITY_LOW;	/* デスティネーションハードウェアハンドシェイク極性 */
+		hdma->Init.Priority     = 4;	/* 優先度 */
+		hdma->Init.SrcMaster    = DMAC_MASTER1;	/* ソースマスター設定 */
+		hdma->Init.DstMaster    = DMAC_MASTER2;	/* デスティネーションマスター設定 */
+		hdma->Init.SrcInc       = DMAC_ADDR_NOCHANGE;	/* ソースインクリメント設定 */
+		hdma->Init.DstInc       = DMAC_ADDR_INCREMENT;	/* デスティネーションインクリメント設定 */
+		hdma->Init.SrcTransWidth = DMAC_TRANS_WIDTH_32;	/* ソース転送幅 */
+		hdma->Init.DstTransWidth = DMAC_TRANS_WIDTH_32;	/* デスティネーション転送幅 */
+		hdma->Init.SrcBurstSize = DMAC_MSIZE_4;	/* ソースバーストサイズ */
+		hdma->Init.DstBurstSize = DMAC_MSIZE_4;	/* デスティネーションバーストサイズ */
+		hdma->Init.IocBlkTrans  = 0;	/* IOCブロック転送 */
 		hdma->localdata         = (void *)hspi;
 		dma_init(hdma);
 		hspi->hdmarx = hdma;
@@ -480,9 +867,9 @@ spi_init(ID port, const SPI_Init_t *init)
 }
 
 /*
- *  SPIλ
- *  parameter1  hspi: SPIϥɥؤΥݥ
- *  return ER
+ *  SPI終了設定
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  return ERコード
  */
 ER
 spi_deinit(SPI_Handle_t *hspi)
@@ -506,186 +893,614 @@ spi_deinit(SPI_Handle_t *hspi)
 }
 
 /*
- *  ݡ󥰥ǡ
+ *  PIO送信FIFO補充関数(データ幅・アライメント別)
  */
 static void
-spi_send_data_normal2(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buff, size_t tx_len)
+spi_pio_tx8(SPI_Handle_t *hspi, uint32_t count)
 {
-	size_t index, fifo_len;
-	uint8_t frame_width = get_framewidth(hspi->Init.DataSize);
-	uint8_t v_misalign_flag = 0;
-	uint32_t v_send_data;
-	uint32_t i = 0;
+	const uint8_t *p = hspi->pTxBuffPtr;
+
+	hspi->TxXferCount -= count;
+	while(count-- > 0)
+		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), *p++);
+	hspi->pTxBuffPtr = (uint8_t *)p;
+}
+
+static void
+spi_pio_tx16(SPI_Handle_t *hspi, uint32_t count)
+{
+	const uint16_t *p = (const uint16_t *)hspi->pTxBuffPtr;
+
+	hspi->TxXferCount -= count;
+	while(count-- > 0)
+		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), *p++);
+	hspi->pTxBuffPtr = (uint8_t *)p;
+}
+
+static void
+spi_pio_tx32(SPI_Handle_t *hspi, uint32_t count)
+{
+	const uint32_t *p = (const uint32_t *)hspi->pTxBuffPtr;
 
-	if((uintptr_t)tx_buff % frame_width){
-		v_misalign_flag = 1;
+	hspi->TxXferCount -= count;
+	while(count-- > 0)
+		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), *p++);
+	hspi->pTxBuffPtr = (uint8_t *)p;
+}
+
+static void
+spi_pio_tx_misalign(SPI_Handle_t *hspi, uint32_t count)
+{
+	uint8_t  width = get_framewidth(hspi->Init.DataSize);
+	uint32_t v_send_data = 0;
+
+	hspi->TxXferCount -= count;
+	while(count-- > 0){
+		memcpy(&v_send_data, hspi->pTxBuffPtr, width);
+		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), v_send_data);
+		hspi->pTxBuffPtr += width;
 	}
-	if(ss_no < 0)
-		ss_no = 0;
+}
 
-	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_ENABLE);
-	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SER), (1 << ss_no));
-	while(tx_len > 0){
-		fifo_len = 32 - sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_TXFLR));
-		fifo_len = fifo_len < tx_len ? fifo_len : tx_len;
-		switch(frame_width){
-		case SPI_TRANS_INT:
-			fifo_len = fifo_len / 4 * 4;
-			if(v_misalign_flag){
-				for(index = 0; index < fifo_len; index +=4){
-					memcpy(&v_send_data, tx_buff + i , 4);
-					sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), v_send_data);
-					i += 4;
-				}
-			}
-			else{
-				for(index = 0; index < fifo_len / 4; index++)
-					sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), ((uint32_t *)tx_buff)[i++]);
-			}
-			break;
-		case SPI_TRANS_SHORT:
-			fifo_len = fifo_len / 2 * 2;
-			if(v_misalign_flag){
-				for(index = 0; index < fifo_len; index +=2){
-					memcpy(&v_send_data, tx_buff + i, 2);
-					sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), v_send_data);
-					i += 2;
-				}
-			}
-			else{
-				for(index = 0; index < fifo_len / 2; index++)
-					sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), ((uint16_t *)tx_buff)[i++]);
-			}
-			break;
-		default:
-			for(index = 0; index < fifo_len; index++)
-				sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), tx_buff[i++]);
-			break;
- 		}
-		tx_len -= fifo_len;
+/*
+ *  PIO受信FIFO回収関数(データ幅別)、格納数を超えたフレームは破棄する
+ */
+static void
+spi_pio_rx8(SPI_Handle_t *hspi, uint32_t count)
+{
+	uint32_t data;
+
+	hspi->RxXferCount -= count;
+	while(count-- > 0){
+		data = sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_DR));
+		if(hspi->RxXferStore > 0){
+			*hspi->pRxBuffPtr++ = (uint8_t)data;
+			hspi->RxXferStore--;
+		}
+	}
+}
+
+static void
+spi_pio_rx16(SPI_Handle_t *hspi, uint32_t count)
+{
+	uint32_t data;
+
+	hspi->RxXferCount -= count;
+	while(count-- > 0){
+		data = sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_DR));
+		if(hspi->RxXferStore > 0){
+			*((uint16_t *)hspi->pRxBuffPtr) = (uint16_t)data;
+			hspi->pRxBuffPtr += 2;
+			hspi->RxXferStore--;
+		}
+	}
+}
+
+static void
+spi_pio_rx32(SPI_Handle_t *hspi, uint32_t count)
+{
+	uint32_t data;
+
+	hspi->RxXferCount -= count;
+	while(count-- > 0){
+		data = sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_DR));
+		if(hspi->RxXferStore > 0){
+			*((uint32_t *)hspi->pRxBuffPtr) = data;
+			hspi->pRxBuffPtr += 4;
+			hspi->RxXferStore--;
+		}
 	}
 }
 
 /*
- *  ݡ󥰥ǡ
+ *  PIO転送の1ステップ(割込み/ポーリング共通)
+ *  受信済みフレームを回収し、FIFOの空きに収まるだけ送信フレームを補充する．
+ *  return      trueで全フレームの転送終了(送信のみはシフトアウト終了まで含む)
+ */
+static bool_t
+spi_pio_step(SPI_Handle_t *hspi)
+{
+	uint32_t n, room;
+
+	if(hspi->pio == SPI_PIO_TXRX){
+		n = sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_RXFLR));
+		if(n > hspi->RxXferCount)
+			n = hspi->RxXferCount;
+		if(n > 0)
+			hspi->pio_rx(hspi, n);
+		/* 受信FIFOがあふれないよう未回収フレームをFIFO段数以下に保つ */
+		room = SPI_FIFO_DEPTH - (hspi->RxXferCount - hspi->TxXferCount);
+	}
+	else
+		room = SPI_FIFO_DEPTH - sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_TXFLR));
+	n = hspi->TxXferCount < room ? hspi->TxXferCount : room;
+	if(n > 0)
+		hspi->pio_tx(hspi, n);
+	if(hspi->pio == SPI_PIO_TXRX)
+		return hspi->RxXferCount == 0;
+	/* 送信のみはFIFOが空になり最終フレームのシフトアウトが終わるまで終了としない */
+	if(hspi->TxXferCount != 0 || sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_TXFLR)) != 0)
+		return false;
+	return spi_spin_idle(hspi);
+}
+
+/*
+ *  PIO転送の割込み許可
+ *  送信のみは送信FIFO空き、送受信は受信FIFOしきい値で割込みを発生させる
  */
 static void
-spi_send_recv_data_normal2(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buff, size_t tx_len, uint8_t *rx_buff, size_t rx_len)
+spi_pio_arm(SPI_Handle_t *hspi)
+{
+	uint32_t level;
+
+	if(hspi->pio == SPI_PIO_TXRX){
+		level = hspi->RxXferCount < SPI_PIO_RX_LEVEL ? hspi->RxXferCount : SPI_PIO_RX_LEVEL;
+		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_RXFTLR), level - 1);
+		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_IMR), SPI_IMR_RXF);
+	}
+	else{
+		/* 全フレームをFIFOに入れた後はFIFOが空になった時点で割込む */
+		level = hspi->TxXferCount == 0 ? 0 : SPI_PIO_TX_LEVEL;
+		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_TXFTLR), level);
+		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_IMR), SPI_IMR_TXE);
+	}
+}
+
+/*
+ *  PIO転送実行
+ *  FIFOを満たした後、残りフレームはspi_handlerが割込みで補充/回収し、
+ *  タスクは終了通知を待つ．転送セマフォがない場合はポーリングで行う．
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  ss_no: SS番号
+ *  parameter3  tx_buff: 送信バッファへのポインタ
+ *  parameter4  frames: 送信フレーム数
+ *  parameter5  rx_buff: 受信バッファへのポインタ(NULLで送信のみ)
+ *  parameter6  rx_frames: 受信格納フレーム数
+ *  return      ERコード
+ */
+static ER
+spi_pio_xfer(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buff, uint32_t frames, uint8_t *rx_buff, uint32_t rx_frames)
 {
-	size_t index, fifo_len;
 	uint8_t frame_width = get_framewidth(hspi->Init.DataSize);
-	uint32_t i = 0;
+	ER      ercd = E_OK;
+	SIL_PRE_LOC;
 
 	if(ss_no < 0)
 		ss_no = 0;
+	if(frames == 0)
+		return E_OK;
+
+	if((uintptr_t)tx_buff % frame_width)
+		hspi->pio_tx = spi_pio_tx_misalign;
+	else if(frame_width == SPI_TRANS_INT)
+		hspi->pio_tx = spi_pio_tx32;
+	else if(frame_width == SPI_TRANS_SHORT)
+		hspi->pio_tx = spi_pio_tx16;
+	else
+		hspi->pio_tx = spi_pio_tx8;
+	if(frame_width == SPI_TRANS_INT)
+		hspi->pio_rx = spi_pio_rx32;
+	else if(frame_width == SPI_TRANS_SHORT)
+		hspi->pio_rx = spi_pio_rx16;
+	else
+		hspi->pio_rx = spi_pio_rx8;
+	hspi->pTxBuffPtr  = (uint8_t *)tx_buff;
+	hspi->TxXferSize  = frames;
+	hspi->TxXferCount = frames;
+	hspi->pRxBuffPtr  = rx_buff;
+	hspi->RxXferSize  = rx_frames;
+	if(rx_buff != NULL){
+		hspi->RxXferCount = frames;
+		hspi->RxXferStore = rx_frames < frames ? rx_frames : frames;
+		hspi->pio = SPI_PIO_TXRX;
+	}
+	else{
+		hspi->RxXferCount = 0;
+		hspi->RxXferStore = 0;
+		hspi->pio = SPI_PIO_TX;
+	}
 
-	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_CTRLR1), (uint32_t)(tx_len / frame_width - 1));
-//	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_CTRLR1), (uint32_t)(rx_len / frame_width - 1));
 	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_ENABLE);
 	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SER), (1 << ss_no));
-	while(tx_len > 0){
-		fifo_len = 32 - sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_TXFLR));
-		fifo_len = fifo_len < tx_len ? fifo_len : tx_len;
-		switch(frame_width){
-		case SPI_TRANS_INT:
-			fifo_len = fifo_len / 4 * 4;
-			for(index = 0; index < fifo_len / 4; index++)
-				sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), ((uint32_t *)tx_buff)[i++]);
-			break;
-		case SPI_TRANS_SHORT:
-			fifo_len = fifo_len / 2 * 2;
-			for(index = 0; index < fifo_len / 2; index++)
-				sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), ((uint16_t *)tx_buff)[i++]);
-			break;
-		default:
-			for(index = 0; index < fifo_len; index++)
-				sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), tx_buff[i++]);
-			break;
- 		}
-		tx_len -= fifo_len;
-	}
-
-    while ((sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_SR)) & 0x05) != 0x04)
-        ;
-//	if (tx_len == 0)
-//	{
-		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_CTRLR1), (uint32_t)(rx_len / frame_width - 1));
-//		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), 0xffffffff);
-		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SER), (1 << ss_no));
-//	}
-    i = 0;
-	while(rx_len > 0){
-		fifo_len = 32 - sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_RXFLR));
-		fifo_len = fifo_len < rx_len ? fifo_len : rx_len;
-		switch(frame_width){
-		case SPI_TRANS_INT:
-			fifo_len = fifo_len / 4 * 4;
-			for(index = 0; index < fifo_len / 4; index++)
-				((uint32_t *)rx_buff)[i++] = sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_DR));
-			break;
-		case SPI_TRANS_SHORT:
-			fifo_len = fifo_len / 2 * 2;
-			for(index = 0; index < fifo_len / 2; index++)
-				((uint16_t *)rx_buff)[i++] = (uint16_t)sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_DR));
-			break;
-		default:
-			for(index = 0; index < fifo_len; index++)
-				rx_buff[i++] = (uint8_t)sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_DR));
-			break;
- 		}
-		rx_len -= fifo_len;
+	if(!spi_pio_step(hspi)){
+		if(hspi->Init.semid != 0){
+			while(pol_sem(hspi->Init.semid) == E_OK)
+				;
+			spi_pio_arm(hspi);
+			ercd = twai_sem(hspi->Init.semid, SPI_PIO_TIMEOUT + frames);
+		}
+		else{
+			while(!spi_pio_step(hspi))
+				;
+		}
 	}
+	SIL_LOC_INT();
+	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_IMR), 0);
+	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_TXFTLR), 0);
+	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_RXFTLR), 0);
+	hspi->pio = SPI_PIO_NONE;
+	SIL_UNL_INT();
+	if(ercd != E_OK)
+		hspi->ErrorCode |= SPI_ERROR_TIMEOUT;
+	return ercd;
 }
 
 /*
- *  SPI¹Դؿ
- *  parameter1  hspi: SPIϥɥؤΥݥ
- *  parameter2  ss_no: SSֹ
- *  parameter3  pdata: ХåեؤΥݥ
- *  parameter4  length: 
- *  return ER
+ *  PIO転送の割込み処理
+ */
+static void
+spi_pio_handler(SPI_Handle_t *hspi)
+{
+	if(spi_pio_step(hspi)){
+		hspi->pio = SPI_PIO_NONE;
+		if(hspi->Init.semid != 0)
+			isig_sem(hspi->Init.semid);
+	}
+	else
+		spi_pio_arm(hspi);
+}
+
+/*
+ *  PIOデータ送信
+ */
+static void
+spi_send_data_normal2(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buff, size_t tx_len)
+{
+	spi_pio_xfer(hspi, ss_no, tx_buff, tx_len / get_framewidth(hspi->Init.DataSize), NULL, 0);
+}
+
+/*
+ *  PIOデータ送信受信
+ *  送信と同時に受信したフレームの先頭rx_lenバイト分を格納する
+ */
+static void
+spi_send_recv_data_normal2(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buff, size_t tx_len, uint8_t *rx_buff, size_t rx_len)
+{
+	uint8_t frame_width = get_framewidth(hspi->Init.DataSize);
+
+	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_CTRLR1), (uint32_t)(tx_len / frame_width - 1));
+	if(rx_len == 0)
+		rx_buff = NULL;
+	spi_pio_xfer(hspi, ss_no, tx_buff, tx_len / frame_width, rx_buff, rx_len / frame_width);
+}
+
+/*
+ *  SPI送信実行関数
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  ss_no: SS番号
+ *  parameter3  pdata: 送信バッファへのポインタ
+ *  parameter4  length: 送信サイズ
+ *  return ERコード
  */
 ER
 spi_core_transmit(SPI_Handle_t *hspi, int8_t ss_no, uint8_t *pdata, uint16_t length)
 {
+	SPI_Client_t *client;
 	DMA_Handle_t *hdma;
+	uint32_t n;
+#if SPI_WAIT_TIME != 0
+	uint32_t total = length;
+#endif
 	ER ercd = E_OK;
 
 	if(hspi == NULL)
 		return E_PAR;
 
-	if(hspi->Init.semlock != 0)
-		wai_sem(hspi->Init.semlock);
+	client = spi_lock(hspi);
 	hspi->xmode = SPI_XMODE_TX;
     spi_set_tmod(hspi, SPI_TMOD_TRANS);
+	SPI_TRACE_BEGIN(hspi, ss_no, SPI_TMOD_TRANS, 0, 0);
 	if(hspi->hdmatx != NULL){
-		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DMACR), SPI_DMACR_TXENABLE);
-		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_ENABLE);
-		hdma = spi_dmac_set_single_mode(hspi, 0, ss_no, (const void *)pdata, 
-							(void *)(hspi->base+TOFF_SPI_DR), DMAC_ADDR_INCREMENT, DMAC_ADDR_NOCHANGE,
-							DMAC_MSIZE_4, DMAC_TRANS_WIDTH_32, length);
-		spi_dmac_wait_done(hdma);
+		for(;;){
+			n = spi_chunk_length(client, length);
+			SPI_TRACE_ADD(hspi, n * get_framewidth(hspi->Init.DataSize), SPI_TRACE_DMA);
+			sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DMACR), SPI_DMACR_TXENABLE);
+			sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_ENABLE);
+			hdma = spi_dmac_set_single_mode(hspi, 0, ss_no, (const void *)pdata, 
+								(void *)(hspi->base+TOFF_SPI_DR), DMAC_ADDR_INCREMENT, DMAC_ADDR_NOCHANGE,
+								DMAC_MSIZE_4, DMAC_TRANS_WIDTH_32, n);
+			spi_dmac_wait_done(hdma);
+			pdata  += n * sizeof(uint32_t);
+			length -= n;
+			if(length == 0)
+				break;
+			if(!spi_contended(hspi))
+				continue;
+			/*
+			 *  分割の切れ目で高優先の待ちにバスを譲り、再獲得後に続きを送る
+			 */
+			SPI_TRACE_ADD(hspi, 0, SPI_TRACE_YIELD);
+			if((ercd = spi_inwait(hspi, SPI_YIELD_TIMEOUT)) != E_OK)
+				break;
+			client->stat.yields++;
+			hspi->waitstat.yields++;
+			spi_unlock(hspi);
+			spi_lock(hspi);
+			hspi->xmode = SPI_XMODE_TX;
+			spi_set_tmod(hspi, SPI_TMOD_TRANS);
+			SPI_TRACE_BEGIN(hspi, ss_no, SPI_TMOD_TRANS, 0, 0);
+		}
 	}
 	else{
+		SPI_TRACE_ADD(hspi, length, SPI_TRACE_PIO);
 		spi_send_data_normal2(hspi, ss_no, (const void *)pdata, length);
 	}
 
 #if SPI_WAIT_TIME != 0
-	ercd = spi_inwait(hspi, SPI_WAIT_TIME * length);
+	/* 分割送信でlengthは0まで減るため、待ち時間は全体のフレーム数で求める */
+	if(ercd == E_OK)
+		ercd = spi_inwait(hspi, SPI_WAIT_TIME * total);
 
-	if(hspi->Init.semlock != 0)
-		sig_sem(hspi->Init.semlock);
+	spi_unlock(hspi);
 #endif
 	return ercd;
 }
 
 /*
- *  SPIե¹Դؿ
- *  parameter1  hspi: SPIϥɥؤΥݥ
- *  parameter2  ss_no: SSֹ
- *  parameter3  pdata: ХåեؤΥݥ
- *  parameter4  length: 
- *  return ER
+ *  非同期送信の次の分割を開始(タスク/割込みコンテキスト共通)
+ *  他の利用者が設定を変えている場合があるため、フレーム設定を復元してから送る
+ */
+static void
+spi_async_next(SPI_Handle_t *hspi)
+{
+	uint32_t n = spi_chunk_length(&hspi->async, hspi->TxXferCount);
+	const uint8_t *pdata = hspi->pTxBuffPtr;
+
+	hspi->pTxBuffPtr  += n * sizeof(uint32_t);
+	hspi->TxXferCount -= n;
+	hspi->xmode = SPI_XMODE_TX_ASYNC;
+	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_DISABLE);
+	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_CTRLR0), hspi->async_ctrl[0]);
+	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SPI_CTRLR0), hspi->async_ctrl[1]);
+	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DMACR), SPI_DMACR_TXENABLE);
+	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_ENABLE);
+	spi_dmac_set_single_mode(hspi, 0, hspi->async_ss, pdata,
+						(void *)(hspi->base+TOFF_SPI_DR), DMAC_ADDR_INCREMENT, DMAC_ADDR_NOCHANGE,
+						DMAC_MSIZE_4, DMAC_TRANS_WIDTH_32, n);
+}
+
+/*
+ *  譲ったバスの再獲得時に呼び出される非同期送信の再開関数
+ */
+static void
+spi_async_resume(SPI_Handle_t *hspi)
+{
+	SYSUTM now;
+
+	get_utm(&now);
+	spi_wait_stat(&hspi->async.stat, (uint32_t)(now - hspi->async.request), true);
+	spi_async_next(hspi);
+}
+
+/*
+ *  SPI非同期送信実行関数
+ *  DMA転送を開始して戻る．転送終了は割込みで処理し、hspi->xfercallbackが
+ *  設定されていれば割込みコンテキストで呼び出す．終了までバスを保持するが、
+ *  spi_client_attachで分割フレーム数を指定したタスクからの送信は分割して送り、
+ *  分割の切れ目で高優先の待ちがあればバスを譲って解放後に再開する．
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  ss_no: SS番号
+ *  parameter3  pdata: 送信バッファへのポインタ(終了まで保持すること)
+ *  parameter4  length: 送信サイズ
+ *  return ERコード
+ */
+ER
+spi_core_transmit_async(SPI_Handle_t *hspi, int8_t ss_no, const void *pdata, uint16_t length)
+{
+	SPI_Client_t *client;
+
+	if(hspi == NULL || length == 0)
+		return E_PAR;
+	if(hspi->hdmatx == NULL || hspi->hdmatx->xfercallback == NULL)
+		return E_NOSPT;
+
+	client = spi_lock(hspi);
+	hspi->ErrorCode   = SPI_ERROR_NONE;
+	hspi->pTxBuffPtr  = (uint8_t *)pdata;
+	hspi->TxXferSize  = length;
+	hspi->TxXferCount = length;
+	hspi->async_ss    = ss_no;
+	hspi->async.priority = (client != NULL) ? client->priority : SPI_PRIORITY_DEFAULT;
+	hspi->async.chunk    = (client != NULL) ? client->chunk : 0;
+	hspi->status = SPI_STATUS_BUSY;
+	spi_set_tmod(hspi, SPI_TMOD_TRANS);
+	SPI_TRACE_BEGIN(hspi, ss_no, SPI_TMOD_TRANS, length * get_framewidth(hspi->Init.DataSize), SPI_TRACE_DMA | SPI_TRACE_ASYNC);
+	hspi->async_ctrl[0] = sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_CTRLR0));
+	hspi->async_ctrl[1] = sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_SPI_CTRLR0));
+	spi_async_next(hspi);
+	return E_OK;
+}
+
+/*
+ *  SPI非同期送信終了待ち
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  timeout: タイムアウト時間(ms)
+ *  return ERコード
+ */
+ER
+spi_core_transmit_wait(SPI_Handle_t *hspi, uint32_t timeout)
+{
+	int tick = timeout;
+
+	if(hspi == NULL)
+		return E_PAR;
+
+	/* 同期転送の終了通知を横取りしないよう、semidは使わずstatusをポーリングする */
+	while(hspi->status == SPI_STATUS_BUSY && tick > 0){
+		dly_tsk(1);
+		tick--;
+	}
+	if(hspi->status == SPI_STATUS_BUSY)
+		return E_TMOUT;
+	else if(hspi->ErrorCode != 0)
+		return E_OBJ;
+	else
+		return E_OK;
+}
+
+/*
+ *  SPI非同期送信終了処理(割込みコンテキスト)
+ *  return trueで終了
+ */
+static bool_t
+spi_async_end(SPI_Handle_t *hspi)
+{
+	SIL_PRE_LOC;
+
+	if(!spi_spin_idle(hspi)){
+		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_IMR), 0x0011);
+		return false;
+	}
+	dma_end(hspi->hdmatx);
+	if(hspi->hdmatx->ErrorCode != 0)
+		hspi->ErrorCode |= SPI_ERROR_DMA;
+	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SER), 0x00000000);
+	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_DISABLE);
+	if(hspi->TxXferCount > 0 && hspi->ErrorCode == SPI_ERROR_NONE){
+		if(!spi_contended(hspi)){
+			spi_async_next(hspi);
+			return false;
+		}
+		/*
+		 *  高優先の待ちにバスを譲り、再開待ちとして待ち行列に入る
+		 */
+		hspi->xmode = SPI_XMODE_TX;
+		hspi->async.resume = spi_async_resume;
+		hspi->async.stat.yields++;
+		hspi->waitstat.yields++;
+		get_utm(&hspi->async.request);
+		SIL_LOC_INT();
+		spi_enqueue(hspi, &hspi->async);
+		SIL_UNL_INT();
+		spi_iunlock(hspi);
+		return false;
+	}
+	hspi->TxXferCount = 0;
+	spi_xfer_done(hspi);
+	hspi->status = SPI_STATUS_READY;
+	hspi->xmode  = SPI_XMODE_TX;
+	if(hspi->xfercallback != NULL)
+		hspi->xfercallback(hspi);
+	spi_iunlock(hspi);
+	return true;
+}
+
+/*
+ *  記述子リスト送信のアイドル待ち
+ */
+static ER
+spi_list_idle(SPI_Handle_t *hspi)
+{
+	int i;
+
+	for(i = 0 ; !spi_is_idle(hspi) ; i++){
+		if(i >= SPI_LIST_SPIN)
+			return E_TMOUT;
+	}
+	return E_OK;
+}
+
+/*
+ *  SPI記述子リスト送信実行関数
+ *  コマンド/アドレス/データのセグメントを、ロック・転送終了待ちを共有して
+ *  連続送信する．フレーム設定はセグメント間で変化した場合のみ再設定し、
+ *  SPI_LIST_PIO_FRAMES以下のセグメントはDMAを使わずFIFOに直接書き込む．
+ *  SPI_SEG_FILLのセグメントは先頭フレームをアドレス固定のDMAで繰り返し送る．
+ *  DCXはセグメント直前のシフトアウト終了後に切り替える．
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  ss_no: SS番号
+ *  parameter3  dcx_no: DCXのGPIOHS番号(-1で未使用)
+ *  parameter4  seg: セグメント配列へのポインタ
+ *  parameter5  num: セグメント数
+ *  return ERコード
+ */
+ER
+spi_core_transmit_list(SPI_Handle_t *hspi, int8_t ss_no, int8_t dcx_no, const SPI_Segment_t *seg, uint16_t num)
+{
+	DMA_Handle_t *hdma;
+	SPI_Init_t   save;
+	SYSUTM       start;
+	uint32_t     dsize = 0, inst = 0, addr = 0;
+	uint16_t     i, j;
+	ER           ercd = E_OK;
+
+	if(hspi == NULL || seg == NULL || num == 0)
+		return E_PAR;
+	if(seg[0].DataSize == 0)
+		return E_PAR;
+	if(ss_no < 0)
+		ss_no = 0;
+
+	spi_lock(hspi);
+	get_utm(&start);
+	save = hspi->Init;
+	hspi->xmode = SPI_XMODE_TX;
+	SPI_TRACE_BEGIN(hspi, ss_no, SPI_TMOD_TRANS, 0, SPI_TRACE_LIST);
+	for(i = 0 ; i < num && ercd == E_OK ; i++, seg++){
+		if(seg->length == 0)
+			continue;
+		if(seg->DataSize != 0 && (seg->DataSize != dsize || seg->InstLength != inst || seg->AddrLength != addr)){
+			dsize = seg->DataSize;
+			inst  = seg->InstLength;
+			addr  = seg->AddrLength;
+			hspi->Init.DataSize   = dsize;
+			hspi->Init.InstLength = inst;
+			hspi->Init.AddrLength = addr;
+			sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_DISABLE);
+			if((ercd = spi_set_tmod(hspi, SPI_TMOD_TRANS)) != E_OK)
+				break;
+		}
+		if(seg->dcx >= 0 && dcx_no >= 0)
+			gpio_set_pin(TADR_GPIOHS_BASE, dcx_no, seg->dcx);
+		SPI_TRACE_ADD(hspi, seg->length * get_framewidth(dsize), 0);
+		if(seg->length <= SPI_LIST_PIO_FRAMES || hspi->hdmatx == NULL){
+			SPI_TRACE_ADD(hspi, 0, SPI_TRACE_PIO);
+			sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DMACR), 0);
+			sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_ENABLE);
+			sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SER), (1 << ss_no));
+			for(j = 0 ; j < seg->length ; j++){
+				while(sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_TXFLR)) >= 32) ;
+				sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DR), seg->pdata[(seg->flags & SPI_SEG_FILL) ? 0 : j]);
+			}
+		}
+		else if((seg->flags & SPI_SEG_FILL) != 0){
+			SPI_TRACE_ADD(hspi, 0, SPI_TRACE_DMA);
+			sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DMACR), SPI_DMACR_TXENABLE);
+			sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_ENABLE);
+			hdma = spi_dmac_set_single_mode(hspi, 0, ss_no, seg->pdata,
+							(void *)(hspi->base+TOFF_SPI_DR), DMAC_ADDR_NOCHANGE, DMAC_ADDR_NOCHANGE,
+							DMAC_MSIZE_1, DMAC_TRANS_WIDTH_32, seg->length);
+			ercd = spi_dmac_wait_done(hdma);
+		}
+		else{
+			SPI_TRACE_ADD(hspi, 0, SPI_TRACE_DMA);
+			sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DMACR), SPI_DMACR_TXENABLE);
+			sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_ENABLE);
+			hdma = spi_dmac_set_single_mode(hspi, 0, ss_no, seg->pdata,
+							(void *)(hspi->base+TOFF_SPI_DR), DMAC_ADDR_INCREMENT, DMAC_ADDR_NOCHANGE,
+							DMAC_MSIZE_4, DMAC_TRANS_WIDTH_32, seg->length);
+			ercd = spi_dmac_wait_done(hdma);
+		}
+		if(ercd == E_OK)
+			ercd = spi_list_idle(hspi);
+		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SER), 0x00000000);
+	}
+	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_DISABLE);
+	hspi->Init  = save;
+	hspi->start = start;
+	spi_xfer_done(hspi);
+
+	spi_unlock(hspi);
+	return ercd;
+}
+
+/*
+ *  SPIフィル送信実行関数
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  ss_no: SS番号
+ *  parameter3  pdata: 送信バッファへのポインタ
+ *  parameter4  length: 送信サイズ
+ *  return ERコード
  */
 ER
 spi_core_transmit_fill(SPI_Handle_t *hspi, int8_t ss_no, const uint32_t *tx_buff, size_t tx_len)
@@ -696,11 +1511,11 @@ spi_core_transmit_fill(SPI_Handle_t *hspi, int8_t ss_no, const uint32_t *tx_buff
 	if(hspi == NULL)
 		return E_PAR;
 
-	if(hspi->Init.semlock != 0)
-		wai_sem(hspi->Init.semlock);
+	spi_lock(hspi);
 
 	hspi->xmode = SPI_XMODE_TX;
 	spi_set_tmod(hspi, SPI_TMOD_TRANS);
+	SPI_TRACE_BEGIN(hspi, ss_no, SPI_TMOD_TRANS, tx_len * get_framewidth(hspi->Init.DataSize), SPI_TRACE_DMA);
 	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DMACR), SPI_DMACR_TXENABLE);
 	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_SSIENR), SPI_SSIENR_ENABLE);
 
@@ -711,19 +1526,18 @@ spi_core_transmit_fill(SPI_Handle_t *hspi, int8_t ss_no, const uint32_t *tx_buff
 #if SPI_WAIT_TIME != 0
 	ercd = spi_inwait(hspi, SPI_WAIT_TIME * tx_len);
 
-	if(hspi->Init.semlock != 0)
-		sig_sem(hspi->Init.semlock);
+	spi_unlock(hspi);
 #endif
 	return ercd;
 }
 
 /*
- *  SPI¹Դؿ
- *  parameter1  hspi: SPIϥɥؤΥݥ
- *  parameter2  ss_no: SSֹ
- *  parameter3  pdata: ХåեؤΥݥ
- *  parameter4  length: 
- *  return ER
+ *  SPI受信実行関数
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  ss_no: SS番号
+ *  parameter3  pdata: 受信バッファへのポインタ
+ *  parameter4  length: 受信サイズ
+ *  return ERコード
  */
 ER
 spi_core_receive(SPI_Handle_t *hspi, int8_t ss_no, void *rx_buff, size_t rx_len)
@@ -734,11 +1548,11 @@ spi_core_receive(SPI_Handle_t *hspi, int8_t ss_no, void *rx_buff, size_t rx_len)
 	if(hspi == NULL || hspi->spi_num == 2)
 		return E_PAR;
 
-	if(hspi->Init.semlock != 0)
-		wai_sem(hspi->Init.semlock);
+	spi_lock(hspi);
 
 	hspi->xmode = SPI_XMODE_RX;
 	spi_set_tmod(hspi, SPI_TMOD_RECV);
+	SPI_TRACE_BEGIN(hspi, ss_no, SPI_TMOD_RECV, rx_len * get_framewidth(hspi->Init.DataSize), SPI_TRACE_DMA);
 
 	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_CTRLR1), (rx_len - 1));
 	sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_DMACR), SPI_DMACR_RXENABLE);
@@ -756,20 +1570,19 @@ spi_core_receive(SPI_Handle_t *hspi, int8_t ss_no, void *rx_buff, size_t rx_len)
 #if SPI_WAIT_TIME != 0
 	ercd = spi_inwait(hspi, SPI_WAIT_TIME * rx_len);
 
-	if(hspi->Init.semlock != 0)
-		sig_sem(hspi->Init.semlock);
+	spi_unlock(hspi);
 #endif
 	return ercd;
 }
 
 /*
- *  SPI¹Դؿ
- *  parameter1  hspi: SPIϥɥؤΥݥ
- *  parameter2  ss_no: SSֹ
- *  parameter3  ptxdata: ХåեؤΥݥ
- *  parameter4  prxdata: ХåեؤΥݥ
- *  parameter5  length: 
- *  return ER
+ *  SPI送受信実行関数
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  ss_no: SS番号
+ *  parameter3  ptxdata: 送信バッファへのポインタ
+ *  parameter4  prxdata: 受信バッファへのポインタ
+ *  parameter5  length: 送受信サイズ
+ *  return ERコード
  */
 ER
 spi_core_transrecv(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buf, uint8_t *rx_buf, size_t len)
@@ -782,11 +1595,12 @@ spi_core_transrecv(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buf, uint
 	if(hspi == NULL)
 		return E_PAR;
 
-	if(hspi->Init.semlock != 0)
-		wai_sem(hspi->Init.semlock);
+	spi_lock(hspi);
 
 	hspi->xmode = SPI_XMODE_TXRX;
     spi_set_tmod(hspi, SPI_TMOD_TRANS_RECV);
+	SPI_TRACE_BEGIN(hspi, ss_no, SPI_TMOD_TRANS_RECV, len,
+					(hspi->hdmatx != NULL) ? SPI_TRACE_DMA : (SPI_TRACE_DMA | SPI_TRACE_PIO));
 
 
 	if(hspi->hdmatx != NULL){
@@ -816,21 +1630,20 @@ spi_core_transrecv(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buf, uint
 #if SPI_WAIT_TIME != 0
 	ercd = spi_inwait(hspi, SPI_WAIT_TIME * len);
 
-	if(hspi->Init.semlock != 0)
-		sig_sem(hspi->Init.semlock);
+	spi_unlock(hspi);
 #endif
 	return ercd;
 }
 
 /*
- *  SPI¹Դؿ
- *  parameter1  hspi: SPIϥɥؤΥݥ
- *  parameter2  ss_no: SSֹ
- *  parameter3  tx_buf: ХåեؤΥݥ
- *  parameter4  tx_len: 
- *  parameter5  rx_buf: ХåեؤΥݥ
- *  parameter6  rx_len: 
- *  return ER
+ *  SPI送受信実行関数
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  ss_no: SS番号
+ *  parameter3  tx_buf: 送信バッファへのポインタ
+ *  parameter4  tx_len: 送信サイズ
+ *  parameter5  rx_buf: 受信バッファへのポインタ
+ *  parameter6  rx_len: 受信サイズ
+ *  return ERコード
  */
 ER
 spi_eerom_transrecv(SPI_Handle_t *hspi, int8_t ss_no, uint8_t *tx_buf, size_t tx_len, uint8_t *rx_buf, size_t rx_len)
@@ -844,11 +1657,12 @@ spi_eerom_transrecv(SPI_Handle_t *hspi, int8_t ss_no, uint8_t *tx_buf, size_t tx
 	if(hspi == NULL)
 		return E_PAR;
 
-	if(hspi->Init.semlock != 0)
-		wai_sem(hspi->Init.semlock);
+	spi_lock(hspi);
 
 	hspi->xmode = SPI_XMODE_TXRX;
     spi_set_tmod(hspi, SPI_TMOD_EEROM);
+	SPI_TRACE_BEGIN(hspi, ss_no, SPI_TMOD_EEROM, tx_len + rx_len,
+					(hspi->hdmatx != NULL) ? SPI_TRACE_DMA : (SPI_TRACE_DMA | SPI_TRACE_PIO));
 
 
 	if(hspi->hdmatx != NULL){
@@ -879,21 +1693,20 @@ spi_eerom_transrecv(SPI_Handle_t *hspi, int8_t ss_no, uint8_t *tx_buf, size_t tx
 #if SPI_WAIT_TIME != 0
 	ercd = spi_inwait(hspi, SPI_WAIT_TIME * (tx_len + rx_len));
 
-	if(hspi->Init.semlock != 0)
-		sig_sem(hspi->Init.semlock);
+	spi_unlock(hspi);
 #endif
 	return ercd;
 }
 
 /*
- *  SPI¹Դؿ
- *  parameter1  hspi: SPIϥɥؤΥݥ
- *  parameter2  ss_no: SSֹ
- *  parameter3  tx_buf: ХåեؤΥݥ
- *  parameter4  tx_len: 
- *  parameter5  rx_buf: ХåեؤΥݥ
- *  parameter6  rx_len: 
- *  return ER
+ *  SPI送受信実行関数
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  ss_no: SS番号
+ *  parameter3  tx_buf: 送信バッファへのポインタ
+ *  parameter4  tx_len: 送信サイズ
+ *  parameter5  rx_buf: 受信バッファへのポインタ
+ *  parameter6  rx_len: 受信サイズ
+ *  return ERコード
  */
 ER
 spi_esp32_transrecv(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buf, size_t tx_len, uint8_t *rx_buf, size_t rx_len)
@@ -903,11 +1716,11 @@ spi_esp32_transrecv(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buf, siz
 	if(hspi == NULL)
 		return E_PAR;
 
-	if(hspi->Init.semlock != 0)
-		wai_sem(hspi->Init.semlock);
+	spi_lock(hspi);
 
 	hspi->xmode = SPI_XMODE_TXRX;
     spi_set_tmod(hspi, SPI_TMOD_TRANS_RECV);
+	SPI_TRACE_BEGIN(hspi, 0, SPI_TMOD_TRANS_RECV, tx_len, SPI_TRACE_PIO);
 
 	spi_send_recv_data_normal2(hspi, 0, (const void *)tx_buf, tx_len, rx_buf, rx_len);
 
@@ -917,14 +1730,13 @@ spi_esp32_transrecv(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buf, siz
 #if SPI_WAIT_TIME != 0
 	ercd = spi_inwait(hspi, SPI_WAIT_TIME * (tx_len + rx_len));
 
-	if(hspi->Init.semlock != 0)
-		sig_sem(hspi->Init.semlock);
+	spi_unlock(hspi);
 #endif
 	return ercd;
 }
 
 /*
- *  SPIžλԤ
+ *  SPI転送終了待ち
  */
 ER
 spi_wait(SPI_Handle_t *hspi, uint32_t timeout)
@@ -935,15 +1747,214 @@ spi_wait(SPI_Handle_t *hspi, uint32_t timeout)
 	if(hspi == NULL)
 		return E_PAR;
 	ercd = spi_inwait(hspi, timeout);
-	if(hspi->Init.semlock != 0)
-		sig_sem(hspi->Init.semlock);
+	spi_unlock(hspi);
+#endif
+	return ercd;
+}
+
+/*
+ *  SPI転送統計の取得
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  pstat: 統計の格納先
+ *  parameter3  clear: trueで取得後にクリア
+ *  return ERコード
+ */
+ER
+spi_get_stat(SPI_Handle_t *hspi, SPI_Stat_t *pstat, bool_t clear)
+{
+	SIL_PRE_LOC;
+
+	if(hspi == NULL || pstat == NULL)
+		return E_PAR;
+	SIL_LOC_INT();
+	*pstat = hspi->stat;
+	if(clear)
+		memset(&hspi->stat, 0, sizeof(SPI_Stat_t));
+	SIL_UNL_INT();
+	return E_OK;
+}
+
+/*
+ *  SPIトレースのダンプ
+ *  未読の記録をシリアルポートに1行ずつ16進数で出力する．書式は
+ *    SPIT-BEGIN 周波数 記録数 消失数
+ *    SPIT 記録番号 ポート SS モード フラグ バイト数 開始サイクル 終了サイクル
+ *    SPIT-END 出力数 消失数
+ *  parameter1  portid: 出力するシリアルポートID
+ *  return      出力した記録数(負値はERコード)
+ */
+ER_UINT
+spi_trace_dump(ID portid)
+{
+#if SPI_TRACE
+	SPI_Trace_t rec;
+	char        line[80], *p;
+	uint32_t    seq, head, lost = 0, count = 0;
+
+	head = __atomic_load_n(&spi_trace_head, __ATOMIC_ACQUIRE);
+	seq  = spi_trace_tail;
+	if(head - seq > SPI_TRACE_SIZE){
+		lost = head - seq - SPI_TRACE_SIZE;
+		seq  = head - SPI_TRACE_SIZE;
+	}
+	memcpy(line, "SPIT-BEGIN ", 11);
+	p = spi_trace_hex(line + 11, SPI_TRACE_HZ, 8);
+	p = spi_trace_hex(p, head - seq, 8);
+	p = spi_trace_hex(p, lost, 8);
+	p[-1] = '\r';
+	*p++  = '\n';
+	serial_wri_dat(portid, line, p - line);
+
+	memcpy(line, "SPIT ", 5);
+	for( ; seq != head ; seq++){
+		rec = spi_trace_ring[seq & (SPI_TRACE_SIZE - 1)];
+		/* 書込み途中、またはコピー中に上書きされた記録は捨てる */
+		if(rec.seq != seq + 1 || spi_trace_ring[seq & (SPI_TRACE_SIZE - 1)].seq != seq + 1){
+			lost++;
+			continue;
+		}
+		p = spi_trace_hex(line + 5, seq, 8);
+		p = spi_trace_hex(p, rec.port, 1);
+		p = spi_trace_hex(p, (uint8_t)rec.ss, 2);
+		p = spi_trace_hex(p, rec.mode, 1);
+		p = spi_trace_hex(p, rec.flags, 2);
+		p = spi_trace_hex(p, rec.bytes, 8);
+		p = spi_trace_hex(p, rec.start, 16);
+		p = spi_trace_hex(p, rec.end, 16);
+		p[-1] = '\r';
+		*p++  = '\n';
+		serial_wri_dat(portid, line, p - line);
+		count++;
+	}
+	spi_trace_tail = head;
+
+	memcpy(line, "SPIT-END ", 9);
+	p = spi_trace_hex(line + 9, count, 8);
+	p = spi_trace_hex(p, lost, 8);
+	p[-1] = '\r';
+	*p++  = '\n';
+	serial_wri_dat(portid, line, p - line);
+	return count;
+#else
+	return E_NOSPT;
 #endif
+}
+
+/*
+ *  SPIトレースの未読記録の破棄
+ */
+void
+spi_trace_clear(void)
+{
+#if SPI_TRACE
+	spi_trace_tail = __atomic_load_n(&spi_trace_head, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/*
+ *  SPIバス利用者の登録
+ *  呼び出しタスクを優先度付きの利用者として登録する．以後このタスクからの
+ *  転送は優先度順にバスを獲得し、chunkを指定するとDMA送信をchunkフレーム
+ *  ごとに分割して、切れ目で高優先の待ちにバスを譲る．
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  client: 利用者構造体へのポインタ
+ *  parameter3  priority: 優先度(値が小さいほど高優先)
+ *  parameter4  chunk: 分割フレーム数(0で分割なし)
+ *  parameter5  semid: バス譲渡通知セマフォID(初期値0、最大値1で生成したもの)
+ *  return ERコード
+ */
+ER
+spi_client_attach(SPI_Handle_t *hspi, SPI_Client_t *client, uint8_t priority, uint32_t chunk, ID semid)
+{
+	SPI_Client_t *p;
+	ID tskid;
+	SIL_PRE_LOC;
+
+	if(hspi == NULL || client == NULL)
+		return E_PAR;
+	if(hspi->Init.semlock != 0 && semid == 0)
+		return E_PAR;
+	if(get_tid(&tskid) != E_OK)
+		return E_OBJ;
+
+	SIL_LOC_INT();
+	for(p = hspi->clients ; p != NULL && p != client ; p = p->link)
+		;
+	if(p == NULL){
+		client->link  = hspi->clients;
+		hspi->clients = client;
+	}
+	client->next     = NULL;
+	client->resume   = NULL;
+	client->tskid    = tskid;
+	client->semid    = semid;
+	client->priority = priority;
+	client->waiting  = false;
+	client->chunk    = chunk;
+	memset(&client->stat, 0, sizeof(SPI_WaitStat_t));
+	SIL_UNL_INT();
+	return E_OK;
+}
+
+/*
+ *  SPIバス利用者の登録解除
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  client: 利用者構造体へのポインタ
+ *  return ERコード
+ */
+ER
+spi_client_detach(SPI_Handle_t *hspi, SPI_Client_t *client)
+{
+	SPI_Client_t **pp;
+	ER ercd = E_OBJ;
+	SIL_PRE_LOC;
+
+	if(hspi == NULL || client == NULL)
+		return E_PAR;
+
+	SIL_LOC_INT();
+	for(pp = &hspi->clients ; *pp != NULL ; pp = &(*pp)->link){
+		if(*pp == client){
+			*pp = client->link;
+			client->link = NULL;
+			ercd = E_OK;
+			break;
+		}
+	}
+	SIL_UNL_INT();
 	return ercd;
 }
 
+/*
+ *  SPIバス待ち統計の取得
+ *  clientにNULLを指定するとポート全体、&hspi->asyncで非同期分割送信の
+ *  再開待ちの統計を返す
+ *  parameter1  hspi: SPIハンドラへのポインタ
+ *  parameter2  client: 利用者構造体へのポインタ
+ *  parameter3  pstat: 統計の格納先
+ *  parameter4  clear: trueで取得後にクリア
+ *  return ERコード
+ */
+ER
+spi_get_wait_stat(SPI_Handle_t *hspi, SPI_Client_t *client, SPI_WaitStat_t *pstat, bool_t clear)
+{
+	SPI_WaitStat_t *stat;
+	SIL_PRE_LOC;
+
+	if(hspi == NULL || pstat == NULL)
+		return E_PAR;
+	stat = (client != NULL) ? &client->stat : &hspi->waitstat;
+	SIL_LOC_INT();
+	*pstat = *stat;
+	if(clear)
+		memset(stat, 0, sizeof(SPI_WaitStat_t));
+	SIL_UNL_INT();
+	return E_OK;
+}
+
 
 /*
- *  SPIߥӥ롼
+ *  SPI割込みサービスルーチン
  */
 void
 spi_handler(SPI_Handle_t *hspi)
@@ -956,13 +1967,29 @@ spi_handler(SPI_Handle_t *hspi)
 
 	syslog_2(LOG_DEBUG, "spi_handler imr[%08x] isr[%08x]", imr, isr);
 	tmp = sil_rew_mem((uint32_t *)(hspi->base+TOFF_SPI_ICR));
+	if(hspi->pio != SPI_PIO_NONE){
+		spi_pio_handler(hspi);
+		return;
+	}
+	if(hspi->xmode == SPI_XMODE_TX_ASYNC){
+		/*
+		 *  非同期送信の終了はstatusで通知する．semidは他の転送の終了待ちと
+		 *  共用のため、ここで返却すると次の転送の待ちが早期に解ける
+		 */
+		spi_async_end(hspi);
+		return;
+	}
+	else if(!spi_spin_idle(hspi)){
+		sil_wrw_mem((uint32_t *)(hspi->base+TOFF_SPI_IMR), 0x0011);
+		return;
+	}
 	if(hspi->Init.semid != 0)
 		isig_sem(hspi->Init.semid);
 	(void)(tmp);
 }
 
 /*
- *  SPIߥӥ롼
+ *  SPI割込みサービスルーチン
  */
 void spi_isr(intptr_t exinf)
 {
@@ -1,221 +1,368 @@
-/*
- *  TOPPERS/ASP Kernel
- *      Toyohashi Open Platform for Embedded Real-Time Systems/
- *      Advanced Standard Profile Kernel
- * 
- *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
- *              Graduate School of Information Science, Nagoya Univ., JAPAN
- *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
- * 
- *  L쌠҂́Cȉ(1)`(4)̏𖞂ꍇɌC{\tgEF
- *  Ai{\tgEFAς̂܂ށDȉjgpEE
- *  ρEĔzziȉCpƌĂԁj邱Ƃ𖳏ŋD
- *  (1) {\tgEFA\[XR[ȟ`ŗpꍇɂ́CL̒
- *      \C̗pщL̖ۏ؋K肪Ĉ܂܂̌`Ń\[
- *      XR[hɊ܂܂Ă邱ƁD
- *  (2) {\tgEFACCu`ȂǁC̃\tgEFAJɎg
- *      pł`ōĔzzꍇɂ́CĔzzɔhLgip
- *      ҃}jAȂǁjɁCL̒쌠\C̗pщL
- *      ̖ۏ؋Kfڂ邱ƁD
- *  (3) {\tgEFAC@ɑgݍނȂǁC̃\tgEFAJɎg
- *      płȂ`ōĔzzꍇɂ́Ĉꂩ̏𖞂
- *      ƁD
- *    (a) ĔzzɔhLgip҃}jAȂǁjɁCL̒
- *        쌠\C̗pщL̖ۏ؋Kfڂ邱ƁD
- *    (b) Ĕzž`ԂCʂɒ߂@ɂāCTOPPERSvWFNg
- *        񍐂邱ƁD
- *  (4) {\tgEFA̗pɂ蒼ړI܂͊ԐړIɐ邢Ȃ鑹
- *      QCL쌠҂TOPPERSvWFNgƐӂ邱ƁD
- *      ܂C{\tgEFÃ[U܂̓Gh[ÛȂ闝
- *      RɊÂCL쌠҂TOPPERSvWFNg
- *      Ɛӂ邱ƁD
- * 
- *  {\tgEFÁCۏ؂Œ񋟂Ă̂łDL쌠҂
- *  TOPPERSvWFNǵC{\tgEFAɊւāC̎gpړI
- *  ɑ΂K܂߂āCȂۏ؂sȂD܂C{\tgEF
- *  A̗pɂ蒼ړI܂͊ԐړIɐȂ鑹QɊւĂC
- *  ̐ӔC𕉂ȂD
- * 
- *  @(#) $Id: spi.h 698 2019-12-28 18:11:30Z roi $
- */
-/*
- * 
- *  K210 SPIfoCXhCo̊O錾
- *
- */
-
-#ifndef _SPI_H_
-#define _SPI_H_
-
-#ifdef __cplusplus
- extern "C" {
-#endif
-
-/*
- *  SPI|[g`
- */
-#define SPI1_PORTID             1
-#define SPI2_PORTID             2
-#define SPI3_PORTID             3
-#define SPI4_PORTID             4
-#define NUM_SPIPORT             4
-
-
-/*
- *  SPIԒ`
- */
-#define SPI_STATUS_RESET        0x0000	/* SPIgp */
-#define SPI_STATUS_READY        0x0001	/* SPIfB */
-#define SPI_STATUS_ERROR        0x0002	/* SPIG[ */
-#define SPI_STATUS_BUSY         0x0004	/* SPI */
-
-/*
- *  SPI][h
- */
-#define SPI_XMODE_TX            0x0000	/* M[h */
-#define SPI_XMODE_RX            0x0001	/* M[h */
-#define SPI_XMODE_TXRX          0x0002	/* M[h */
-
-/*
- *  SPIG[`
- */
-#define SPI_ERROR_NONE          0x00000000	/* No error */
-#define SPI_ERROR_MODF          0x00000001	/* MODF error */
-#define SPI_ERROR_CRC           0x00000002	/* CRC error */
-#define SPI_ERROR_OVR           0x00000004	/* OVR error */
-#define SPI_ERROR_FRE           0x00000008	/* FRE error */
-#define SPI_ERROR_DMA           0x00000010	/* DMA transfer error */
-#define SPI_ERROR_TIMEOUT       0x00000020
-
-/*
- *  SPI[N[h`
- */
-#define SPI_WORK_MODE_0         0x00000000
-#define SPI_WORK_MODE_1         0x00000001
-#define SPI_WORK_MODE_2         0x00000002
-#define SPI_WORK_MODE_3         0x00000003
-
-/*
- *  SPIt[tH[}bg`
- */
-#define SPI_FF_STANDARD         0x00000000
-#define SPI_FF_DUAL             0x00000001
-#define SPI_FF_QUAD             0x00000002
-#define SPI_FF_OCTAL            0x00000003
-
-/*
- *  SPICXgNVAhX[h
- */
-#define SPI_AITM_STANDARD        0x00000000
-#define SPI_AITM_ADDR_STANDARD   0x00000001
-#define SPI_AITM_AS_FRAME_FORMAT 0x00000002
-
-
-/*
- *  SPI][h`
- */
-#define SPI_TMOD_TRANS_RECV     0x00000000
-#define SPI_TMOD_TRANS          0x00000001
-#define SPI_TMOD_RECV           0x00000002
-#define SPI_TMOD_EEROM          0x00000003
-
-/*
- *  SPI]f[^`
- */
-#define SPI_TRANS_CHAR          0x01
-#define SPI_TRANS_SHORT         0x02
-#define SPI_TRANS_INT           0x04
-
-/*
- *  SPI CSI`
- */
-#define SPI_CHIP_SELECT_0       0x00
-#define SPI_CHIP_SELECT_1       0x01
-#define SPI_CHIP_SELECT_2       0x02
-#define SPI_CHIP_SELECT_3       0x03
-#define SPI_CHIP_SELECT_MAX     4
-
-/*
- *  SPI ݒ菉ݒ\
- */
-typedef struct
-{
-	uint32_t              WorkMode;
-	uint32_t              FrameFormat;
-    uint32_t              DataSize;			/* SPI]f[^TCY */
-	uint32_t              Prescaler;		/* SPINbNݒ */
-	uint32_t              SignBit;			/* SPI MSB/LSBݒ */
-	uint32_t              InstLength;		/* SPI Instraction Length */
-	uint32_t              AddrLength;		/* SPI Address Length */
-	uint32_t              WaitCycles;		/* SPI WaitCycles */
-	uint32_t              IATransMode;		/* SPI ][h */
-	int32_t               SclkPin;			/* SPI SCLK-PIN */
-	int32_t               MosiPin;			/* SPI MOSI-PIN */
-	int32_t               MisoPin;			/* SPI MISO-PIN */
-	int32_t               SsPin;			/* SPI Slave Select-PIN */
-	int32_t               SsNo;				/* SPI Slave Select-Number */
-	int32_t               TxDMAChannel;		/* SPI TxDMA`l */
-	int32_t               RxDMAChannel;		/* SPI RxDMA`l */
-	int                   semid;			/* SPI ʐMpZ}tHl */
-	int                   semlock;			/* SPI bNZ}tHl */
-	int                   semdmaid;			/* SPI DMAʐMpZ}tHl */
-}SPI_Init_t;
-
-/*
- *  SPInh
- */
-typedef struct _SPI_Handle_t
-{
-	unsigned long         base;				/* SPI registers base address */
-	SPI_Init_t            Init;				/* SPI communication parameters */
-	uint8_t               spi_num;
-	uint8_t               dfs_offset;
-	uint8_t               frf_offset;
-	uint8_t               work_mode_offset;
-	uint8_t               tmod_offset;
-	uint8_t               dummy[3];
-	uint8_t               *pTxBuffPtr;		/* Pointer to SPI Tx transfer Buffer */
-	uint32_t              TxXferSize;		/* SPI Tx transfer size */
-	uint32_t              TxXferCount;		/* SPI Tx Transfer Counter */
-	uint8_t               *pRxBuffPtr;		/* Pointer to SPI Rx transfer Buffer */
-	uint32_t              RxXferSize;		/* SPI Rx transfer size */
-	uint32_t              RxXferCount;		/* SPI Rx Transfer Counter */
-	DMA_Handle_t          *hdmatx;			/* SPI Tx DMA handle parameters */
-	DMA_Handle_t          *hdmarx;			/* SPI Rx DMA handle parameters */
-	uint16_t              xmode;			/* SPI Transfar mode */
-	volatile uint16_t     status;			/* SPI communication state */
-	volatile uint32_t     ErrorCode;		/* SPI Error code */
-}SPI_Handle_t;
-
-
-extern SPI_Handle_t *spi_init(ID port, const SPI_Init_t *init);
-extern ER spi_deinit(SPI_Handle_t *hspi);
-extern ER spi_core_transmit(SPI_Handle_t *hspi, int8_t ss_no, uint8_t *pdata, uint16_t length);
-extern ER spi_core_transmit_fill(SPI_Handle_t *hspi, int8_t ss_no, const uint32_t *tx_buff, size_t tx_len);
-extern ER spi_core_receive(SPI_Handle_t *hspi, int8_t ss_no, void *rx_buff, size_t rx_len);
-extern ER spi_core_transrecv(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buf, uint8_t *rx_buf, size_t len);
-extern ER spi_eerom_transrecv(SPI_Handle_t *hspi, int8_t ss_no, uint8_t *tx_buf, size_t tx_len, uint8_t *rx_buf, size_t rx_len);
-extern ER spi_esp32_transrecv(SPI_Handle_t *hspi, int8_t ss_no, uint8_t *tx_buf, size_t tx_len, uint8_t *rx_buf, size_t rx_len);
-extern ER spi_transmit(SPI_Handle_t *hspi, uint8_t *pdata, uint16_t length);
-extern ER spi_receive(SPI_Handle_t *hspi, uint8_t *pdata, uint16_t length);
-extern ER spi_transrecv(SPI_Handle_t *hspi, uint8_t *ptxData, uint8_t *prxData, uint16_t length);
-extern ER spi_wait(SPI_Handle_t *hspi, uint32_t timeout);
-extern void spi_handler(SPI_Handle_t *hspi);
-extern void spi_isr(intptr_t exinf);
-extern DMA_Handle_t *spi_dmac_set_single_mode(SPI_Handle_t *hspi, 
-                          uint8_t rtx,
-						  int8_t  ss_no,
-                          const void *src, void *dest, uint8_t src_inc,
-                          uint8_t dest_inc,
-                          uint8_t dmac_burst_size,
-                          uint8_t dmac_trans_width,
-                          size_t block_size);
-extern ER spi_dmac_wait_done(DMA_Handle_t * hdma);
-
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif	/* _SPI_H_ */
-
+/*
+ *  TOPPERS/ASP Kernel
+ *      Toyohashi Open Platform for Embedded Real-Time Systems/
+ *      Advanced Standard Profile Kernel
+ * 
+ *  Copyright (C) 2008-2011 by Embedded and Real-Time Systems Laboratory
+ *              Graduate School of Information Science, Nagoya Univ., JAPAN
+ *  Copyright (C) 2015-2019 by TOPPERS PROJECT Educational Working Group.
+ * 
+ *  上記著作権者は，以下の(1)～(4)の条件を満たす場合に限り，本ソフトウェ
+ *  ア（本ソフトウェアを改変したものを含む．以下同じ）を使用・複製・改
+ *  変・再配布（以下，利用と呼ぶ）することを無償で許諾する．
+ *  (1) 本ソフトウェアをソースコードの形で利用する場合には，上記の著作
+ *      権表示，この利用条件および下記の無保証規定が，そのままの形でソー
+ *      スコード中に含まれていること．
+ *  (2) 本ソフトウェアを，ライブラリ形式など，他のソフトウェア開発に使
+ *      用できる形で再配布する場合には，再配布に伴うドキュメント（利用
+ *      者マニュアルなど）に，上記の著作権表示，この利用条件および下記
+ *      の無保証規定を掲載すること．
+ *  (3) 本ソフトウェアを，機器に組み込むなど，他のソフトウェア開発に使
+ *      用できない形で再配布する場合には，次のいずれかの条件を満たすこ
+ *      と．
+ *    (a) 再配布に伴うドキュメント（利用者マニュアルなど）に，上記の著
+ *        作権表示，この利用条件および下記の無保証規定を掲載すること．
+ *    (b) 再配布の形態を，別に定める方法によって，TOPPERSプロジェクトに
+ *        報告すること．
+ *  (4) 本ソフトウェアの利用により直接的または間接的に生じるいかなる損
+ *      害からも，上記著作権者およびTOPPERSプロジェクトを免責すること．
+ *      また，本ソフトウェアのユーザまたはエンドユーザからのいかなる理
+ *      由に基づく請求からも，上記著作権者およびTOPPERSプロジェクトを
+ *      免責すること．
+ * 
+ *  本ソフトウェアは，無保証で提供されているものである．上記著作権者お
+ *  よびTOPPERSプロジェクトは，本ソフトウェアに関して，特定の使用目的
+ *  に対する適合性も含めて，いかなる保証も行わない．また，本ソフトウェ
+ *  アの利用により直接的または間接的に生じたいかなる損害に関しても，そ
+ *  の責任を負わない．
+ * 
+ *  @(#) $Id: spi.h 698 2019-12-28 18:11:30Z roi $
+ */
+/*
+ * 
+ *  K210 SPIデバイスドライバの外部宣言
+ *
+ */
+
+#ifndef _SPI_H_
+#define _SPI_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/*
+ *  SPIポート定義
+ */
+#define SPI1_PORTID             1
+#define SPI2_PORTID             2
+#define SPI3_PORTID             3
+#define SPI4_PORTID             4
+#define NUM_SPIPORT             4
+
+
+/*
+ *  SPI状態定義
+ */
+#define SPI_STATUS_RESET        0x0000	/* SPI未使用状態 */
+#define SPI_STATUS_READY        0x0001	/* SPIレディ状態 */
+#define SPI_STATUS_ERROR        0x0002	/* SPIエラー状態 */
+#define SPI_STATUS_BUSY         0x0004	/* SPI処理中 */
+
+/*
+ *  SPI転送モード
+ */
+#define SPI_XMODE_TX            0x0000	/* 送信モード */
+#define SPI_XMODE_RX            0x0001	/* 受信モード */
+#define SPI_XMODE_TXRX          0x0002	/* 送受信モード */
+#define SPI_XMODE_TX_ASYNC      0x0003	/* 非同期送信モード */
+
+/*
+ *  SPI PIO転送状態
+ */
+#define SPI_PIO_NONE            0x00	/* PIO転送なし */
+#define SPI_PIO_TX              0x01	/* 送信FIFO補充中 */
+#define SPI_PIO_TXRX            0x02	/* 送受信FIFO補充/回収中 */
+
+/*
+ *  SPIエラー定義
+ */
+#define SPI_ERROR_NONE          0x00000000	/* No error */
+#define SPI_ERROR_MODF          0x00000001	/* MODF error */
+#define SPI_ERROR_CRC           0x00000002	/* CRC error */
+#define SPI_ERROR_OVR           0x00000004	/* OVR error */
+#define SPI_ERROR_FRE           0x00000008	/* FRE error */
+#define SPI_ERROR_DMA           0x00000010	/* DMA transfer error */
+#define SPI_ERROR_TIMEOUT       0x00000020
+
+/*
+ *  SPIワークモード定義
+ */
+#define SPI_WORK_MODE_0         0x00000000
+#define SPI_WORK_MODE_1         0x00000001
+#define SPI_WORK_MODE_2         0x00000002
+#define SPI_WORK_MODE_3         0x00000003
+
+/*
+ *  SPIフレームフォーマット定義
+ */
+#define SPI_FF_STANDARD         0x00000000
+#define SPI_FF_DUAL             0x00000001
+#define SPI_FF_QUAD             0x00000002
+#define SPI_FF_OCTAL            0x00000003
+
+/*
+ *  SPIインストラクションアドレスモード
+ */
+#define SPI_AITM_STANDARD        0x00000000
+#define SPI_AITM_ADDR_STANDARD   0x00000001
+#define SPI_AITM_AS_FRAME_FORMAT 0x00000002
+
+
+/*
+ *  SPI転送モード定義
+ */
+#define SPI_TMOD_TRANS_RECV     0x00000000
+#define SPI_TMOD_TRANS          0x00000001
+#define SPI_TMOD_RECV           0x00000002
+#define SPI_TMOD_EEROM          0x00000003
+
+/*
+ *  SPI転送データ長定義
+ */
+#define SPI_TRANS_CHAR          0x01
+#define SPI_TRANS_SHORT         0x02
+#define SPI_TRANS_INT           0x04
+
+/*
+ *  SPI CS選択定義
+ */
+#define SPI_CHIP_SELECT_0       0x00
+#define SPI_CHIP_SELECT_1       0x01
+#define SPI_CHIP_SELECT_2       0x02
+#define SPI_CHIP_SELECT_3       0x03
+#define SPI_CHIP_SELECT_MAX     4
+
+/*
+ *  SPI 設定初期設定構造体
+ */
+typedef struct
+{
+	uint32_t              WorkMode;
+	uint32_t              FrameFormat;
+    uint32_t              DataSize;			/* SPI転送データサイズ */
+	uint32_t              Prescaler;		/* SPIクロック分周設定 */
+	uint32_t              SignBit;			/* SPI MSB/LSB設定 */
+	uint32_t              InstLength;		/* SPI Instraction Length */
+	uint32_t              AddrLength;		/* SPI Address Length */
+	uint32_t              WaitCycles;		/* SPI WaitCycles */
+	uint32_t              IATransMode;		/* SPI 転送モード */
+	int32_t               SclkPin;			/* SPI SCLK-PIN */
+	int32_t               MosiPin;			/* SPI MOSI-PIN */
+	int32_t               MisoPin;			/* SPI MISO-PIN */
+	int32_t               SsPin;			/* SPI Slave Select-PIN */
+	int32_t               SsNo;				/* SPI Slave Select-Number */
+	int32_t               TxDMAChannel;		/* SPI TxDMAチャンネル */
+	int32_t               RxDMAChannel;		/* SPI RxDMAチャンネル */
+	int                   semid;			/* SPI 通信用セマフォ値 */
+	int                   semlock;			/* SPI ロックセマフォ値(0以外で優先度付きバス調停、未登録タスクの譲渡通知用、初期値0) */
+	int                   semdmaid;			/* SPI DMA通信用セマフォ値 */
+}SPI_Init_t;
+
+/*
+ *  SPI送信セグメント(記述子リスト用)
+ *  送信データは1フレームを32ビットで格納する
+ */
+#define SPI_SEG_FILL            0x01	/* pdata[0]をlengthフレーム繰り返し送信 */
+
+typedef struct
+{
+	const uint32_t        *pdata;			/* 送信データ */
+	uint16_t              length;			/* 送信フレーム数 */
+	uint8_t               DataSize;			/* データサイズ(0で前セグメントと同じ) */
+	uint8_t               InstLength;		/* Instraction Length */
+	uint8_t               AddrLength;		/* Address Length */
+	int8_t                dcx;				/* DCXピン出力値(-1で変更なし) */
+	uint8_t               flags;			/* SPI_SEG_FILL */
+	uint8_t               dummy;
+}SPI_Segment_t;
+
+/*
+ *  SPI転送統計
+ */
+typedef struct
+{
+	uint32_t              count;			/* 転送回数 */
+	uint32_t              irqwaits;			/* 割込みで終了を待った回数 */
+	uint32_t              last;				/* 直近の転送時間(μs) */
+	uint32_t              min;				/* 最小転送時間(μs) */
+	uint32_t              max;				/* 最大転送時間(μs) */
+	uint64_t              total;			/* 累積転送時間(μs) */
+}SPI_Stat_t;
+
+/*
+ *  SPIトランザクショントレース
+ *  SPI_TRACEを1でビルドすると転送ごとにポート・SS・モード・バイト数・
+ *  開始/終了サイクルをリングバッファに記録する
+ */
+#ifndef SPI_TRACE
+#define SPI_TRACE               0
+#endif
+#ifndef SPI_TRACE_SIZE
+#define SPI_TRACE_SIZE          256		/* 記録数(2のべき乗) */
+#endif
+#ifndef SPI_TRACE_HZ
+#define SPI_TRACE_HZ            400000000	/* サイクルカウンタの周波数 */
+#endif
+
+#define SPI_TRACE_DMA           0x01	/* DMA転送を含む */
+#define SPI_TRACE_PIO           0x02	/* PIO転送を含む */
+#define SPI_TRACE_ASYNC         0x04	/* 非同期送信 */
+#define SPI_TRACE_LIST          0x08	/* 記述子リスト送信 */
+#define SPI_TRACE_YIELD         0x10	/* 分割送信でバスを譲るため途中で終了 */
+#define SPI_TRACE_ERROR         0x80	/* エラー終了 */
+
+/*
+ *  SPIトレース記録
+ */
+typedef struct
+{
+	volatile uint32_t     seq;				/* 記録番号+1(0で書込み中) */
+	uint8_t               port;				/* SPIポートインデックス */
+	int8_t                ss;				/* SS番号 */
+	uint8_t               mode;				/* SPI_TMOD_xxx */
+	uint8_t               flags;			/* SPI_TRACE_xxx */
+	uint32_t              bytes;			/* 転送バイト数 */
+	uint32_t              dummy;
+	uint64_t              start;			/* 開始サイクル */
+	uint64_t              end;				/* 終了サイクル */
+}SPI_Trace_t;
+
+/*
+ *  SPIバス利用者の優先度(値が小さいほど高優先)
+ */
+#define SPI_PRIORITY_HIGH       1
+#define SPI_PRIORITY_DEFAULT    8
+#define SPI_PRIORITY_LOW        15
+
+/*
+ *  SPIバス待ち統計
+ */
+typedef struct
+{
+	uint32_t              count;			/* バス獲得回数 */
+	uint32_t              waits;			/* 待ちが発生した回数 */
+	uint32_t              yields;			/* 分割送信でバスを譲った回数 */
+	uint32_t              max;				/* 最大待ち時間(μs) */
+	uint64_t              total;			/* 累積待ち時間(μs) */
+}SPI_WaitStat_t;
+
+struct _SPI_Handle_t;
+
+/*
+ *  SPIバス利用者
+ */
+typedef struct _SPI_Client_t
+{
+	struct _SPI_Client_t  *next;			/* バス待ち行列リンク */
+	struct _SPI_Client_t  *link;			/* 登録リストリンク */
+	void                  (*resume)(struct _SPI_Handle_t * hspi);	/* 非同期送信の再開関数 */
+	ID                    tskid;			/* 利用タスクID */
+	ID                    semid;			/* バス譲渡通知セマフォID */
+	uint8_t               priority;			/* 優先度 */
+	volatile uint8_t      waiting;			/* バス待ち中 */
+	uint16_t              dummy;
+	uint32_t              chunk;			/* 1回のバス占有で送る最大フレーム数(0で分割なし) */
+	SYSUTM                request;			/* バス要求時刻 */
+	SPI_WaitStat_t        stat;				/* バス待ち統計 */
+}SPI_Client_t;
+
+/*
+ *  SPIハンドラ
+ */
+typedef struct _SPI_Handle_t
+{
+	unsigned long         base;				/* SPI registers base address */
+	SPI_Init_t            Init;				/* SPI communication parameters */
+	uint8_t               spi_num;
+	uint8_t               dfs_offset;
+	uint8_t               frf_offset;
+	uint8_t               work_mode_offset;
+	uint8_t               tmod_offset;
+	uint8_t               dummy[3];
+	uint8_t               *pTxBuffPtr;		/* Pointer to SPI Tx transfer Buffer */
+	uint32_t              TxXferSize;		/* SPI Tx transfer size */
+	uint32_t              TxXferCount;		/* SPI Tx Transfer Counter */
+	uint8_t               *pRxBuffPtr;		/* Pointer to SPI Rx transfer Buffer */
+	uint32_t              RxXferSize;		/* SPI Rx transfer size */
+	uint32_t              RxXferCount;		/* SPI Rx Transfer Counter */
+	DMA_Handle_t          *hdmatx;			/* SPI Tx DMA handle parameters */
+	DMA_Handle_t          *hdmarx;			/* SPI Rx DMA handle parameters */
+	uint16_t              xmode;			/* SPI Transfar mode */
+	volatile uint16_t     status;			/* SPI communication state */
+	volatile uint32_t     ErrorCode;		/* SPI Error code */
+	void                  (*xfercallback)(struct _SPI_Handle_t * hspi);	/* 非同期送信終了コールバック */
+	void                  *localdata;		/* コールバック用ローカルデータ */
+	SYSUTM                start;			/* 転送開始時刻 */
+	SPI_Stat_t            stat;				/* 転送統計 */
+	volatile uint8_t      pio;				/* PIO転送状態 */
+	uint32_t              RxXferStore;		/* PIO受信で格納する残りフレーム数 */
+	void                  (*pio_tx)(struct _SPI_Handle_t * hspi, uint32_t count);	/* FIFO補充関数 */
+	void                  (*pio_rx)(struct _SPI_Handle_t * hspi, uint32_t count);	/* FIFO回収関数 */
+	volatile uint8_t      locked;			/* バス使用中 */
+	uint8_t               lockpri;			/* バス使用中の利用者の優先度 */
+	int8_t                async_ss;			/* 非同期送信のSS番号 */
+	uint8_t               async_dummy;
+	SPI_Client_t          *waitq;			/* バス待ち行列(優先度順) */
+	SPI_Client_t          *clients;			/* 登録利用者リスト */
+	SPI_Client_t          async;			/* 非同期分割送信の再開待ち */
+	SPI_Client_t          temp;				/* 未登録タスク共通のバス待ち */
+	uint32_t              tempwait;			/* 未登録タスクのバス待ち数 */
+	uint32_t              async_ctrl[2];	/* 非同期送信のフレーム設定 */
+	SPI_WaitStat_t        waitstat;			/* ポート全体のバス待ち統計 */
+#if SPI_TRACE
+	SPI_Trace_t           trace;			/* 転送中のトレース記録 */
+#endif
+}SPI_Handle_t;
+
+
+extern SPI_Handle_t *spi_init(ID port, const SPI_Init_t *init);
+extern ER spi_deinit(SPI_Handle_t *hspi);
+extern ER spi_core_transmit(SPI_Handle_t *hspi, int8_t ss_no, uint8_t *pdata, uint16_t length);
+extern ER spi_core_transmit_async(SPI_Handle_t *hspi, int8_t ss_no, const void *pdata, uint16_t length);
+extern ER spi_core_transmit_wait(SPI_Handle_t *hspi, uint32_t timeout);
+extern ER spi_core_transmit_list(SPI_Handle_t *hspi, int8_t ss_no, int8_t dcx_no, const SPI_Segment_t *seg, uint16_t num);
+extern ER spi_core_transmit_fill(SPI_Handle_t *hspi, int8_t ss_no, const uint32_t *tx_buff, size_t tx_len);
+extern ER spi_core_receive(SPI_Handle_t *hspi, int8_t ss_no, void *rx_buff, size_t rx_len);
+extern ER spi_core_transrecv(SPI_Handle_t *hspi, int8_t ss_no, const uint8_t *tx_buf, uint8_t *rx_buf, size_t len);
+extern ER spi_eerom_transrecv(SPI_Handle_t *hspi, int8_t ss_no, uint8_t *tx_buf, size_t tx_len, uint8_t *rx_buf, size_t rx_len);
+extern ER spi_esp32_transrecv(SPI_Handle_t *hspi, int8_t ss_no, uint8_t *tx_buf, size_t tx_len, uint8_t *rx_buf, size_t rx_len);
+extern ER spi_transmit(SPI_Handle_t *hspi, uint8_t *pdata, uint16_t length);
+extern ER spi_receive(SPI_Handle_t *hspi, uint8_t *pdata, uint16_t length);
+extern ER spi_transrecv(SPI_Handle_t *hspi, uint8_t *ptxData, uint8_t *prxData, uint16_t length);
+extern ER spi_wait(SPI_Handle_t *hspi, uint32_t timeout);
+extern ER spi_get_stat(SPI_Handle_t *hspi, SPI_Stat_t *pstat, bool_t clear);
+extern ER spi_client_attach(SPI_Handle_t *hspi, SPI_Client_t *client, uint8_t priority, uint32_t chunk, ID semid);
+extern ER spi_client_detach(SPI_Handle_t *hspi, SPI_Client_t *client);
+extern ER spi_get_wait_stat(SPI_Handle_t *hspi, SPI_Client_t *client, SPI_WaitStat_t *pstat, bool_t clear);
+extern ER_UINT spi_trace_dump(ID portid);
+extern void spi_trace_clear(void);
+extern void spi_handler(SPI_Handle_t *hspi);
+extern void spi_isr(intptr_t exinf);
+extern DMA_Handle_t *spi_dmac_set_single_mode(SPI_Handle_t *hspi, 
+                          uint8_t rtx,
+						  int8_t  ss_no,
+                          const void *src, void *dest, uint8_t src_inc,
+                          uint8_t dest_inc,
+                          uint8_t dmac_burst_size,
+                          uint8_t dmac_trans_width,
+                          size_t block_size);
+extern ER spi_dmac_wait_done(DMA_Handle_t * hdma);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _SPI_H_ */
+
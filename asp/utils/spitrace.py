@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+#
+#   TOPPERS/ASP Kernel
+#       Toyohashi Open Platform for Embedded Real-Time Systems/
+#       Advanced Standard Profile Kernel
+#
+#   SPI transaction trace decoder
+#
+#   Reads the serial log produced by spi_trace_dump() (built with
+#   SPI_TRACE=1) and prints a per-transaction timeline, a coarse bus
+#   occupancy chart per port and a bandwidth report per port/SS.
+#
+#   usage: spitrace.py [-z HZ] [-w WIDTH] [-n] [logfile ...]
+#
+
+import argparse
+import sys
+from collections import OrderedDict
+
+MODES = {0: "TXRX", 1: "TX", 2: "RX", 3: "EEROM"}
+FLAGS = ((0x01, "DMA"), (0x02, "PIO"), (0x04, "ASYNC"), (0x08, "LIST"),
+         (0x10, "YIELD"), (0x80, "ERR"))
+
+
+def flag_names(flags):
+    names = [name for bit, name in FLAGS if flags & bit]
+    return "|".join(names) if names else "-"
+
+
+def parse(lines):
+    """Collect SPIT records, skipping any other log output on the line."""
+    hz = None
+    lost = 0
+    pending = 0
+    records = OrderedDict()
+    for line in lines:
+        pos = line.find("SPIT")
+        if pos < 0:
+            continue
+        fields = line[pos:].split()
+        try:
+            if fields[0] == "SPIT-BEGIN" and len(fields) >= 4:
+                hz = int(fields[1], 16)
+                lost += pending
+                pending = int(fields[3], 16)
+            elif fields[0] == "SPIT-END" and len(fields) >= 3:
+                # the END count also includes records torn while dumping
+                lost += int(fields[2], 16)
+                pending = 0
+            elif fields[0] == "SPIT" and len(fields) >= 9:
+                seq = int(fields[1], 16)
+                ss = int(fields[3], 16)
+                records[seq] = {
+                    "seq": seq,
+                    "port": int(fields[2], 16),
+                    "ss": ss - 256 if ss >= 128 else ss,
+                    "mode": int(fields[4], 16),
+                    "flags": int(fields[5], 16),
+                    "bytes": int(fields[6], 16),
+                    "start": int(fields[7], 16),
+                    "end": int(fields[8], 16),
+                }
+        except ValueError:
+            continue
+    return hz, lost + pending, sorted(records.values(), key=lambda r: r["start"])
+
+
+def timeline(recs, hz, out):
+    base = recs[0]["start"]
+    prev_end = {}
+    out.write("%12s %10s %10s %4s %3s %-5s %-16s %8s %8s\n" % (
+        "start(us)", "dur(us)", "gap(us)", "port", "ss", "mode", "flags",
+        "bytes", "MB/s"))
+    for r in recs:
+        dur = (r["end"] - r["start"]) * 1e6 / hz
+        port = r["port"]
+        gap = (r["start"] - prev_end[port]) * 1e6 / hz if port in prev_end else 0.0
+        prev_end[port] = r["end"]
+        rate = r["bytes"] / dur if dur > 0 else 0.0
+        out.write("%12.1f %10.1f %10.1f %4d %3d %-5s %-16s %8d %8.2f\n" % (
+            (r["start"] - base) * 1e6 / hz, dur, gap, port, r["ss"],
+            MODES.get(r["mode"], "?"), flag_names(r["flags"]), r["bytes"], rate))
+
+
+def chart(recs, hz, width, out):
+    """Per-port bus occupancy (D: DMA, P: PIO, *: both, .: idle)."""
+    base = recs[0]["start"]
+    span = max(r["end"] for r in recs) - base
+    if span <= 0:
+        return
+    rows = {}
+    for r in recs:
+        row = rows.setdefault(r["port"], [0] * width)
+        kind = (1 if r["flags"] & 0x01 else 0) | (2 if r["flags"] & 0x02 else 0)
+        c0 = (r["start"] - base) * width // span
+        c1 = max(c0 + 1, (r["end"] - base) * width // span)
+        for c in range(c0, min(c1, width)):
+            row[c] |= kind or 1
+    out.write("\nbus occupancy over %.1f ms (%d columns)\n" % (span * 1e3 / hz, width))
+    for port in sorted(rows):
+        out.write("SPI%d |%s|\n" % (port, "".join(".DP*"[k] for k in rows[port])))
+
+
+def report(recs, hz, out):
+    base = recs[0]["start"]
+    span = max(r["end"] for r in recs) - base
+    stats = OrderedDict()
+    ports = {}
+    for r in recs:
+        cycles = r["end"] - r["start"]
+        s = stats.setdefault((r["port"], r["ss"]), {
+            "count": 0, "bytes": 0, "cycles": 0, "max": 0,
+            "dma": 0, "pio": 0, "err": 0})
+        s["count"] += 1
+        s["bytes"] += r["bytes"]
+        s["cycles"] += cycles
+        s["max"] = max(s["max"], cycles)
+        s["dma"] += r["bytes"] if r["flags"] & 0x01 else 0
+        s["pio"] += r["bytes"] if not r["flags"] & 0x01 else 0
+        s["err"] += 1 if r["flags"] & 0x80 else 0
+        ports[r["port"]] = ports.get(r["port"], 0) + cycles
+    out.write("\n%4s %3s %7s %10s %10s %8s %10s %6s %10s %10s %4s\n" % (
+        "port", "ss", "count", "bytes", "busy(us)", "busy%", "max(us)",
+        "MB/s", "dma(B)", "pio(B)", "err"))
+    for (port, ss), s in sorted(stats.items()):
+        busy = s["cycles"] * 1e6 / hz
+        out.write("%4d %3d %7d %10d %10.1f %7.2f%% %10.1f %6.2f %10d %10d %4d\n" % (
+            port, ss, s["count"], s["bytes"], busy,
+            100.0 * s["cycles"] / span if span else 0.0, s["max"] * 1e6 / hz,
+            s["bytes"] / busy if busy else 0.0, s["dma"], s["pio"], s["err"]))
+    for port in sorted(ports):
+        out.write("SPI%d utilization %.2f%%\n" % (
+            port, 100.0 * ports[port] / span if span else 0.0))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="decode spi_trace_dump() output")
+    ap.add_argument("logfile", nargs="*", help="serial log (default: stdin)")
+    ap.add_argument("-z", "--hz", type=int, help="cycle counter frequency (overrides SPIT-BEGIN)")
+    ap.add_argument("-w", "--width", type=int, default=72, help="occupancy chart columns")
+    ap.add_argument("-n", "--no-timeline", action="store_true", help="print the report only")
+    args = ap.parse_args()
+
+    lines = []
+    if args.logfile:
+        for name in args.logfile:
+            with open(name, errors="replace") as f:
+                lines.extend(f)
+    else:
+        lines = sys.stdin.readlines()
+
+    hz, lost, recs = parse(lines)
+    if args.hz:
+        hz = args.hz
+    if not recs:
+        sys.stderr.write("no SPIT records found\n")
+        return 1
+    if not hz:
+        sys.stderr.write("cycle frequency unknown, use --hz\n")
+        return 1
+
+    out = sys.stdout
+    out.write("%d transactions, %d lost, %d Hz\n" % (len(recs), lost, hz))
+    if not args.no_timeline:
+        timeline(recs, hz, out)
+    chart(recs, hz, args.width, out)
+    report(recs, hz, out)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())